@@ -0,0 +1,996 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "Array.h"
+#include "Cpu.h"
+
+#include "ArrayKernels.h"   // unmanaged kernels
+#include "SortKernels.h"
+
+#include <algorithm>        // std::sort
+
+#pragma managed
+
+using namespace System::Threading::Tasks;
+
+namespace Intrinsics
+{
+    template<typename T> struct ArraySumOf { typedef Int64 Type; };
+    template<> struct ArraySumOf<float> { typedef double Type; };
+    template<> struct ArraySumOf<double> { typedef double Type; };
+
+    enum ArrayScanOperation
+    {
+        ArrayScanSum,
+        ArrayScanDot,
+        ArrayScanCountEqual,
+        ArrayScanIndexOf,
+        ArrayScanLastIndexOf,
+        ArrayScanMin,
+        ArrayScanMax,
+        ArrayScanMinMax
+    };
+
+    // a scan split in chunks run on the thread pool, a few chunks per worker to balance them. every chunk
+    // write its own result, they are merged in order by the calling thread which keep the arrays pinned
+    template<typename T>
+    ref class ArrayScan
+    {
+    public:
+        typedef typename ArraySumOf<T>::Type Sum;
+
+        __clrcall ArrayScan(ArrayScanOperation operation, const T* a, const T* b, T value, Int64 count)
+            : operation_(operation), a_(a), b_(b), value_(value), count_(count)
+        {
+            const int workers = Cpu::WorkerCount;
+            chunkLength_ = (count + workers * 4 - 1) / (workers * 4);
+            chunks_ = (int)((count + chunkLength_ - 1) / chunkLength_);
+            sums_ = gcnew array<Sum>(chunks_);
+            first_ = gcnew array<Int64>(chunks_);
+            second_ = gcnew array<Int64>(chunks_);
+            for (int i = 0; i < chunks_; ++i)
+                first_[i] = second_[i] = -1;
+        }
+
+        void __clrcall Run()
+        {
+            ParallelOptions^ options = gcnew ParallelOptions();
+            options->MaxDegreeOfParallelism = Cpu::WorkerCount;
+            Parallel::For(0, chunks_, options, gcnew Action<int, ParallelLoopState^>(this, &ArrayScan::RunChunk));
+        }
+
+        Sum __clrcall Total()
+        {
+            Sum total = 0;
+            for (int i = 0; i < chunks_; ++i)
+                total += sums_[i];
+            return total;
+        }
+
+        Int64 __clrcall Count()
+        {
+            Int64 count = 0;
+            for (int i = 0; i < chunks_; ++i)
+                count += first_[i];
+            return count;
+        }
+
+        // the chunks are searched in order (from the end for LastIndexOf), the first found stop the later ones
+        Int64 __clrcall Found()
+        {
+            for (int i = 0; i < chunks_; ++i)
+            {
+                if (first_[i] >= 0)
+                    return first_[i];
+            }
+            return -1;
+        }
+
+        void __clrcall Extrema(Int64& min, Int64& max)
+        {
+            min = max = -1;
+            for (int i = 0; i < chunks_; ++i)
+            {
+                const Int64 any = first_[i] >= 0 ? first_[i] : second_[i];
+                if (a_[any] != a_[any])
+                {
+                    min = max = any;
+                    return;
+                }
+                if (first_[i] >= 0 && (min < 0 || a_[first_[i]] < a_[min]))
+                    min = first_[i];
+                if (second_[i] >= 0 && (max < 0 || a_[second_[i]] > a_[max]))
+                    max = second_[i];
+            }
+        }
+
+    private:
+        void __clrcall RunChunk(int iteration, ParallelLoopState^ state)
+        {
+            const int chunk = operation_ == ArrayScanLastIndexOf ? chunks_ - 1 - iteration : iteration;
+            const Int64 begin = chunk * chunkLength_;
+            const Int64 length = count_ - begin < chunkLength_ ? count_ - begin : chunkLength_;
+            const ArrayTier tier = ArrayBestTier();
+            const T* a = a_ + begin;
+
+            switch (operation_)
+            {
+            case ArrayScanSum:
+                sums_[chunk] = ArraySum(tier, a, length);
+                break;
+            case ArrayScanDot:
+                sums_[chunk] = ArrayDot(tier, a, b_ + begin, length);
+                break;
+            case ArrayScanCountEqual:
+                first_[chunk] = ArrayCountEqual(tier, a, length, value_);
+                break;
+            case ArrayScanIndexOf:
+            case ArrayScanLastIndexOf:
+            {
+                const Int64 found = operation_ == ArrayScanIndexOf ? ArrayIndexOf(tier, a, length, value_) : ArrayLastIndexOf(tier, a, length, value_);
+                if (found >= 0)
+                {
+                    first_[iteration] = begin + found;
+                    state->Break();
+                }
+                break;
+            }
+            default:
+            {
+                int64_t min = -1;
+                int64_t max = -1;
+                ArrayMinMax(tier, a, length, operation_ != ArrayScanMax ? &min : nullptr, operation_ != ArrayScanMin ? &max : nullptr);
+                first_[chunk] = min < 0 ? -1 : begin + min;
+                second_[chunk] = max < 0 ? -1 : begin + max;
+                break;
+            }
+            }
+        }
+
+        ArrayScanOperation operation_;
+        const T* a_;
+        const T* b_;
+        T value_;
+        Int64 count_;
+        Int64 chunkLength_;
+        int chunks_;
+        array<Sum>^ sums_;
+        array<Int64>^ first_;
+        array<Int64>^ second_;
+    };
+
+    static bool __clrcall IsParallel(Int64 count)
+    {
+        return count >= Array::ParallelThreshold && Cpu::WorkerCount > 1;
+    }
+
+    template<typename T>
+    static void __clrcall CheckRange(array<T>^ values, int startIndex, int count)
+    {
+        if (values == nullptr)
+            throw gcnew ArgumentNullException("values is null");
+
+        if (startIndex < 0 || startIndex > values->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than values length");
+
+        if (count < 0 || count > values->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than values - startIndex");
+    }
+
+    template<typename T>
+    static typename ArraySumOf<T>::Type __clrcall SumCore(array<T>^ values, int startIndex, int count)
+    {
+        CheckRange(values, startIndex, count);
+        if (!count)
+            return 0;
+
+        pin_ptr<T> pinValues = &values[startIndex];
+        if (!IsParallel(count))
+            return ArraySum(ArrayBestTier(), (const T*)pinValues, count);
+
+        ArrayScan<T>^ scan = gcnew ArrayScan<T>(ArrayScanSum, pinValues, nullptr, T(), count);
+        scan->Run();
+        return scan->Total();
+    }
+
+    template<typename T>
+    static typename ArraySumOf<T>::Type __clrcall DotCore(array<T>^ a, int indexA, array<T>^ b, int indexB, int count)
+    {
+        if (a == nullptr)
+            throw gcnew ArgumentNullException("a is null");
+
+        if (b == nullptr)
+            throw gcnew ArgumentNullException("b is null");
+
+        if (count < 0)
+            throw gcnew ArgumentOutOfRangeException(L"count must be greater or equal to 0");
+
+        if (indexA < 0 || indexA > a->Length - count)
+            throw gcnew ArgumentOutOfRangeException(L"indexA must be greater than 0 and smaller than a length - count");
+
+        if (indexB < 0 || indexB > b->Length - count)
+            throw gcnew ArgumentOutOfRangeException(L"indexB must be greater than 0 and smaller than b length - count");
+
+        if (!count)
+            return 0;
+
+        pin_ptr<T> pinA = &a[indexA];
+        pin_ptr<T> pinB = &b[indexB];
+        if (!IsParallel(count))
+            return ArrayDot(ArrayBestTier(), (const T*)pinA, (const T*)pinB, count);
+
+        ArrayScan<T>^ scan = gcnew ArrayScan<T>(ArrayScanDot, pinA, pinB, T(), count);
+        scan->Run();
+        return scan->Total();
+    }
+
+    // indices in values, -1 when count is 0
+    template<typename T>
+    static void __clrcall ExtremaCore(array<T>^ values, int startIndex, int count, ArrayScanOperation operation, int& min, int& max)
+    {
+        CheckRange(values, startIndex, count);
+        min = max = -1;
+        if (!count)
+            return;
+
+        pin_ptr<T> pinValues = &values[startIndex];
+        int64_t minIndex = -1;
+        int64_t maxIndex = -1;
+        if (!IsParallel(count))
+        {
+            ArrayMinMax(ArrayBestTier(), (const T*)pinValues, count, operation != ArrayScanMax ? &minIndex : nullptr, operation != ArrayScanMin ? &maxIndex : nullptr);
+        }
+        else
+        {
+            ArrayScan<T>^ scan = gcnew ArrayScan<T>(operation, pinValues, nullptr, T(), count);
+            scan->Run();
+            scan->Extrema(minIndex, maxIndex);
+        }
+
+        if (minIndex >= 0)
+            min = startIndex + (int)minIndex;
+        if (maxIndex >= 0)
+            max = startIndex + (int)maxIndex;
+    }
+
+    template<typename T>
+    static T __clrcall MinCore(array<T>^ values)
+    {
+        if (values == nullptr)
+            throw gcnew ArgumentNullException("values is null");
+
+        if (!values->Length)
+            throw gcnew InvalidOperationException("values is empty");
+
+        int min, max;
+        ExtremaCore(values, 0, values->Length, ArrayScanMin, min, max);
+        return values[min];
+    }
+
+    template<typename T>
+    static T __clrcall MaxCore(array<T>^ values)
+    {
+        if (values == nullptr)
+            throw gcnew ArgumentNullException("values is null");
+
+        if (!values->Length)
+            throw gcnew InvalidOperationException("values is empty");
+
+        int min, max;
+        ExtremaCore(values, 0, values->Length, ArrayScanMax, min, max);
+        return values[max];
+    }
+
+    template<typename T>
+    static Array::MinMaxValue<T> __clrcall MinMaxCore(array<T>^ values, int startIndex, int count)
+    {
+        CheckRange(values, startIndex, count);
+        if (!count)
+            throw gcnew InvalidOperationException("count is 0");
+
+        int min, max;
+        ExtremaCore(values, startIndex, count, ArrayScanMinMax, min, max);
+
+        Array::MinMaxValue<T> value;
+        value.Min = values[min];
+        value.MinIndex = min;
+        value.Max = values[max];
+        value.MaxIndex = max;
+        return value;
+    }
+
+    template<typename T>
+    static int __clrcall SearchCore(array<T>^ values, T value, int startIndex, int count, ArrayScanOperation operation)
+    {
+        CheckRange(values, startIndex, count);
+        if (!count)
+            return operation == ArrayScanCountEqual ? 0 : -1;
+
+        pin_ptr<T> pinValues = &values[startIndex];
+        const T* a = pinValues;
+        Int64 result;
+        if (IsParallel(count))
+        {
+            ArrayScan<T>^ scan = gcnew ArrayScan<T>(operation, a, nullptr, value, count);
+            scan->Run();
+            result = operation == ArrayScanCountEqual ? scan->Count() : scan->Found();
+        }
+        else if (operation == ArrayScanCountEqual)
+            result = ArrayCountEqual(ArrayBestTier(), a, count, value);
+        else if (operation == ArrayScanIndexOf)
+            result = ArrayIndexOf(ArrayBestTier(), a, count, value);
+        else
+            result = ArrayLastIndexOf(ArrayBestTier(), a, count, value);
+
+        if (operation == ArrayScanCountEqual)
+            return (int)result;
+        return result < 0 ? -1 : startIndex + (int)result;
+    }
+
+    // float and double are sorted as their integer keys
+    template<typename T>
+    struct ArraySortKey
+    {
+        typedef T Type;
+        static void ToKeys(T*, Int64) {}
+        static void ToValues(T*, Int64) {}
+    };
+
+    template<>
+    struct ArraySortKey<float>
+    {
+        typedef int32_t Type;
+        static void ToKeys(float* values, Int64 count) { ArrayFloatToKeys(values, count); }
+        static void ToValues(int32_t* keys, Int64 count) { ArrayKeysToFloat(keys, count); }
+    };
+
+    template<>
+    struct ArraySortKey<double>
+    {
+        typedef int64_t Type;
+        static void ToKeys(double* values, Int64 count) { ArrayFloatToKeys(values, count); }
+        static void ToValues(int64_t* keys, Int64 count) { ArrayKeysToFloat(keys, count); }
+    };
+
+    // items are only sorted with 64 bits keys
+    static void __clrcall SortRange(int32_t* keys, int64_t*, Int64 count)
+    {
+        ArraySort(ArrayBestTier(), keys, count);
+    }
+
+    static void __clrcall SortRange(int64_t* keys, int64_t* items, Int64 count)
+    {
+        if (items)
+            ArraySort(ArrayBestTier(), keys, items, count);
+        else
+            ArraySort(ArrayBestTier(), keys, count);
+    }
+
+    static Int64 __clrcall PartitionRange(int32_t* keys, int64_t*, Int64 count)
+    {
+        return ArraySortPartition(ArrayBestTier(), keys, count);
+    }
+
+    static Int64 __clrcall PartitionRange(int64_t* keys, int64_t* items, Int64 count)
+    {
+        return items ? ArraySortPartition(ArrayBestTier(), keys, items, count) : ArraySortPartition(ArrayBestTier(), keys, count);
+    }
+
+    // a partition step then both sides run on the thread pool, until they are small enough to be sorted
+    // by a worker. the depth is bounded like the introsort, past it the range is sorted in place
+    template<typename K>
+    ref class ArraySortTask
+    {
+    public:
+        __clrcall ArraySortTask(K* keys, int64_t* items, Int64 count, Int64 grain, int depth)
+            : keys_(keys), items_(items), count_(count), grain_(grain), depth_(depth)
+        {
+        }
+
+        void __clrcall Run()
+        {
+            if (count_ <= grain_ || !depth_)
+            {
+                SortRange(keys_, items_, count_);
+                return;
+            }
+
+            const Int64 mid = PartitionRange(keys_, items_, count_);
+            if (!mid)
+                return;
+
+            ArraySortTask^ left = gcnew ArraySortTask(keys_, items_, mid, grain_, depth_ - 1);
+            ArraySortTask^ right = gcnew ArraySortTask(keys_ + mid, items_ ? items_ + mid : nullptr, count_ - mid, grain_, depth_ - 1);
+            Parallel::Invoke(gcnew Action(left, &ArraySortTask::Run), gcnew Action(right, &ArraySortTask::Run));
+        }
+
+    private:
+        K* keys_;
+        int64_t* items_;
+        Int64 count_;
+        Int64 grain_;
+        int depth_;
+    };
+
+    template<typename K>
+    static void __clrcall SortKeys(K* keys, int64_t* items, Int64 count)
+    {
+        if (!IsParallel(count))
+        {
+            SortRange(keys, items, count);
+            return;
+        }
+
+        // a few ranges per worker to balance them, large enough to amortize the tasks
+        const Int64 grain = count / (Cpu::WorkerCount * 8);
+        ArraySortTask<K>^ task = gcnew ArraySortTask<K>(keys, items, count, grain > (1 << 16) ? grain : (1 << 16), 64);
+        task->Run();
+    }
+
+    template<typename T>
+    static void __clrcall SortCore(array<T>^ values, int startIndex, int count)
+    {
+        CheckRange(values, startIndex, count);
+        if (count < 2)
+            return;
+
+        typedef typename ArraySortKey<T>::Type Key;
+        pin_ptr<T> pinValues = &values[startIndex];
+        Key* keys = (Key*)(T*)pinValues;
+        ArraySortKey<T>::ToKeys(pinValues, count);
+        SortKeys(keys, (int64_t*)nullptr, count);
+        ArraySortKey<T>::ToValues(keys, count);
+    }
+
+    // 32 bits keys are sorted with their index in the low bits, which make the sort stable
+    static void __clrcall SortIndices(int32_t* keys, int* indices, int64_t* buffer, int count)
+    {
+        ArrayPackIndex(keys, buffer, count);
+        SortKeys(buffer, (int64_t*)nullptr, count);
+        ArrayUnpackIndex(buffer, keys, indices, count);
+    }
+
+    // 64 bits keys move their index, then the indices of equal keys are put back in order
+    static void __clrcall SortIndices(int64_t* keys, int* indices, int64_t* buffer, int count)
+    {
+        for (int i = 0; i < count; ++i)
+            buffer[i] = i;
+        SortKeys(keys, buffer, count);
+
+        for (int i = 0; i < count;)
+        {
+            int end = i + 1;
+            while (end < count && keys[end] == keys[i])
+                ++end;
+            if (end - i > 1)
+                std::sort(buffer + i, buffer + end);
+            i = end;
+        }
+
+        for (int i = 0; i < count; ++i)
+            indices[i] = (int)buffer[i];
+    }
+
+    template<typename T>
+    static void __clrcall SortCore(array<T>^ values, array<int>^ indices)
+    {
+        if (values == nullptr)
+            throw gcnew ArgumentNullException("values is null");
+
+        if (indices == nullptr)
+            throw gcnew ArgumentNullException("indices is null");
+
+        if (values->Length != indices->Length)
+            throw gcnew ArgumentException("values and indices must have the same length");
+
+        const int count = values->Length;
+        if (!count)
+            return;
+
+        typedef typename ArraySortKey<T>::Type Key;
+        array<Int64>^ buffer = gcnew array<Int64>(count);
+        pin_ptr<T> pinValues = &values[0];
+        pin_ptr<int> pinIndices = &indices[0];
+        pin_ptr<Int64> pinBuffer = &buffer[0];
+        Key* keys = (Key*)(T*)pinValues;
+        ArraySortKey<T>::ToKeys(pinValues, count);
+        SortIndices(keys, pinIndices, pinBuffer, count);
+        ArraySortKey<T>::ToValues(keys, count);
+    }
+
+    Array::Array()
+    {
+        // tens of millions elements, below that the threads startup and the memory bandwidth they share
+        // leave little to gain
+        parallelThreshold_ = 1 << 24;
+    }
+
+    void __clrcall Array::ParallelThreshold::set(int value)
+    {
+        if (value < 1)
+            throw gcnew ArgumentOutOfRangeException(L"ParallelThreshold must be greater than 0");
+        parallelThreshold_ = value;
+    }
+
+    Int64 __clrcall Array::Sum(array<int>^ values)
+    {
+        return SumCore(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    Int64 __clrcall Array::Sum(array<int>^ values, int startIndex, int count)
+    {
+        return SumCore(values, startIndex, count);
+    }
+
+    Int64 __clrcall Array::Sum(array<Int64>^ values)
+    {
+        return SumCore(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    Int64 __clrcall Array::Sum(array<Int64>^ values, int startIndex, int count)
+    {
+        return SumCore(values, startIndex, count);
+    }
+
+    double __clrcall Array::Sum(array<float>^ values)
+    {
+        return SumCore(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    double __clrcall Array::Sum(array<float>^ values, int startIndex, int count)
+    {
+        return SumCore(values, startIndex, count);
+    }
+
+    double __clrcall Array::Sum(array<double>^ values)
+    {
+        return SumCore(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    double __clrcall Array::Sum(array<double>^ values, int startIndex, int count)
+    {
+        return SumCore(values, startIndex, count);
+    }
+
+    int __clrcall Array::Min(array<int>^ values)
+    {
+        return MinCore(values);
+    }
+
+    Int64 __clrcall Array::Min(array<Int64>^ values)
+    {
+        return MinCore(values);
+    }
+
+    float __clrcall Array::Min(array<float>^ values)
+    {
+        return MinCore(values);
+    }
+
+    double __clrcall Array::Min(array<double>^ values)
+    {
+        return MinCore(values);
+    }
+
+    int __clrcall Array::Max(array<int>^ values)
+    {
+        return MaxCore(values);
+    }
+
+    Int64 __clrcall Array::Max(array<Int64>^ values)
+    {
+        return MaxCore(values);
+    }
+
+    float __clrcall Array::Max(array<float>^ values)
+    {
+        return MaxCore(values);
+    }
+
+    double __clrcall Array::Max(array<double>^ values)
+    {
+        return MaxCore(values);
+    }
+
+    int __clrcall Array::IndexOfMin(array<int>^ values)
+    {
+        return IndexOfMin(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    int __clrcall Array::IndexOfMin(array<int>^ values, int startIndex, int count)
+    {
+        int min, max;
+        ExtremaCore(values, startIndex, count, ArrayScanMin, min, max);
+        return min;
+    }
+
+    int __clrcall Array::IndexOfMin(array<Int64>^ values)
+    {
+        return IndexOfMin(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    int __clrcall Array::IndexOfMin(array<Int64>^ values, int startIndex, int count)
+    {
+        int min, max;
+        ExtremaCore(values, startIndex, count, ArrayScanMin, min, max);
+        return min;
+    }
+
+    int __clrcall Array::IndexOfMin(array<float>^ values)
+    {
+        return IndexOfMin(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    int __clrcall Array::IndexOfMin(array<float>^ values, int startIndex, int count)
+    {
+        int min, max;
+        ExtremaCore(values, startIndex, count, ArrayScanMin, min, max);
+        return min;
+    }
+
+    int __clrcall Array::IndexOfMin(array<double>^ values)
+    {
+        return IndexOfMin(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    int __clrcall Array::IndexOfMin(array<double>^ values, int startIndex, int count)
+    {
+        int min, max;
+        ExtremaCore(values, startIndex, count, ArrayScanMin, min, max);
+        return min;
+    }
+
+    int __clrcall Array::IndexOfMax(array<int>^ values)
+    {
+        return IndexOfMax(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    int __clrcall Array::IndexOfMax(array<int>^ values, int startIndex, int count)
+    {
+        int min, max;
+        ExtremaCore(values, startIndex, count, ArrayScanMax, min, max);
+        return max;
+    }
+
+    int __clrcall Array::IndexOfMax(array<Int64>^ values)
+    {
+        return IndexOfMax(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    int __clrcall Array::IndexOfMax(array<Int64>^ values, int startIndex, int count)
+    {
+        int min, max;
+        ExtremaCore(values, startIndex, count, ArrayScanMax, min, max);
+        return max;
+    }
+
+    int __clrcall Array::IndexOfMax(array<float>^ values)
+    {
+        return IndexOfMax(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    int __clrcall Array::IndexOfMax(array<float>^ values, int startIndex, int count)
+    {
+        int min, max;
+        ExtremaCore(values, startIndex, count, ArrayScanMax, min, max);
+        return max;
+    }
+
+    int __clrcall Array::IndexOfMax(array<double>^ values)
+    {
+        return IndexOfMax(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    int __clrcall Array::IndexOfMax(array<double>^ values, int startIndex, int count)
+    {
+        int min, max;
+        ExtremaCore(values, startIndex, count, ArrayScanMax, min, max);
+        return max;
+    }
+
+    Array::MinMaxValue<int> __clrcall Array::MinMax(array<int>^ values)
+    {
+        return MinMaxCore(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    Array::MinMaxValue<int> __clrcall Array::MinMax(array<int>^ values, int startIndex, int count)
+    {
+        return MinMaxCore(values, startIndex, count);
+    }
+
+    Array::MinMaxValue<Int64> __clrcall Array::MinMax(array<Int64>^ values)
+    {
+        return MinMaxCore(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    Array::MinMaxValue<Int64> __clrcall Array::MinMax(array<Int64>^ values, int startIndex, int count)
+    {
+        return MinMaxCore(values, startIndex, count);
+    }
+
+    Array::MinMaxValue<float> __clrcall Array::MinMax(array<float>^ values)
+    {
+        return MinMaxCore(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    Array::MinMaxValue<float> __clrcall Array::MinMax(array<float>^ values, int startIndex, int count)
+    {
+        return MinMaxCore(values, startIndex, count);
+    }
+
+    Array::MinMaxValue<double> __clrcall Array::MinMax(array<double>^ values)
+    {
+        return MinMaxCore(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    Array::MinMaxValue<double> __clrcall Array::MinMax(array<double>^ values, int startIndex, int count)
+    {
+        return MinMaxCore(values, startIndex, count);
+    }
+
+    int __clrcall Array::IndexOf(array<int>^ values, int value)
+    {
+        return SearchCore(values, value, 0, values == nullptr ? 0 : values->Length, ArrayScanIndexOf);
+    }
+
+    int __clrcall Array::IndexOf(array<int>^ values, int value, int startIndex, int count)
+    {
+        return SearchCore(values, value, startIndex, count, ArrayScanIndexOf);
+    }
+
+    int __clrcall Array::IndexOf(array<Int64>^ values, Int64 value)
+    {
+        return SearchCore(values, value, 0, values == nullptr ? 0 : values->Length, ArrayScanIndexOf);
+    }
+
+    int __clrcall Array::IndexOf(array<Int64>^ values, Int64 value, int startIndex, int count)
+    {
+        return SearchCore(values, value, startIndex, count, ArrayScanIndexOf);
+    }
+
+    int __clrcall Array::IndexOf(array<float>^ values, float value)
+    {
+        return SearchCore(values, value, 0, values == nullptr ? 0 : values->Length, ArrayScanIndexOf);
+    }
+
+    int __clrcall Array::IndexOf(array<float>^ values, float value, int startIndex, int count)
+    {
+        return SearchCore(values, value, startIndex, count, ArrayScanIndexOf);
+    }
+
+    int __clrcall Array::IndexOf(array<double>^ values, double value)
+    {
+        return SearchCore(values, value, 0, values == nullptr ? 0 : values->Length, ArrayScanIndexOf);
+    }
+
+    int __clrcall Array::IndexOf(array<double>^ values, double value, int startIndex, int count)
+    {
+        return SearchCore(values, value, startIndex, count, ArrayScanIndexOf);
+    }
+
+    int __clrcall Array::LastIndexOf(array<int>^ values, int value)
+    {
+        return SearchCore(values, value, 0, values == nullptr ? 0 : values->Length, ArrayScanLastIndexOf);
+    }
+
+    int __clrcall Array::LastIndexOf(array<int>^ values, int value, int startIndex, int count)
+    {
+        return SearchCore(values, value, startIndex, count, ArrayScanLastIndexOf);
+    }
+
+    int __clrcall Array::LastIndexOf(array<Int64>^ values, Int64 value)
+    {
+        return SearchCore(values, value, 0, values == nullptr ? 0 : values->Length, ArrayScanLastIndexOf);
+    }
+
+    int __clrcall Array::LastIndexOf(array<Int64>^ values, Int64 value, int startIndex, int count)
+    {
+        return SearchCore(values, value, startIndex, count, ArrayScanLastIndexOf);
+    }
+
+    int __clrcall Array::LastIndexOf(array<float>^ values, float value)
+    {
+        return SearchCore(values, value, 0, values == nullptr ? 0 : values->Length, ArrayScanLastIndexOf);
+    }
+
+    int __clrcall Array::LastIndexOf(array<float>^ values, float value, int startIndex, int count)
+    {
+        return SearchCore(values, value, startIndex, count, ArrayScanLastIndexOf);
+    }
+
+    int __clrcall Array::LastIndexOf(array<double>^ values, double value)
+    {
+        return SearchCore(values, value, 0, values == nullptr ? 0 : values->Length, ArrayScanLastIndexOf);
+    }
+
+    int __clrcall Array::LastIndexOf(array<double>^ values, double value, int startIndex, int count)
+    {
+        return SearchCore(values, value, startIndex, count, ArrayScanLastIndexOf);
+    }
+
+    bool __clrcall Array::Contains(array<int>^ values, int value)
+    {
+        return IndexOf(values, value) >= 0;
+    }
+
+    bool __clrcall Array::Contains(array<Int64>^ values, Int64 value)
+    {
+        return IndexOf(values, value) >= 0;
+    }
+
+    bool __clrcall Array::Contains(array<float>^ values, float value)
+    {
+        return IndexOf(values, value) >= 0;
+    }
+
+    bool __clrcall Array::Contains(array<double>^ values, double value)
+    {
+        return IndexOf(values, value) >= 0;
+    }
+
+    int __clrcall Array::CountEqual(array<int>^ values, int value)
+    {
+        return SearchCore(values, value, 0, values == nullptr ? 0 : values->Length, ArrayScanCountEqual);
+    }
+
+    int __clrcall Array::CountEqual(array<int>^ values, int value, int startIndex, int count)
+    {
+        return SearchCore(values, value, startIndex, count, ArrayScanCountEqual);
+    }
+
+    int __clrcall Array::CountEqual(array<Int64>^ values, Int64 value)
+    {
+        return SearchCore(values, value, 0, values == nullptr ? 0 : values->Length, ArrayScanCountEqual);
+    }
+
+    int __clrcall Array::CountEqual(array<Int64>^ values, Int64 value, int startIndex, int count)
+    {
+        return SearchCore(values, value, startIndex, count, ArrayScanCountEqual);
+    }
+
+    int __clrcall Array::CountEqual(array<float>^ values, float value)
+    {
+        return SearchCore(values, value, 0, values == nullptr ? 0 : values->Length, ArrayScanCountEqual);
+    }
+
+    int __clrcall Array::CountEqual(array<float>^ values, float value, int startIndex, int count)
+    {
+        return SearchCore(values, value, startIndex, count, ArrayScanCountEqual);
+    }
+
+    int __clrcall Array::CountEqual(array<double>^ values, double value)
+    {
+        return SearchCore(values, value, 0, values == nullptr ? 0 : values->Length, ArrayScanCountEqual);
+    }
+
+    int __clrcall Array::CountEqual(array<double>^ values, double value, int startIndex, int count)
+    {
+        return SearchCore(values, value, startIndex, count, ArrayScanCountEqual);
+    }
+
+    Int64 __clrcall Array::Dot(array<int>^ a, array<int>^ b)
+    {
+        if (a != nullptr && b != nullptr && a->Length != b->Length)
+            throw gcnew ArgumentException("a and b must have the same length");
+        return DotCore(a, 0, b, 0, a == nullptr ? 0 : a->Length);
+    }
+
+    Int64 __clrcall Array::Dot(array<int>^ a, int indexA, array<int>^ b, int indexB, int count)
+    {
+        return DotCore(a, indexA, b, indexB, count);
+    }
+
+    Int64 __clrcall Array::Dot(array<Int64>^ a, array<Int64>^ b)
+    {
+        if (a != nullptr && b != nullptr && a->Length != b->Length)
+            throw gcnew ArgumentException("a and b must have the same length");
+        return DotCore(a, 0, b, 0, a == nullptr ? 0 : a->Length);
+    }
+
+    Int64 __clrcall Array::Dot(array<Int64>^ a, int indexA, array<Int64>^ b, int indexB, int count)
+    {
+        return DotCore(a, indexA, b, indexB, count);
+    }
+
+    double __clrcall Array::Dot(array<float>^ a, array<float>^ b)
+    {
+        if (a != nullptr && b != nullptr && a->Length != b->Length)
+            throw gcnew ArgumentException("a and b must have the same length");
+        return DotCore(a, 0, b, 0, a == nullptr ? 0 : a->Length);
+    }
+
+    double __clrcall Array::Dot(array<float>^ a, int indexA, array<float>^ b, int indexB, int count)
+    {
+        return DotCore(a, indexA, b, indexB, count);
+    }
+
+    double __clrcall Array::Dot(array<double>^ a, array<double>^ b)
+    {
+        if (a != nullptr && b != nullptr && a->Length != b->Length)
+            throw gcnew ArgumentException("a and b must have the same length");
+        return DotCore(a, 0, b, 0, a == nullptr ? 0 : a->Length);
+    }
+
+    double __clrcall Array::Dot(array<double>^ a, int indexA, array<double>^ b, int indexB, int count)
+    {
+        return DotCore(a, indexA, b, indexB, count);
+    }
+
+    void __clrcall Array::Sort(array<int>^ values)
+    {
+        SortCore(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    void __clrcall Array::Sort(array<int>^ values, int startIndex, int count)
+    {
+        SortCore(values, startIndex, count);
+    }
+
+    void __clrcall Array::Sort(array<Int64>^ values)
+    {
+        SortCore(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    void __clrcall Array::Sort(array<Int64>^ values, int startIndex, int count)
+    {
+        SortCore(values, startIndex, count);
+    }
+
+    void __clrcall Array::Sort(array<float>^ values)
+    {
+        SortCore(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    void __clrcall Array::Sort(array<float>^ values, int startIndex, int count)
+    {
+        SortCore(values, startIndex, count);
+    }
+
+    void __clrcall Array::Sort(array<double>^ values)
+    {
+        SortCore(values, 0, values == nullptr ? 0 : values->Length);
+    }
+
+    void __clrcall Array::Sort(array<double>^ values, int startIndex, int count)
+    {
+        SortCore(values, startIndex, count);
+    }
+
+    void __clrcall Array::Sort(array<int>^ values, array<int>^ indices)
+    {
+        SortCore(values, indices);
+    }
+
+    void __clrcall Array::Sort(array<Int64>^ values, array<int>^ indices)
+    {
+        SortCore(values, indices);
+    }
+
+    void __clrcall Array::Sort(array<float>^ values, array<int>^ indices)
+    {
+        SortCore(values, indices);
+    }
+
+    void __clrcall Array::Sort(array<double>^ values, array<int>^ indices)
+    {
+        SortCore(values, indices);
+    }
+}
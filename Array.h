@@ -0,0 +1,246 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+using namespace System;
+
+namespace Intrinsics
+{
+    // vector reductions, searches and sorts over primitive arrays, the kernels are selected from the cpu features.
+    // ranges of ParallelThreshold elements or more are split across Cpu::WorkerCount thread pool workers.
+    // values are compared with == and <, a NaN is never found or counted but Min and Max return it like
+    // Math::Min and Math::Max.
+    public ref class Array abstract sealed
+    {
+    public:
+        // extrema of a range, indices are in the array
+        generic<typename T>
+        value struct MinMaxValue
+        {
+        public:
+            T Min;
+            int MinIndex;
+            T Max;
+            int MaxIndex;
+        };
+
+        // elements from which a scan is split across the workers, Int32::MaxValue to always scan in the
+        // calling thread
+        static property int ParallelThreshold
+        {
+            int get() { return parallelThreshold_; }
+            void set(int value);
+        }
+
+        // int and float are summed in 64 bits, Int64 and double, an Int64 sum wraps around on overflow. vector
+        // sums add in lanes order, floating point results can differ from a sequential sum in the last bits
+        static Int64 __clrcall Sum(array<int>^ values);
+
+        static Int64 __clrcall Sum(array<int>^ values, int startIndex, int count);
+
+        static Int64 __clrcall Sum(array<Int64>^ values);
+
+        static Int64 __clrcall Sum(array<Int64>^ values, int startIndex, int count);
+
+        static double __clrcall Sum(array<float>^ values);
+
+        static double __clrcall Sum(array<float>^ values, int startIndex, int count);
+
+        static double __clrcall Sum(array<double>^ values);
+
+        static double __clrcall Sum(array<double>^ values, int startIndex, int count);
+
+        // throw InvalidOperationException when values is empty
+        static int __clrcall Min(array<int>^ values);
+
+        static Int64 __clrcall Min(array<Int64>^ values);
+
+        static float __clrcall Min(array<float>^ values);
+
+        static double __clrcall Min(array<double>^ values);
+
+        static int __clrcall Max(array<int>^ values);
+
+        static Int64 __clrcall Max(array<Int64>^ values);
+
+        static float __clrcall Max(array<float>^ values);
+
+        static double __clrcall Max(array<double>^ values);
+
+        // index of the first smallest or largest element, -1 when count is 0
+        static int __clrcall IndexOfMin(array<int>^ values);
+
+        static int __clrcall IndexOfMin(array<int>^ values, int startIndex, int count);
+
+        static int __clrcall IndexOfMin(array<Int64>^ values);
+
+        static int __clrcall IndexOfMin(array<Int64>^ values, int startIndex, int count);
+
+        static int __clrcall IndexOfMin(array<float>^ values);
+
+        static int __clrcall IndexOfMin(array<float>^ values, int startIndex, int count);
+
+        static int __clrcall IndexOfMin(array<double>^ values);
+
+        static int __clrcall IndexOfMin(array<double>^ values, int startIndex, int count);
+
+        static int __clrcall IndexOfMax(array<int>^ values);
+
+        static int __clrcall IndexOfMax(array<int>^ values, int startIndex, int count);
+
+        static int __clrcall IndexOfMax(array<Int64>^ values);
+
+        static int __clrcall IndexOfMax(array<Int64>^ values, int startIndex, int count);
+
+        static int __clrcall IndexOfMax(array<float>^ values);
+
+        static int __clrcall IndexOfMax(array<float>^ values, int startIndex, int count);
+
+        static int __clrcall IndexOfMax(array<double>^ values);
+
+        static int __clrcall IndexOfMax(array<double>^ values, int startIndex, int count);
+
+        // throw InvalidOperationException when count is 0
+        static MinMaxValue<int> __clrcall MinMax(array<int>^ values);
+
+        static MinMaxValue<int> __clrcall MinMax(array<int>^ values, int startIndex, int count);
+
+        static MinMaxValue<Int64> __clrcall MinMax(array<Int64>^ values);
+
+        static MinMaxValue<Int64> __clrcall MinMax(array<Int64>^ values, int startIndex, int count);
+
+        static MinMaxValue<float> __clrcall MinMax(array<float>^ values);
+
+        static MinMaxValue<float> __clrcall MinMax(array<float>^ values, int startIndex, int count);
+
+        static MinMaxValue<double> __clrcall MinMax(array<double>^ values);
+
+        static MinMaxValue<double> __clrcall MinMax(array<double>^ values, int startIndex, int count);
+
+        // -1 when not found. the ranges are [startIndex, startIndex + count[, LastIndexOf search them from the end
+        static int __clrcall IndexOf(array<int>^ values, int value);
+
+        static int __clrcall IndexOf(array<int>^ values, int value, int startIndex, int count);
+
+        static int __clrcall IndexOf(array<Int64>^ values, Int64 value);
+
+        static int __clrcall IndexOf(array<Int64>^ values, Int64 value, int startIndex, int count);
+
+        static int __clrcall IndexOf(array<float>^ values, float value);
+
+        static int __clrcall IndexOf(array<float>^ values, float value, int startIndex, int count);
+
+        static int __clrcall IndexOf(array<double>^ values, double value);
+
+        static int __clrcall IndexOf(array<double>^ values, double value, int startIndex, int count);
+
+        static int __clrcall LastIndexOf(array<int>^ values, int value);
+
+        static int __clrcall LastIndexOf(array<int>^ values, int value, int startIndex, int count);
+
+        static int __clrcall LastIndexOf(array<Int64>^ values, Int64 value);
+
+        static int __clrcall LastIndexOf(array<Int64>^ values, Int64 value, int startIndex, int count);
+
+        static int __clrcall LastIndexOf(array<float>^ values, float value);
+
+        static int __clrcall LastIndexOf(array<float>^ values, float value, int startIndex, int count);
+
+        static int __clrcall LastIndexOf(array<double>^ values, double value);
+
+        static int __clrcall LastIndexOf(array<double>^ values, double value, int startIndex, int count);
+
+        static bool __clrcall Contains(array<int>^ values, int value);
+
+        static bool __clrcall Contains(array<Int64>^ values, Int64 value);
+
+        static bool __clrcall Contains(array<float>^ values, float value);
+
+        static bool __clrcall Contains(array<double>^ values, double value);
+
+        static int __clrcall CountEqual(array<int>^ values, int value);
+
+        static int __clrcall CountEqual(array<int>^ values, int value, int startIndex, int count);
+
+        static int __clrcall CountEqual(array<Int64>^ values, Int64 value);
+
+        static int __clrcall CountEqual(array<Int64>^ values, Int64 value, int startIndex, int count);
+
+        static int __clrcall CountEqual(array<float>^ values, float value);
+
+        static int __clrcall CountEqual(array<float>^ values, float value, int startIndex, int count);
+
+        static int __clrcall CountEqual(array<double>^ values, double value);
+
+        static int __clrcall CountEqual(array<double>^ values, double value, int startIndex, int count);
+
+        // sum of a[i] * b[i], accumulated like Sum. a and b must have the same length
+        static Int64 __clrcall Dot(array<int>^ a, array<int>^ b);
+
+        static Int64 __clrcall Dot(array<int>^ a, int indexA, array<int>^ b, int indexB, int count);
+
+        static Int64 __clrcall Dot(array<Int64>^ a, array<Int64>^ b);
+
+        static Int64 __clrcall Dot(array<Int64>^ a, int indexA, array<Int64>^ b, int indexB, int count);
+
+        static double __clrcall Dot(array<float>^ a, array<float>^ b);
+
+        static double __clrcall Dot(array<float>^ a, int indexA, array<float>^ b, int indexB, int count);
+
+        static double __clrcall Dot(array<double>^ a, array<double>^ b);
+
+        static double __clrcall Dot(array<double>^ a, int indexA, array<double>^ b, int indexB, int count);
+
+        // ascending in place. floats are ordered NaN first and -0 before 0, the values keep their bits (NaN
+        // payloads included). ranges of ParallelThreshold elements or more are partitioned across the workers
+        static void __clrcall Sort(array<int>^ values);
+
+        static void __clrcall Sort(array<int>^ values, int startIndex, int count);
+
+        static void __clrcall Sort(array<Int64>^ values);
+
+        static void __clrcall Sort(array<Int64>^ values, int startIndex, int count);
+
+        static void __clrcall Sort(array<float>^ values);
+
+        static void __clrcall Sort(array<float>^ values, int startIndex, int count);
+
+        static void __clrcall Sort(array<double>^ values);
+
+        static void __clrcall Sort(array<double>^ values, int startIndex, int count);
+
+        // sort values and write in indices the original index of each sorted value, to permute payloads
+        // afterward. equal values keep their order. values and indices must have the same length
+        static void __clrcall Sort(array<int>^ values, array<int>^ indices);
+
+        static void __clrcall Sort(array<Int64>^ values, array<int>^ indices);
+
+        static void __clrcall Sort(array<float>^ values, array<int>^ indices);
+
+        static void __clrcall Sort(array<double>^ values, array<int>^ indices);
+
+    private:
+        static Array();
+
+        static int parallelThreshold_;
+    };
+}
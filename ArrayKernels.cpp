@@ -0,0 +1,1042 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "ArrayKernels.h"
+#include "InstructionSet.h"
+#include "KernelIsa.h"
+
+namespace
+{
+    // Length elements of T per Vector. a compare give a Mask (a vector, or a mask register with avx-512),
+    // Index hold the Length element indices of the min / max lanes and Wide the 64 bits sum lanes.
+    template<typename Isa, typename T> struct Lanes;
+
+    __forceinline __m128i Blend(__m128i mask, __m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a));
+    }
+
+    // signed 32 bits products of the even lanes in 64 bits lanes, mul_epu32 corrected for the signs
+    __forceinline __m128i MultiplyEven(__m128i a, __m128i b)
+    {
+        const __m128i signA = _mm_srai_epi32(a, 31);
+        const __m128i signB = _mm_srai_epi32(b, 31);
+        const __m128i correction = _mm_add_epi32(_mm_and_si128(signA, b), _mm_and_si128(signB, a));
+        return _mm_sub_epi64(_mm_mul_epu32(a, b), _mm_slli_epi64(correction, 32));
+    }
+
+    // low 64 bits of the products, from 32 bits halves
+    __forceinline __m128i Multiply64(__m128i a, __m128i b)
+    {
+        const __m128i cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+        return _mm_add_epi64(_mm_mul_epu32(a, b), _mm_slli_epi64(cross, 32));
+    }
+
+    __forceinline __m256i Multiply64(__m256i a, __m256i b)
+    {
+        const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+        return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+    }
+
+    // sum of the 64 bits lanes, integers wrap around
+    __forceinline int64_t Reduce(const int64_t* lanes, int length)
+    {
+        uint64_t sum = 0;
+        for (int i = 0; i < length; ++i)
+            sum += (uint64_t)lanes[i];
+        return (int64_t)sum;
+    }
+
+    __forceinline double Reduce(const double* lanes, int length)
+    {
+        double sum = 0;
+        for (int i = 0; i < length; ++i)
+            sum += lanes[i];
+        return sum;
+    }
+
+    // 32 bits indices are widened when the lanes are reduced
+    __forceinline void WidenIndices(int64_t* store, const int32_t* indices, int length)
+    {
+        for (int i = 0; i < length; ++i)
+            store[i] = indices[i];
+    }
+
+    template<> struct Lanes<Sse2, int32_t>
+    {
+        typedef __m128i Vector;
+        typedef __m128i Mask;
+        typedef __m128i Index;
+        typedef __m128i Wide;
+        typedef int64_t Sum;
+        static const int Length = 4;
+
+        static __forceinline Vector Load(const int32_t* a) { return _mm_loadu_si128((const __m128i*)a); }
+        static __forceinline Vector Set(int32_t v) { return _mm_set1_epi32(v); }
+        static __forceinline Mask Equal(Vector a, Vector b) { return _mm_cmpeq_epi32(a, b); }
+        static __forceinline Mask Less(Vector a, Vector b) { return _mm_cmplt_epi32(a, b); }
+        static __forceinline Mask Greater(Vector a, Vector b) { return _mm_cmpgt_epi32(a, b); }
+        static __forceinline Mask Unordered(Vector) { return _mm_setzero_si128(); }
+        static __forceinline Mask Or(Mask a, Mask b) { return _mm_or_si128(a, b); }
+        static __forceinline unsigned Bits(Mask m) { return (unsigned)_mm_movemask_ps(_mm_castsi128_ps(m)); }
+        static __forceinline Vector Select(Mask m, Vector a, Vector b) { return Blend(m, a, b); }
+        static __forceinline Index SelectIndex(Mask m, Index a, Index b) { return Blend(m, a, b); }
+        static __forceinline Index FirstIndex() { return _mm_setr_epi32(0, 1, 2, 3); }
+        static __forceinline Index NextIndex(Index i) { return _mm_add_epi32(i, _mm_set1_epi32(Length)); }
+        static __forceinline void Store(int32_t* store, Vector v) { _mm_storeu_si128((__m128i*)store, v); }
+        static __forceinline void StoreIndex(int64_t* store, Index i) { int32_t indices[Length]; _mm_storeu_si128((__m128i*)indices, i); WidenIndices(store, indices, Length); }
+
+        static __forceinline Wide WideZero() { return _mm_setzero_si128(); }
+        static __forceinline Wide Accumulate(Wide w, Vector v)
+        {
+            const __m128i sign = _mm_cmpgt_epi32(_mm_setzero_si128(), v);
+            return _mm_add_epi64(w, _mm_add_epi64(_mm_unpacklo_epi32(v, sign), _mm_unpackhi_epi32(v, sign)));
+        }
+        static __forceinline Wide MultiplyAdd(Wide w, Vector a, Vector b)
+        {
+            return _mm_add_epi64(w, _mm_add_epi64(MultiplyEven(a, b), MultiplyEven(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32))));
+        }
+        static __forceinline Sum Total(Wide w) { int64_t sums[2]; _mm_storeu_si128((__m128i*)sums, w); return Reduce(sums, 2); }
+    };
+
+    template<> struct Lanes<Sse2, int64_t>
+    {
+        typedef __m128i Vector;
+        typedef __m128i Mask;
+        typedef __m128i Index;
+        typedef __m128i Wide;
+        typedef int64_t Sum;
+        static const int Length = 2;
+
+        static __forceinline Vector Load(const int64_t* a) { return _mm_loadu_si128((const __m128i*)a); }
+        static __forceinline Vector Set(int64_t v) { return _mm_set1_epi64x(v); }
+        static __forceinline Mask Equal(Vector a, Vector b)
+        {
+            const __m128i equal = _mm_cmpeq_epi32(a, b);
+            return _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+        // no 64 bits compare before sse4.2: signed high halves, then unsigned low halves when the high are equal
+        static __forceinline Mask Greater(Vector a, Vector b)
+        {
+            const __m128i flip = _mm_set_epi32(0, (int)0x80000000, 0, (int)0x80000000);
+            const __m128i low = _mm_cmpgt_epi32(_mm_xor_si128(a, flip), _mm_xor_si128(b, flip));
+            const __m128i greater = _mm_or_si128(_mm_cmpgt_epi32(a, b), _mm_and_si128(_mm_cmpeq_epi32(a, b), _mm_slli_epi64(low, 32)));
+            return _mm_shuffle_epi32(greater, _MM_SHUFFLE(3, 3, 1, 1));
+        }
+        static __forceinline Mask Less(Vector a, Vector b) { return Greater(b, a); }
+        static __forceinline Mask Unordered(Vector) { return _mm_setzero_si128(); }
+        static __forceinline Mask Or(Mask a, Mask b) { return _mm_or_si128(a, b); }
+        static __forceinline unsigned Bits(Mask m) { return (unsigned)_mm_movemask_pd(_mm_castsi128_pd(m)); }
+        static __forceinline Vector Select(Mask m, Vector a, Vector b) { return Blend(m, a, b); }
+        static __forceinline Index SelectIndex(Mask m, Index a, Index b) { return Blend(m, a, b); }
+        static __forceinline Index FirstIndex() { return _mm_set_epi64x(1, 0); }
+        static __forceinline Index NextIndex(Index i) { return _mm_add_epi64(i, _mm_set1_epi64x(Length)); }
+        static __forceinline void Store(int64_t* store, Vector v) { _mm_storeu_si128((__m128i*)store, v); }
+        static __forceinline void StoreIndex(int64_t* store, Index i) { _mm_storeu_si128((__m128i*)store, i); }
+
+        static __forceinline Wide WideZero() { return _mm_setzero_si128(); }
+        static __forceinline Wide Accumulate(Wide w, Vector v) { return _mm_add_epi64(w, v); }
+        static __forceinline Wide MultiplyAdd(Wide w, Vector a, Vector b) { return _mm_add_epi64(w, Multiply64(a, b)); }
+        static __forceinline Sum Total(Wide w) { int64_t sums[2]; _mm_storeu_si128((__m128i*)sums, w); return Reduce(sums, 2); }
+    };
+
+    template<> struct Lanes<Sse2, float>
+    {
+        typedef __m128 Vector;
+        typedef __m128 Mask;
+        typedef __m128i Index;
+        typedef __m128d Wide;
+        typedef double Sum;
+        static const int Length = 4;
+
+        static __forceinline Vector Load(const float* a) { return _mm_loadu_ps(a); }
+        static __forceinline Vector Set(float v) { return _mm_set1_ps(v); }
+        static __forceinline Mask Equal(Vector a, Vector b) { return _mm_cmpeq_ps(a, b); }
+        static __forceinline Mask Less(Vector a, Vector b) { return _mm_cmplt_ps(a, b); }
+        static __forceinline Mask Greater(Vector a, Vector b) { return _mm_cmpgt_ps(a, b); }
+        static __forceinline Mask Unordered(Vector v) { return _mm_cmpunord_ps(v, v); }
+        static __forceinline Mask Or(Mask a, Mask b) { return _mm_or_ps(a, b); }
+        static __forceinline unsigned Bits(Mask m) { return (unsigned)_mm_movemask_ps(m); }
+        static __forceinline Vector Select(Mask m, Vector a, Vector b) { return _mm_or_ps(_mm_and_ps(m, b), _mm_andnot_ps(m, a)); }
+        static __forceinline Index SelectIndex(Mask m, Index a, Index b) { return Blend(_mm_castps_si128(m), a, b); }
+        static __forceinline Index FirstIndex() { return _mm_setr_epi32(0, 1, 2, 3); }
+        static __forceinline Index NextIndex(Index i) { return _mm_add_epi32(i, _mm_set1_epi32(Length)); }
+        static __forceinline void Store(float* store, Vector v) { _mm_storeu_ps(store, v); }
+        static __forceinline void StoreIndex(int64_t* store, Index i) { int32_t indices[Length]; _mm_storeu_si128((__m128i*)indices, i); WidenIndices(store, indices, Length); }
+
+        static __forceinline Wide WideZero() { return _mm_setzero_pd(); }
+        static __forceinline Wide Accumulate(Wide w, Vector v) { return _mm_add_pd(w, _mm_add_pd(_mm_cvtps_pd(v), _mm_cvtps_pd(_mm_movehl_ps(v, v)))); }
+        static __forceinline Wide MultiplyAdd(Wide w, Vector a, Vector b)
+        {
+            const __m128d low = _mm_mul_pd(_mm_cvtps_pd(a), _mm_cvtps_pd(b));
+            const __m128d high = _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(a, a)), _mm_cvtps_pd(_mm_movehl_ps(b, b)));
+            return _mm_add_pd(w, _mm_add_pd(low, high));
+        }
+        static __forceinline Sum Total(Wide w) { double sums[2]; _mm_storeu_pd(sums, w); return Reduce(sums, 2); }
+    };
+
+    template<> struct Lanes<Sse2, double>
+    {
+        typedef __m128d Vector;
+        typedef __m128d Mask;
+        typedef __m128i Index;
+        typedef __m128d Wide;
+        typedef double Sum;
+        static const int Length = 2;
+
+        static __forceinline Vector Load(const double* a) { return _mm_loadu_pd(a); }
+        static __forceinline Vector Set(double v) { return _mm_set1_pd(v); }
+        static __forceinline Mask Equal(Vector a, Vector b) { return _mm_cmpeq_pd(a, b); }
+        static __forceinline Mask Less(Vector a, Vector b) { return _mm_cmplt_pd(a, b); }
+        static __forceinline Mask Greater(Vector a, Vector b) { return _mm_cmpgt_pd(a, b); }
+        static __forceinline Mask Unordered(Vector v) { return _mm_cmpunord_pd(v, v); }
+        static __forceinline Mask Or(Mask a, Mask b) { return _mm_or_pd(a, b); }
+        static __forceinline unsigned Bits(Mask m) { return (unsigned)_mm_movemask_pd(m); }
+        static __forceinline Vector Select(Mask m, Vector a, Vector b) { return _mm_or_pd(_mm_and_pd(m, b), _mm_andnot_pd(m, a)); }
+        static __forceinline Index SelectIndex(Mask m, Index a, Index b) { return Blend(_mm_castpd_si128(m), a, b); }
+        static __forceinline Index FirstIndex() { return _mm_set_epi64x(1, 0); }
+        static __forceinline Index NextIndex(Index i) { return _mm_add_epi64(i, _mm_set1_epi64x(Length)); }
+        static __forceinline void Store(double* store, Vector v) { _mm_storeu_pd(store, v); }
+        static __forceinline void StoreIndex(int64_t* store, Index i) { _mm_storeu_si128((__m128i*)store, i); }
+
+        static __forceinline Wide WideZero() { return _mm_setzero_pd(); }
+        static __forceinline Wide Accumulate(Wide w, Vector v) { return _mm_add_pd(w, v); }
+        static __forceinline Wide MultiplyAdd(Wide w, Vector a, Vector b) { return _mm_add_pd(w, _mm_mul_pd(a, b)); }
+        static __forceinline Sum Total(Wide w) { double sums[2]; _mm_storeu_pd(sums, w); return Reduce(sums, 2); }
+    };
+
+    template<> struct Lanes<Avx2, int32_t>
+    {
+        typedef __m256i Vector;
+        typedef __m256i Mask;
+        typedef __m256i Index;
+        typedef __m256i Wide;
+        typedef int64_t Sum;
+        static const int Length = 8;
+
+        static __forceinline Vector Load(const int32_t* a) { return _mm256_loadu_si256((const __m256i*)a); }
+        static __forceinline Vector Set(int32_t v) { return _mm256_set1_epi32(v); }
+        static __forceinline Mask Equal(Vector a, Vector b) { return _mm256_cmpeq_epi32(a, b); }
+        static __forceinline Mask Less(Vector a, Vector b) { return _mm256_cmpgt_epi32(b, a); }
+        static __forceinline Mask Greater(Vector a, Vector b) { return _mm256_cmpgt_epi32(a, b); }
+        static __forceinline Mask Unordered(Vector) { return _mm256_setzero_si256(); }
+        static __forceinline Mask Or(Mask a, Mask b) { return _mm256_or_si256(a, b); }
+        static __forceinline unsigned Bits(Mask m) { return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(m)); }
+        static __forceinline Vector Select(Mask m, Vector a, Vector b) { return _mm256_blendv_epi8(a, b, m); }
+        static __forceinline Index SelectIndex(Mask m, Index a, Index b) { return _mm256_blendv_epi8(a, b, m); }
+        static __forceinline Index FirstIndex() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+        static __forceinline Index NextIndex(Index i) { return _mm256_add_epi32(i, _mm256_set1_epi32(Length)); }
+        static __forceinline void Store(int32_t* store, Vector v) { _mm256_storeu_si256((__m256i*)store, v); }
+        static __forceinline void StoreIndex(int64_t* store, Index i) { int32_t indices[Length]; _mm256_storeu_si256((__m256i*)indices, i); WidenIndices(store, indices, Length); }
+
+        static __forceinline Wide WideZero() { return _mm256_setzero_si256(); }
+        static __forceinline Wide Accumulate(Wide w, Vector v)
+        {
+            return _mm256_add_epi64(w, _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1))));
+        }
+        static __forceinline Wide MultiplyAdd(Wide w, Vector a, Vector b)
+        {
+            const __m256i low = _mm256_mul_epi32(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(a)), _mm256_cvtepi32_epi64(_mm256_castsi256_si128(b)));
+            const __m256i high = _mm256_mul_epi32(_mm256_cvtepi32_epi64(_mm256_extracti128_si256(a, 1)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(b, 1)));
+            return _mm256_add_epi64(w, _mm256_add_epi64(low, high));
+        }
+        static __forceinline Sum Total(Wide w) { int64_t sums[4]; _mm256_storeu_si256((__m256i*)sums, w); return Reduce(sums, 4); }
+    };
+
+    template<> struct Lanes<Avx2, int64_t>
+    {
+        typedef __m256i Vector;
+        typedef __m256i Mask;
+        typedef __m256i Index;
+        typedef __m256i Wide;
+        typedef int64_t Sum;
+        static const int Length = 4;
+
+        static __forceinline Vector Load(const int64_t* a) { return _mm256_loadu_si256((const __m256i*)a); }
+        static __forceinline Vector Set(int64_t v) { return _mm256_set1_epi64x(v); }
+        static __forceinline Mask Equal(Vector a, Vector b) { return _mm256_cmpeq_epi64(a, b); }
+        static __forceinline Mask Less(Vector a, Vector b) { return _mm256_cmpgt_epi64(b, a); }
+        static __forceinline Mask Greater(Vector a, Vector b) { return _mm256_cmpgt_epi64(a, b); }
+        static __forceinline Mask Unordered(Vector) { return _mm256_setzero_si256(); }
+        static __forceinline Mask Or(Mask a, Mask b) { return _mm256_or_si256(a, b); }
+        static __forceinline unsigned Bits(Mask m) { return (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(m)); }
+        static __forceinline Vector Select(Mask m, Vector a, Vector b) { return _mm256_blendv_epi8(a, b, m); }
+        static __forceinline Index SelectIndex(Mask m, Index a, Index b) { return _mm256_blendv_epi8(a, b, m); }
+        static __forceinline Index FirstIndex() { return _mm256_setr_epi64x(0, 1, 2, 3); }
+        static __forceinline Index NextIndex(Index i) { return _mm256_add_epi64(i, _mm256_set1_epi64x(Length)); }
+        static __forceinline void Store(int64_t* store, Vector v) { _mm256_storeu_si256((__m256i*)store, v); }
+        static __forceinline void StoreIndex(int64_t* store, Index i) { _mm256_storeu_si256((__m256i*)store, i); }
+
+        static __forceinline Wide WideZero() { return _mm256_setzero_si256(); }
+        static __forceinline Wide Accumulate(Wide w, Vector v) { return _mm256_add_epi64(w, v); }
+        static __forceinline Wide MultiplyAdd(Wide w, Vector a, Vector b) { return _mm256_add_epi64(w, Multiply64(a, b)); }
+        static __forceinline Sum Total(Wide w) { int64_t sums[4]; _mm256_storeu_si256((__m256i*)sums, w); return Reduce(sums, 4); }
+    };
+
+    template<> struct Lanes<Avx2, float>
+    {
+        typedef __m256 Vector;
+        typedef __m256 Mask;
+        typedef __m256i Index;
+        typedef __m256d Wide;
+        typedef double Sum;
+        static const int Length = 8;
+
+        static __forceinline Vector Load(const float* a) { return _mm256_loadu_ps(a); }
+        static __forceinline Vector Set(float v) { return _mm256_set1_ps(v); }
+        static __forceinline Mask Equal(Vector a, Vector b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+        static __forceinline Mask Less(Vector a, Vector b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static __forceinline Mask Greater(Vector a, Vector b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        static __forceinline Mask Unordered(Vector v) { return _mm256_cmp_ps(v, v, _CMP_UNORD_Q); }
+        static __forceinline Mask Or(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+        static __forceinline unsigned Bits(Mask m) { return (unsigned)_mm256_movemask_ps(m); }
+        static __forceinline Vector Select(Mask m, Vector a, Vector b) { return _mm256_blendv_ps(a, b, m); }
+        static __forceinline Index SelectIndex(Mask m, Index a, Index b) { return _mm256_blendv_epi8(a, b, _mm256_castps_si256(m)); }
+        static __forceinline Index FirstIndex() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+        static __forceinline Index NextIndex(Index i) { return _mm256_add_epi32(i, _mm256_set1_epi32(Length)); }
+        static __forceinline void Store(float* store, Vector v) { _mm256_storeu_ps(store, v); }
+        static __forceinline void StoreIndex(int64_t* store, Index i) { int32_t indices[Length]; _mm256_storeu_si256((__m256i*)indices, i); WidenIndices(store, indices, Length); }
+
+        static __forceinline Wide WideZero() { return _mm256_setzero_pd(); }
+        static __forceinline Wide Accumulate(Wide w, Vector v)
+        {
+            return _mm256_add_pd(w, _mm256_add_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(v)), _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1))));
+        }
+        static __forceinline Wide MultiplyAdd(Wide w, Vector a, Vector b)
+        {
+            const __m256d low = _mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(a)), _mm256_cvtps_pd(_mm256_castps256_ps128(b)));
+            const __m256d high = _mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(a, 1)), _mm256_cvtps_pd(_mm256_extractf128_ps(b, 1)));
+            return _mm256_add_pd(w, _mm256_add_pd(low, high));
+        }
+        static __forceinline Sum Total(Wide w) { double sums[4]; _mm256_storeu_pd(sums, w); return Reduce(sums, 4); }
+    };
+
+    template<> struct Lanes<Avx2, double>
+    {
+        typedef __m256d Vector;
+        typedef __m256d Mask;
+        typedef __m256i Index;
+        typedef __m256d Wide;
+        typedef double Sum;
+        static const int Length = 4;
+
+        static __forceinline Vector Load(const double* a) { return _mm256_loadu_pd(a); }
+        static __forceinline Vector Set(double v) { return _mm256_set1_pd(v); }
+        static __forceinline Mask Equal(Vector a, Vector b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+        static __forceinline Mask Less(Vector a, Vector b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+        static __forceinline Mask Greater(Vector a, Vector b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+        static __forceinline Mask Unordered(Vector v) { return _mm256_cmp_pd(v, v, _CMP_UNORD_Q); }
+        static __forceinline Mask Or(Mask a, Mask b) { return _mm256_or_pd(a, b); }
+        static __forceinline unsigned Bits(Mask m) { return (unsigned)_mm256_movemask_pd(m); }
+        static __forceinline Vector Select(Mask m, Vector a, Vector b) { return _mm256_blendv_pd(a, b, m); }
+        static __forceinline Index SelectIndex(Mask m, Index a, Index b) { return _mm256_blendv_epi8(a, b, _mm256_castpd_si256(m)); }
+        static __forceinline Index FirstIndex() { return _mm256_setr_epi64x(0, 1, 2, 3); }
+        static __forceinline Index NextIndex(Index i) { return _mm256_add_epi64(i, _mm256_set1_epi64x(Length)); }
+        static __forceinline void Store(double* store, Vector v) { _mm256_storeu_pd(store, v); }
+        static __forceinline void StoreIndex(int64_t* store, Index i) { _mm256_storeu_si256((__m256i*)store, i); }
+
+        static __forceinline Wide WideZero() { return _mm256_setzero_pd(); }
+        static __forceinline Wide Accumulate(Wide w, Vector v) { return _mm256_add_pd(w, v); }
+        static __forceinline Wide MultiplyAdd(Wide w, Vector a, Vector b) { return _mm256_add_pd(w, _mm256_mul_pd(a, b)); }
+        static __forceinline Sum Total(Wide w) { double sums[4]; _mm256_storeu_pd(sums, w); return Reduce(sums, 4); }
+    };
+
+#ifdef INTRINSICS_AVX512
+    template<> struct Lanes<Avx512, int32_t>
+    {
+        typedef __m512i Vector;
+        typedef __mmask16 Mask;
+        typedef __m512i Index;
+        typedef __m512i Wide;
+        typedef int64_t Sum;
+        static const int Length = 16;
+
+        static __forceinline Vector Load(const int32_t* a) { return _mm512_loadu_si512(a); }
+        static __forceinline Vector Set(int32_t v) { return _mm512_set1_epi32(v); }
+        static __forceinline Mask Equal(Vector a, Vector b) { return _mm512_cmpeq_epi32_mask(a, b); }
+        static __forceinline Mask Less(Vector a, Vector b) { return _mm512_cmplt_epi32_mask(a, b); }
+        static __forceinline Mask Greater(Vector a, Vector b) { return _mm512_cmpgt_epi32_mask(a, b); }
+        static __forceinline Mask Unordered(Vector) { return 0; }
+        static __forceinline Mask Or(Mask a, Mask b) { return (Mask)(a | b); }
+        static __forceinline unsigned Bits(Mask m) { return (unsigned)m; }
+        static __forceinline Vector Select(Mask m, Vector a, Vector b) { return _mm512_mask_blend_epi32(m, a, b); }
+        static __forceinline Index SelectIndex(Mask m, Index a, Index b) { return _mm512_mask_blend_epi32(m, a, b); }
+        static __forceinline Index FirstIndex() { return _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0); }
+        static __forceinline Index NextIndex(Index i) { return _mm512_add_epi32(i, _mm512_set1_epi32(Length)); }
+        static __forceinline void Store(int32_t* store, Vector v) { _mm512_storeu_si512(store, v); }
+        static __forceinline void StoreIndex(int64_t* store, Index i) { int32_t indices[Length]; _mm512_storeu_si512(indices, i); WidenIndices(store, indices, Length); }
+
+        static __forceinline Wide WideZero() { return _mm512_setzero_si512(); }
+        static __forceinline Wide Accumulate(Wide w, Vector v)
+        {
+            return _mm512_add_epi64(w, _mm512_add_epi64(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(v)), _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1))));
+        }
+        static __forceinline Wide MultiplyAdd(Wide w, Vector a, Vector b)
+        {
+            const __m512i low = _mm512_mul_epi32(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(a)), _mm512_cvtepi32_epi64(_mm512_castsi512_si256(b)));
+            const __m512i high = _mm512_mul_epi32(_mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(a, 1)), _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(b, 1)));
+            return _mm512_add_epi64(w, _mm512_add_epi64(low, high));
+        }
+        static __forceinline Sum Total(Wide w)
+        {
+            int64_t sums[8];
+            _mm512_storeu_si512(sums, w);
+            return Reduce(sums, 8);
+        }
+    };
+
+    template<> struct Lanes<Avx512, int64_t>
+    {
+        typedef __m512i Vector;
+        typedef __mmask8 Mask;
+        typedef __m512i Index;
+        typedef __m512i Wide;
+        typedef int64_t Sum;
+        static const int Length = 8;
+
+        static __forceinline Vector Load(const int64_t* a) { return _mm512_loadu_si512(a); }
+        static __forceinline Vector Set(int64_t v) { return _mm512_set1_epi64(v); }
+        static __forceinline Mask Equal(Vector a, Vector b) { return _mm512_cmpeq_epi64_mask(a, b); }
+        static __forceinline Mask Less(Vector a, Vector b) { return _mm512_cmplt_epi64_mask(a, b); }
+        static __forceinline Mask Greater(Vector a, Vector b) { return _mm512_cmpgt_epi64_mask(a, b); }
+        static __forceinline Mask Unordered(Vector) { return 0; }
+        static __forceinline Mask Or(Mask a, Mask b) { return (Mask)(a | b); }
+        static __forceinline unsigned Bits(Mask m) { return (unsigned)m; }
+        static __forceinline Vector Select(Mask m, Vector a, Vector b) { return _mm512_mask_blend_epi64(m, a, b); }
+        static __forceinline Index SelectIndex(Mask m, Index a, Index b) { return _mm512_mask_blend_epi64(m, a, b); }
+        static __forceinline Index FirstIndex() { return _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0); }
+        static __forceinline Index NextIndex(Index i) { return _mm512_add_epi64(i, _mm512_set1_epi64(Length)); }
+        static __forceinline void Store(int64_t* store, Vector v) { _mm512_storeu_si512(store, v); }
+        static __forceinline void StoreIndex(int64_t* store, Index i) { _mm512_storeu_si512(store, i); }
+
+        static __forceinline Wide WideZero() { return _mm512_setzero_si512(); }
+        static __forceinline Wide Accumulate(Wide w, Vector v) { return _mm512_add_epi64(w, v); }
+        static __forceinline Wide MultiplyAdd(Wide w, Vector a, Vector b)
+        {
+            const __m512i cross = _mm512_add_epi64(_mm512_mul_epu32(_mm512_srli_epi64(a, 32), b), _mm512_mul_epu32(a, _mm512_srli_epi64(b, 32)));
+            return _mm512_add_epi64(w, _mm512_add_epi64(_mm512_mul_epu32(a, b), _mm512_slli_epi64(cross, 32)));
+        }
+        static __forceinline Sum Total(Wide w)
+        {
+            int64_t sums[8];
+            _mm512_storeu_si512(sums, w);
+            return Reduce(sums, 8);
+        }
+    };
+
+    template<> struct Lanes<Avx512, float>
+    {
+        typedef __m512 Vector;
+        typedef __mmask16 Mask;
+        typedef __m512i Index;
+        typedef __m512d Wide;
+        typedef double Sum;
+        static const int Length = 16;
+
+        static __forceinline __m256 High(Vector v) { return _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1)); }
+
+        static __forceinline Vector Load(const float* a) { return _mm512_loadu_ps(a); }
+        static __forceinline Vector Set(float v) { return _mm512_set1_ps(v); }
+        static __forceinline Mask Equal(Vector a, Vector b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+        static __forceinline Mask Less(Vector a, Vector b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+        static __forceinline Mask Greater(Vector a, Vector b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+        static __forceinline Mask Unordered(Vector v) { return _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q); }
+        static __forceinline Mask Or(Mask a, Mask b) { return (Mask)(a | b); }
+        static __forceinline unsigned Bits(Mask m) { return (unsigned)m; }
+        static __forceinline Vector Select(Mask m, Vector a, Vector b) { return _mm512_mask_blend_ps(m, a, b); }
+        static __forceinline Index SelectIndex(Mask m, Index a, Index b) { return _mm512_mask_blend_epi32(m, a, b); }
+        static __forceinline Index FirstIndex() { return _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0); }
+        static __forceinline Index NextIndex(Index i) { return _mm512_add_epi32(i, _mm512_set1_epi32(Length)); }
+        static __forceinline void Store(float* store, Vector v) { _mm512_storeu_ps(store, v); }
+        static __forceinline void StoreIndex(int64_t* store, Index i) { int32_t indices[Length]; _mm512_storeu_si512(indices, i); WidenIndices(store, indices, Length); }
+
+        static __forceinline Wide WideZero() { return _mm512_setzero_pd(); }
+        static __forceinline Wide Accumulate(Wide w, Vector v)
+        {
+            return _mm512_add_pd(w, _mm512_add_pd(_mm512_cvtps_pd(_mm512_castps512_ps256(v)), _mm512_cvtps_pd(High(v))));
+        }
+        static __forceinline Wide MultiplyAdd(Wide w, Vector a, Vector b)
+        {
+            const __m512d low = _mm512_mul_pd(_mm512_cvtps_pd(_mm512_castps512_ps256(a)), _mm512_cvtps_pd(_mm512_castps512_ps256(b)));
+            const __m512d high = _mm512_mul_pd(_mm512_cvtps_pd(High(a)), _mm512_cvtps_pd(High(b)));
+            return _mm512_add_pd(w, _mm512_add_pd(low, high));
+        }
+        static __forceinline Sum Total(Wide w)
+        {
+            double sums[8];
+            _mm512_storeu_pd(sums, w);
+            return Reduce(sums, 8);
+        }
+    };
+
+    template<> struct Lanes<Avx512, double>
+    {
+        typedef __m512d Vector;
+        typedef __mmask8 Mask;
+        typedef __m512i Index;
+        typedef __m512d Wide;
+        typedef double Sum;
+        static const int Length = 8;
+
+        static __forceinline Vector Load(const double* a) { return _mm512_loadu_pd(a); }
+        static __forceinline Vector Set(double v) { return _mm512_set1_pd(v); }
+        static __forceinline Mask Equal(Vector a, Vector b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+        static __forceinline Mask Less(Vector a, Vector b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+        static __forceinline Mask Greater(Vector a, Vector b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+        static __forceinline Mask Unordered(Vector v) { return _mm512_cmp_pd_mask(v, v, _CMP_UNORD_Q); }
+        static __forceinline Mask Or(Mask a, Mask b) { return (Mask)(a | b); }
+        static __forceinline unsigned Bits(Mask m) { return (unsigned)m; }
+        static __forceinline Vector Select(Mask m, Vector a, Vector b) { return _mm512_mask_blend_pd(m, a, b); }
+        static __forceinline Index SelectIndex(Mask m, Index a, Index b) { return _mm512_mask_blend_epi64(m, a, b); }
+        static __forceinline Index FirstIndex() { return _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0); }
+        static __forceinline Index NextIndex(Index i) { return _mm512_add_epi64(i, _mm512_set1_epi64(Length)); }
+        static __forceinline void Store(double* store, Vector v) { _mm512_storeu_pd(store, v); }
+        static __forceinline void StoreIndex(int64_t* store, Index i) { _mm512_storeu_si512(store, i); }
+
+        static __forceinline Wide WideZero() { return _mm512_setzero_pd(); }
+        static __forceinline Wide Accumulate(Wide w, Vector v) { return _mm512_add_pd(w, v); }
+        static __forceinline Wide MultiplyAdd(Wide w, Vector a, Vector b) { return _mm512_add_pd(w, _mm512_mul_pd(a, b)); }
+        static __forceinline Sum Total(Wide w)
+        {
+            double sums[8];
+            _mm512_storeu_pd(sums, w);
+            return Reduce(sums, 8);
+        }
+    };
+#endif
+
+    // scalar accumulators: 64 bits lanes like the vectors, integers wrap around in unsigned arithmetic
+    template<typename T> struct Scalar { typedef uint64_t Accumulator; typedef int64_t Sum; };
+    template<> struct Scalar<float> { typedef double Accumulator; typedef double Sum; };
+    template<> struct Scalar<double> { typedef double Accumulator; typedef double Sum; };
+
+    template<typename T>
+    __forceinline typename Scalar<T>::Accumulator Widen(T v)
+    {
+        return (typename Scalar<T>::Accumulator)(typename Scalar<T>::Sum)v;
+    }
+
+    __forceinline int64_t BitCount(unsigned bits)
+    {
+        bits = bits - ((bits >> 1) & 0x55555555);
+        bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+        return (int64_t)((((bits + (bits >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24);
+    }
+
+    __forceinline int64_t FirstBit(unsigned bits)
+    {
+        unsigned long first;
+        _BitScanForward(&first, bits);
+        return first;
+    }
+
+    __forceinline int64_t LastBit(unsigned bits)
+    {
+        unsigned long last;
+        _BitScanReverse(&last, bits);
+        return last;
+    }
+
+    template<typename T>
+    typename Scalar<T>::Sum SumCpp(const T* a, int64_t count)
+    {
+        typename Scalar<T>::Accumulator sum = 0;
+        for (int64_t i = 0; i < count; ++i)
+            sum += Widen(a[i]);
+        return (typename Scalar<T>::Sum)sum;
+    }
+
+    template<typename T>
+    typename Scalar<T>::Sum DotCpp(const T* a, const T* b, int64_t count)
+    {
+        typename Scalar<T>::Accumulator sum = 0;
+        for (int64_t i = 0; i < count; ++i)
+            sum += Widen(a[i]) * Widen(b[i]);
+        return (typename Scalar<T>::Sum)sum;
+    }
+
+    // 4 accumulators hide the add latency
+    template<class L, typename T>
+    typename L::Sum Sum(const T* a, int64_t count)
+    {
+        typename L::Wide w0 = L::WideZero(), w1 = L::WideZero(), w2 = L::WideZero(), w3 = L::WideZero();
+        int64_t i = 0;
+        for (; count - i >= 4 * L::Length; i += 4 * L::Length)
+        {
+            w0 = L::Accumulate(w0, L::Load(a + i));
+            w1 = L::Accumulate(w1, L::Load(a + i + L::Length));
+            w2 = L::Accumulate(w2, L::Load(a + i + 2 * L::Length));
+            w3 = L::Accumulate(w3, L::Load(a + i + 3 * L::Length));
+        }
+        for (; count - i >= L::Length; i += L::Length)
+            w0 = L::Accumulate(w0, L::Load(a + i));
+        typename Scalar<T>::Accumulator sum = (typename Scalar<T>::Accumulator)L::Total(w0) + L::Total(w1) + L::Total(w2) + L::Total(w3);
+        for (; i < count; ++i)
+            sum += Widen(a[i]);
+        return (typename L::Sum)sum;
+    }
+
+    template<class L, typename T>
+    typename L::Sum Dot(const T* a, const T* b, int64_t count)
+    {
+        typename L::Wide w0 = L::WideZero(), w1 = L::WideZero(), w2 = L::WideZero(), w3 = L::WideZero();
+        int64_t i = 0;
+        for (; count - i >= 4 * L::Length; i += 4 * L::Length)
+        {
+            w0 = L::MultiplyAdd(w0, L::Load(a + i), L::Load(b + i));
+            w1 = L::MultiplyAdd(w1, L::Load(a + i + L::Length), L::Load(b + i + L::Length));
+            w2 = L::MultiplyAdd(w2, L::Load(a + i + 2 * L::Length), L::Load(b + i + 2 * L::Length));
+            w3 = L::MultiplyAdd(w3, L::Load(a + i + 3 * L::Length), L::Load(b + i + 3 * L::Length));
+        }
+        for (; count - i >= L::Length; i += L::Length)
+            w0 = L::MultiplyAdd(w0, L::Load(a + i), L::Load(b + i));
+        typename Scalar<T>::Accumulator sum = (typename Scalar<T>::Accumulator)L::Total(w0) + L::Total(w1) + L::Total(w2) + L::Total(w3);
+        for (; i < count; ++i)
+            sum += Widen(a[i]) * Widen(b[i]);
+        return (typename L::Sum)sum;
+    }
+
+    template<typename T>
+    int64_t IndexOfCpp(const T* a, int64_t count, T value)
+    {
+        for (int64_t i = 0; i < count; ++i)
+        {
+            if (a[i] == value)
+                return i;
+        }
+        return -1;
+    }
+
+    // 4 vectors per iteration, the masks are merged to test them once
+    template<class L, typename T>
+    int64_t IndexOf(const T* a, int64_t count, T value)
+    {
+        const typename L::Vector v = L::Set(value);
+        int64_t i = 0;
+        for (; count - i >= 4 * L::Length; i += 4 * L::Length)
+        {
+            const typename L::Mask m0 = L::Equal(L::Load(a + i), v);
+            const typename L::Mask m1 = L::Equal(L::Load(a + i + L::Length), v);
+            const typename L::Mask m2 = L::Equal(L::Load(a + i + 2 * L::Length), v);
+            const typename L::Mask m3 = L::Equal(L::Load(a + i + 3 * L::Length), v);
+            if (L::Bits(L::Or(L::Or(m0, m1), L::Or(m2, m3))))
+            {
+                unsigned bits;
+                if ((bits = L::Bits(m0)) != 0)
+                    return i + FirstBit(bits);
+                if ((bits = L::Bits(m1)) != 0)
+                    return i + L::Length + FirstBit(bits);
+                if ((bits = L::Bits(m2)) != 0)
+                    return i + 2 * L::Length + FirstBit(bits);
+                return i + 3 * L::Length + FirstBit(L::Bits(m3));
+            }
+        }
+        for (; count - i >= L::Length; i += L::Length)
+        {
+            const unsigned bits = L::Bits(L::Equal(L::Load(a + i), v));
+            if (bits)
+                return i + FirstBit(bits);
+        }
+        const int64_t tail = IndexOfCpp(a + i, count - i, value);
+        return tail < 0 ? -1 : i + tail;
+    }
+
+    template<typename T>
+    int64_t LastIndexOfCpp(const T* a, int64_t count, T value)
+    {
+        for (int64_t i = count - 1; i >= 0; --i)
+        {
+            if (a[i] == value)
+                return i;
+        }
+        return -1;
+    }
+
+    template<class L, typename T>
+    int64_t LastIndexOf(const T* a, int64_t count, T value)
+    {
+        const typename L::Vector v = L::Set(value);
+        int64_t end = count;
+        for (; end >= 4 * L::Length; end -= 4 * L::Length)
+        {
+            const T* block = a + end - 4 * L::Length;
+            const typename L::Mask m0 = L::Equal(L::Load(block), v);
+            const typename L::Mask m1 = L::Equal(L::Load(block + L::Length), v);
+            const typename L::Mask m2 = L::Equal(L::Load(block + 2 * L::Length), v);
+            const typename L::Mask m3 = L::Equal(L::Load(block + 3 * L::Length), v);
+            if (L::Bits(L::Or(L::Or(m0, m1), L::Or(m2, m3))))
+            {
+                const int64_t first = end - 4 * L::Length;
+                unsigned bits;
+                if ((bits = L::Bits(m3)) != 0)
+                    return first + 3 * L::Length + LastBit(bits);
+                if ((bits = L::Bits(m2)) != 0)
+                    return first + 2 * L::Length + LastBit(bits);
+                if ((bits = L::Bits(m1)) != 0)
+                    return first + L::Length + LastBit(bits);
+                return first + LastBit(L::Bits(m0));
+            }
+        }
+        for (; end >= L::Length; end -= L::Length)
+        {
+            const unsigned bits = L::Bits(L::Equal(L::Load(a + end - L::Length), v));
+            if (bits)
+                return end - L::Length + LastBit(bits);
+        }
+        return LastIndexOfCpp(a, end, value);
+    }
+
+    template<typename T>
+    int64_t CountEqualCpp(const T* a, int64_t count, T value)
+    {
+        int64_t found = 0;
+        for (int64_t i = 0; i < count; ++i)
+            found += a[i] == value;
+        return found;
+    }
+
+    template<class L, typename T>
+    int64_t CountEqual(const T* a, int64_t count, T value)
+    {
+        const typename L::Vector v = L::Set(value);
+        int64_t found = 0;
+        int64_t i = 0;
+        for (; count - i >= 2 * L::Length; i += 2 * L::Length)
+            found += BitCount(L::Bits(L::Equal(L::Load(a + i), v))) + BitCount(L::Bits(L::Equal(L::Load(a + i + L::Length), v)));
+        for (; count - i >= L::Length; i += L::Length)
+            found += BitCount(L::Bits(L::Equal(L::Load(a + i), v)));
+        return found + CountEqualCpp(a + i, count - i, value);
+    }
+
+    // extrema of a[begin, count[ carried on from the best index so far (-1 for none), a NaN is returned
+    // as soon as it is found
+    template<bool FindMin, bool FindMax, typename T>
+    void ExtremaCpp(const T* a, int64_t begin, int64_t count, int64_t& min, int64_t& max)
+    {
+        for (int64_t i = begin; i < count; ++i)
+        {
+            const T v = a[i];
+            if (v != v)
+            {
+                min = max = i;
+                return;
+            }
+            if (FindMin && (min < 0 || v < a[min]))
+                min = i;
+            if (FindMax && (max < 0 || v > a[max]))
+                max = i;
+        }
+    }
+
+    // running extrema of the lanes of even and odd vectors, 2 chains of compare and blend. Index keep the
+    // lanes first index of their extremum
+    template<class L, bool Largest>
+    struct Running
+    {
+        typename L::Vector values[2];
+        typename L::Index indices[2];
+
+        __forceinline void Start(typename L::Vector v0, typename L::Vector v1, typename L::Index i0, typename L::Index i1)
+        {
+            values[0] = v0;
+            values[1] = v1;
+            indices[0] = i0;
+            indices[1] = i1;
+        }
+
+        __forceinline void Update(int set, typename L::Vector v, typename L::Index index)
+        {
+            const typename L::Mask better = Largest ? L::Greater(v, values[set]) : L::Less(v, values[set]);
+            values[set] = L::Select(better, values[set], v);
+            indices[set] = L::SelectIndex(better, indices[set], index);
+        }
+
+        // the lanes ties go to the smallest index
+        template<typename T>
+        __forceinline int64_t Reduce() const
+        {
+            T lanes[2 * L::Length];
+            int64_t lanesIndex[2 * L::Length];
+            L::Store(lanes, values[0]);
+            L::Store(lanes + L::Length, values[1]);
+            L::StoreIndex(lanesIndex, indices[0]);
+            L::StoreIndex(lanesIndex + L::Length, indices[1]);
+            int best = 0;
+            for (int lane = 1; lane < 2 * L::Length; ++lane)
+            {
+                const bool better = Largest ? lanes[lane] > lanes[best] : lanes[lane] < lanes[best];
+                if (better || (lanes[lane] == lanes[best] && lanesIndex[lane] < lanesIndex[best]))
+                    best = lane;
+            }
+            return lanesIndex[best];
+        }
+    };
+
+    // NaN lanes are only flagged, the first NaN index is searched again at the end
+    template<class L, bool FindMin, bool FindMax, typename T>
+    void Extrema(const T* a, int64_t count, int64_t& min, int64_t& max)
+    {
+        min = max = -1;
+        int64_t i = 0;
+        if (count >= 4 * L::Length)
+        {
+            Running<L, false> low;
+            Running<L, true> high;
+            typename L::Vector v0 = L::Load(a);
+            typename L::Vector v1 = L::Load(a + L::Length);
+            typename L::Index index0 = L::FirstIndex();
+            typename L::Index index1 = L::NextIndex(index0);
+            low.Start(v0, v1, index0, index1);
+            high.Start(v0, v1, index0, index1);
+            typename L::Mask unordered = L::Or(L::Unordered(v0), L::Unordered(v1));
+            for (i = 2 * L::Length; count - i >= 2 * L::Length; i += 2 * L::Length)
+            {
+                v0 = L::Load(a + i);
+                v1 = L::Load(a + i + L::Length);
+                index0 = L::NextIndex(index1);
+                index1 = L::NextIndex(index0);
+                unordered = L::Or(unordered, L::Or(L::Unordered(v0), L::Unordered(v1)));
+                if (FindMin)
+                {
+                    low.Update(0, v0, index0);
+                    low.Update(1, v1, index1);
+                }
+                if (FindMax)
+                {
+                    high.Update(0, v0, index0);
+                    high.Update(1, v1, index1);
+                }
+            }
+
+            if (L::Bits(unordered))
+            {
+                ExtremaCpp<false, false>(a, 0, count, min, max);
+                return;
+            }
+            if (FindMin)
+                min = low.template Reduce<T>();
+            if (FindMax)
+                max = high.template Reduce<T>();
+        }
+        ExtremaCpp<FindMin, FindMax>(a, i, count, min, max);
+    }
+
+    // 32 bits index lanes, the arrays are split in blocks they can count
+    static const int64_t ExtremaBlock = 1ll << 30;
+
+    template<class L, typename T>
+    void MinMax(const T* a, int64_t count, int64_t* minIndex, int64_t* maxIndex)
+    {
+        int64_t min = -1;
+        int64_t max = -1;
+        for (int64_t begin = 0; begin < count; begin += ExtremaBlock)
+        {
+            const int64_t length = count - begin < ExtremaBlock ? count - begin : ExtremaBlock;
+            int64_t blockMin, blockMax;
+            if (!maxIndex)
+                Extrema<L, true, false>(a + begin, length, blockMin, blockMax);
+            else if (!minIndex)
+                Extrema<L, false, true>(a + begin, length, blockMin, blockMax);
+            else
+                Extrema<L, true, true>(a + begin, length, blockMin, blockMax);
+
+            const T* block = a + begin;
+            const int64_t any = blockMin >= 0 ? blockMin : blockMax;
+            if (block[any] != block[any])
+            {
+                min = max = begin + any;
+                break;
+            }
+            if (blockMin >= 0 && (min < 0 || block[blockMin] < a[min]))
+                min = begin + blockMin;
+            if (blockMax >= 0 && (max < 0 || block[blockMax] > a[max]))
+                max = begin + blockMax;
+        }
+        if (minIndex)
+            *minIndex = min;
+        if (maxIndex)
+            *maxIndex = max;
+    }
+
+    template<typename T>
+    void MinMaxCpp(const T* a, int64_t count, int64_t* minIndex, int64_t* maxIndex)
+    {
+        int64_t min = -1;
+        int64_t max = -1;
+        ExtremaCpp<true, true>(a, 0, count, min, max);
+        if (minIndex)
+            *minIndex = min;
+        if (maxIndex)
+            *maxIndex = max;
+    }
+}
+
+ArrayTier ArrayBestTier()
+{
+#ifdef INTRINSICS_AVX512
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX512F))
+        return ArrayAvx512;
+#endif
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return ArrayAvx2;
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return ArraySse2;
+    return ArrayCpp;
+}
+
+#ifdef INTRINSICS_AVX512
+#define ARRAY_CASE_AVX512(T, kernel, args) case ArrayAvx512: return kernel<Lanes<Avx512, T> > args;
+#else
+#define ARRAY_CASE_AVX512(T, kernel, args) case ArrayAvx512:
+#endif
+
+// kernel instantiated for the lanes of the tier, the scalar kernelCpp otherwise
+#define ARRAY_DISPATCH(T, kernel, args) \
+    switch (tier) \
+    { \
+    ARRAY_CASE_AVX512(T, kernel, args) \
+    case ArrayAvx2: return kernel<Lanes<Avx2, T> > args; \
+    case ArraySse2: return kernel<Lanes<Sse2, T> > args; \
+    default: return kernel##Cpp args; \
+    }
+
+int64_t ArraySum(ArrayTier tier, const int32_t* a, int64_t count)
+{
+    ARRAY_DISPATCH(int32_t, Sum, (a, count))
+}
+
+int64_t ArraySum(ArrayTier tier, const int64_t* a, int64_t count)
+{
+    ARRAY_DISPATCH(int64_t, Sum, (a, count))
+}
+
+double ArraySum(ArrayTier tier, const float* a, int64_t count)
+{
+    ARRAY_DISPATCH(float, Sum, (a, count))
+}
+
+double ArraySum(ArrayTier tier, const double* a, int64_t count)
+{
+    ARRAY_DISPATCH(double, Sum, (a, count))
+}
+
+void ArrayMinMax(ArrayTier tier, const int32_t* a, int64_t count, int64_t* minIndex, int64_t* maxIndex)
+{
+    ARRAY_DISPATCH(int32_t, MinMax, (a, count, minIndex, maxIndex))
+}
+
+void ArrayMinMax(ArrayTier tier, const int64_t* a, int64_t count, int64_t* minIndex, int64_t* maxIndex)
+{
+    // the 64 bits compares emulated with sse2 are slower than the scalar loop
+    if (tier == ArraySse2)
+        tier = ArrayCpp;
+    ARRAY_DISPATCH(int64_t, MinMax, (a, count, minIndex, maxIndex))
+}
+
+void ArrayMinMax(ArrayTier tier, const float* a, int64_t count, int64_t* minIndex, int64_t* maxIndex)
+{
+    ARRAY_DISPATCH(float, MinMax, (a, count, minIndex, maxIndex))
+}
+
+void ArrayMinMax(ArrayTier tier, const double* a, int64_t count, int64_t* minIndex, int64_t* maxIndex)
+{
+    ARRAY_DISPATCH(double, MinMax, (a, count, minIndex, maxIndex))
+}
+
+int64_t ArrayIndexOf(ArrayTier tier, const int32_t* a, int64_t count, int32_t value)
+{
+    ARRAY_DISPATCH(int32_t, IndexOf, (a, count, value))
+}
+
+int64_t ArrayIndexOf(ArrayTier tier, const int64_t* a, int64_t count, int64_t value)
+{
+    ARRAY_DISPATCH(int64_t, IndexOf, (a, count, value))
+}
+
+int64_t ArrayIndexOf(ArrayTier tier, const float* a, int64_t count, float value)
+{
+    ARRAY_DISPATCH(float, IndexOf, (a, count, value))
+}
+
+int64_t ArrayIndexOf(ArrayTier tier, const double* a, int64_t count, double value)
+{
+    ARRAY_DISPATCH(double, IndexOf, (a, count, value))
+}
+
+int64_t ArrayLastIndexOf(ArrayTier tier, const int32_t* a, int64_t count, int32_t value)
+{
+    ARRAY_DISPATCH(int32_t, LastIndexOf, (a, count, value))
+}
+
+int64_t ArrayLastIndexOf(ArrayTier tier, const int64_t* a, int64_t count, int64_t value)
+{
+    ARRAY_DISPATCH(int64_t, LastIndexOf, (a, count, value))
+}
+
+int64_t ArrayLastIndexOf(ArrayTier tier, const float* a, int64_t count, float value)
+{
+    ARRAY_DISPATCH(float, LastIndexOf, (a, count, value))
+}
+
+int64_t ArrayLastIndexOf(ArrayTier tier, const double* a, int64_t count, double value)
+{
+    ARRAY_DISPATCH(double, LastIndexOf, (a, count, value))
+}
+
+int64_t ArrayCountEqual(ArrayTier tier, const int32_t* a, int64_t count, int32_t value)
+{
+    ARRAY_DISPATCH(int32_t, CountEqual, (a, count, value))
+}
+
+int64_t ArrayCountEqual(ArrayTier tier, const int64_t* a, int64_t count, int64_t value)
+{
+    ARRAY_DISPATCH(int64_t, CountEqual, (a, count, value))
+}
+
+int64_t ArrayCountEqual(ArrayTier tier, const float* a, int64_t count, float value)
+{
+    ARRAY_DISPATCH(float, CountEqual, (a, count, value))
+}
+
+int64_t ArrayCountEqual(ArrayTier tier, const double* a, int64_t count, double value)
+{
+    ARRAY_DISPATCH(double, CountEqual, (a, count, value))
+}
+
+int64_t ArrayDot(ArrayTier tier, const int32_t* a, const int32_t* b, int64_t count)
+{
+    ARRAY_DISPATCH(int32_t, Dot, (a, b, count))
+}
+
+int64_t ArrayDot(ArrayTier tier, const int64_t* a, const int64_t* b, int64_t count)
+{
+    ARRAY_DISPATCH(int64_t, Dot, (a, b, count))
+}
+
+double ArrayDot(ArrayTier tier, const float* a, const float* b, int64_t count)
+{
+    ARRAY_DISPATCH(float, Dot, (a, b, count))
+}
+
+double ArrayDot(ArrayTier tier, const double* a, const double* b, int64_t count)
+{
+    ARRAY_DISPATCH(double, Dot, (a, b, count))
+}
@@ -0,0 +1,76 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// unmanaged reductions and searches over primitive arrays, compiled without /clr like StringKernels
+//
+// every kernel is a template over the vector lanes of one element type, the tier argument picks the
+// instruction set: ArrayBestTier() for the cpu, the others to compare them. values are compared with
+// == and <, a NaN is never found or counted. counts are elements.
+
+#include <stdint.h>
+
+enum ArrayTier
+{
+    ArrayCpp,
+    ArraySse2,
+    ArrayAvx2,
+    ArrayAvx512     // avx-512 F, runs the ArrayAvx2 kernels when the compiler has no avx-512 intrinsics
+};
+
+ArrayTier ArrayBestTier();
+
+// int32 and float are summed in 64 bits lanes (int64 / double), int64 wraps around. vector sums add in
+// lanes order, floating point results can differ from a sequential sum in the last bits
+int64_t ArraySum(ArrayTier tier, const int32_t* a, int64_t count);
+int64_t ArraySum(ArrayTier tier, const int64_t* a, int64_t count);
+double ArraySum(ArrayTier tier, const float* a, int64_t count);
+double ArraySum(ArrayTier tier, const double* a, int64_t count);
+
+// index of the first smallest and the first largest element, -1 when count is 0. minIndex or maxIndex
+// can be null to skip one. like Math::Min and Math::Max a NaN wins, both are the first NaN index then
+void ArrayMinMax(ArrayTier tier, const int32_t* a, int64_t count, int64_t* minIndex, int64_t* maxIndex);
+void ArrayMinMax(ArrayTier tier, const int64_t* a, int64_t count, int64_t* minIndex, int64_t* maxIndex);
+void ArrayMinMax(ArrayTier tier, const float* a, int64_t count, int64_t* minIndex, int64_t* maxIndex);
+void ArrayMinMax(ArrayTier tier, const double* a, int64_t count, int64_t* minIndex, int64_t* maxIndex);
+
+// -1 when not found
+int64_t ArrayIndexOf(ArrayTier tier, const int32_t* a, int64_t count, int32_t value);
+int64_t ArrayIndexOf(ArrayTier tier, const int64_t* a, int64_t count, int64_t value);
+int64_t ArrayIndexOf(ArrayTier tier, const float* a, int64_t count, float value);
+int64_t ArrayIndexOf(ArrayTier tier, const double* a, int64_t count, double value);
+
+int64_t ArrayLastIndexOf(ArrayTier tier, const int32_t* a, int64_t count, int32_t value);
+int64_t ArrayLastIndexOf(ArrayTier tier, const int64_t* a, int64_t count, int64_t value);
+int64_t ArrayLastIndexOf(ArrayTier tier, const float* a, int64_t count, float value);
+int64_t ArrayLastIndexOf(ArrayTier tier, const double* a, int64_t count, double value);
+
+int64_t ArrayCountEqual(ArrayTier tier, const int32_t* a, int64_t count, int32_t value);
+int64_t ArrayCountEqual(ArrayTier tier, const int64_t* a, int64_t count, int64_t value);
+int64_t ArrayCountEqual(ArrayTier tier, const float* a, int64_t count, float value);
+int64_t ArrayCountEqual(ArrayTier tier, const double* a, int64_t count, double value);
+
+// sum of a[i] * b[i], accumulated like ArraySum
+int64_t ArrayDot(ArrayTier tier, const int32_t* a, const int32_t* b, int64_t count);
+int64_t ArrayDot(ArrayTier tier, const int64_t* a, const int64_t* b, int64_t count);
+double ArrayDot(ArrayTier tier, const float* a, const float* b, int64_t count);
+double ArrayDot(ArrayTier tier, const double* a, const double* b, int64_t count);
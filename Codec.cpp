@@ -0,0 +1,262 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "Codec.h"
+
+#include <vcclr.h>          // cli/c++ pinning
+#include "CodecKernels.h"   // unmanaged kernels
+
+#pragma managed
+
+namespace Intrinsics
+{
+    static bool __clrcall UrlSafe(Base64::Variant variant)
+    {
+        return variant == Base64::Variant::UrlSafe || variant == Base64::Variant::UrlSafeNoPadding;
+    }
+
+    static bool __clrcall Padding(Base64::Variant variant)
+    {
+        return variant == Base64::Variant::Standard || variant == Base64::Variant::UrlSafe;
+    }
+
+    static void __clrcall CheckVariant(Base64::Variant variant)
+    {
+        if (variant < Base64::Variant::Standard || variant > Base64::Variant::UrlSafeNoPadding)
+            throw gcnew ArgumentOutOfRangeException(L"variant");
+    }
+
+    static void __clrcall CheckSlice(System::Array ^ items, int index, int count, System::String ^ name)
+    {
+        if (items == nullptr)
+            throw gcnew ArgumentNullException(name + " is null");
+
+        if (index < 0 || index > items->Length)
+            throw gcnew ArgumentOutOfRangeException(L"index must be greater than 0 and smaller than " + name + " length");
+
+        if (count < 0 || count > items->Length - index)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than " + name + " - index");
+    }
+
+    static void __clrcall CheckOutput(System::Array ^ items, int index, int length, System::String ^ name, System::String ^ indexName)
+    {
+        if (items == nullptr)
+            throw gcnew ArgumentNullException(name + " is null");
+
+        if (index < 0 || index > items->Length)
+            throw gcnew ArgumentOutOfRangeException(indexName + " must be greater than 0 and smaller than " + name + " length");
+
+        if (length > items->Length - index)
+            throw gcnew ArgumentException(name + " is too small");
+    }
+
+    static FormatException ^ __clrcall InvalidChar(int error)
+    {
+        return gcnew FormatException(System::String::Format(L"invalid char at index {0}", -1 - error));
+    }
+
+    // the data chars without the padding, throw on invalid length or padding
+    static int __clrcall Base64Data(const wchar_t* str, int length, Base64::Variant variant, int% decodedLength)
+    {
+        const int dataLength = Base64DataLength(str, length, Padding(variant));
+        if (dataLength < 0)
+            throw gcnew FormatException(System::String::Format(L"invalid base64 length or padding at index {0}", -1 - dataLength));
+
+        decodedLength = Base64DecodedLength(dataLength);
+        return dataLength;
+    }
+
+    static int __clrcall Base64Decode(const wchar_t* str, int length, array<unsigned char>^ bytes, int byteIndex, Base64::Variant variant)
+    {
+        int decodedLength;
+        const int dataLength = Base64Data(str, length, variant, decodedLength);
+        CheckOutput(bytes, byteIndex, decodedLength, L"bytes", L"byteIndex");
+        if (!decodedLength)
+            return 0;
+
+        pin_ptr<unsigned char> pinBytes = &bytes[byteIndex];
+        const int written = StrBase64Decode(str, dataLength, pinBytes, UrlSafe(variant));
+        if (written < 0)
+            throw InvalidChar(written);
+        return written;
+    }
+
+    int __clrcall Base64::GetEncodedLength(int byteCount, Variant variant)
+    {
+        CheckVariant(variant);
+
+        if (byteCount < 0 || byteCount > Int32::MaxValue / 4 * 3)
+            throw gcnew ArgumentOutOfRangeException(L"byteCount must be greater than 0 and encode in less than Int32::MaxValue chars");
+
+        return Base64EncodedLength(byteCount, Padding(variant));
+    }
+
+    int __clrcall Base64::Encode(array<unsigned char>^ bytes, int index, int count, array<wchar_t>^ chars, int charIndex, Variant variant)
+    {
+        CheckSlice(bytes, index, count, L"bytes");
+        const int length = GetEncodedLength(count, variant);
+        CheckOutput(chars, charIndex, length, L"chars", L"charIndex");
+        if (!length)
+            return 0;
+
+        pin_ptr<unsigned char> pinBytes = &bytes[index];
+        pin_ptr<wchar_t> pinChars = &chars[charIndex];
+        return StrBase64Encode(pinBytes, count, pinChars, UrlSafe(variant), Padding(variant));
+    }
+
+    System::String ^ __clrcall Base64::Encode(array<unsigned char>^ bytes, Variant variant)
+    {
+        if (bytes == nullptr)
+            throw gcnew ArgumentNullException("bytes is null");
+
+        const int length = GetEncodedLength(bytes->Length, variant);
+        if (!length)
+            return System::String::Empty;
+
+        // the string is encoded in place, it isn't visible to anyone else before the return
+        System::String ^ str = gcnew System::String(L'\0', length);
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<unsigned char> pinBytes = &bytes[0];
+        StrBase64Encode(pinBytes, bytes->Length, const_cast<wchar_t*>((const wchar_t*)pinStr), UrlSafe(variant), Padding(variant));
+        return str;
+    }
+
+    int __clrcall Base64::GetDecodedLength(System::String ^ str, Variant variant)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        CheckVariant(variant);
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        int decodedLength;
+        Base64Data(pinStr, str->Length, variant, decodedLength);
+        return decodedLength;
+    }
+
+    int __clrcall Base64::Decode(System::String ^ str, array<unsigned char>^ bytes, int byteIndex, Variant variant)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        CheckVariant(variant);
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        return Base64Decode(pinStr, str->Length, bytes, byteIndex, variant);
+    }
+
+    int __clrcall Base64::Decode(array<wchar_t>^ chars, int index, int count, array<unsigned char>^ bytes, int byteIndex, Variant variant)
+    {
+        CheckSlice(chars, index, count, L"chars");
+        CheckVariant(variant);
+        if (!count)
+            return Base64Decode(nullptr, 0, bytes, byteIndex, variant);
+
+        pin_ptr<wchar_t> pinChars = &chars[index];
+        return Base64Decode(pinChars, count, bytes, byteIndex, variant);
+    }
+
+    array<unsigned char>^ __clrcall Base64::Decode(System::String ^ str, Variant variant)
+    {
+        array<unsigned char>^ bytes = gcnew array<unsigned char>(GetDecodedLength(str, variant));
+        Decode(str, bytes, 0, variant);
+        return bytes;
+    }
+
+    static int __clrcall HexDecode(const wchar_t* str, int length, array<unsigned char>^ bytes, int byteIndex)
+    {
+        if (length & 1)
+            throw gcnew FormatException(L"hex length must be even");
+
+        CheckOutput(bytes, byteIndex, length / 2, L"bytes", L"byteIndex");
+        if (!length)
+            return 0;
+
+        pin_ptr<unsigned char> pinBytes = &bytes[byteIndex];
+        const int written = StrHexDecode(str, length, pinBytes);
+        if (written < 0)
+            throw InvalidChar(written);
+        return written;
+    }
+
+    int __clrcall Hex::Encode(array<unsigned char>^ bytes, int index, int count, array<wchar_t>^ chars, int charIndex, bool upperCase)
+    {
+        CheckSlice(bytes, index, count, L"bytes");
+
+        if (count > Int32::MaxValue / 2)
+            throw gcnew ArgumentOutOfRangeException(L"count must encode in less than Int32::MaxValue chars");
+
+        CheckOutput(chars, charIndex, 2 * count, L"chars", L"charIndex");
+        if (!count)
+            return 0;
+
+        pin_ptr<unsigned char> pinBytes = &bytes[index];
+        pin_ptr<wchar_t> pinChars = &chars[charIndex];
+        return StrHexEncode(pinBytes, count, pinChars, upperCase);
+    }
+
+    System::String ^ __clrcall Hex::Encode(array<unsigned char>^ bytes, bool upperCase)
+    {
+        if (bytes == nullptr)
+            throw gcnew ArgumentNullException("bytes is null");
+
+        if (bytes->Length > Int32::MaxValue / 2)
+            throw gcnew ArgumentOutOfRangeException(L"bytes must encode in less than Int32::MaxValue chars");
+
+        if (!bytes->Length)
+            return System::String::Empty;
+
+        System::String ^ str = gcnew System::String(L'\0', 2 * bytes->Length);
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<unsigned char> pinBytes = &bytes[0];
+        StrHexEncode(pinBytes, bytes->Length, const_cast<wchar_t*>((const wchar_t*)pinStr), upperCase);
+        return str;
+    }
+
+    int __clrcall Hex::Decode(System::String ^ str, array<unsigned char>^ bytes, int byteIndex)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        return HexDecode(pinStr, str->Length, bytes, byteIndex);
+    }
+
+    int __clrcall Hex::Decode(array<wchar_t>^ chars, int index, int count, array<unsigned char>^ bytes, int byteIndex)
+    {
+        CheckSlice(chars, index, count, L"chars");
+        if (!count)
+            return HexDecode(nullptr, 0, bytes, byteIndex);
+
+        pin_ptr<wchar_t> pinChars = &chars[index];
+        return HexDecode(pinChars, count, bytes, byteIndex);
+    }
+
+    array<unsigned char>^ __clrcall Hex::Decode(System::String ^ str)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        array<unsigned char>^ bytes = gcnew array<unsigned char>(str->Length / 2);
+        Decode(str, bytes, 0);
+        return bytes;
+    }
+}
@@ -0,0 +1,74 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+using namespace System;
+
+namespace Intrinsics
+{
+    // base64 of bytes, the vector kernels are selected from the cpu features. decoders are strict:
+    // whitespace, chars outside the alphabet and invalid padding throw FormatException.
+    public ref class Base64 abstract sealed
+    {
+    public:
+        enum class Variant
+        {
+            Standard,           // '+' and '/', '=' padding
+            StandardNoPadding,
+            UrlSafe,            // '-' and '_', '=' padding
+            UrlSafeNoPadding
+        };
+
+        static int __clrcall GetEncodedLength(int byteCount, Variant variant);
+
+        // returns the chars written
+        static int __clrcall Encode(array<unsigned char>^ bytes, int index, int count, array<wchar_t>^ chars, int charIndex, Variant variant);
+
+        static System::String ^ __clrcall Encode(array<unsigned char>^ bytes, Variant variant);
+
+        static int __clrcall GetDecodedLength(System::String ^ str, Variant variant);
+
+        // returns the bytes written
+        static int __clrcall Decode(System::String ^ str, array<unsigned char>^ bytes, int byteIndex, Variant variant);
+
+        static int __clrcall Decode(array<wchar_t>^ chars, int index, int count, array<unsigned char>^ bytes, int byteIndex, Variant variant);
+
+        static array<unsigned char>^ __clrcall Decode(System::String ^ str, Variant variant);
+    };
+
+    // hex digits of bytes, 2 chars per byte. decoders take both cases and throw FormatException on other chars
+    public ref class Hex abstract sealed
+    {
+    public:
+        // returns the chars written
+        static int __clrcall Encode(array<unsigned char>^ bytes, int index, int count, array<wchar_t>^ chars, int charIndex, bool upperCase);
+
+        static System::String ^ __clrcall Encode(array<unsigned char>^ bytes, bool upperCase);
+
+        // returns the bytes written
+        static int __clrcall Decode(System::String ^ str, array<unsigned char>^ bytes, int byteIndex);
+
+        static int __clrcall Decode(array<wchar_t>^ chars, int index, int count, array<unsigned char>^ bytes, int byteIndex);
+
+        static array<unsigned char>^ __clrcall Decode(System::String ^ str);
+    };
+}
@@ -0,0 +1,575 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "CodecKernels.h"
+#include "InstructionSet.h"
+
+#include <intrin.h>         // intrinsics
+#include <emmintrin.h>      // SSE2
+#include <tmmintrin.h>      // SSSE3
+#include <immintrin.h>      // AVX2
+
+namespace
+{
+    // byte lanes traits, Width bytes per vector. shuffles work per 128 bits lane so the tables are
+    // repeated in each lane.
+    struct Ssse3Bytes
+    {
+        typedef __m128i Vector;
+        static const int Width = 16;
+        static const unsigned MaskAll = 0xffff;
+
+        // bytes read to encode Width / 4 * 3 bytes, bytes written to decode Width chars
+        static const int EncodeRead = 16;
+        static const int DecodeWrite = 16;
+
+        static __forceinline Vector Set(int c) { return _mm_set1_epi8((char)c); }
+        static __forceinline Vector Set32(int c) { return _mm_set1_epi32(c); }
+        static __forceinline Vector Table(__m128i table) { return table; }
+        static __forceinline Vector And(Vector a, Vector b) { return _mm_and_si128(a, b); }
+        static __forceinline Vector Or(Vector a, Vector b) { return _mm_or_si128(a, b); }
+        static __forceinline Vector Add(Vector a, Vector b) { return _mm_add_epi8(a, b); }
+        static __forceinline Vector SubSaturate(Vector a, Vector b) { return _mm_subs_epu8(a, b); }
+        static __forceinline Vector Equal(Vector a, Vector b) { return _mm_cmpeq_epi8(a, b); }
+        static __forceinline Vector Greater(Vector a, Vector b) { return _mm_cmpgt_epi8(a, b); }
+        static __forceinline Vector Shuffle(Vector table, Vector index) { return _mm_shuffle_epi8(table, index); }
+        static __forceinline Vector HighNibbles(Vector v) { return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0f)); }
+        static __forceinline Vector MultiplyHigh16(Vector a, Vector b) { return _mm_mulhi_epu16(a, b); }
+        static __forceinline Vector MultiplyLow16(Vector a, Vector b) { return _mm_mullo_epi16(a, b); }
+        static __forceinline Vector MultiplyAddBytes(Vector a, Vector b) { return _mm_maddubs_epi16(a, b); }
+        static __forceinline Vector MultiplyAdd16(Vector a, Vector b) { return _mm_madd_epi16(a, b); }
+        static __forceinline unsigned Mask(Vector v) { return (unsigned)_mm_movemask_epi8(v); }
+
+        static __forceinline Vector LoadBytes(const unsigned char* p) { return _mm_loadu_si128((const __m128i*)p); }
+        static __forceinline Vector LoadEncodeBlock(const unsigned char* p) { return _mm_loadu_si128((const __m128i*)p); }
+
+        // Width chars to bytes, chars above 0xff saturate to invalid bytes
+        static __forceinline Vector LoadChars(const wchar_t* s)
+        {
+            return _mm_packus_epi16(_mm_loadu_si128((const __m128i*)s), _mm_loadu_si128((const __m128i*)(s + 8)));
+        }
+
+        static __forceinline void StoreChars(wchar_t* d, Vector bytes)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            _mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi8(bytes, zero));
+            _mm_storeu_si128((__m128i*)(d + 8), _mm_unpackhi_epi8(bytes, zero));
+        }
+
+        static __forceinline void StoreBytes(unsigned char* d, Vector v) { _mm_storeu_si128((__m128i*)d, v); }
+
+        // 12 bytes per lane
+        static __forceinline void StoreDecodeBlock(unsigned char* d, Vector v) { _mm_storeu_si128((__m128i*)d, v); }
+
+        // bytes pairs of a and b in order
+        static __forceinline void Interleave(Vector a, Vector b, Vector& first, Vector& second)
+        {
+            first = _mm_unpacklo_epi8(a, b);
+            second = _mm_unpackhi_epi8(a, b);
+        }
+
+        static __forceinline Vector PackWords(Vector a, Vector b) { return _mm_packus_epi16(a, b); }
+    };
+
+    struct Avx2Bytes
+    {
+        typedef __m256i Vector;
+        static const int Width = 32;
+        static const unsigned MaskAll = 0xffffffff;
+
+        static const int EncodeRead = 28;
+        static const int DecodeWrite = 28;
+
+        static __forceinline Vector Set(int c) { return _mm256_set1_epi8((char)c); }
+        static __forceinline Vector Set32(int c) { return _mm256_set1_epi32(c); }
+        static __forceinline Vector Table(__m128i table) { return _mm256_broadcastsi128_si256(table); }
+        static __forceinline Vector And(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+        static __forceinline Vector Or(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+        static __forceinline Vector Add(Vector a, Vector b) { return _mm256_add_epi8(a, b); }
+        static __forceinline Vector SubSaturate(Vector a, Vector b) { return _mm256_subs_epu8(a, b); }
+        static __forceinline Vector Equal(Vector a, Vector b) { return _mm256_cmpeq_epi8(a, b); }
+        static __forceinline Vector Greater(Vector a, Vector b) { return _mm256_cmpgt_epi8(a, b); }
+        static __forceinline Vector Shuffle(Vector table, Vector index) { return _mm256_shuffle_epi8(table, index); }
+        static __forceinline Vector HighNibbles(Vector v) { return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f)); }
+        static __forceinline Vector MultiplyHigh16(Vector a, Vector b) { return _mm256_mulhi_epu16(a, b); }
+        static __forceinline Vector MultiplyLow16(Vector a, Vector b) { return _mm256_mullo_epi16(a, b); }
+        static __forceinline Vector MultiplyAddBytes(Vector a, Vector b) { return _mm256_maddubs_epi16(a, b); }
+        static __forceinline Vector MultiplyAdd16(Vector a, Vector b) { return _mm256_madd_epi16(a, b); }
+        static __forceinline unsigned Mask(Vector v) { return (unsigned)_mm256_movemask_epi8(v); }
+
+        static __forceinline Vector LoadBytes(const unsigned char* p) { return _mm256_loadu_si256((const __m256i*)p); }
+
+        // 12 bytes in each lane
+        static __forceinline Vector LoadEncodeBlock(const unsigned char* p)
+        {
+            return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)), _mm_loadu_si128((const __m128i*)(p + 12)), 1);
+        }
+
+        // packus work per 128 bits lane, the quarters are put back in order
+        static __forceinline Vector LoadChars(const wchar_t* s)
+        {
+            const __m256i packed = _mm256_packus_epi16(_mm256_loadu_si256((const __m256i*)s), _mm256_loadu_si256((const __m256i*)(s + 16)));
+            return _mm256_permute4x64_epi64(packed, 0xd8);
+        }
+
+        static __forceinline void StoreChars(wchar_t* d, Vector bytes)
+        {
+            _mm256_storeu_si256((__m256i*)d, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+            _mm256_storeu_si256((__m256i*)(d + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+        }
+
+        static __forceinline void StoreBytes(unsigned char* d, Vector v) { _mm256_storeu_si256((__m256i*)d, v); }
+
+        static __forceinline void StoreDecodeBlock(unsigned char* d, Vector v)
+        {
+            _mm_storeu_si128((__m128i*)d, _mm256_castsi256_si128(v));
+            _mm_storeu_si128((__m128i*)(d + 12), _mm256_extracti128_si256(v, 1));
+        }
+
+        static __forceinline void Interleave(Vector a, Vector b, Vector& first, Vector& second)
+        {
+            const __m256i low = _mm256_unpacklo_epi8(a, b);
+            const __m256i high = _mm256_unpackhi_epi8(a, b);
+            first = _mm256_permute2x128_si256(low, high, 0x20);
+            second = _mm256_permute2x128_si256(low, high, 0x31);
+        }
+
+        static __forceinline Vector PackWords(Vector a, Vector b) { return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8); }
+    };
+
+    const char Base64Standard[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const char Base64UrlSafe[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    const char HexLower[17] = "0123456789abcdef";
+    const char HexUpper[17] = "0123456789ABCDEF";
+
+    __forceinline int Invalid(int64_t index)
+    {
+        return (int)(-1 - index);
+    }
+
+    // lanes in [low, high], the chars are below 0x80 so signed compares work
+    template<class Isa>
+    __forceinline typename Isa::Vector InRange(typename Isa::Vector v, int low, int high)
+    {
+        return Isa::And(Isa::Greater(v, Isa::Set(low - 1)), Isa::Greater(Isa::Set(high + 1), v));
+    }
+
+    int Base64EncodeScalar(const unsigned char* bytes, int length, wchar_t* str, const char* alphabet, bool padding)
+    {
+        wchar_t* d = str;
+        int i = 0;
+        for (; length - i >= 3; i += 3)
+        {
+            const unsigned v = (unsigned)bytes[i] << 16 | (unsigned)bytes[i + 1] << 8 | bytes[i + 2];
+            d[0] = alphabet[v >> 18];
+            d[1] = alphabet[(v >> 12) & 0x3f];
+            d[2] = alphabet[(v >> 6) & 0x3f];
+            d[3] = alphabet[v & 0x3f];
+            d += 4;
+        }
+
+        if (i < length)
+        {
+            const unsigned v = (unsigned)bytes[i] << 16 | (i + 1 < length ? (unsigned)bytes[i + 1] << 8 : 0);
+            *d++ = alphabet[v >> 18];
+            *d++ = alphabet[(v >> 12) & 0x3f];
+            if (i + 1 < length)
+                *d++ = alphabet[(v >> 6) & 0x3f];
+            else if (padding)
+                *d++ = L'=';
+            if (padding)
+                *d++ = L'=';
+        }
+        return (int)(d - str);
+    }
+
+    __forceinline int Base64Index(unsigned c, bool urlSafe)
+    {
+        if (c - L'A' < 26)
+            return c - L'A';
+        if (c - L'a' < 26)
+            return c - L'a' + 26;
+        if (c - L'0' < 10)
+            return c - L'0' + 52;
+        if (c == (urlSafe ? L'-' : L'+'))
+            return 62;
+        if (c == (urlSafe ? L'_' : L'/'))
+            return 63;
+        return -1;
+    }
+
+    // str index offset the error index of a block
+    int Base64DecodeScalar(const wchar_t* str, int length, unsigned char* bytes, bool urlSafe, int offset)
+    {
+        unsigned char* d = bytes;
+        int i = 0;
+        while (i < length)
+        {
+            // a quad, or the 2 or 3 last chars
+            const int n = length - i < 4 ? length - i : 4;
+            if (n == 1)
+                return Invalid(offset + i);
+
+            unsigned v = 0;
+            for (int k = 0; k < n; ++k)
+            {
+                const int index = Base64Index(str[i + k], urlSafe);
+                if (index < 0)
+                    return Invalid(offset + i + k);
+                v |= (unsigned)index << (18 - 6 * k);
+            }
+
+            *d++ = (unsigned char)(v >> 16);
+            if (n > 2)
+                *d++ = (unsigned char)(v >> 8);
+            if (n > 3)
+                *d++ = (unsigned char)v;
+            i += n;
+        }
+        return (int)(d - bytes);
+    }
+
+    template<class Isa>
+    int Base64Encode(const unsigned char* bytes, int length, wchar_t* str, bool urlSafe, bool padding)
+    {
+        typedef typename Isa::Vector Vector;
+
+        // 3 bytes to 4 indices of 6 bits, in 16 bits lanes then moved in place by the multiplies
+        const Vector spread = Isa::Table(_mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+        const Vector maskHigh = Isa::Set32(0x0fc0fc00);
+        const Vector shiftHigh = Isa::Set32(0x04000040);
+        const Vector maskLow = Isa::Set32(0x003f03f0);
+        const Vector shiftLow = Isa::Set32(0x01000010);
+
+        // offset to the alphabet char by range: 0 for 'A'-'Z' after the compare, 1 to 10 digits, 11 and 12
+        // the 2 last chars and 13 'a'-'z'
+        const char plus = urlSafe ? '-' : '+';
+        const char slash = urlSafe ? '_' : '/';
+        const Vector offsets = Isa::Table(_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, (char)(plus - 62), (char)(slash - 63), 'A', 0, 0));
+
+        const int blockBytes = Isa::Width / 4 * 3;
+        const unsigned char* p = bytes;
+        const unsigned char* end = bytes + length;
+        wchar_t* d = str;
+        for (; end - p >= Isa::EncodeRead; p += blockBytes, d += Isa::Width)
+        {
+            const Vector in = Isa::Shuffle(Isa::LoadEncodeBlock(p), spread);
+            const Vector indices = Isa::Or(Isa::MultiplyHigh16(Isa::And(in, maskHigh), shiftHigh), Isa::MultiplyLow16(Isa::And(in, maskLow), shiftLow));
+
+            Vector range = Isa::SubSaturate(indices, Isa::Set(51));
+            range = Isa::Or(range, Isa::And(Isa::Greater(Isa::Set(26), indices), Isa::Set(13)));
+            Isa::StoreChars(d, Isa::Add(indices, Isa::Shuffle(offsets, range)));
+        }
+
+        return (int)(d - str) + Base64EncodeScalar(p, (int)(end - p), d, urlSafe ? Base64UrlSafe : Base64Standard, padding);
+    }
+
+    template<class Isa>
+    int Base64Decode(const wchar_t* str, int length, unsigned char* bytes, bool urlSafe)
+    {
+        typedef typename Isa::Vector Vector;
+
+        const int plus = urlSafe ? '-' : '+';
+        const int slash = urlSafe ? '_' : '/';
+
+        // indices pairs merged in 12 bits, then in 24 bits and the 3 bytes of each 32 bits lane gathered
+        const Vector pairs = Isa::Set32(0x01400140);
+        const Vector quads = Isa::Set32(0x00011000);
+        const Vector gather = Isa::Table(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+        // the last block stores DecodeWrite bytes, the chars left make sure they stay in the output
+        const int charsLeft = (Isa::DecodeWrite - Isa::Width / 4 * 3) * 4 / 3 + 4;
+
+        const wchar_t* s = str;
+        const wchar_t* end = str + length;
+        unsigned char* d = bytes;
+        while (end - s >= Isa::Width + charsLeft)
+        {
+            const Vector v = Isa::LoadChars(s);
+            const Vector upper = InRange<Isa>(v, 'A', 'Z');
+            const Vector lower = InRange<Isa>(v, 'a', 'z');
+            const Vector digit = InRange<Isa>(v, '0', '9');
+            const Vector lastButOne = Isa::Equal(v, Isa::Set(plus));
+            const Vector last = Isa::Equal(v, Isa::Set(slash));
+
+            const Vector valid = Isa::Or(Isa::Or(Isa::Or(upper, lower), digit), Isa::Or(lastButOne, last));
+            if (Isa::Mask(valid) != Isa::MaskAll)
+            {
+                const int written = Base64DecodeScalar(s, Isa::Width, d, urlSafe, (int)(s - str));
+                if (written < 0)
+                    return written;
+                s += Isa::Width;
+                d += written;
+                continue;
+            }
+
+            Vector offset = Isa::And(upper, Isa::Set(-'A'));
+            offset = Isa::Or(offset, Isa::And(lower, Isa::Set(26 - 'a')));
+            offset = Isa::Or(offset, Isa::And(digit, Isa::Set(52 - '0')));
+            offset = Isa::Or(offset, Isa::And(lastButOne, Isa::Set(62 - plus)));
+            offset = Isa::Or(offset, Isa::And(last, Isa::Set(63 - slash)));
+            const Vector indices = Isa::Add(v, offset);
+
+            const Vector merged = Isa::MultiplyAdd16(Isa::MultiplyAddBytes(indices, pairs), quads);
+            Isa::StoreDecodeBlock(d, Isa::Shuffle(merged, gather));
+            s += Isa::Width;
+            d += Isa::Width / 4 * 3;
+        }
+
+        const int written = Base64DecodeScalar(s, (int)(end - s), d, urlSafe, (int)(s - str));
+        if (written < 0)
+            return written;
+        return (int)(d - bytes) + written;
+    }
+
+    int HexEncodeScalar(const unsigned char* bytes, int length, wchar_t* str, const char* digits)
+    {
+        for (int i = 0; i < length; ++i)
+        {
+            str[2 * i] = digits[bytes[i] >> 4];
+            str[2 * i + 1] = digits[bytes[i] & 0x0f];
+        }
+        return 2 * length;
+    }
+
+    __forceinline int HexValue(unsigned c)
+    {
+        if (c - L'0' < 10)
+            return c - L'0';
+        if ((c | 0x20) - L'a' < 6)
+            return (c | 0x20) - L'a' + 10;
+        return -1;
+    }
+
+    int HexDecodeScalar(const wchar_t* str, int length, unsigned char* bytes, int offset)
+    {
+        for (int i = 0; i < length; i += 2)
+        {
+            const int high = HexValue(str[i]);
+            if (high < 0)
+                return Invalid(offset + i);
+            const int low = HexValue(str[i + 1]);
+            if (low < 0)
+                return Invalid(offset + i + 1);
+            bytes[i / 2] = (unsigned char)(high << 4 | low);
+        }
+        return length / 2;
+    }
+
+    template<class Isa>
+    int HexEncode(const unsigned char* bytes, int length, wchar_t* str, bool upperCase)
+    {
+        typedef typename Isa::Vector Vector;
+
+        const char* digits = upperCase ? HexUpper : HexLower;
+        const Vector table = Isa::Table(_mm_loadu_si128((const __m128i*)digits));
+        const Vector low = Isa::Set(0x0f);
+
+        const unsigned char* p = bytes;
+        const unsigned char* end = bytes + length;
+        wchar_t* d = str;
+        for (; end - p >= Isa::Width; p += Isa::Width, d += 2 * Isa::Width)
+        {
+            const Vector v = Isa::LoadBytes(p);
+            Vector first;
+            Vector second;
+            Isa::Interleave(Isa::Shuffle(table, Isa::HighNibbles(v)), Isa::Shuffle(table, Isa::And(v, low)), first, second);
+            Isa::StoreChars(d, first);
+            Isa::StoreChars(d + Isa::Width, second);
+        }
+
+        return (int)(d - str) + HexEncodeScalar(p, (int)(end - p), d, digits);
+    }
+
+    template<class Isa>
+    __forceinline bool HexValues(typename Isa::Vector v, typename Isa::Vector& values)
+    {
+        const typename Isa::Vector digit = InRange<Isa>(v, '0', '9');
+        const typename Isa::Vector upper = InRange<Isa>(v, 'A', 'F');
+        const typename Isa::Vector lower = InRange<Isa>(v, 'a', 'f');
+        if (Isa::Mask(Isa::Or(Isa::Or(digit, upper), lower)) != Isa::MaskAll)
+            return false;
+
+        typename Isa::Vector offset = Isa::And(digit, Isa::Set(-'0'));
+        offset = Isa::Or(offset, Isa::And(upper, Isa::Set(10 - 'A')));
+        offset = Isa::Or(offset, Isa::And(lower, Isa::Set(10 - 'a')));
+        values = Isa::Add(v, offset);
+        return true;
+    }
+
+    template<class Isa>
+    int HexDecode(const wchar_t* str, int length, unsigned char* bytes)
+    {
+        typedef typename Isa::Vector Vector;
+
+        // high nibble * 16 + low nibble in 16 bits lanes
+        const Vector nibbles = Isa::Set32(0x01100110);
+
+        const wchar_t* s = str;
+        const wchar_t* end = str + length;
+        unsigned char* d = bytes;
+        for (; end - s >= 2 * Isa::Width; s += 2 * Isa::Width, d += Isa::Width)
+        {
+            Vector first;
+            Vector second;
+            if (!HexValues<Isa>(Isa::LoadChars(s), first) || !HexValues<Isa>(Isa::LoadChars(s + Isa::Width), second))
+            {
+                const int written = HexDecodeScalar(s, 2 * Isa::Width, d, (int)(s - str));
+                if (written < 0)
+                    return written;
+                continue;
+            }
+
+            Isa::StoreBytes(d, Isa::PackWords(Isa::MultiplyAddBytes(first, nibbles), Isa::MultiplyAddBytes(second, nibbles)));
+        }
+
+        const int written = HexDecodeScalar(s, (int)(end - s), d, (int)(s - str));
+        if (written < 0)
+            return written;
+        return (int)(d - bytes) + written;
+    }
+}
+
+int Base64EncodedLength(int length, bool padding)
+{
+    if (padding)
+        return (length + 2) / 3 * 4;
+    return length / 3 * 4 + (length % 3 ? length % 3 + 1 : 0);
+}
+
+int StrBase64Encode(const unsigned char* bytes, int length, wchar_t* str, bool urlSafe, bool padding)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrBase64Encode_AVX2(bytes, length, str, urlSafe, padding);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSSE3))
+        return StrBase64Encode_SSSE3(bytes, length, str, urlSafe, padding);
+    return StrBase64Encode_CPP(bytes, length, str, urlSafe, padding);
+}
+
+int StrBase64Encode_SSSE3(const unsigned char* bytes, int length, wchar_t* str, bool urlSafe, bool padding)
+{
+    return Base64Encode<Ssse3Bytes>(bytes, length, str, urlSafe, padding);
+}
+
+int StrBase64Encode_AVX2(const unsigned char* bytes, int length, wchar_t* str, bool urlSafe, bool padding)
+{
+    return Base64Encode<Avx2Bytes>(bytes, length, str, urlSafe, padding);
+}
+
+int StrBase64Encode_CPP(const unsigned char* bytes, int length, wchar_t* str, bool urlSafe, bool padding)
+{
+    return Base64EncodeScalar(bytes, length, str, urlSafe ? Base64UrlSafe : Base64Standard, padding);
+}
+
+int Base64DataLength(const wchar_t* str, int length, bool padding)
+{
+    if (!padding)
+        return length % 4 == 1 ? Invalid(length - 1) : length;
+
+    if (length % 4)
+        return Invalid(length - length % 4);
+
+    // at most 2 padding chars, completing a quad
+    int dataLength = length;
+    while (dataLength > 0 && length - dataLength < 2 && str[dataLength - 1] == L'=')
+        --dataLength;
+    return dataLength % 4 == 1 ? Invalid(dataLength) : dataLength;
+}
+
+int Base64DecodedLength(int dataLength)
+{
+    if (dataLength % 4 == 1)
+        return -1;
+    return dataLength / 4 * 3 + (dataLength % 4 ? dataLength % 4 - 1 : 0);
+}
+
+int StrBase64Decode(const wchar_t* str, int length, unsigned char* bytes, bool urlSafe)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrBase64Decode_AVX2(str, length, bytes, urlSafe);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSSE3))
+        return StrBase64Decode_SSSE3(str, length, bytes, urlSafe);
+    return StrBase64Decode_CPP(str, length, bytes, urlSafe);
+}
+
+int StrBase64Decode_SSSE3(const wchar_t* str, int length, unsigned char* bytes, bool urlSafe)
+{
+    return Base64Decode<Ssse3Bytes>(str, length, bytes, urlSafe);
+}
+
+int StrBase64Decode_AVX2(const wchar_t* str, int length, unsigned char* bytes, bool urlSafe)
+{
+    return Base64Decode<Avx2Bytes>(str, length, bytes, urlSafe);
+}
+
+int StrBase64Decode_CPP(const wchar_t* str, int length, unsigned char* bytes, bool urlSafe)
+{
+    return Base64DecodeScalar(str, length, bytes, urlSafe, 0);
+}
+
+int StrHexEncode(const unsigned char* bytes, int length, wchar_t* str, bool upperCase)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrHexEncode_AVX2(bytes, length, str, upperCase);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSSE3))
+        return StrHexEncode_SSSE3(bytes, length, str, upperCase);
+    return StrHexEncode_CPP(bytes, length, str, upperCase);
+}
+
+int StrHexEncode_SSSE3(const unsigned char* bytes, int length, wchar_t* str, bool upperCase)
+{
+    return HexEncode<Ssse3Bytes>(bytes, length, str, upperCase);
+}
+
+int StrHexEncode_AVX2(const unsigned char* bytes, int length, wchar_t* str, bool upperCase)
+{
+    return HexEncode<Avx2Bytes>(bytes, length, str, upperCase);
+}
+
+int StrHexEncode_CPP(const unsigned char* bytes, int length, wchar_t* str, bool upperCase)
+{
+    return HexEncodeScalar(bytes, length, str, upperCase ? HexUpper : HexLower);
+}
+
+int StrHexDecode(const wchar_t* str, int length, unsigned char* bytes)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrHexDecode_AVX2(str, length, bytes);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSSE3))
+        return StrHexDecode_SSSE3(str, length, bytes);
+    return StrHexDecode_CPP(str, length, bytes);
+}
+
+int StrHexDecode_SSSE3(const wchar_t* str, int length, unsigned char* bytes)
+{
+    return HexDecode<Ssse3Bytes>(str, length, bytes);
+}
+
+int StrHexDecode_AVX2(const wchar_t* str, int length, unsigned char* bytes)
+{
+    return HexDecode<Avx2Bytes>(str, length, bytes);
+}
+
+int StrHexDecode_CPP(const wchar_t* str, int length, unsigned char* bytes)
+{
+    return HexDecodeScalar(str, length, bytes, 0);
+}
@@ -0,0 +1,78 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// unmanaged base64 and hex kernels, compiled without /clr like StringKernels
+//
+// base64 encoders map 12 (24 with avx2) bytes to 16 (32) chars: a shuffle and multiplies split the
+// bytes in 6 bits indices, a shuffle table map the indices to the alphabet. decoders validate and
+// translate 16 (32) chars with range compares, the indices are merged back with multiply-adds and a
+// shuffle. hex kernels map nibbles with a shuffle table and merge them back with a multiply-add.
+// decoders return -1 - index of the first invalid char, the blocks with an invalid char are decoded
+// by the scalar code to find it. they take the chars without the base64 padding.
+// the kernels without suffix pick one from the cpu features.
+
+#include <stdint.h>
+
+// chars of the encoded length bytes
+int Base64EncodedLength(int length, bool padding);
+
+int StrBase64Encode(const unsigned char* bytes, int length, wchar_t* str, bool urlSafe, bool padding);
+
+int StrBase64Encode_SSSE3(const unsigned char* bytes, int length, wchar_t* str, bool urlSafe, bool padding);
+
+int StrBase64Encode_AVX2(const unsigned char* bytes, int length, wchar_t* str, bool urlSafe, bool padding);
+
+int StrBase64Encode_CPP(const unsigned char* bytes, int length, wchar_t* str, bool urlSafe, bool padding);
+
+// length of str without the padding, padding is then required, or -1 - index when the length or the
+// padding are invalid
+int Base64DataLength(const wchar_t* str, int length, bool padding);
+
+// bytes of dataLength chars without padding, -1 when a dataLength can't be encoded
+int Base64DecodedLength(int dataLength);
+
+int StrBase64Decode(const wchar_t* str, int length, unsigned char* bytes, bool urlSafe);
+
+int StrBase64Decode_SSSE3(const wchar_t* str, int length, unsigned char* bytes, bool urlSafe);
+
+int StrBase64Decode_AVX2(const wchar_t* str, int length, unsigned char* bytes, bool urlSafe);
+
+int StrBase64Decode_CPP(const wchar_t* str, int length, unsigned char* bytes, bool urlSafe);
+
+// 2 * length chars
+int StrHexEncode(const unsigned char* bytes, int length, wchar_t* str, bool upperCase);
+
+int StrHexEncode_SSSE3(const unsigned char* bytes, int length, wchar_t* str, bool upperCase);
+
+int StrHexEncode_AVX2(const unsigned char* bytes, int length, wchar_t* str, bool upperCase);
+
+int StrHexEncode_CPP(const unsigned char* bytes, int length, wchar_t* str, bool upperCase);
+
+// length / 2 bytes, length is even. both cases are decoded
+int StrHexDecode(const wchar_t* str, int length, unsigned char* bytes);
+
+int StrHexDecode_SSSE3(const wchar_t* str, int length, unsigned char* bytes);
+
+int StrHexDecode_AVX2(const wchar_t* str, int length, unsigned char* bytes);
+
+int StrHexDecode_CPP(const wchar_t* str, int length, unsigned char* bytes);
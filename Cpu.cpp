@@ -0,0 +1,72 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "Cpu.h"
+#include "InstructionSet.h" // cpu intrinsics support helper
+
+#pragma managed
+
+namespace Intrinsics
+{
+    static_assert((uint64_t)InstructionSet::FeatureAVX2 == 1ull << 7, "CpuFeatures must match InstructionSet::Feature bits");
+    static_assert((uint64_t)InstructionSet::FeatureAVX512BW == 1ull << 23, "CpuFeatures must match InstructionSet::Feature bits");
+    static_assert((uint64_t)InstructionSet::FeatureAVXVNNI == 1ull << 35, "CpuFeatures must match InstructionSet::Feature bits");
+
+    Cpu::Cpu()
+    {
+        features_ = (CpuFeatures)InstructionSet::Features();
+        vendor_ = gcnew System::String(InstructionSet::Vendor().c_str());
+        brand_ = gcnew System::String(InstructionSet::Brand().c_str())->Trim();
+        lastLevelCacheSize_ = (Int64)InstructionSet::LastLevelCacheSize();
+        cacheLineSize_ = InstructionSet::CacheLineSize();
+        logicalProcessors_ = InstructionSet::LogicalProcessors();
+        physicalCores_ = InstructionSet::PhysicalCores();
+        chunkSize_ = InstructionSet::ChunkSize();
+        nonTemporalThreshold_ = (Int64)InstructionSet::NonTemporalThreshold();
+    }
+
+    bool __clrcall Cpu::Supports(CpuFeatures features)
+    {
+        return (features_ & features) == features;
+    }
+
+    array<CpuCache>^ __clrcall Cpu::GetCaches()
+    {
+        const std::vector<InstructionSet::Cache>& caches = InstructionSet::Caches();
+        array<CpuCache>^ result = gcnew array<CpuCache>((int)caches.size());
+        for (int i = 0; i < result->Length; ++i)
+        {
+            result[i].Level = caches[i].level;
+            result[i].Type = (CpuCacheType)caches[i].type;
+            result[i].Size = (Int64)caches[i].size;
+            result[i].LineSize = caches[i].lineSize;
+            result[i].Ways = caches[i].ways;
+            result[i].SharedBy = caches[i].sharedBy;
+        }
+        return result;
+    }
+
+    Int64 __clrcall Cpu::CacheSize(int level)
+    {
+        return (Int64)InstructionSet::CacheSize(level);
+    }
+}
@@ -0,0 +1,164 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+using namespace System;
+
+namespace Intrinsics
+{
+    // usable instruction sets, same bits as the native InstructionSet::Features() mask
+    [Flags]
+    public enum class CpuFeatures : UInt64
+    {
+        None = 0,
+        Sse2 = 1ull << 0,
+        Sse3 = 1ull << 1,
+        Ssse3 = 1ull << 2,
+        Sse41 = 1ull << 3,
+        Sse42 = 1ull << 4,
+        Popcnt = 1ull << 5,
+        Avx = 1ull << 6,
+        Avx2 = 1ull << 7,
+        Fma = 1ull << 8,
+        F16c = 1ull << 9,
+        Bmi1 = 1ull << 10,
+        Bmi2 = 1ull << 11,
+        Lzcnt = 1ull << 12,
+        Movbe = 1ull << 13,
+        Aes = 1ull << 14,
+        Pclmulqdq = 1ull << 15,
+        Sha = 1ull << 16,
+        Erms = 1ull << 17,
+
+        Avx512F = 1ull << 20,
+        Avx512Dq = 1ull << 21,
+        Avx512Cd = 1ull << 22,
+        Avx512Bw = 1ull << 23,
+        Avx512Vl = 1ull << 24,
+        Avx512Vbmi = 1ull << 25,
+        Avx512Vbmi2 = 1ull << 26,
+        Avx512Vnni = 1ull << 27,
+        Avx512Bitalg = 1ull << 28,
+        Avx512Vpopcntdq = 1ull << 29,
+
+        Vaes = 1ull << 32,
+        Vpclmulqdq = 1ull << 33,
+        Gfni = 1ull << 34,
+        AvxVnni = 1ull << 35,
+    };
+
+    public enum class CpuCacheType
+    {
+        Data = 1,
+        Instruction = 2,
+        Unified = 3
+    };
+
+    public value struct CpuCache
+    {
+    public:
+        int Level;
+        CpuCacheType Type;
+        Int64 Size;         // bytes
+        int LineSize;       // bytes
+        int Ways;
+        int SharedBy;       // logical processors sharing this cache
+    };
+
+    public ref class Cpu abstract sealed
+    {
+    public:
+        // detected once, AVX and AVX-512 features are only reported when the OS save their state (XCR0)
+        static property CpuFeatures Features
+        {
+            CpuFeatures get() { return features_; }
+        }
+
+        static property System::String ^ Vendor
+        {
+            System::String ^ get() { return vendor_; }
+        }
+
+        static property System::String ^ Brand
+        {
+            System::String ^ get() { return brand_; }
+        }
+
+        static bool __clrcall Supports(CpuFeatures features);
+
+        static array<CpuCache>^ __clrcall GetCaches();
+
+        // data or unified cache size of a level in bytes, 0 when unknown
+        static Int64 __clrcall CacheSize(int level);
+
+        static property Int64 LastLevelCacheSize
+        {
+            Int64 get() { return lastLevelCacheSize_; }
+        }
+
+        static property int CacheLineSize
+        {
+            int get() { return cacheLineSize_; }
+        }
+
+        static property int LogicalProcessors
+        {
+            int get() { return logicalProcessors_; }
+        }
+
+        static property int PhysicalCores
+        {
+            int get() { return physicalCores_; }
+        }
+
+        // scans split in chunks of this size (bytes) stay in L2
+        static property int ChunkSize
+        {
+            int get() { return chunkSize_; }
+        }
+
+        // inputs larger than this (bytes) don't fit in the last level cache
+        static property Int64 NonTemporalThreshold
+        {
+            Int64 get() { return nonTemporalThreshold_; }
+        }
+
+        // parallel scans workers, one per physical core
+        static property int WorkerCount
+        {
+            int get() { return physicalCores_; }
+        }
+
+    private:
+        static Cpu();
+
+        static initonly CpuFeatures features_;
+        static initonly System::String ^ vendor_;
+        static initonly System::String ^ brand_;
+        static initonly Int64 lastLevelCacheSize_;
+        static initonly int cacheLineSize_;
+        static initonly int logicalProcessors_;
+        static initonly int physicalCores_;
+        static initonly int chunkSize_;
+        static initonly Int64 nonTemporalThreshold_;
+    };
+}
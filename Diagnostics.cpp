@@ -0,0 +1,175 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "Diagnostics.h"
+#include "Instrumentation.h"
+
+using namespace System::Collections::Generic;
+using namespace System::Globalization;
+using namespace System::Threading;
+
+namespace Intrinsics
+{
+    // .net 4.5 has no EventCounter, the counters are published as events on the interval EventCounter
+    // listeners ask for
+    [EventSource(Name = "Intrinsics-Net")]
+    ref class IntrinsicsEventSource sealed : public EventSource
+    {
+    public:
+        [Event(1, Level = EventLevel::Informational)]
+        void KernelCounters(System::String ^ operation, System::String ^ tier, Int64 calls, Int64 chars, Int64 matches, Int64 scalarChars, Int64 vectorChars)
+        {
+            WriteEvent(1, operation, tier, calls, chars, matches, scalarChars, vectorChars);
+        }
+
+        [Event(2, Level = EventLevel::Informational)]
+        void Reallocations(System::String ^ operation, Int64 reallocations)
+        {
+            WriteEvent(2, operation, reallocations);
+        }
+
+    protected:
+        virtual void OnEventCommand(EventCommandEventArgs ^ command) override
+        {
+            if (command->Command == EventCommand::Disable)
+            {
+                Stop();
+                return;
+            }
+
+            if (command->Command != EventCommand::Enable)
+                return;
+
+            double interval = 1.0;
+            System::String ^ argument;
+            if (command->Arguments != nullptr && command->Arguments->TryGetValue(L"EventCounterIntervalSec", argument))
+                Double::TryParse(argument, NumberStyles::Float, CultureInfo::InvariantCulture, interval);
+
+            Stop();
+            if (interval > 0.0)
+            {
+                int period = (int)(interval * 1000.0);
+                timer_ = gcnew Timer(gcnew TimerCallback(this, &IntrinsicsEventSource::Publish), nullptr, period, period);
+            }
+        }
+
+    private:
+        [NonEvent]
+        void Stop()
+        {
+            Timer ^ timer = timer_;
+            timer_ = nullptr;
+            if (timer != nullptr)
+                delete timer;
+        }
+
+        [NonEvent]
+        void Publish(Object ^ state)
+        {
+            if (!IsEnabled())
+                return;
+
+            Diagnostics::Snapshot ^ snapshot = Diagnostics::TakeSnapshot();
+            for each (Diagnostics::Operation operation in Enum::GetValues(Diagnostics::Operation::typeid))
+            {
+                for each (Diagnostics::Tier tier in Enum::GetValues(Diagnostics::Tier::typeid))
+                {
+                    Diagnostics::KernelCounters counters = snapshot->Kernel(operation, tier);
+                    if (counters.Calls)
+                        KernelCounters(operation.ToString(), tier.ToString(), counters.Calls, counters.Chars, counters.Matches, counters.ScalarChars, counters.VectorChars);
+                }
+                Reallocations(operation.ToString(), snapshot->Reallocations(operation));
+            }
+        }
+
+        Timer ^ timer_;
+    };
+
+    Diagnostics::Snapshot::Snapshot()
+    {
+        kernels_ = gcnew array<KernelCounters >(InstrumentOperationCount * InstrumentTierCount);
+        reallocations_ = gcnew array<Int64>(InstrumentOperationCount);
+    }
+
+    Diagnostics::KernelCounters __clrcall Diagnostics::Snapshot::Kernel(Operation operation, Tier tier)
+    {
+        return kernels_[(int)operation * InstrumentTierCount + (int)tier];
+    }
+
+    Int64 __clrcall Diagnostics::Snapshot::Reallocations(Operation operation)
+    {
+        return reallocations_[(int)operation];
+    }
+
+    bool Diagnostics::Enabled::get()
+    {
+        return InstrumentationEnabled();
+    }
+
+    Diagnostics::Snapshot^ __clrcall Diagnostics::TakeSnapshot()
+    {
+        InstrumentationSnapshot native;
+        InstrumentationTake(native);
+
+        Snapshot^ snapshot = gcnew Snapshot();
+        for (int operation = 0; operation < InstrumentOperationCount; ++operation)
+        {
+            snapshot->reallocations_[operation] = (Int64)native.reallocations[operation];
+
+            for (int tier = 0; tier < InstrumentTierCount; ++tier)
+            {
+                const InstrumentationCounters& from = native.kernels[operation][tier];
+                KernelCounters counters;
+                counters.Calls = (Int64)from.calls;
+                counters.Chars = (Int64)from.chars;
+                counters.Matches = (Int64)from.matches;
+                counters.ScalarChars = (Int64)from.scalarChars;
+                counters.VectorChars = (Int64)from.vectorChars;
+                counters.LengthHistogram = gcnew array<Int64>(HistogramBuckets);
+                counters.LatencyHistogram = gcnew array<Int64>(HistogramBuckets);
+                for (int i = 0; i < HistogramBuckets; ++i)
+                {
+                    counters.LengthHistogram[i] = (Int64)from.lengthHistogram[i];
+                    counters.LatencyHistogram[i] = (Int64)from.latencyHistogram[i];
+                }
+                snapshot->kernels_[operation * InstrumentTierCount + tier] = counters;
+            }
+        }
+        return snapshot;
+    }
+
+    void __clrcall Diagnostics::Reset()
+    {
+        InstrumentationReset();
+    }
+
+    EventSource^ Diagnostics::Events::get()
+    {
+        if (events_ == nullptr)
+        {
+            EventSource^ events = gcnew IntrinsicsEventSource();
+            if (Interlocked::CompareExchange(events_, events, nullptr) != nullptr)
+                delete events;
+        }
+        return events_;
+    }
+}
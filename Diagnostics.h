@@ -0,0 +1,100 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+using namespace System;
+using namespace System::Diagnostics::Tracing;
+
+namespace Intrinsics
+{
+    // kernels counters, only collected when the library is built with INTRINSICS_INSTRUMENTATION: always
+    // in Debug, in Release when built with msbuild /p:IntrinsicsInstrumentation=true
+    public ref class Diagnostics abstract sealed
+    {
+    public:
+
+        enum class Operation
+        {
+            IndexOfAll,
+            IndexOfAny,
+            CommonPrefix    // Equals, CompareOrdinal, StartsWith, EndsWith and CommonPrefixLength
+        };
+
+        enum class Tier
+        {
+            Cpp,
+            Sse2,
+            Avx2
+        };
+
+        // log2 buckets, bucket i count values in [2^(i-1), 2^i[, bucket 0 count 0
+        literal int HistogramBuckets = 32;
+
+        value struct KernelCounters
+        {
+        public:
+            Int64 Calls;
+            Int64 Chars;                    // chars scanned
+            Int64 Matches;                  // results emitted
+            Int64 ScalarChars;              // chars processed by the scalar head and tail loops
+            Int64 VectorChars;              // chars processed by the vector loop
+            array<Int64>^ LengthHistogram;  // chars per call
+            array<Int64>^ LatencyHistogram; // time stamp counter cycles per call
+        };
+
+        ref class Snapshot sealed
+        {
+        public:
+            KernelCounters __clrcall Kernel(Operation operation, Tier tier);
+
+            // results buffer reallocated because the caller one was too small
+            Int64 __clrcall Reallocations(Operation operation);
+
+        internal:
+            Snapshot();
+
+            array<KernelCounters >^ kernels_;
+            array<Int64>^ reallocations_;
+        };
+
+        static property bool Enabled
+        {
+            bool get();
+        }
+
+        // sum of every thread counters
+        static Snapshot^ __clrcall TakeSnapshot();
+
+        static void __clrcall Reset();
+
+        // "Intrinsics-Net" event source, publish the counters every EventCounterIntervalSec seconds
+        // (argument of the enable command, 1 second by default) while a listener is enabled.
+        // access it once at startup so listeners can find it.
+        static property EventSource^ Events
+        {
+            EventSource^ get();
+        }
+
+    private:
+        static EventSource^ events_;
+    };
+}
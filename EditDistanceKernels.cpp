@@ -0,0 +1,451 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "EditDistanceKernels.h"
+#include "InstructionSet.h"
+#include "KernelIsa.h"
+
+#include <limits.h>         // INT_MAX
+#include <string.h>         // memset
+#include <vector>
+
+struct EditPattern
+{
+    int length;
+    int blocks;                 // 64 chars words per mask
+    uint64_t* latin1;           // 256 * blocks, the chars below 0x100
+    unsigned slotMask;          // open addressing of the other chars, half full at most
+    wchar_t* slotChars;         // 0 for empty slots
+    uint64_t* slotMasks;        // (slots + 1) * blocks, the last row is zero for the chars not in the pattern
+
+    // storage of the patterns from StrEditPatternCreate
+    std::vector<uint64_t> masks;
+    std::vector<wchar_t> chars;
+
+    static __forceinline unsigned Hash(wchar_t c) { return ((unsigned)c * 0x9e3779b1u) >> 16; }
+
+    __forceinline const uint64_t* Masks(wchar_t c) const
+    {
+        if (c < 0x100)
+            return latin1 + c * blocks;
+
+        for (unsigned slot = Hash(c) & slotMask;; slot = (slot + 1) & slotMask)
+        {
+            if (slotChars[slot] == c)
+                return slotMasks + slot * blocks;
+            if (!slotChars[slot])
+                return slotMasks + (slotMask + 1) * blocks;
+        }
+    }
+};
+
+namespace
+{
+    // small patterns are built on the stack, slots for the 64 chars of a word
+    const int SmallSlots = 128;
+
+    // slots a power of 2 and at least twice length, latin1, slotChars and slotMasks zeroed
+    void Build(EditPattern& p, const wchar_t* pattern, int length, int slots)
+    {
+        p.length = length;
+        p.blocks = (length + 63) / 64;
+        p.slotMask = slots - 1;
+        for (int i = 0; i < length; ++i)
+        {
+            const wchar_t c = pattern[i];
+            uint64_t* masks;
+            if (c < 0x100)
+            {
+                masks = p.latin1 + c * p.blocks;
+            }
+            else
+            {
+                unsigned slot = EditPattern::Hash(c) & p.slotMask;
+                while (p.slotChars[slot] && p.slotChars[slot] != c)
+                    slot = (slot + 1) & p.slotMask;
+                p.slotChars[slot] = c;
+                masks = p.slotMasks + slot * p.blocks;
+            }
+            masks[i / 64] |= 1ull << (i % 64);
+        }
+    }
+
+    __forceinline int Bounded(int distance, int maxDistance)
+    {
+        return maxDistance >= 0 && distance > maxDistance ? maxDistance + 1 : distance;
+    }
+
+    // patterns of 64 chars or less, a single word
+    int DistanceWord(const EditPattern& p, const wchar_t* text, int length, int maxDistance)
+    {
+        const uint64_t high = 1ull << (p.length - 1);
+        uint64_t pv = ~0ull;
+        uint64_t mv = 0;
+        int score = p.length;
+        for (int j = 0; j < length; ++j)
+        {
+            const uint64_t eq = p.Masks(text[j])[0];
+            const uint64_t xv = eq | mv;
+            const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+            score += (ph & high) != 0;
+            score -= (mh & high) != 0;
+
+            // the first row is the text index, every char add 1
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+
+            // each remaining char lower the score by 1 at most
+            if (maxDistance >= 0 && score - (length - 1 - j) > maxDistance)
+                return maxDistance + 1;
+        }
+        return Bounded(score, maxDistance);
+    }
+
+    // a word per 64 chars block, the horizontal delta of the block last row carry to the next block
+    int DistanceBlocks(const EditPattern& p, const wchar_t* text, int length, int maxDistance)
+    {
+        const int blocks = p.blocks;
+        const uint64_t high = 1ull << ((p.length - 1) % 64);
+        std::vector<uint64_t> state(2 * blocks);
+        uint64_t* pvs = &state[0];
+        uint64_t* mvs = pvs + blocks;
+        for (int b = 0; b < blocks; ++b)
+            pvs[b] = ~0ull;
+
+        int score = p.length;
+        for (int j = 0; j < length; ++j)
+        {
+            const uint64_t* eqs = p.Masks(text[j]);
+            int carry = 1;
+            for (int b = 0; b < blocks; ++b)
+            {
+                uint64_t eq = eqs[b];
+                const uint64_t pv = pvs[b];
+                const uint64_t mv = mvs[b];
+                const uint64_t xv = eq | mv;
+                if (carry < 0)
+                    eq |= 1;
+                const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+                uint64_t ph = mv | ~(xh | pv);
+                uint64_t mh = pv & xh;
+
+                const uint64_t last = b == blocks - 1 ? high : 1ull << 63;
+                const int out = (ph & last) ? 1 : (mh & last) ? -1 : 0;
+                ph <<= 1;
+                mh <<= 1;
+                if (carry < 0)
+                    mh |= 1;
+                else if (carry > 0)
+                    ph |= 1;
+                pvs[b] = mh | ~(xv | ph);
+                mvs[b] = ph & xv;
+                carry = out;
+            }
+            score += carry;
+
+            if (maxDistance >= 0 && score - (length - 1 - j) > maxDistance)
+                return maxDistance + 1;
+        }
+        return Bounded(score, maxDistance);
+    }
+
+    int Distance(const EditPattern& p, const wchar_t* text, int length, int maxDistance)
+    {
+        const int difference = p.length > length ? p.length - length : length - p.length;
+        if (maxDistance >= 0 && difference > maxDistance)
+            return maxDistance + 1;
+        if (!p.length)
+            return Bounded(length, maxDistance);
+        return p.blocks == 1 ? DistanceWord(p, text, length, maxDistance) : DistanceBlocks(p, text, length, maxDistance);
+    }
+
+    // a text per 64 bits lane
+    template<typename Isa> struct EditLanes;
+
+    template<> struct EditLanes<Sse2>
+    {
+        typedef __m128i Vector;
+        static const int Count = 2;
+
+        static __forceinline Vector Make(uint64_t a0, uint64_t a1, uint64_t, uint64_t) { return _mm_set_epi64x((int64_t)a1, (int64_t)a0); }
+        static __forceinline void Store(uint64_t* a, Vector v) { _mm_storeu_si128((__m128i*)a, v); }
+        static __forceinline Vector Set(uint64_t v) { return _mm_set1_epi64x((int64_t)v); }
+        static __forceinline Vector And(Vector a, Vector b) { return _mm_and_si128(a, b); }
+        static __forceinline Vector Or(Vector a, Vector b) { return _mm_or_si128(a, b); }
+        static __forceinline Vector Xor(Vector a, Vector b) { return _mm_xor_si128(a, b); }
+        static __forceinline Vector AndNot(Vector a, Vector b) { return _mm_andnot_si128(a, b); }
+        static __forceinline Vector Add(Vector a, Vector b) { return _mm_add_epi64(a, b); }
+        static __forceinline Vector Sub(Vector a, Vector b) { return _mm_sub_epi64(a, b); }
+        static __forceinline Vector ShiftLeft1(Vector v) { return _mm_slli_epi64(v, 1); }
+        static __forceinline Vector ShiftRight(Vector v, __m128i count) { return _mm_srl_epi64(v, count); }
+    };
+
+    template<> struct EditLanes<Avx2>
+    {
+        typedef __m256i Vector;
+        static const int Count = 4;
+
+        static __forceinline Vector Make(uint64_t a0, uint64_t a1, uint64_t a2, uint64_t a3) { return _mm256_set_epi64x((int64_t)a3, (int64_t)a2, (int64_t)a1, (int64_t)a0); }
+        static __forceinline void Store(uint64_t* a, Vector v) { _mm256_storeu_si256((__m256i*)a, v); }
+        static __forceinline Vector Set(uint64_t v) { return _mm256_set1_epi64x((int64_t)v); }
+        static __forceinline Vector And(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+        static __forceinline Vector Or(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+        static __forceinline Vector Xor(Vector a, Vector b) { return _mm256_xor_si256(a, b); }
+        static __forceinline Vector AndNot(Vector a, Vector b) { return _mm256_andnot_si256(a, b); }
+        static __forceinline Vector Add(Vector a, Vector b) { return _mm256_add_epi64(a, b); }
+        static __forceinline Vector Sub(Vector a, Vector b) { return _mm256_sub_epi64(a, b); }
+        static __forceinline Vector ShiftLeft1(Vector v) { return _mm256_slli_epi64(v, 1); }
+        static __forceinline Vector ShiftRight(Vector v, __m128i count) { return _mm256_srl_epi64(v, count); }
+    };
+
+    // pattern positions of the lane char, 0 past the lane end or for lanes the vector doesn't have
+    template<class L>
+    __forceinline uint64_t LaneMask(const EditPattern& p, const wchar_t* const* text, const int* length, int lane, int j, bool masked)
+    {
+        if (lane >= L::Count || (masked && j >= length[lane]))
+            return 0;
+        return p.Masks(text[lane][j])[0];
+    }
+
+    template<class L>
+    __forceinline uint64_t LaneActive(const int* length, int lane, int j)
+    {
+        return lane < L::Count && j < length[lane] ? ~0ull : 0;
+    }
+
+    // the texts of the lanes at index, DistanceWord on all lanes at once. lanes past their text end keep
+    // their state, the loop stop when every lane score is above maxDistance
+    template<class L>
+    void DistanceLanes(const EditPattern& p, const wchar_t* const* texts, const int* lengths, const int* index, int lanes, int maxDistance, int* distances)
+    {
+        typedef typename L::Vector Vector;
+        const wchar_t* text[L::Count];
+        int length[L::Count];
+        int shortest = INT_MAX;
+        int longest = 0;
+        for (int k = 0; k < L::Count; ++k)
+        {
+            // missing lanes repeat the first text, their results are dropped
+            const int i = index[k < lanes ? k : 0];
+            text[k] = texts[i];
+            length[k] = lengths[i];
+            shortest = length[k] < shortest ? length[k] : shortest;
+            longest = length[k] > longest ? length[k] : longest;
+        }
+
+        const Vector ones = L::Set(~0ull);
+        const Vector one = L::Set(1);
+        const Vector high = L::Set(1ull << (p.length - 1));
+        const __m128i highShift = _mm_cvtsi32_si128(p.length - 1);
+        Vector pv = ones;
+        Vector mv = L::Set(0);
+        Vector score = L::Set((uint64_t)p.length);
+        for (int j = 0; j < longest; ++j)
+        {
+            // lanes past their end take no char until the longest text end. the masks are built from
+            // registers, a vector load of just stored lanes would stall on the store forwarding
+            const bool masked = j >= shortest;
+            const Vector e = L::Make(LaneMask<L>(p, text, length, 0, j, masked), LaneMask<L>(p, text, length, 1, j, masked), LaneMask<L>(p, text, length, 2, j, masked), LaneMask<L>(p, text, length, 3, j, masked));
+            const Vector xv = L::Or(e, mv);
+            const Vector xh = L::Or(L::Xor(L::Add(L::And(e, pv), pv), pv), e);
+            Vector ph = L::Or(mv, L::AndNot(L::Or(xh, pv), ones));
+            Vector mh = L::And(pv, xh);
+            Vector nextScore = L::Sub(L::Add(score, L::ShiftRight(L::And(ph, high), highShift)), L::ShiftRight(L::And(mh, high), highShift));
+
+            ph = L::Or(L::ShiftLeft1(ph), one);
+            mh = L::ShiftLeft1(mh);
+            Vector nextPv = L::Or(mh, L::AndNot(L::Or(xv, ph), ones));
+            Vector nextMv = L::And(ph, xv);
+
+            if (masked)
+            {
+                const Vector a = L::Make(LaneActive<L>(length, 0, j), LaneActive<L>(length, 1, j), LaneActive<L>(length, 2, j), LaneActive<L>(length, 3, j));
+                nextPv = L::Or(L::And(a, nextPv), L::AndNot(a, pv));
+                nextMv = L::Or(L::And(a, nextMv), L::AndNot(a, mv));
+                nextScore = L::Or(L::And(a, nextScore), L::AndNot(a, score));
+            }
+            pv = nextPv;
+            mv = nextMv;
+            score = nextScore;
+
+            if (maxDistance >= 0 && (j & 3) == 3)
+            {
+                uint64_t scores[L::Count];
+                L::Store(scores, score);
+                bool above = true;
+                for (int k = 0; k < L::Count && above; ++k)
+                    above = (int)scores[k] - (length[k] > j ? length[k] - 1 - j : 0) > maxDistance;
+                if (above)
+                    break;
+            }
+        }
+
+        uint64_t scores[L::Count];
+        L::Store(scores, score);
+        for (int k = 0; k < lanes; ++k)
+            distances[index[k]] = Bounded((int)scores[k], maxDistance);
+    }
+
+    int CountWithin(const int* distances, int count, int maxDistance)
+    {
+        if (maxDistance < 0)
+            return count;
+        int within = 0;
+        for (int i = 0; i < count; ++i)
+            within += distances[i] <= maxDistance;
+        return within;
+    }
+
+    template<class L>
+    int DistanceBatch(const EditPattern* pattern, const wchar_t* const* texts, const int* lengths, int count, int maxDistance, int* distances)
+    {
+        if (pattern->blocks != 1)
+            return StrEditDistanceBatch_CPP(pattern, texts, lengths, count, maxDistance, distances);
+
+        // the texts the length difference doesn't reject fill the lanes
+        int index[L::Count];
+        int lanes = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const int difference = pattern->length > lengths[i] ? pattern->length - lengths[i] : lengths[i] - pattern->length;
+            if (maxDistance >= 0 && difference > maxDistance)
+            {
+                distances[i] = maxDistance + 1;
+                continue;
+            }
+
+            index[lanes++] = i;
+            if (lanes == L::Count)
+            {
+                DistanceLanes<L>(*pattern, texts, lengths, index, lanes, maxDistance, distances);
+                lanes = 0;
+            }
+        }
+        if (lanes)
+            DistanceLanes<L>(*pattern, texts, lengths, index, lanes, maxDistance, distances);
+        return CountWithin(distances, count, maxDistance);
+    }
+}
+
+EditPattern* StrEditPatternCreate(const wchar_t* pattern, int length)
+{
+    EditPattern* p = new EditPattern();
+    int slots = 2;
+    while (slots < 2 * length)
+        slots *= 2;
+
+    const int blocks = (length + 63) / 64;
+    p->masks.assign((256 + slots + 1) * (size_t)blocks + 1, 0);
+    p->chars.assign(slots, 0);
+    p->latin1 = &p->masks[0];
+    p->slotMasks = p->latin1 + 256 * blocks;
+    p->slotChars = &p->chars[0];
+    Build(*p, pattern, length, slots);
+    return p;
+}
+
+void StrEditPatternFree(EditPattern* pattern)
+{
+    delete pattern;
+}
+
+int StrEditDistance(const wchar_t* a, int lengthA, const wchar_t* b, int lengthB, int maxDistance)
+{
+    // the shorter string is the pattern, without the common prefix and suffix
+    if (lengthA > lengthB)
+    {
+        const wchar_t* s = a;
+        a = b;
+        b = s;
+        const int length = lengthA;
+        lengthA = lengthB;
+        lengthB = length;
+    }
+    while (lengthA && *a == *b)
+    {
+        ++a;
+        ++b;
+        --lengthA;
+        --lengthB;
+    }
+    while (lengthA && a[lengthA - 1] == b[lengthB - 1])
+    {
+        --lengthA;
+        --lengthB;
+    }
+
+    if (lengthA > 64)
+    {
+        EditPattern* pattern = StrEditPatternCreate(a, lengthA);
+        const int distance = Distance(*pattern, b, lengthB, maxDistance);
+        StrEditPatternFree(pattern);
+        return distance;
+    }
+
+    uint64_t latin1[256];
+    wchar_t slotChars[SmallSlots];
+    uint64_t slotMasks[SmallSlots + 1];
+    memset(latin1, 0, sizeof(latin1));
+    memset(slotChars, 0, sizeof(slotChars));
+    memset(slotMasks, 0, sizeof(slotMasks));
+
+    EditPattern pattern;
+    pattern.latin1 = latin1;
+    pattern.slotChars = slotChars;
+    pattern.slotMasks = slotMasks;
+    Build(pattern, a, lengthA, SmallSlots);
+    return Distance(pattern, b, lengthB, maxDistance);
+}
+
+int StrEditDistance(const EditPattern* pattern, const wchar_t* text, int length, int maxDistance)
+{
+    return Distance(*pattern, text, length, maxDistance);
+}
+
+int StrEditDistanceBatch(const EditPattern* pattern, const wchar_t* const* texts, const int* lengths, int count, int maxDistance, int* distances)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrEditDistanceBatch_AVX2(pattern, texts, lengths, count, maxDistance, distances);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return StrEditDistanceBatch_SSE2(pattern, texts, lengths, count, maxDistance, distances);
+    return StrEditDistanceBatch_CPP(pattern, texts, lengths, count, maxDistance, distances);
+}
+
+int StrEditDistanceBatch_SSE2(const EditPattern* pattern, const wchar_t* const* texts, const int* lengths, int count, int maxDistance, int* distances)
+{
+    return DistanceBatch<EditLanes<Sse2> >(pattern, texts, lengths, count, maxDistance, distances);
+}
+
+int StrEditDistanceBatch_AVX2(const EditPattern* pattern, const wchar_t* const* texts, const int* lengths, int count, int maxDistance, int* distances)
+{
+    return DistanceBatch<EditLanes<Avx2> >(pattern, texts, lengths, count, maxDistance, distances);
+}
+
+int StrEditDistanceBatch_CPP(const EditPattern* pattern, const wchar_t* const* texts, const int* lengths, int count, int maxDistance, int* distances)
+{
+    for (int i = 0; i < count; ++i)
+        distances[i] = Distance(*pattern, texts[i], lengths[i], maxDistance);
+    return CountWithin(distances, count, maxDistance);
+}
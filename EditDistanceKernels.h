@@ -0,0 +1,57 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// unmanaged edit distance kernels, compiled without /clr like StringKernels
+//
+// levenshtein distance (insert, delete and substitute cost 1) with the Myers / Hyyro bit-parallel
+// algorithm: a column of the distance matrix is 64 pattern chars per word, updated with a few
+// logical ops and an add per text char. longer patterns run one word per 64 chars block with the
+// carries passed between the blocks.
+// maxDistance < 0 is unbounded. bounded kernels return maxDistance + 1 as soon as the distance can't
+// be maxDistance or less: the length difference exceed it, or the current score minus the remaining
+// text chars does.
+// batch kernels score one pattern of 64 chars or less against several texts, a text per 64 bits
+// lane. longer patterns score the texts one at a time. the kernels without suffix pick one from the
+// cpu features.
+
+#include <stdint.h>
+
+// compiled pattern: the positions of each pattern char in 64 bits masks
+struct EditPattern;
+
+EditPattern* StrEditPatternCreate(const wchar_t* pattern, int length);
+
+void StrEditPatternFree(EditPattern* pattern);
+
+int StrEditDistance(const wchar_t* a, int lengthA, const wchar_t* b, int lengthB, int maxDistance);
+
+int StrEditDistance(const EditPattern* pattern, const wchar_t* text, int length, int maxDistance);
+
+// distances[i] of pattern to texts[i], returns the texts within maxDistance
+int StrEditDistanceBatch(const EditPattern* pattern, const wchar_t* const* texts, const int* lengths, int count, int maxDistance, int* distances);
+
+int StrEditDistanceBatch_SSE2(const EditPattern* pattern, const wchar_t* const* texts, const int* lengths, int count, int maxDistance, int* distances);
+
+int StrEditDistanceBatch_AVX2(const EditPattern* pattern, const wchar_t* const* texts, const int* lengths, int count, int maxDistance, int* distances);
+
+int StrEditDistanceBatch_CPP(const EditPattern* pattern, const wchar_t* const* texts, const int* lengths, int count, int maxDistance, int* distances);
@@ -0,0 +1,395 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "GlobPattern.h"
+
+#include <vcclr.h>          // cli/c++ pinning
+#include "Tuning.h"         // crossover table
+
+#pragma managed
+
+using namespace System::Collections::Generic;
+
+static const int RunLiteral = 0;
+static const int RunAny = 1;
+static const int RunSet = 2;
+
+static bool IsAsciiLetter(wchar_t c)
+{
+    return (unsigned)((c | 0x20) - L'a') < 26u;
+}
+
+static wchar_t FoldCase(wchar_t c, bool ignoreCase)
+{
+    return ignoreCase && (unsigned)(c - L'A') < 26u ? (wchar_t)(c | 0x20) : c;
+}
+
+namespace Intrinsics
+{
+    GlobPattern::GlobPattern()
+    {
+        Tuning::Initialize();
+    }
+
+    GlobPattern::GlobPattern(System::String ^ pattern)
+        : pattern_(pattern), ignoreCase_(false)
+    {
+        Compile();
+    }
+
+    GlobPattern::GlobPattern(System::String ^ pattern, bool ignoreCase)
+        : pattern_(pattern), ignoreCase_(ignoreCase)
+    {
+        Compile();
+    }
+
+    void __clrcall GlobPattern::Compile()
+    {
+        System::String ^ pattern = pattern_;
+        const bool ignoreCase = ignoreCase_;
+        if (pattern == nullptr)
+            throw gcnew ArgumentNullException("pattern is null");
+
+        List<Run>^ runs = gcnew List<Run>();
+        List<Segment>^ segments = gcnew List<Segment>();
+        List<wchar_t>^ literals = gcnew List<wchar_t>();
+        List<wchar_t>^ anchors = gcnew List<wchar_t>();
+        List<Set>^ sets = gcnew List<Set>();
+        List<UInt64>^ setBits = gcnew List<UInt64>();
+        List<wchar_t>^ setRanges = gcnew List<wchar_t>();
+        array<UInt64>^ required = gcnew array<UInt64>(4);
+        int minLength = 0;
+        bool star = false;
+
+        Segment segment = Segment();
+        for (int i = 0; i <= pattern->Length; ++i)
+        {
+            const wchar_t c = i < pattern->Length ? pattern[i] : L'*';
+            if (c == L'*')
+            {
+                // the segment is complete, its anchor is the first char of its longest literal
+                segment.RunCount = runs->Count - segment.FirstRun;
+                segment.Anchor = -1;
+                segment.AnchorChars = 0;
+                wchar_t anchor = 0;
+                int offset = 0;
+                int longest = 0;
+                for (int r = segment.FirstRun; r < runs->Count; ++r)
+                {
+                    const Run run = runs[r];
+                    if (run.Kind == RunLiteral && run.Length > longest)
+                    {
+                        longest = run.Length;
+                        anchor = literals[run.Start];
+                        segment.Anchor = offset;
+                        segment.AnchorChars = ignoreCase && IsAsciiLetter(anchor) ? 2 : 1;
+                    }
+                    offset += run.Length;
+                }
+                anchors->Add(anchor);
+                anchors->Add((wchar_t)(anchor ^ 0x20));
+                segments->Add(segment);
+                minLength += segment.Length;
+
+                if (i < pattern->Length)
+                    star = true;
+                while (i + 1 < pattern->Length && pattern[i + 1] == L'*')
+                    ++i;
+                segment = Segment();
+                segment.FirstRun = runs->Count;
+                continue;
+            }
+
+            Run run = Run();
+            run.Length = 1;
+            if (c == L'?')
+            {
+                run.Kind = RunAny;
+                if (runs->Count > segment.FirstRun && runs[runs->Count - 1].Kind == RunAny)
+                {
+                    run.Length += runs[runs->Count - 1].Length;
+                    runs->RemoveAt(runs->Count - 1);
+                }
+            }
+            else if (c == L'[')
+            {
+                Set set = Set();
+                set.FirstRange = setRanges->Count / 2;
+                int j = i + 1;
+                if (j < pattern->Length && (pattern[j] == L'!' || pattern[j] == L'^'))
+                {
+                    set.Negated = true;
+                    ++j;
+                }
+
+                UInt64 bits[2] = { 0, 0 };
+                for (bool first = true; j < pattern->Length && (pattern[j] != L']' || first); first = false)
+                {
+                    const wchar_t low = pattern[j];
+                    wchar_t high = low;
+                    if (j + 2 < pattern->Length && pattern[j + 1] == L'-' && pattern[j + 2] != L']')
+                    {
+                        high = pattern[j + 2];
+                        j += 3;
+                    }
+                    else
+                    {
+                        ++j;
+                    }
+
+                    setRanges->Add(low);
+                    setRanges->Add(high);
+                    for (int a = low; a <= high && a < 0x80; ++a)
+                    {
+                        bits[a >> 6] |= 1ull << (a & 63);
+                        if (ignoreCase && IsAsciiLetter((wchar_t)a))
+                            bits[(a ^ 0x20) >> 6] |= 1ull << ((a ^ 0x20) & 63);
+                    }
+                }
+                if (j >= pattern->Length)
+                    throw gcnew ArgumentException(System::String::Format(L"pattern has an unclosed set at {0}", i));
+
+                set.RangeCount = setRanges->Count / 2 - set.FirstRange;
+                run.Kind = RunSet;
+                run.Start = sets->Count;
+                sets->Add(set);
+                setBits->Add(bits[0]);
+                setBits->Add(bits[1]);
+                i = j;
+            }
+            else
+            {
+                run.Kind = RunLiteral;
+                run.Start = literals->Count;
+                literals->Add(c);
+                if (c < 0x100)
+                {
+                    const wchar_t folded = FoldCase(c, ignoreCase);
+                    required[folded >> 6] |= 1ull << (folded & 63);
+                }
+                if (runs->Count > segment.FirstRun && runs[runs->Count - 1].Kind == RunLiteral)
+                {
+                    run.Start = runs[runs->Count - 1].Start;
+                    run.Length += runs[runs->Count - 1].Length;
+                    runs->RemoveAt(runs->Count - 1);
+                }
+            }
+            runs->Add(run);
+            segment.Length += 1;
+        }
+
+        // arrays aren't empty so they can always be pinned
+        literals->Add(0);
+        setRanges->Add(0);
+        star_ = star;
+        minLength_ = minLength;
+        required_ = required;
+        runs_ = runs->ToArray();
+        segments_ = segments->ToArray();
+        literals_ = literals->ToArray();
+        anchors_ = anchors->ToArray();
+        sets_ = sets->ToArray();
+        setBits_ = setBits->ToArray();
+        setRanges_ = setRanges->ToArray();
+    }
+
+    bool __clrcall GlobPattern::IsMatch(System::String ^ str)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        return Match(pinStr, str->Length);
+    }
+
+    bool __clrcall GlobPattern::IsMatch(const wchar_t* str, int length)
+    {
+        if (str == nullptr && length)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (length < 0)
+            throw gcnew ArgumentOutOfRangeException(L"length must be greater or equal to 0");
+
+        return Match(str, length);
+    }
+
+    bool __clrcall GlobPattern::Match(const wchar_t* str, int length)
+    {
+        if (length < minLength_)
+            return false;
+
+        pin_ptr<wchar_t> pinLiterals = &literals_[0];
+        const wchar_t* literals = pinLiterals;
+        const int last = segments_->Length - 1;
+        if (!star_)
+            return length == minLength_ && MatchAt(0, str, literals);
+
+        // minLength_ keep the prefix and the suffix apart
+        const int end = length - segments_[last].Length;
+        if (!MatchAt(0, str, literals) || !MatchAt(last, str + end, literals))
+            return false;
+
+        pin_ptr<wchar_t> pinAnchors = &anchors_[0];
+        int startIndex = segments_[0].Length;
+        for (int i = 1; i < last; ++i)
+        {
+            const int index = Find(i, str, startIndex, end, literals, pinAnchors);
+            if (index < 0)
+                return false;
+            startIndex = index + segments_[i].Length;
+        }
+        return true;
+    }
+
+    bool __clrcall GlobPattern::MatchAt(int segment, const wchar_t* str, const wchar_t* literals)
+    {
+        const Segment s = segments_[segment];
+        for (int r = s.FirstRun; r < s.FirstRun + s.RunCount; ++r)
+        {
+            const Run run = runs_[r];
+            if (run.Kind == RunLiteral)
+            {
+                if (StrCommonPrefixTier(TuningSelect(TuningCommonPrefix, 1, run.Length), str, literals + run.Start, run.Length, ignoreCase_) != run.Length)
+                    return false;
+            }
+            else if (run.Kind == RunSet && !InSet(run.Start, *str))
+            {
+                return false;
+            }
+            str += run.Length;
+        }
+        return true;
+    }
+
+    // leftmost index of the segment in [startIndex, end[, -1 when not found
+    int __clrcall GlobPattern::Find(int segment, const wchar_t* str, int startIndex, int end, const wchar_t* literals, const wchar_t* anchors)
+    {
+        const Segment s = segments_[segment];
+        const int last = end - s.Length;
+        for (int index = startIndex; index <= last; ++index)
+        {
+            if (s.Anchor >= 0)
+            {
+                const int count = last - index + 1;
+                const int found = StrIndexOfAnyTier(TuningSelect(TuningIndexOfAny, s.AnchorChars, count), str, anchors + 2 * segment, s.AnchorChars, index + s.Anchor, count);
+                if (found < 0)
+                    return -1;
+                index = found - s.Anchor;
+            }
+
+            if (MatchAt(segment, str + index, literals))
+                return index;
+        }
+        return -1;
+    }
+
+    bool __clrcall GlobPattern::InSet(int set, wchar_t c)
+    {
+        const Set s = sets_[set];
+        bool found = false;
+        if (c < 0x80)
+        {
+            found = ((setBits_[2 * set + (c >> 6)] >> (c & 63)) & 1) != 0;
+        }
+        else
+        {
+            for (int r = s.FirstRange; r < s.FirstRange + s.RangeCount && !found; ++r)
+                found = c >= setRanges_[2 * r] && c <= setRanges_[2 * r + 1];
+        }
+        return found != s.Negated;
+    }
+
+    GlobPatternSet::GlobPatternSet()
+    {
+        Tuning::Initialize();
+    }
+
+    GlobPatternSet::GlobPatternSet(array<System::String ^>^ patterns, bool ignoreCase)
+        : ignoreCase_(ignoreCase)
+    {
+        if (patterns == nullptr)
+            throw gcnew ArgumentNullException("patterns is null");
+
+        patterns_ = gcnew array<GlobPattern^>(patterns->Length);
+        for (int i = 0; i < patterns->Length; ++i)
+            patterns_[i] = gcnew GlobPattern(patterns[i], ignoreCase);
+    }
+
+    void __clrcall GlobPatternSet::Present(const wchar_t* str, int length, UInt64* present)
+    {
+        present[0] = present[1] = present[2] = present[3] = 0;
+        for (int i = 0; i < length; ++i)
+        {
+            const wchar_t c = FoldCase(str[i], ignoreCase_);
+            if (c < 0x100)
+                present[c >> 6] |= 1ull << (c & 63);
+        }
+    }
+
+    bool __clrcall GlobPatternSet::MayMatch(GlobPattern^ pattern, int length, const UInt64* present)
+    {
+        array<UInt64>^ required = pattern->required_;
+        return length >= pattern->minLength_ &&
+            !(required[0] & ~present[0]) && !(required[1] & ~present[1]) && !(required[2] & ~present[2]) && !(required[3] & ~present[3]);
+    }
+
+    int __clrcall GlobPatternSet::IndexOfMatch(System::String ^ str)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        UInt64 present[4];
+        Present(pinStr, str->Length, present);
+        for (int i = 0; i < patterns_->Length; ++i)
+        {
+            if (MayMatch(patterns_[i], str->Length, present) && patterns_[i]->Match(pinStr, str->Length))
+                return i;
+        }
+        return -1;
+    }
+
+    int __clrcall GlobPatternSet::Match(System::String ^ str, array<int>^% matches)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        UInt64 present[4];
+        Present(pinStr, str->Length, present);
+        int count = 0;
+        for (int i = 0; i < patterns_->Length; ++i)
+        {
+            if (!MayMatch(patterns_[i], str->Length, present) || !patterns_[i]->Match(pinStr, str->Length))
+                continue;
+
+            if (matches == nullptr || matches->Length <= count)
+            {
+                array<int>^ grown = gcnew array<int>(count < 8 ? 8 : count * 2);
+                if (count)
+                    System::Array::Copy(matches, grown, count);
+                matches = grown;
+            }
+            matches[count++] = i;
+        }
+        return count;
+    }
+}
@@ -0,0 +1,158 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+using namespace System;
+
+namespace Intrinsics
+{
+    // compiled glob pattern: '*' match any chars (including none), '?' any single char and [set] one char
+    // of the set, like [abc], [a-z] or [!0-9] (or [^0-9]) for the other chars. a ']' first in a set is
+    // one of its chars and '*', '?' or '[' in a set are literal. ignoreCase fold the ascii letters only,
+    // like the String compares.
+    // the pattern is split in segments between the '*'. the first and last segments are matched at both
+    // ends of the string, the others are found in order at their leftmost position: the vector IndexOfAny
+    // kernels jump to the first char of their longest literal and the String compares check the literals,
+    // so there is no backtracking. a pattern is immutable once compiled, it can be shared across threads
+    // and a match doesn't allocate.
+    public ref class GlobPattern sealed
+    {
+    public:
+        // throw ArgumentException on an unclosed set
+        GlobPattern(System::String ^ pattern);
+
+        GlobPattern(System::String ^ pattern, bool ignoreCase);
+
+        property System::String ^ Pattern
+        {
+            System::String ^ get() { return pattern_; }
+        }
+
+        property bool IgnoreCase
+        {
+            bool get() { return ignoreCase_; }
+        }
+
+        // the whole string must match
+        bool __clrcall IsMatch(System::String ^ str);
+
+        [CLSCompliant(false)]
+        bool __clrcall IsMatch(const wchar_t* str, int length);
+
+        virtual System::String ^ __clrcall ToString() override { return pattern_; }
+
+    internal:
+        // matched chars count without the '*', and the chars below 0x100 the string must have: the literals
+        // folded like the string when ignoreCase is set, 4 words of 64 bits. set once by Compile
+        int minLength_;
+        array<UInt64>^ required_;
+
+        bool __clrcall Match(const wchar_t* str, int length);
+
+    private:
+        // install the crossover table before the first search, see Tuning
+        static GlobPattern();
+
+        value struct Run
+        {
+            int Kind;           // RunLiteral, RunAny or RunSet
+            int Start;          // literal chars index or set index
+            int Length;         // chars matched
+        };
+
+        value struct Segment
+        {
+            int FirstRun;
+            int RunCount;
+            int Length;
+            int Anchor;         // offset of the first char of the longest literal, -1 without literal
+            int AnchorChars;    // 1, or 2 with the other case of an ascii letter
+        };
+
+        value struct Set
+        {
+            int FirstRange;
+            int RangeCount;
+            bool Negated;
+        };
+
+        // split pattern_ in runs and segments
+        void __clrcall Compile();
+
+        bool __clrcall MatchAt(int segment, const wchar_t* str, const wchar_t* literals);
+
+        int __clrcall Find(int segment, const wchar_t* str, int startIndex, int end, const wchar_t* literals, const wchar_t* anchors);
+
+        bool __clrcall InSet(int set, wchar_t c);
+
+        System::String ^ pattern_;
+        bool ignoreCase_;
+        bool star_;
+
+        array<Run>^ runs_;
+        array<Segment>^ segments_;
+        array<wchar_t>^ literals_;
+        array<wchar_t>^ anchors_;      // 2 chars per segment
+
+        // chars below 0x80 in 2 words per set, the others are checked against the ranges
+        array<Set>^ sets_;
+        array<UInt64>^ setBits_;
+        array<wchar_t>^ setRanges_;    // first and last char of each range
+    };
+
+    // one string matched against many patterns. the chars of the string are collected once and the
+    // patterns with a literal char the string doesn't have are skipped without running their match
+    public ref class GlobPatternSet sealed
+    {
+    public:
+        GlobPatternSet(array<System::String ^>^ patterns, bool ignoreCase);
+
+        property int Count
+        {
+            int get() { return patterns_->Length; }
+        }
+
+        property GlobPattern^ default[int]
+        {
+            GlobPattern^ get(int index) { return patterns_[index]; }
+        }
+
+        // index of the first pattern matching str, -1 when none
+        int __clrcall IndexOfMatch(System::String ^ str);
+
+        // indices of the patterns matching str in increasing order, matches grow when too small. returns
+        // the matches count
+        int __clrcall Match(System::String ^ str, array<int>^% matches);
+
+    private:
+        // install the crossover table before the first search, see Tuning
+        static GlobPatternSet();
+
+        // the chars below 0x100 of str, folded like the patterns
+        void __clrcall Present(const wchar_t* str, int length, UInt64* present);
+
+        bool __clrcall MayMatch(GlobPattern^ pattern, int length, const UInt64* present);
+
+        initonly array<GlobPattern^>^ patterns_;
+        initonly bool ignoreCase_;
+    };
+}
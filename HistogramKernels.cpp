@@ -0,0 +1,134 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "HistogramKernels.h"
+#include "InstructionSet.h"
+#include "KernelIsa.h"
+
+#include <string.h>         // memset
+
+namespace
+{
+    // below that zeroing and merging the sub-histograms cost more than the store conflicts
+    const int InterleaveLength = 256;
+
+    __forceinline void CountChar(uint32_t* counts, wchar_t c, int& other, wchar_t*& others)
+    {
+        if (c < 0x100)
+        {
+            ++counts[c];
+            return;
+        }
+        ++other;
+        if (others)
+            *others++ = c;
+    }
+
+    int CountChars(const wchar_t* str, int length, uint32_t* counts, wchar_t* others)
+    {
+        int other = 0;
+        for (int i = 0; i < length; ++i)
+            CountChar(counts, str[i], other, others);
+        counts[256] += other;
+        return other;
+    }
+
+    // the 4 sub-histograms summed in counts
+    void Merge(uint32_t (*sub)[256], uint32_t* counts, int other)
+    {
+        for (int c = 0; c < 256; ++c)
+            counts[c] += sub[0][c] + sub[1][c] + sub[2][c] + sub[3][c];
+        counts[256] += other;
+    }
+
+    template<class Isa>
+    int Histogram(const wchar_t* str, int length, uint32_t* counts, wchar_t* others)
+    {
+        if (length < InterleaveLength)
+            return CountChars(str, length, counts, others);
+
+        uint32_t sub[4][256];
+        memset(sub, 0, sizeof(sub));
+
+        const typename Isa::Vector high = Isa::Set(0xff00);
+        const wchar_t* s = str;
+        const wchar_t* end = str + length;
+        int other = 0;
+        for (; end - s >= Isa::Length; s += Isa::Length)
+        {
+            if (Isa::Mask(Isa::Equal(Isa::And(Isa::LoadUnaligned(s), high), Isa::Zero())) == Isa::MaskAll)
+            {
+                for (int i = 0; i < Isa::Length; i += 4)
+                {
+                    ++sub[0][s[i]];
+                    ++sub[1][s[i + 1]];
+                    ++sub[2][s[i + 2]];
+                    ++sub[3][s[i + 3]];
+                }
+                continue;
+            }
+
+            for (int i = 0; i < Isa::Length; ++i)
+                CountChar(sub[i & 3], s[i], other, others);
+        }
+
+        for (int i = 0; s < end; ++s, ++i)
+            CountChar(sub[i & 3], *s, other, others);
+
+        Merge(sub, counts, other);
+        return other;
+    }
+}
+
+int StrHistogram(const wchar_t* str, int length, uint32_t* counts, wchar_t* others)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrHistogram_AVX2(str, length, counts, others);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return StrHistogram_SSE2(str, length, counts, others);
+    return StrHistogram_CPP(str, length, counts, others);
+}
+
+int StrHistogram_SSE2(const wchar_t* str, int length, uint32_t* counts, wchar_t* others)
+{
+    return Histogram<Sse2>(str, length, counts, others);
+}
+
+int StrHistogram_AVX2(const wchar_t* str, int length, uint32_t* counts, wchar_t* others)
+{
+    return Histogram<Avx2>(str, length, counts, others);
+}
+
+int StrHistogram_CPP(const wchar_t* str, int length, uint32_t* counts, wchar_t* others)
+{
+    if (length < InterleaveLength)
+        return CountChars(str, length, counts, others);
+
+    uint32_t sub[4][256];
+    memset(sub, 0, sizeof(sub));
+
+    int other = 0;
+    for (int i = 0; i < length; ++i)
+        CountChar(sub[i & 3], str[i], other, others);
+
+    Merge(sub, counts, other);
+    return other;
+}
@@ -0,0 +1,43 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// unmanaged char histogram kernels, compiled without /clr like StringKernels
+//
+// counts has 257 elements: the chars below 0x100 are added to counts[c] and the others to counts[256].
+// the chars are counted in 4 interleaved sub-histograms so repeated chars don't wait on the store of
+// the previous increment. vector kernels check a vector at a time that all its chars are below 0x100,
+// those are counted without a branch and the other vectors take the per char path.
+// others, when not null, receive the chars above 0xff in order and must have room for length chars.
+// returns the count of those chars. the kernels without suffix pick one from the cpu features.
+
+#include <stdint.h>
+
+static const int HistogramLength = 257;
+
+int StrHistogram(const wchar_t* str, int length, uint32_t* counts, wchar_t* others);
+
+int StrHistogram_SSE2(const wchar_t* str, int length, uint32_t* counts, wchar_t* others);
+
+int StrHistogram_AVX2(const wchar_t* str, int length, uint32_t* counts, wchar_t* others);
+
+int StrHistogram_CPP(const wchar_t* str, int length, uint32_t* counts, wchar_t* others);
@@ -1,5 +1,255 @@
 
 #include "InstructionSet.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 // Initialize static member data  
 const InstructionSet::InstructionSet_Internal InstructionSet::CPU_Rep;
+
+namespace
+{
+    // cpuid leaf 4 and 0x8000001D share the same layout
+    bool DecodeCacheLeaf(const std::array<int, 4>& cpui, InstructionSet::Cache& cache)
+    {
+        const unsigned eax = (unsigned)cpui[0];
+        const unsigned ebx = (unsigned)cpui[1];
+        const unsigned ecx = (unsigned)cpui[2];
+
+        int type = eax & 0x1f;
+        if (type < InstructionSet::Cache::Data || type > InstructionSet::Cache::Unified)
+            return false;
+
+        cache.level = (eax >> 5) & 0x7;
+        cache.type = (InstructionSet::Cache::Type)type;
+        cache.sharedBy = ((eax >> 14) & 0xfff) + 1;
+        cache.lineSize = (ebx & 0xfff) + 1;
+        cache.ways = ((ebx >> 22) & 0x3ff) + 1;
+        const uint64_t partitions = ((ebx >> 12) & 0x3ff) + 1;
+        const uint64_t sets = (uint64_t)ecx + 1;
+        cache.size = (uint64_t)cache.ways * partitions * cache.lineSize * sets;
+        return true;
+    }
+
+#ifdef __linux__
+    bool ReadSysFile(const char* path, char* buffer, size_t size)
+    {
+        FILE* file = fopen(path, "r");
+        if (!file)
+            return false;
+        size_t length = fread(buffer, 1, size - 1, file);
+        fclose(file);
+        buffer[length] = 0;
+        return length != 0;
+    }
+
+    long ReadSysNumber(const char* path)
+    {
+        char buffer[64];
+        return ReadSysFile(path, buffer, sizeof(buffer)) ? strtol(buffer, nullptr, 10) : -1;
+    }
+
+    // "0-3,8,10-11" -> 7
+    int CountCpuList(const char* list)
+    {
+        int count = 0;
+        while (*list)
+        {
+            char* end;
+            long first = strtol(list, &end, 10);
+            if (end == list)
+                break;
+            long last = first;
+            if (*end == '-')
+                last = strtol(end + 1, &end, 10);
+            count += (int)(last - first + 1);
+            list = *end == ',' ? end + 1 : end;
+        }
+        return count;
+    }
+#endif
+}
+
+void InstructionSet::InstructionSet_Internal::DetectCaches()
+{
+    std::array<int, 4> cpui;
+
+    if (isIntel_ && nIds_ >= 4)
+    {
+        for (int i = 0;; ++i)
+        {
+            Cache cache;
+            __cpuidex(cpui.data(), 4, i);
+            if (!DecodeCacheLeaf(cpui, cache))
+                break;
+            caches_.push_back(cache);
+        }
+    }
+    else if (isAMD_ && nExIds_ >= (int)0x8000001D && f_81_ECX_[22])   // TOPOEXT
+    {
+        for (int i = 0;; ++i)
+        {
+            Cache cache;
+            __cpuidex(cpui.data(), 0x8000001D, i);
+            if (!DecodeCacheLeaf(cpui, cache))
+                break;
+            caches_.push_back(cache);
+        }
+    }
+
+#ifdef __linux__
+    // hypervisors often hide the cache leaves
+    if (caches_.empty())
+    {
+        for (int i = 0;; ++i)
+        {
+            char path[128];
+            char buffer[64];
+            sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/type", i);
+            if (!ReadSysFile(path, buffer, sizeof(buffer)))
+                break;
+
+            Cache cache;
+            cache.type = buffer[0] == 'D' ? Cache::Data : buffer[0] == 'I' ? Cache::Instruction : Cache::Unified;
+
+            sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/level", i);
+            cache.level = (int)ReadSysNumber(path);
+
+            // "32K"
+            sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/size", i);
+            cache.size = 0;
+            if (ReadSysFile(path, buffer, sizeof(buffer)))
+            {
+                char* unit;
+                cache.size = strtoull(buffer, &unit, 10);
+                if (*unit == 'K')
+                    cache.size <<= 10;
+                else if (*unit == 'M')
+                    cache.size <<= 20;
+            }
+
+            sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/coherency_line_size", i);
+            cache.lineSize = (int)ReadSysNumber(path);
+
+            sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/ways_of_associativity", i);
+            cache.ways = (int)ReadSysNumber(path);
+
+            sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/shared_cpu_list", i);
+            cache.sharedBy = ReadSysFile(path, buffer, sizeof(buffer)) ? CountCpuList(buffer) : 1;
+
+            if (cache.level > 0 && cache.size)
+                caches_.push_back(cache);
+        }
+    }
+#endif
+
+    for (size_t i = 0; i < caches_.size(); ++i)
+    {
+        lastLevel_ = std::max(lastLevel_, caches_[i].level);
+        if (caches_[i].level == 1 && caches_[i].type != Cache::Instruction && caches_[i].lineSize > 0)
+            cacheLineSize_ = caches_[i].lineSize;
+    }
+}
+
+void InstructionSet::InstructionSet_Internal::DetectTopology()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    logicalProcessors_ = (int)info.dwNumberOfProcessors;
+#else
+    logicalProcessors_ = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (logicalProcessors_ < 1)
+        logicalProcessors_ = 1;
+
+    std::array<int, 4> cpui;
+    int threadsPerCore = 0;
+
+    // extended topology, sub-leaf level type 1 is SMT, ebx the logical processors count at that level
+    int topologyLeaf = nIds_ >= 0x1f ? 0x1f : nIds_ >= 0xb ? 0xb : 0;
+    if (topologyLeaf)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            __cpuidex(cpui.data(), topologyLeaf, i);
+            int levelType = (cpui[2] >> 8) & 0xff;
+            if (levelType == 0)
+                break;
+            if (levelType == 1)
+                threadsPerCore = cpui[1] & 0xffff;
+        }
+    }
+
+    if (!threadsPerCore && isAMD_ && nExIds_ >= (int)0x8000001E && f_81_ECX_[22])
+    {
+        __cpuid(cpui.data(), 0x8000001E);
+        threadsPerCore = ((cpui[1] >> 8) & 0xff) + 1;
+    }
+
+    // the cores are counted, not derived from threadsPerCore: hybrid cpus have cores without SMT
+    int physicalCores = 0;
+#ifdef _WIN32
+    DWORD bytes = 0;
+    if (!GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &bytes) && GetLastError() == ERROR_INSUFFICIENT_BUFFER)
+    {
+        std::vector<char> buffer(bytes);
+        if (GetLogicalProcessorInformationEx(RelationProcessorCore, (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)buffer.data(), &bytes))
+        {
+            // one variable size entry per core
+            for (DWORD offset = 0; offset < bytes; offset += ((PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)&buffer[offset])->Size)
+                ++physicalCores;
+        }
+    }
+#endif
+
+#ifdef __linux__
+    // count distinct (package, core) pairs, exact even with SMT disabled on some cores. offline cpus
+    // have no topology
+    std::set<std::pair<long, long> > cores;
+    const int configured = std::max(logicalProcessors_, (int)sysconf(_SC_NPROCESSORS_CONF));
+    for (int cpu = 0; cpu < configured; ++cpu)
+    {
+        char path[128];
+        sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+        long core = ReadSysNumber(path);
+        sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        long package = ReadSysNumber(path);
+        if (core < 0)
+            continue;
+        cores.insert(std::make_pair(package, core));
+    }
+    if (!cores.empty())
+    {
+        physicalCores = (int)cores.size();
+        if (!threadsPerCore)
+            threadsPerCore = (logicalProcessors_ + physicalCores - 1) / physicalCores;
+    }
+#endif
+
+    threadsPerCore_ = threadsPerCore > 0 ? threadsPerCore : 1;
+    // logicalProcessors_ is the processor group count on windows, the core list span every group
+    physicalCores_ = physicalCores > 0 ? std::min(physicalCores, logicalProcessors_) : std::max(1, logicalProcessors_ / threadsPerCore_);
+}
+
+void InstructionSet::InstructionSet_Internal::DetectPolicy()
+{
+    // half of L2 for the input, the other half for the results and the caller working set
+    const uint64_t l2 = CacheSize(2);
+    const uint64_t chunk = l2 ? l2 / 2 : 128 * 1024;
+    chunkSize_ = (int)std::max<uint64_t>(16 * 1024, std::min<uint64_t>(chunk, 4 * 1024 * 1024) & ~(uint64_t)4095);
+
+    const uint64_t llc = CacheSize(lastLevel_);
+    nonTemporalThreshold_ = llc ? llc : 8 * 1024 * 1024;
+}
@@ -2,12 +2,18 @@
 
 // https://msdn.microsoft.com/en-us/library/hskdteyh.aspx
 
+#include <intrin.h>
+#include <immintrin.h>  // _xgetbv
+#include <stdint.h>
+#include <cstring>
 #include <vector>  
 #include <bitset>  
 #include <array>  
 #include <string>  
 
+#ifdef _MANAGED
 #pragma unmanaged
+#endif
 
 class InstructionSet
 {
@@ -15,6 +21,83 @@ class InstructionSet
     class InstructionSet_Internal;
 
 public:
+    // usable instruction sets, reported by cpuid and for AVX / AVX-512 also enabled by the OS in XCR0.
+    // precomputed once, test Features() instead of the getters in hot paths
+    enum Feature : uint64_t
+    {
+        FeatureSSE2 = 1ull << 0,
+        FeatureSSE3 = 1ull << 1,
+        FeatureSSSE3 = 1ull << 2,
+        FeatureSSE41 = 1ull << 3,
+        FeatureSSE42 = 1ull << 4,
+        FeaturePOPCNT = 1ull << 5,
+        FeatureAVX = 1ull << 6,
+        FeatureAVX2 = 1ull << 7,
+        FeatureFMA = 1ull << 8,
+        FeatureF16C = 1ull << 9,
+        FeatureBMI1 = 1ull << 10,
+        FeatureBMI2 = 1ull << 11,
+        FeatureLZCNT = 1ull << 12,
+        FeatureMOVBE = 1ull << 13,
+        FeatureAES = 1ull << 14,
+        FeaturePCLMULQDQ = 1ull << 15,
+        FeatureSHA = 1ull << 16,
+        FeatureERMS = 1ull << 17,
+
+        FeatureAVX512F = 1ull << 20,
+        FeatureAVX512DQ = 1ull << 21,
+        FeatureAVX512CD = 1ull << 22,
+        FeatureAVX512BW = 1ull << 23,
+        FeatureAVX512VL = 1ull << 24,
+        FeatureAVX512VBMI = 1ull << 25,
+        FeatureAVX512VBMI2 = 1ull << 26,
+        FeatureAVX512VNNI = 1ull << 27,
+        FeatureAVX512BITALG = 1ull << 28,
+        FeatureAVX512VPOPCNTDQ = 1ull << 29,
+
+        FeatureVAES = 1ull << 32,
+        FeatureVPCLMULQDQ = 1ull << 33,
+        FeatureGFNI = 1ull << 34,
+        FeatureAVXVNNI = 1ull << 35,
+    };
+
+    static uint64_t Features(void) { return CPU_Rep.features_; }
+    static bool Supports(uint64_t features) { return (CPU_Rep.features_ & features) == features; }
+
+    // cache descriptor from cpuid leaf 4 (intel) or 0x8000001D (amd), /sys/devices/system/cpu on linux otherwise
+    struct Cache
+    {
+        enum Type { Data = 1, Instruction = 2, Unified = 3 };
+
+        int level;
+        Type type;
+        uint64_t size;      // bytes
+        int lineSize;       // bytes
+        int ways;
+        int sharedBy;       // logical processors sharing this cache
+    };
+
+    static const std::vector<Cache>& Caches(void) { return CPU_Rep.caches_; }
+
+    // data or unified cache size of a level, 0 when unknown
+    static uint64_t CacheSize(int level) { return CPU_Rep.CacheSize(level); }
+    static uint64_t L1DataCacheSize(void) { return CPU_Rep.CacheSize(1); }
+    static uint64_t L2CacheSize(void) { return CPU_Rep.CacheSize(2); }
+    static uint64_t LastLevelCacheSize(void) { return CPU_Rep.CacheSize(CPU_Rep.lastLevel_); }
+    static int CacheLineSize(void) { return CPU_Rep.cacheLineSize_; }
+
+    // topology from cpuid leaf 0x1F / 0xB (0x8000001E on amd), /sys/devices/system/cpu on linux otherwise
+    static int LogicalProcessors(void) { return CPU_Rep.logicalProcessors_; }
+    static int ThreadsPerCore(void) { return CPU_Rep.threadsPerCore_; }
+    static int PhysicalCores(void) { return CPU_Rep.physicalCores_; }
+
+    // scans split in chunks of this size (bytes) stay in L2 with room left for the results
+    static int ChunkSize(void) { return CPU_Rep.chunkSize_; }
+    // inputs larger than this (bytes) don't fit in the last level cache, read them non-temporal
+    static uint64_t NonTemporalThreshold(void) { return CPU_Rep.nonTemporalThreshold_; }
+    // parallel scans use one worker per physical core, SMT siblings share the same vector units
+    static int WorkerCount(void) { return CPU_Rep.physicalCores_; }
+
     // getters  
     static std::string Vendor(void) { return CPU_Rep.vendor_; }
     static std::string Brand(void) { return CPU_Rep.brand_; }
@@ -23,7 +106,7 @@ public:
     static bool PCLMULQDQ(void) { return CPU_Rep.f_1_ECX_[1]; }
     static bool MONITOR(void) { return CPU_Rep.f_1_ECX_[3]; }
     static bool SSSE3(void) { return CPU_Rep.f_1_ECX_[9]; }
-    static bool FMA(void) { return CPU_Rep.f_1_ECX_[12]; }
+    static bool FMA(void) { return CPU_Rep.osAvx_ && CPU_Rep.f_1_ECX_[12]; }
     static bool CMPXCHG16B(void) { return CPU_Rep.f_1_ECX_[13]; }
     static bool SSE41(void) { return CPU_Rep.f_1_ECX_[19]; }
     static bool SSE42(void) { return CPU_Rep.f_1_ECX_[20]; }
@@ -32,8 +115,8 @@ public:
     static bool AES(void) { return CPU_Rep.f_1_ECX_[25]; }
     static bool XSAVE(void) { return CPU_Rep.f_1_ECX_[26]; }
     static bool OSXSAVE(void) { return CPU_Rep.f_1_ECX_[27]; }
-    static bool AVX(void) { return CPU_Rep.f_1_ECX_[28]; }
-    static bool F16C(void) { return CPU_Rep.f_1_ECX_[29]; }
+    static bool AVX(void) { return CPU_Rep.osAvx_ && CPU_Rep.f_1_ECX_[28]; }
+    static bool F16C(void) { return CPU_Rep.osAvx_ && CPU_Rep.f_1_ECX_[29]; }
     static bool RDRAND(void) { return CPU_Rep.f_1_ECX_[30]; }
 
     static bool MSR(void) { return CPU_Rep.f_1_EDX_[5]; }
@@ -49,20 +132,38 @@ public:
     static bool FSGSBASE(void) { return CPU_Rep.f_7_EBX_[0]; }
     static bool BMI1(void) { return CPU_Rep.f_7_EBX_[3]; }
     static bool HLE(void) { return CPU_Rep.isIntel_ && CPU_Rep.f_7_EBX_[4]; }
-    static bool AVX2(void) { return CPU_Rep.f_7_EBX_[5]; }
+    static bool AVX2(void) { return CPU_Rep.osAvx_ && CPU_Rep.f_7_EBX_[5]; }
     static bool BMI2(void) { return CPU_Rep.f_7_EBX_[8]; }
     static bool ERMS(void) { return CPU_Rep.f_7_EBX_[9]; }
     static bool INVPCID(void) { return CPU_Rep.f_7_EBX_[10]; }
     static bool RTM(void) { return CPU_Rep.isIntel_ && CPU_Rep.f_7_EBX_[11]; }
-    static bool AVX512F(void) { return CPU_Rep.f_7_EBX_[16]; }
+    static bool AVX512F(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_EBX_[16]; }
+    static bool AVX512DQ(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_EBX_[17]; }
     static bool RDSEED(void) { return CPU_Rep.f_7_EBX_[18]; }
     static bool ADX(void) { return CPU_Rep.f_7_EBX_[19]; }
-    static bool AVX512PF(void) { return CPU_Rep.f_7_EBX_[26]; }
-    static bool AVX512ER(void) { return CPU_Rep.f_7_EBX_[27]; }
-    static bool AVX512CD(void) { return CPU_Rep.f_7_EBX_[28]; }
+    static bool AVX512PF(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_EBX_[26]; }
+    static bool AVX512ER(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_EBX_[27]; }
+    static bool AVX512CD(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_EBX_[28]; }
     static bool SHA(void) { return CPU_Rep.f_7_EBX_[29]; }
+    static bool AVX512BW(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_EBX_[30]; }
+    static bool AVX512VL(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_EBX_[31]; }
 
     static bool PREFETCHWT1(void) { return CPU_Rep.f_7_ECX_[0]; }
+    static bool AVX512VBMI(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_ECX_[1]; }
+    static bool AVX512VBMI2(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_ECX_[6]; }
+    static bool GFNI(void) { return CPU_Rep.f_7_ECX_[8]; }
+    static bool VAES(void) { return CPU_Rep.osAvx_ && CPU_Rep.f_7_ECX_[9]; }
+    static bool VPCLMULQDQ(void) { return CPU_Rep.osAvx_ && CPU_Rep.f_7_ECX_[10]; }
+    static bool AVX512VNNI(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_ECX_[11]; }
+    static bool AVX512BITALG(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_ECX_[12]; }
+    static bool AVX512VPOPCNTDQ(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_ECX_[14]; }
+
+    // leaf 7 sub-leaf 1
+    static bool AVXVNNI(void) { return CPU_Rep.osAvx_ && CPU_Rep.f_7_1_EAX_[4]; }
+    static bool AVX512BF16(void) { return CPU_Rep.osAvx512_ && CPU_Rep.f_7_1_EAX_[5]; }
+
+    // XCR0, OS enabled register states, 0 when XGETBV is not available
+    static uint64_t XCR0(void) { return CPU_Rep.xcr0_; }
 
     static bool LAHF(void) { return CPU_Rep.f_81_ECX_[0]; }
     static bool LZCNT(void) { return CPU_Rep.isIntel_ && CPU_Rep.f_81_ECX_[5]; }
@@ -92,10 +193,22 @@ private:
             f_1_EDX_{ 0 },
             f_7_EBX_{ 0 },
             f_7_ECX_{ 0 },
+            f_7_1_EAX_{ 0 },
             f_81_ECX_{ 0 },
             f_81_EDX_{ 0 },
             data_{},
-            extdata_{}
+            extdata_{},
+            xcr0_{ 0 },
+            osAvx_{ false },
+            osAvx512_{ false },
+            features_{ 0 },
+            lastLevel_{ 0 },
+            cacheLineSize_{ 64 },
+            logicalProcessors_{ 1 },
+            threadsPerCore_{ 1 },
+            physicalCores_{ 1 },
+            chunkSize_{ 0 },
+            nonTemporalThreshold_{ 0 }
         {
             //int cpuInfo[4] = {-1};  
             std::array<int, 4> cpui;
@@ -139,6 +252,22 @@ private:
             {
                 f_7_EBX_ = data_[7][1];
                 f_7_ECX_ = data_[7][2];
+
+                // eax is the highest sub-leaf
+                if (data_[7][0] >= 1)
+                {
+                    __cpuidex(cpui.data(), 7, 1);
+                    f_7_1_EAX_ = cpui[0];
+                }
+            }
+
+            // cpuid only tell the cpu support AVX, the OS must also save the YMM / ZMM state on
+            // context switch (hypervisors and containers can mask it)
+            if (f_1_ECX_[27])
+            {
+                xcr0_ = _xgetbv(0);
+                osAvx_ = (xcr0_ & 0x6) == 0x6;                  // XMM | YMM
+                osAvx512_ = osAvx_ && (xcr0_ & 0xe0) == 0xe0;   // opmask | ZMM_Hi256 | Hi16_ZMM
             }
 
             // Calling __cpuid with 0x80000000 as the function_id argument  
@@ -170,8 +299,83 @@ private:
                 memcpy(brand + 32, extdata_[4].data(), sizeof(cpui));
                 brand_ = brand;
             }
+
+            features_ = DetectFeatures();
+
+            DetectCaches();
+            DetectTopology();
+            DetectPolicy();
         };
 
+        // InstructionSet.cpp
+        void DetectCaches();
+        void DetectTopology();
+        void DetectPolicy();
+
+        uint64_t CacheSize(int level) const
+        {
+            for (size_t i = 0; i < caches_.size(); ++i)
+            {
+                if (caches_[i].level == level && caches_[i].type != Cache::Instruction)
+                    return caches_[i].size;
+            }
+            return 0;
+        }
+
+        uint64_t DetectFeatures() const
+        {
+            struct Bit { bool supported; uint64_t feature; };
+            const Bit bits[] =
+            {
+                { f_1_EDX_[26], FeatureSSE2 },
+                { f_1_ECX_[0], FeatureSSE3 },
+                { f_1_ECX_[9], FeatureSSSE3 },
+                { f_1_ECX_[19], FeatureSSE41 },
+                { f_1_ECX_[20], FeatureSSE42 },
+                { f_1_ECX_[23], FeaturePOPCNT },
+                { osAvx_ && f_1_ECX_[28], FeatureAVX },
+                { osAvx_ && f_7_EBX_[5], FeatureAVX2 },
+                { osAvx_ && f_1_ECX_[12], FeatureFMA },
+                { osAvx_ && f_1_ECX_[29], FeatureF16C },
+                { f_7_EBX_[3], FeatureBMI1 },
+                { f_7_EBX_[8], FeatureBMI2 },
+                { f_81_ECX_[5], FeatureLZCNT },
+                { f_1_ECX_[22], FeatureMOVBE },
+                { f_1_ECX_[25], FeatureAES },
+                { f_1_ECX_[1], FeaturePCLMULQDQ },
+                { f_7_EBX_[29], FeatureSHA },
+                { f_7_EBX_[9], FeatureERMS },
+
+                { osAvx512_ && f_7_EBX_[16], FeatureAVX512F },
+                { osAvx512_ && f_7_EBX_[17], FeatureAVX512DQ },
+                { osAvx512_ && f_7_EBX_[28], FeatureAVX512CD },
+                { osAvx512_ && f_7_EBX_[30], FeatureAVX512BW },
+                { osAvx512_ && f_7_EBX_[31], FeatureAVX512VL },
+                { osAvx512_ && f_7_ECX_[1], FeatureAVX512VBMI },
+                { osAvx512_ && f_7_ECX_[6], FeatureAVX512VBMI2 },
+                { osAvx512_ && f_7_ECX_[11], FeatureAVX512VNNI },
+                { osAvx512_ && f_7_ECX_[12], FeatureAVX512BITALG },
+                { osAvx512_ && f_7_ECX_[14], FeatureAVX512VPOPCNTDQ },
+
+                { osAvx_ && f_7_ECX_[9], FeatureVAES },
+                { osAvx_ && f_7_ECX_[10], FeatureVPCLMULQDQ },
+                { f_7_ECX_[8], FeatureGFNI },
+                { osAvx_ && f_7_1_EAX_[4], FeatureAVXVNNI },
+            };
+
+            uint64_t features = 0;
+            for (size_t i = 0; i < sizeof(bits) / sizeof(bits[0]); ++i)
+            {
+                if (bits[i].supported)
+                    features |= bits[i].feature;
+            }
+
+            // AVX-512 extensions are only usable on top of the foundation
+            if (!(features & FeatureAVX512F))
+                features &= ~(uint64_t)(FeatureAVX512DQ | FeatureAVX512CD | FeatureAVX512BW | FeatureAVX512VL | FeatureAVX512VBMI | FeatureAVX512VBMI2 | FeatureAVX512VNNI | FeatureAVX512BITALG | FeatureAVX512VPOPCNTDQ);
+            return features;
+        }
+
         int nIds_;
         int nExIds_;
         std::string vendor_;
@@ -182,10 +386,24 @@ private:
         std::bitset<32> f_1_EDX_;
         std::bitset<32> f_7_EBX_;
         std::bitset<32> f_7_ECX_;
+        std::bitset<32> f_7_1_EAX_;
         std::bitset<32> f_81_ECX_;
         std::bitset<32> f_81_EDX_;
         std::vector<std::array<int, 4>> data_;
         std::vector<std::array<int, 4>> extdata_;
+        uint64_t xcr0_;
+        bool osAvx_;
+        bool osAvx512_;
+        uint64_t features_;
+
+        std::vector<Cache> caches_;
+        int lastLevel_;
+        int cacheLineSize_;
+        int logicalProcessors_;
+        int threadsPerCore_;
+        int physicalCores_;
+        int chunkSize_;
+        uint64_t nonTemporalThreshold_;
     };
 };
 
@@ -0,0 +1,154 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "Instrumentation.h"
+
+#include <string.h>
+
+#ifdef INTRINSICS_INSTRUMENTATION
+
+#include <new>
+
+#ifdef _MSC_VER
+#define INSTRUMENTATION_THREAD_LOCAL __declspec(thread)
+#else
+#define INSTRUMENTATION_THREAD_LOCAL __thread
+#endif
+
+namespace
+{
+    struct ThreadBlock
+    {
+        InstrumentationSnapshot counters;
+        ThreadBlock* next;
+    };
+
+    // push only list, a block outlive its thread so the counts of finished threads are kept.
+    // lock free because it can be reached from dll initialization where locks are not safe.
+    ThreadBlock* volatile blocks = nullptr;
+
+    INSTRUMENTATION_THREAD_LOCAL ThreadBlock* threadBlock = nullptr;
+
+    ThreadBlock* ThreadBlockCreate()
+    {
+        ThreadBlock* block = new (std::nothrow) ThreadBlock;
+        if (!block)
+            return nullptr;
+        memset(block, 0, sizeof(ThreadBlock));
+
+        ThreadBlock* head;
+        do
+        {
+            head = blocks;
+            block->next = head;
+        }
+#ifdef _MSC_VER
+        while (_InterlockedCompareExchangePointer((void* volatile*)&blocks, block, head) != head);
+#else
+        while (__sync_val_compare_and_swap(&blocks, head, block) != head);
+#endif
+        return block;
+    }
+
+    // used when a block cannot be allocated, counts are lost but the kernels keep working
+    InstrumentationSnapshot overflow;
+
+    InstrumentationSnapshot& ThreadCounters()
+    {
+        ThreadBlock* block = threadBlock;
+        if (!block)
+        {
+            threadBlock = block = ThreadBlockCreate();
+            if (!block)
+                return overflow;
+        }
+        return block->counters;
+    }
+}
+
+InstrumentationCounters& InstrumentationThreadCounters(InstrumentationOperation operation, InstrumentationTier tier)
+{
+    return ThreadCounters().kernels[operation][tier];
+}
+
+void InstrumentationReallocation(InstrumentationOperation operation)
+{
+    ++ThreadCounters().reallocations[operation];
+}
+
+bool InstrumentationEnabled()
+{
+    return true;
+}
+
+void InstrumentationTake(InstrumentationSnapshot& snapshot)
+{
+    // counters are read while other threads update them, a snapshot can miss the calls in flight
+    memset(&snapshot, 0, sizeof(snapshot));
+    for (ThreadBlock* block = blocks; block; block = block->next)
+    {
+        for (int operation = 0; operation < InstrumentOperationCount; ++operation)
+        {
+            snapshot.reallocations[operation] += block->counters.reallocations[operation];
+
+            for (int tier = 0; tier < InstrumentTierCount; ++tier)
+            {
+                const InstrumentationCounters& from = block->counters.kernels[operation][tier];
+                InstrumentationCounters& to = snapshot.kernels[operation][tier];
+                to.calls += from.calls;
+                to.chars += from.chars;
+                to.matches += from.matches;
+                to.scalarChars += from.scalarChars;
+                to.vectorChars += from.vectorChars;
+                for (int i = 0; i < InstrumentationHistogramBuckets; ++i)
+                {
+                    to.lengthHistogram[i] += from.lengthHistogram[i];
+                    to.latencyHistogram[i] += from.latencyHistogram[i];
+                }
+            }
+        }
+    }
+}
+
+void InstrumentationReset()
+{
+    for (ThreadBlock* block = blocks; block; block = block->next)
+        memset(&block->counters, 0, sizeof(block->counters));
+}
+
+#else
+
+bool InstrumentationEnabled()
+{
+    return false;
+}
+
+void InstrumentationTake(InstrumentationSnapshot& snapshot)
+{
+    memset(&snapshot, 0, sizeof(snapshot));
+}
+
+void InstrumentationReset()
+{
+}
+
+#endif
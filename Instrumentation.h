@@ -0,0 +1,160 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// optional kernels instrumentation, compiled in only when INTRINSICS_INSTRUMENTATION is defined. Debug
+// builds define it, Release builds when the IntrinsicsInstrumentation msbuild property is true.
+//
+// every thread count in its own block, blocks are summed when a snapshot is taken, so the hot path
+// is a few non atomic increments. kernels use the INTRINSICS_PROBE* macros which expand to nothing
+// (or to their value argument) when instrumentation is disabled.
+
+#include <stdint.h>
+
+enum InstrumentationOperation
+{
+    InstrumentIndexOfAll,
+    InstrumentIndexOfAny,
+    InstrumentCommonPrefix,
+    InstrumentOperationCount
+};
+
+enum InstrumentationTier
+{
+    InstrumentCpp,
+    InstrumentSse2,
+    InstrumentAvx2,
+    InstrumentTierCount
+};
+
+// log2 buckets, bucket i count values in [2^(i-1), 2^i[, bucket 0 count 0
+static const int InstrumentationHistogramBuckets = 32;
+
+struct InstrumentationCounters
+{
+    uint64_t calls;
+    uint64_t chars;             // chars scanned
+    uint64_t matches;           // results emitted
+    uint64_t scalarChars;       // chars processed by the scalar head and tail loops
+    uint64_t vectorChars;       // chars processed by the vector loop
+    uint64_t lengthHistogram[InstrumentationHistogramBuckets];   // chars per call
+    uint64_t latencyHistogram[InstrumentationHistogramBuckets];  // time stamp counter cycles per call
+};
+
+struct InstrumentationSnapshot
+{
+    InstrumentationCounters kernels[InstrumentOperationCount][InstrumentTierCount];
+    uint64_t reallocations[InstrumentOperationCount];   // results buffer reallocated by the managed wrapper
+};
+
+// true when compiled with INTRINSICS_INSTRUMENTATION
+bool InstrumentationEnabled();
+
+// sum of every thread counters
+void InstrumentationTake(InstrumentationSnapshot& snapshot);
+
+void InstrumentationReset();
+
+#ifdef INTRINSICS_INSTRUMENTATION
+
+#include <intrin.h>
+
+InstrumentationCounters& InstrumentationThreadCounters(InstrumentationOperation operation, InstrumentationTier tier);
+
+void InstrumentationReallocation(InstrumentationOperation operation);
+
+// record one kernel call, the destructor account the call length and latency
+class InstrumentationProbe
+{
+public:
+    InstrumentationProbe(InstrumentationOperation operation, InstrumentationTier tier, int length)
+        : counters_(InstrumentationThreadCounters(operation, tier)), length_(length), vectorChars_(0), start_(__rdtsc())
+    {
+    }
+
+    ~InstrumentationProbe()
+    {
+        uint64_t latency = __rdtsc() - start_;
+        ++counters_.calls;
+        counters_.chars += length_;
+        counters_.vectorChars += vectorChars_;
+        counters_.scalarChars += length_ - vectorChars_;
+        ++counters_.lengthHistogram[Bucket((uint64_t)length_)];
+        ++counters_.latencyHistogram[Bucket(latency)];
+    }
+
+    void VectorChars(int64_t chars) { vectorChars_ += chars; }
+
+    int Matches(int matches)
+    {
+        counters_.matches += matches;
+        return matches;
+    }
+
+    // IndexOfAny stop at the first match, only account what was really scanned. the match vector was
+    // accounted whole, its chars after the match are not vector chars either
+    int Found(int index, int scanned)
+    {
+        ++counters_.matches;
+        length_ = scanned;
+        vectorChars_ = vectorChars_ < scanned ? vectorChars_ : scanned;
+        return index;
+    }
+
+private:
+    static int Bucket(uint64_t value)
+    {
+        int bucket = 0;
+        while (value && bucket < InstrumentationHistogramBuckets - 1)
+        {
+            value >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    InstrumentationProbe(const InstrumentationProbe&);
+    InstrumentationProbe& operator=(const InstrumentationProbe&);
+
+    InstrumentationCounters& counters_;
+    int64_t length_;
+    int64_t vectorChars_;
+    uint64_t start_;
+};
+
+#define INTRINSICS_PROBE(operation, tier, length) InstrumentationProbe probe_(Instrument##operation, Instrument##tier, length)
+#define INTRINSICS_PROBE_TIER(operation, tier, length) InstrumentationProbe probe_(Instrument##operation, tier, length)
+#define INTRINSICS_PROBE_VECTOR(chars) probe_.VectorChars(chars)
+#define INTRINSICS_PROBE_MATCHES(matches) probe_.Matches(matches)
+#define INTRINSICS_PROBE_FOUND(index, scanned) probe_.Found(index, scanned)
+#define INTRINSICS_PROBE_REALLOCATION(operation) InstrumentationReallocation(Instrument##operation)
+
+#else
+
+#define INTRINSICS_PROBE(operation, tier, length) ((void)0)
+#define INTRINSICS_PROBE_TIER(operation, tier, length) ((void)0)
+#define INTRINSICS_PROBE_VECTOR(chars) ((void)0)
+#define INTRINSICS_PROBE_MATCHES(matches) (matches)
+#define INTRINSICS_PROBE_FOUND(index, scanned) (index)
+#define INTRINSICS_PROBE_REALLOCATION(operation) ((void)0)
+
+#endif
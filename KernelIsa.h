@@ -0,0 +1,109 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// vector instruction sets traits the native kernels templates are instantiated for, Length chars
+// (16 bits lanes) per vector. only included by TUs compiled without /clr.
+
+#include "Instrumentation.h"
+
+#include <intrin.h>         // intrinsics
+#include <emmintrin.h>      // SSE2
+#include <immintrin.h>      // AVX2
+
+// the avx-512 intrinsics came with visual studio 2017, older toolsets only build the other tiers
+#if (defined(_MSC_VER) && _MSC_VER >= 1910) || defined(__AVX512F__)
+#define INTRINSICS_AVX512
+#endif
+
+namespace
+{
+    struct Sse2
+    {
+        typedef __m128i Vector;
+        static const int Length = 8;    // chars per vector
+        static const unsigned MaskAll = 0xffff;
+        static const InstrumentationTier Tier = InstrumentSse2;
+
+        static __forceinline Vector Zero() { return _mm_setzero_si128(); }
+        static __forceinline Vector Set(int c) { return _mm_set1_epi16((short)c); }
+        static __forceinline Vector Load(const wchar_t* s) { return _mm_load_si128((__m128i const *)s); }
+        static __forceinline Vector LoadUnaligned(const wchar_t* s) { return _mm_loadu_si128((__m128i const *)s); }
+        static __forceinline Vector Add(Vector a, Vector b) { return _mm_add_epi16(a, b); }
+        static __forceinline Vector Sub(Vector a, Vector b) { return _mm_sub_epi16(a, b); }
+        static __forceinline Vector MultiplyAdd(Vector a, Vector b) { return _mm_madd_epi16(a, b); }
+        static __forceinline Vector Equal(Vector a, Vector b) { return _mm_cmpeq_epi16(a, b); }
+        static __forceinline Vector Greater(Vector a, Vector b) { return _mm_cmpgt_epi16(a, b); }
+        static __forceinline Vector And(Vector a, Vector b) { return _mm_and_si128(a, b); }
+        static __forceinline Vector Or(Vector a, Vector b) { return _mm_or_si128(a, b); }
+        static __forceinline unsigned Mask(Vector v) { return (unsigned)_mm_movemask_epi8(v); }
+        static __forceinline void Store(short* store, Vector v) { _mm_storeu_si128((__m128i*)store, v); }
+        static __forceinline __m128i Low128(Vector v) { return v; }
+        static __forceinline __m128i High128(Vector v) { return v; }
+
+        // Length chars under 0x100 to Length bytes
+        static __forceinline void StoreNarrow(unsigned char* dst, Vector v) { _mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(v, v)); }
+
+        // 16 bytes zero extended to 16 chars
+        static __forceinline void StoreWide(wchar_t* dst, __m128i bytes)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            _mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi8(bytes, zero));
+            _mm_storeu_si128((__m128i*)(dst + 8), _mm_unpackhi_epi8(bytes, zero));
+        }
+    };
+
+    struct Avx2
+    {
+        typedef __m256i Vector;
+        static const int Length = 16;   // chars per vector
+        static const unsigned MaskAll = 0xffffffff;
+        static const InstrumentationTier Tier = InstrumentAvx2;
+
+        static __forceinline Vector Zero() { return _mm256_setzero_si256(); }
+        static __forceinline Vector Set(int c) { return _mm256_set1_epi16((short)c); }
+        static __forceinline Vector Load(const wchar_t* s) { return _mm256_load_si256((__m256i const *)s); }
+        static __forceinline Vector LoadUnaligned(const wchar_t* s) { return _mm256_loadu_si256((__m256i const *)s); }
+        static __forceinline Vector Add(Vector a, Vector b) { return _mm256_add_epi16(a, b); }
+        static __forceinline Vector Sub(Vector a, Vector b) { return _mm256_sub_epi16(a, b); }
+        static __forceinline Vector MultiplyAdd(Vector a, Vector b) { return _mm256_madd_epi16(a, b); }
+        static __forceinline Vector Equal(Vector a, Vector b) { return _mm256_cmpeq_epi16(a, b); }
+        static __forceinline Vector Greater(Vector a, Vector b) { return _mm256_cmpgt_epi16(a, b); }
+        static __forceinline Vector And(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+        static __forceinline Vector Or(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+        static __forceinline unsigned Mask(Vector v) { return (unsigned)_mm256_movemask_epi8(v); }
+        static __forceinline void Store(short* store, Vector v) { _mm256_storeu_si256((__m256i*)store, v); }
+        static __forceinline __m128i Low128(Vector v) { return _mm256_castsi256_si128(v); }
+        static __forceinline __m128i High128(Vector v) { return _mm256_extracti128_si256(v, 1); }
+
+        // packus work per 128 bits lane, gather the 2 packed quarters
+        static __forceinline void StoreNarrow(unsigned char* dst, Vector v)
+        {
+            _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0xd8)));
+        }
+
+        static __forceinline void StoreWide(wchar_t* dst, __m128i bytes) { _mm256_storeu_si256((__m256i*)dst, _mm256_cvtepu8_epi16(bytes)); }
+    };
+
+    // tag of the avx-512 traits, they are local to the kernels using them
+    struct Avx512 {};
+}
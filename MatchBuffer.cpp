@@ -0,0 +1,197 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "MatchBuffer.h"
+#include "Instrumentation.h"
+
+namespace Intrinsics
+{
+    MatchBuffer::MatchBuffer(array<String::MatchIndex >^ results)
+        : results_(results), count_(0)
+    {
+    }
+
+    MatchBuffer::~MatchBuffer()
+    {
+        MatchBufferPool::Return(this);
+    }
+
+    array<String::MatchIndex >^ MatchBuffer::Results::get()
+    {
+        if (results_ == nullptr)
+            throw gcnew ObjectDisposedException(L"MatchBuffer");
+        return results_;
+    }
+
+    void MatchBuffer::Grow(int minimumCapacity)
+    {
+        int capacity = Capacity;
+        int newCapacity = capacity > Int32::MaxValue / 2 ? Int32::MaxValue : capacity * 2;
+        if (newCapacity < minimumCapacity)
+            newCapacity = minimumCapacity;
+
+        array<String::MatchIndex >^ results = MatchBufferPool::RentArray(newCapacity);
+        System::Array::Copy(results_, results, count_);
+        MatchBufferPool::ReturnArray(results_);
+        results_ = results;
+
+        Interlocked::Increment(MatchBufferPool::grows_);
+        INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+    }
+
+    MatchBufferPool::MatchBufferPool()
+    {
+        shared_ = gcnew array<Stack<array<String::MatchIndex >^ >^ >(SizeClassCount);
+        for (int i = 0; i < SizeClassCount; ++i)
+            shared_[i] = gcnew Stack<array<String::MatchIndex >^ >(SharedPerClassMax);
+    }
+
+    int __clrcall MatchBufferPool::SizeClass(int capacity)
+    {
+        // smallest class that fit capacity, SizeClassCount if too large to be pooled
+        int sizeClass = 0;
+        for (int size = SizeClassMin; size < capacity && sizeClass < SizeClassCount; size <<= 1)
+            ++sizeClass;
+        return sizeClass;
+    }
+
+    MatchBuffer^ __clrcall MatchBufferPool::Rent(int minimumCapacity)
+    {
+        return gcnew MatchBuffer(RentArray(minimumCapacity));
+    }
+
+    void __clrcall MatchBufferPool::Return(MatchBuffer^ buffer)
+    {
+        if (buffer == nullptr)
+            throw gcnew ArgumentNullException("buffer is null");
+
+        // already returned
+        if (buffer->results_ == nullptr)
+            return;
+
+        ReturnArray(buffer->results_);
+        buffer->results_ = nullptr;
+        buffer->count_ = 0;
+    }
+
+    array<String::MatchIndex >^ __clrcall MatchBufferPool::RentArray(int minimumCapacity)
+    {
+        if (minimumCapacity < 0)
+            throw gcnew ArgumentOutOfRangeException(L"minimumCapacity must be greater or equal to 0");
+
+        Interlocked::Increment(rents_);
+
+        int sizeClass = SizeClass(minimumCapacity);
+        if (sizeClass == SizeClassCount)
+        {
+            Interlocked::Increment(misses_);
+            return gcnew array<String::MatchIndex >(minimumCapacity);
+        }
+
+        // thread cache first, no lock
+        array<array<String::MatchIndex >^ >^ cache = threadCache_;
+        if (cache != nullptr && cache[sizeClass] != nullptr)
+        {
+            array<String::MatchIndex >^ results = cache[sizeClass];
+            cache[sizeClass] = nullptr;
+            Interlocked::Increment(threadLocalHits_);
+            return results;
+        }
+
+        Stack<array<String::MatchIndex >^ >^ shared = shared_[sizeClass];
+        Monitor::Enter(shared);
+        try
+        {
+            if (shared->Count)
+                return shared->Pop();
+        }
+        finally
+        {
+            Monitor::Exit(shared);
+        }
+
+        Interlocked::Increment(misses_);
+        return gcnew array<String::MatchIndex >(SizeClassMin << sizeClass);
+    }
+
+    void __clrcall MatchBufferPool::ReturnArray(array<String::MatchIndex >^ results)
+    {
+        Interlocked::Increment(returns_);
+
+        // only exact size classes are pooled
+        int sizeClass = SizeClass(results->Length);
+        if (sizeClass == SizeClassCount || (SizeClassMin << sizeClass) != results->Length)
+        {
+            Interlocked::Increment(discards_);
+            return;
+        }
+
+        array<array<String::MatchIndex >^ >^ cache = threadCache_;
+        if (cache == nullptr)
+            threadCache_ = cache = gcnew array<array<String::MatchIndex >^ >(SizeClassCount);
+
+        if (cache[sizeClass] == nullptr)
+        {
+            cache[sizeClass] = results;
+            return;
+        }
+
+        Stack<array<String::MatchIndex >^ >^ shared = shared_[sizeClass];
+        Monitor::Enter(shared);
+        try
+        {
+            if (shared->Count < SharedPerClassMax)
+            {
+                shared->Push(results);
+                return;
+            }
+        }
+        finally
+        {
+            Monitor::Exit(shared);
+        }
+
+        Interlocked::Increment(discards_);
+    }
+
+    MatchBufferPool::Statistics __clrcall MatchBufferPool::GetStatistics()
+    {
+        Statistics statistics;
+        statistics.Rents = Interlocked::Read(rents_);
+        statistics.Returns = Interlocked::Read(returns_);
+        statistics.Misses = Interlocked::Read(misses_);
+        statistics.ThreadLocalHits = Interlocked::Read(threadLocalHits_);
+        statistics.Discards = Interlocked::Read(discards_);
+        statistics.Grows = Interlocked::Read(grows_);
+        return statistics;
+    }
+
+    void __clrcall MatchBufferPool::ResetStatistics()
+    {
+        Interlocked::Exchange(rents_, 0);
+        Interlocked::Exchange(returns_, 0);
+        Interlocked::Exchange(misses_, 0);
+        Interlocked::Exchange(threadLocalHits_, 0);
+        Interlocked::Exchange(discards_, 0);
+        Interlocked::Exchange(grows_, 0);
+    }
+}
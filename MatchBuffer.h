@@ -0,0 +1,118 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+#include "String.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Threading;
+
+namespace Intrinsics
+{
+    // IndexOfAll results rented from MatchBufferPool, dispose it to give the storage back to the pool.
+    // IndexOfAll overloads taking a MatchBuffer grow it from the actual matches count instead of
+    // allocating str->Length results up front.
+    public ref class MatchBuffer sealed
+    {
+    public:
+        ~MatchBuffer();
+
+        property array<String::MatchIndex >^ Results
+        {
+            array<String::MatchIndex >^ get();
+        }
+
+        property int Count
+        {
+            int get() { return count_; }
+        }
+
+        property int Capacity
+        {
+            int get() { return Results->Length; }
+        }
+
+    internal:
+        MatchBuffer(array<String::MatchIndex >^ results);
+
+        // at least double the capacity, keep the current results
+        void Grow(int minimumCapacity);
+
+        array<String::MatchIndex >^ results_;
+        int count_;
+    };
+
+    public ref class MatchBufferPool abstract sealed
+    {
+    public:
+
+        value struct Statistics
+        {
+        public:
+            Int64 Rents;            // buffers or arrays handed out
+            Int64 Returns;          // buffers or arrays given back
+            Int64 Misses;           // rents that had to allocate
+            Int64 ThreadLocalHits;  // rents served by the calling thread cache
+            Int64 Discards;         // returns dropped because the pool was full or the size is not pooled
+            Int64 Grows;            // MatchBuffer reallocations during a search
+        };
+
+        // size classes are powers of 2: SizeClassMin << [0, SizeClassCount[
+        literal int SizeClassMin = 64;
+        literal int SizeClassCount = 16;
+
+        // shared buffers kept per size class, on top of one buffer per class per thread
+        literal int SharedPerClassMax = 8;
+
+        static MatchBuffer^ __clrcall Rent(int minimumCapacity);
+
+        static void __clrcall Return(MatchBuffer^ buffer);
+
+        static Statistics __clrcall GetStatistics();
+
+        static void __clrcall ResetStatistics();
+
+    internal:
+        static array<String::MatchIndex >^ __clrcall RentArray(int minimumCapacity);
+
+        static void __clrcall ReturnArray(array<String::MatchIndex >^ results);
+
+        static Int64 grows_;
+
+    private:
+        static MatchBufferPool();
+
+        static int __clrcall SizeClass(int capacity);
+
+        [ThreadStatic]
+        static array<array<String::MatchIndex >^ >^ threadCache_;
+
+        static initonly array<Stack<array<String::MatchIndex >^ >^ >^ shared_;
+
+        static Int64 rents_;
+        static Int64 returns_;
+        static Int64 misses_;
+        static Int64 threadLocalHits_;
+        static Int64 discards_;
+    };
+}
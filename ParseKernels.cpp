@@ -0,0 +1,289 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "ParseKernels.h"
+#include "InstructionSet.h"
+#include "KernelIsa.h"
+
+namespace
+{
+    const uint64_t Pow10[20] =
+    {
+        1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+        10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull,
+        1000000000000000ull, 10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull
+    };
+
+    // powers of ten exactly representable as double
+    const double Pow10Double[23] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const uint64_t DoubleExactMax = 1ull << 53;
+
+    // 16 lanes off then 16 on, loaded at n the last n lanes of a 16 chars window are on
+    const short DigitLanes[32] =
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+    };
+
+    // multiply-add weights of the digits pairs
+    const short Tens[16] = { 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1 };
+
+    // below this many digits the scalar loop is faster than the vector setup
+    const int VectorDigitsMin = 4;
+
+    __forceinline bool ScalarDigits(const wchar_t* s, int n, uint64_t& value)
+    {
+        uint64_t v = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            const unsigned d = (unsigned)s[i] - L'0';
+            if (d > 9)
+                return false;
+            v = v * 10 + d;
+        }
+        value = v;
+        return true;
+    }
+
+    // the n (1 to 16) digits ending at end, the 16 chars before end are readable
+    template<class Isa>
+    __forceinline bool VectorDigits(const wchar_t* end, int n, uint64_t& value)
+    {
+        typedef typename Isa::Vector Vector;
+
+        const Vector zero = Isa::Set(L'0');
+        const Vector below = Isa::Set(-1);
+        const Vector above = Isa::Set(10);
+        const Vector tens = Isa::LoadUnaligned((const wchar_t*)Tens);
+
+        // 2 digits values, 0 to 99 in 32 bits lanes
+        __m128i pairs[2];
+        for (int i = 0; i < 16 / Isa::Length; ++i)
+        {
+            const Vector lanes = Isa::LoadUnaligned((const wchar_t*)DigitLanes + n + i * Isa::Length);
+            const Vector d = Isa::Sub(Isa::LoadUnaligned(end - 16 + i * Isa::Length), zero);
+            const Vector digit = Isa::And(Isa::Greater(d, below), Isa::Greater(above, d));
+            if (Isa::Mask(Isa::And(digit, lanes)) != Isa::Mask(lanes))
+                return false;
+
+            const Vector sums = Isa::MultiplyAdd(Isa::And(d, lanes), tens);
+            if (Isa::Length == 16)
+            {
+                pairs[0] = Isa::Low128(sums);
+                pairs[1] = Isa::High128(sums);
+            }
+            else
+                pairs[i] = Isa::Low128(sums);
+        }
+
+        // 4 digits values, then the 2 octets in the first 32 bits lanes
+        const __m128i quads = _mm_madd_epi16(_mm_packs_epi32(pairs[0], pairs[1]), _mm_set1_epi32(0x00010064));
+        const __m128i octets = _mm_madd_epi16(_mm_packs_epi32(quads, quads), _mm_set1_epi32(0x00012710));
+
+        const uint64_t high = (uint32_t)_mm_cvtsi128_si32(octets);
+        const uint64_t low = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(octets, 4));
+        value = high * 100000000ull + low;
+        return true;
+    }
+
+    // the n (0 to 19) digits at s, str is the string start
+    template<class Isa>
+    __forceinline bool Digits(const wchar_t* str, const wchar_t* s, int n, uint64_t& value)
+    {
+        if (n < VectorDigitsMin)
+            return ScalarDigits(s, n, value);
+
+        // digits above the last 16
+        uint64_t head = 0;
+        const int headLength = n > 16 ? n - 16 : 0;
+        if (headLength && !ScalarDigits(s, headLength, head))
+            return false;
+
+        const wchar_t* end = s + n;
+        wchar_t window[16];
+        if (end - str < 16)
+        {
+            // too close to the string start, the digits are copied at the end of a zero padded window
+            const int tail = n - headLength;
+            for (int i = 0; i < 16 - tail; ++i)
+                window[i] = L'0';
+            for (int i = 0; i < tail; ++i)
+                window[16 - tail + i] = end[i - tail];
+            end = window + 16;
+        }
+
+        uint64_t tail;
+        if (!VectorDigits<Isa>(end, n - headLength, tail))
+            return false;
+        value = head * Pow10[16] + tail;
+        return true;
+    }
+
+    struct ScalarIsa {};
+
+    template<class Isa>
+    __forceinline bool ParseDigits(const wchar_t* str, const wchar_t* s, int n, uint64_t& value)
+    {
+        return Digits<Isa>(str, s, n, value);
+    }
+
+    template<>
+    __forceinline bool ParseDigits<ScalarIsa>(const wchar_t*, const wchar_t* s, int n, uint64_t& value)
+    {
+        return ScalarDigits(s, n, value);
+    }
+
+    template<class Isa>
+    __forceinline bool ParseInt64(const wchar_t* str, const wchar_t* s, int n, int64_t& value)
+    {
+        const bool negative = n && s[0] == L'-';
+        if (negative)
+        {
+            ++s;
+            --n;
+        }
+
+        if (n < 1 || n > 19)
+            return false;
+
+        uint64_t v;
+        if (!ParseDigits<Isa>(str, s, n, v))
+            return false;
+
+        // -2^63 has no positive counterpart
+        if (v > (negative ? 0x8000000000000000ull : 0x7fffffffffffffffull))
+            return false;
+
+        value = negative ? (int64_t)(0 - v) : (int64_t)v;
+        return true;
+    }
+
+    template<class Isa>
+    __forceinline bool ParseDouble(const wchar_t* str, const wchar_t* s, int n, double& value)
+    {
+        const bool negative = n && s[0] == L'-';
+        if (negative)
+        {
+            ++s;
+            --n;
+        }
+
+        int integerLength = 0;
+        while (integerLength < n && s[integerLength] != L'.')
+            ++integerLength;
+
+        const int fractionLength = integerLength < n ? n - integerLength - 1 : 0;
+        if (integerLength + fractionLength == 0 || integerLength + fractionLength > 19 || fractionLength > 22)
+            return false;
+
+        uint64_t integer;
+        uint64_t fraction;
+        if (!ParseDigits<Isa>(str, s, integerLength, integer) || !ParseDigits<Isa>(str, s + integerLength + 1, fractionLength, fraction))
+            return false;
+
+        const uint64_t mantissa = integer * Pow10[fractionLength] + fraction;
+        if (mantissa > DoubleExactMax)
+            return false;
+
+        // the sign of a parsed zero changed between runtimes, the BCL decide it
+        if (!mantissa && negative)
+            return false;
+
+        const double v = (double)mantissa / Pow10Double[fractionLength];
+        value = negative ? -v : v;
+        return true;
+    }
+
+    template<class Isa>
+    int ParseInt64Ranges(const wchar_t* str, const int* ranges, int count, int64_t* values)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            if (!ParseInt64<Isa>(str, str + ranges[2 * i], ranges[2 * i + 1], values[i]))
+                return i;
+        }
+        return count;
+    }
+
+    template<class Isa>
+    int ParseDoubleRanges(const wchar_t* str, const int* ranges, int count, double* values)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            if (!ParseDouble<Isa>(str, str + ranges[2 * i], ranges[2 * i + 1], values[i]))
+                return i;
+        }
+        return count;
+    }
+}
+
+int StrParseInt64(const wchar_t* str, const int* ranges, int count, int64_t* values)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrParseInt64_AVX2(str, ranges, count, values);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return StrParseInt64_SSE2(str, ranges, count, values);
+    return StrParseInt64_CPP(str, ranges, count, values);
+}
+
+int StrParseInt64_SSE2(const wchar_t* str, const int* ranges, int count, int64_t* values)
+{
+    return ParseInt64Ranges<Sse2>(str, ranges, count, values);
+}
+
+int StrParseInt64_AVX2(const wchar_t* str, const int* ranges, int count, int64_t* values)
+{
+    return ParseInt64Ranges<Avx2>(str, ranges, count, values);
+}
+
+int StrParseInt64_CPP(const wchar_t* str, const int* ranges, int count, int64_t* values)
+{
+    return ParseInt64Ranges<ScalarIsa>(str, ranges, count, values);
+}
+
+int StrParseDouble(const wchar_t* str, const int* ranges, int count, double* values)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrParseDouble_AVX2(str, ranges, count, values);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return StrParseDouble_SSE2(str, ranges, count, values);
+    return StrParseDouble_CPP(str, ranges, count, values);
+}
+
+int StrParseDouble_SSE2(const wchar_t* str, const int* ranges, int count, double* values)
+{
+    return ParseDoubleRanges<Sse2>(str, ranges, count, values);
+}
+
+int StrParseDouble_AVX2(const wchar_t* str, const int* ranges, int count, double* values)
+{
+    return ParseDoubleRanges<Avx2>(str, ranges, count, values);
+}
+
+int StrParseDouble_CPP(const wchar_t* str, const int* ranges, int count, double* values)
+{
+    return ParseDoubleRanges<ScalarIsa>(str, ranges, count, values);
+}
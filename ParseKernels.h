@@ -0,0 +1,51 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// unmanaged number parsing kernels, compiled without /clr like StringKernels
+//
+// ranges hold count (start index, length) pairs of str, each range is one number. the kernels parse
+// the ranges in order and return how many they parsed, the range at the returned index has a form the
+// kernels don't take and is left to the caller (the BCL parse), it may be valid.
+// Int64 kernels take an optional '-' and 1 to 19 digits. Double kernels take an optional '-', digits
+// with an optional '.' and at most 19 digits when the value is exact: at most 2^53 once the dot is
+// removed and at most 22 fraction digits, the division by the power of ten is then correctly rounded.
+// vector kernels check and convert the last 16 digits at once: range compares, then multiply-add of
+// the digits pairs, quads and octets.
+
+#include <stdint.h>
+
+int StrParseInt64(const wchar_t* str, const int* ranges, int count, int64_t* values);
+
+int StrParseInt64_SSE2(const wchar_t* str, const int* ranges, int count, int64_t* values);
+
+int StrParseInt64_AVX2(const wchar_t* str, const int* ranges, int count, int64_t* values);
+
+int StrParseInt64_CPP(const wchar_t* str, const int* ranges, int count, int64_t* values);
+
+int StrParseDouble(const wchar_t* str, const int* ranges, int count, double* values);
+
+int StrParseDouble_SSE2(const wchar_t* str, const int* ranges, int count, double* values);
+
+int StrParseDouble_AVX2(const wchar_t* str, const int* ranges, int count, double* values);
+
+int StrParseDouble_CPP(const wchar_t* str, const int* ranges, int count, double* values);
@@ -0,0 +1,826 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "SortKernels.h"
+#include "InstructionSet.h"
+#include "KernelIsa.h"
+
+#include <nmmintrin.h>      // popcnt
+#include <string.h>         // memcpy
+#include <algorithm>        // std::sort
+#include <limits>
+#include <vector>
+
+namespace
+{
+    // permutevar8x32 controls moving the lanes <= pivot first and the lanes > pivot last, both in order,
+    // indexed by the mask of the lanes > pivot. 4 lanes of 64 bits move their pairs of 32 bits lanes.
+    struct PartitionTable
+    {
+        uint64_t lanes8[256];
+        uint64_t lanes4[16];
+
+        PartitionTable()
+        {
+            for (int mask = 0; mask < 256; ++mask)
+                lanes8[mask] = Controls(mask, 8, 1);
+            for (int mask = 0; mask < 16; ++mask)
+                lanes4[mask] = Controls(mask, 4, 2);
+        }
+
+        // lanes of width 32 bits lanes, one control byte per 32 bits lane
+        static uint64_t Controls(int mask, int lanes, int width)
+        {
+            uint64_t controls = 0;
+            int n = 0;
+            for (int greater = 0; greater < 2; ++greater)
+            {
+                for (int i = 0; i < lanes; ++i)
+                {
+                    if (((mask >> i) & 1) != greater)
+                        continue;
+                    for (int j = 0; j < width; ++j, ++n)
+                        controls |= (uint64_t)(i * width + j) << (8 * n);
+                }
+            }
+            return controls;
+        }
+    };
+
+    const PartitionTable Partitions;
+
+    __forceinline __m256i PartitionControl(const uint64_t* controls)
+    {
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)controls));
+    }
+
+    // Length keys per Vector, compares return a bit per lane. Blend take the lanes of b where bits are
+    // set and Swap exchange the lanes at distance (a power of 2 below Length). PartitionStore write the
+    // lanes <= pivot at left and the lanes > pivot ending at right, it returns the count of the later.
+    template<typename Isa, typename T> struct SortLanes;
+
+    template<> struct SortLanes<Avx2, int32_t>
+    {
+        typedef __m256i Vector;
+        static const int Length = 8;
+
+        static __forceinline Vector Load(const int32_t* a) { return _mm256_loadu_si256((const __m256i*)a); }
+        static __forceinline void Store(int32_t* a, Vector v) { _mm256_storeu_si256((__m256i*)a, v); }
+        static __forceinline Vector Set(int32_t v) { return _mm256_set1_epi32(v); }
+        static __forceinline unsigned Greater(Vector a, Vector b) { return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b))); }
+        static __forceinline Vector Min(Vector a, Vector b) { return _mm256_min_epi32(a, b); }
+        static __forceinline Vector Max(Vector a, Vector b) { return _mm256_max_epi32(a, b); }
+        static __forceinline Vector Blend(Vector a, Vector b, unsigned bits)
+        {
+            const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+            return _mm256_blendv_epi8(a, b, _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32((int)bits), lanes), lanes));
+        }
+        static __forceinline Vector Swap(Vector v, int distance)
+        {
+            switch (distance)
+            {
+            case 1: return _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+            case 2: return _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+            default: return _mm256_permute2x128_si256(v, v, 1);
+            }
+        }
+        static __forceinline int PartitionStore(Vector v, unsigned greater, int32_t* left, int32_t* right)
+        {
+            const __m256i packed = _mm256_permutevar8x32_epi32(v, PartitionControl(&Partitions.lanes8[greater]));
+            _mm256_storeu_si256((__m256i*)left, packed);
+            _mm256_storeu_si256((__m256i*)(right - Length), packed);
+            return _mm_popcnt_u32(greater);
+        }
+    };
+
+    template<> struct SortLanes<Avx2, int64_t>
+    {
+        typedef __m256i Vector;
+        static const int Length = 4;
+
+        static __forceinline Vector Load(const int64_t* a) { return _mm256_loadu_si256((const __m256i*)a); }
+        static __forceinline void Store(int64_t* a, Vector v) { _mm256_storeu_si256((__m256i*)a, v); }
+        static __forceinline Vector Set(int64_t v) { return _mm256_set1_epi64x(v); }
+        static __forceinline unsigned Greater(Vector a, Vector b) { return (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b))); }
+        static __forceinline Vector Min(Vector a, Vector b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+        static __forceinline Vector Max(Vector a, Vector b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+        static __forceinline Vector Blend(Vector a, Vector b, unsigned bits)
+        {
+            const __m256i lanes = _mm256_setr_epi64x(1, 2, 4, 8);
+            return _mm256_blendv_epi8(a, b, _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(bits), lanes), lanes));
+        }
+        static __forceinline Vector Swap(Vector v, int distance)
+        {
+            if (distance == 1)
+                return _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+            return _mm256_permute2x128_si256(v, v, 1);
+        }
+        static __forceinline int PartitionStore(Vector v, unsigned greater, int64_t* left, int64_t* right)
+        {
+            const __m256i packed = _mm256_permutevar8x32_epi32(v, PartitionControl(&Partitions.lanes4[greater]));
+            _mm256_storeu_si256((__m256i*)left, packed);
+            _mm256_storeu_si256((__m256i*)(right - Length), packed);
+            return _mm_popcnt_u32(greater);
+        }
+    };
+
+#ifdef INTRINSICS_AVX512
+    template<> struct SortLanes<Avx512, int32_t>
+    {
+        typedef __m512i Vector;
+        static const int Length = 16;
+
+        static __forceinline Vector Load(const int32_t* a) { return _mm512_loadu_si512(a); }
+        static __forceinline void Store(int32_t* a, Vector v) { _mm512_storeu_si512(a, v); }
+        static __forceinline Vector Set(int32_t v) { return _mm512_set1_epi32(v); }
+        static __forceinline unsigned Greater(Vector a, Vector b) { return (unsigned)_mm512_cmpgt_epi32_mask(a, b); }
+        static __forceinline Vector Min(Vector a, Vector b) { return _mm512_min_epi32(a, b); }
+        static __forceinline Vector Max(Vector a, Vector b) { return _mm512_max_epi32(a, b); }
+        static __forceinline Vector Blend(Vector a, Vector b, unsigned bits) { return _mm512_mask_blend_epi32((__mmask16)bits, a, b); }
+        static __forceinline Vector Swap(Vector v, int distance)
+        {
+            switch (distance)
+            {
+            case 1: return _mm512_shuffle_epi32(v, (_MM_PERM_ENUM)_MM_SHUFFLE(2, 3, 0, 1));
+            case 2: return _mm512_shuffle_epi32(v, (_MM_PERM_ENUM)_MM_SHUFFLE(1, 0, 3, 2));
+            case 4: return _mm512_shuffle_i32x4(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+            default: return _mm512_shuffle_i32x4(v, v, _MM_SHUFFLE(1, 0, 3, 2));
+            }
+        }
+        static __forceinline int PartitionStore(Vector v, unsigned greater, int32_t* left, int32_t* right)
+        {
+            const int count = _mm_popcnt_u32(greater);
+            _mm512_mask_compressstoreu_epi32(left, (__mmask16)~greater, v);
+            _mm512_mask_compressstoreu_epi32(right - count, (__mmask16)greater, v);
+            return count;
+        }
+    };
+
+    template<> struct SortLanes<Avx512, int64_t>
+    {
+        typedef __m512i Vector;
+        static const int Length = 8;
+
+        static __forceinline Vector Load(const int64_t* a) { return _mm512_loadu_si512(a); }
+        static __forceinline void Store(int64_t* a, Vector v) { _mm512_storeu_si512(a, v); }
+        static __forceinline Vector Set(int64_t v) { return _mm512_set1_epi64(v); }
+        static __forceinline unsigned Greater(Vector a, Vector b) { return (unsigned)_mm512_cmpgt_epi64_mask(a, b); }
+        static __forceinline Vector Min(Vector a, Vector b) { return _mm512_min_epi64(a, b); }
+        static __forceinline Vector Max(Vector a, Vector b) { return _mm512_max_epi64(a, b); }
+        static __forceinline Vector Blend(Vector a, Vector b, unsigned bits) { return _mm512_mask_blend_epi64((__mmask8)bits, a, b); }
+        static __forceinline Vector Swap(Vector v, int distance)
+        {
+            switch (distance)
+            {
+            case 1: return _mm512_shuffle_epi32(v, (_MM_PERM_ENUM)_MM_SHUFFLE(1, 0, 3, 2));
+            case 2: return _mm512_shuffle_i64x2(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+            default: return _mm512_shuffle_i64x2(v, v, _MM_SHUFFLE(1, 0, 3, 2));
+            }
+        }
+        static __forceinline int PartitionStore(Vector v, unsigned greater, int64_t* left, int64_t* right)
+        {
+            const int count = _mm_popcnt_u32(greater);
+            _mm512_mask_compressstoreu_epi64(left, (__mmask8)~greater, v);
+            _mm512_mask_compressstoreu_epi64(right - count, (__mmask8)greater, v);
+            return count;
+        }
+    };
+#endif
+
+    // the scalar tiers
+    struct Scalar {};
+    template<typename T> struct SortLanes<Scalar, T> {};
+
+    template<bool Pairs, typename T>
+    __forceinline void Exchange(T* keys, int64_t* items, int64_t i, int64_t j)
+    {
+        std::swap(keys[i], keys[j]);
+        if (Pairs)
+            std::swap(items[i], items[j]);
+    }
+
+    template<bool Pairs, typename T>
+    void InsertionSort(T* keys, int64_t* items, int64_t count)
+    {
+        for (int64_t i = 1; i < count; ++i)
+        {
+            const T key = keys[i];
+            const int64_t item = Pairs ? items[i] : 0;
+            int64_t j = i;
+            for (; j > 0 && keys[j - 1] > key; --j)
+            {
+                keys[j] = keys[j - 1];
+                if (Pairs)
+                    items[j] = items[j - 1];
+            }
+            keys[j] = key;
+            if (Pairs)
+                items[j] = item;
+        }
+    }
+
+    template<bool Pairs, typename T>
+    void SiftDown(T* keys, int64_t* items, int64_t root, int64_t count)
+    {
+        for (int64_t child; (child = 2 * root + 1) < count; root = child)
+        {
+            if (child + 1 < count && keys[child + 1] > keys[child])
+                ++child;
+            if (!(keys[child] > keys[root]))
+                return;
+            Exchange<Pairs>(keys, items, root, child);
+        }
+    }
+
+    // introsort fallback when the pivots keep failing
+    template<bool Pairs, typename T>
+    void HeapSort(T* keys, int64_t* items, int64_t count)
+    {
+        for (int64_t i = count / 2; i-- > 0;)
+            SiftDown<Pairs>(keys, items, i, count);
+        for (int64_t end = count; end-- > 1;)
+        {
+            Exchange<Pairs>(keys, items, 0, end);
+            SiftDown<Pairs>(keys, items, 0, end);
+        }
+    }
+
+    template<bool Pairs, typename T>
+    int64_t PartitionScalar(T* keys, int64_t* items, int64_t count, T pivot)
+    {
+        int64_t left = 0;
+        int64_t right = count;
+        for (;;)
+        {
+            while (left < right && !(keys[left] > pivot))
+                ++left;
+            while (left < right && keys[right - 1] > pivot)
+                --right;
+            if (left >= right)
+                return left;
+            Exchange<Pairs>(keys, items, left, right - 1);
+            ++left;
+            --right;
+        }
+    }
+
+    // the vectors at both ends are loaded first, which leave 2 vectors of free space. the next vector is
+    // read from the side with less free space, so both sides have room for a whole vector store, and
+    // the free space is back to 2 vectors once it is partitioned. count >= 2 * L::Length
+    template<class L, bool Pairs, typename T>
+    int64_t PartitionVector(T* keys, int64_t* items, int64_t count, T pivot)
+    {
+        typedef typename L::Vector Vector;
+        const int N = L::Length;
+        const Vector p = L::Set(pivot);
+
+        const Vector first = L::Load(keys);
+        const Vector last = L::Load(keys + count - N);
+        Vector firstItems, lastItems;
+        if (Pairs)
+        {
+            firstItems = L::Load((const T*)items);
+            lastItems = L::Load((const T*)items + count - N);
+        }
+
+        int64_t readLeft = N;
+        int64_t readRight = count - N;
+        int64_t writeLeft = 0;
+        int64_t writeRight = count;
+        while (readRight - readLeft >= N)
+        {
+            int64_t read;
+            if (readLeft - writeLeft <= writeRight - readRight)
+            {
+                read = readLeft;
+                readLeft += N;
+            }
+            else
+            {
+                readRight -= N;
+                read = readRight;
+            }
+
+            const Vector v = L::Load(keys + read);
+            const unsigned greater = L::Greater(v, p);
+            if (Pairs)
+                L::PartitionStore(L::Load((const T*)items + read), greater, (T*)items + writeLeft, (T*)items + writeRight);
+            const int right = L::PartitionStore(v, greater, keys + writeLeft, keys + writeRight);
+            writeLeft += N - right;
+            writeRight -= right;
+        }
+
+        // less than a vector left, one key at a time with the same rule
+        while (readLeft < readRight)
+        {
+            int64_t read;
+            if (readLeft - writeLeft <= writeRight - readRight)
+                read = readLeft++;
+            else
+                read = --readRight;
+
+            const T key = keys[read];
+            const int64_t item = Pairs ? items[read] : 0;
+            const int64_t write = key > pivot ? --writeRight : writeLeft++;
+            keys[write] = key;
+            if (Pairs)
+                items[write] = item;
+        }
+
+        // the free space is now the 2 vectors between writeLeft and writeRight
+        unsigned greater = L::Greater(first, p);
+        if (Pairs)
+            L::PartitionStore(firstItems, greater, (T*)items + writeLeft, (T*)items + writeRight);
+        int right = L::PartitionStore(first, greater, keys + writeLeft, keys + writeRight);
+        writeLeft += N - right;
+        writeRight -= right;
+
+        greater = L::Greater(last, p);
+        if (Pairs)
+            L::PartitionStore(lastItems, greater, (T*)items + writeLeft, (T*)items + writeRight);
+        right = L::PartitionStore(last, greater, keys + writeLeft, keys + writeRight);
+        return writeLeft + N - right;
+    }
+
+    template<class L, bool Pairs, typename T>
+    __forceinline void CompareExchange(typename L::Vector& a, typename L::Vector& b, typename L::Vector& itemsA, typename L::Vector& itemsB, bool ascending)
+    {
+        if (Pairs)
+        {
+            const unsigned swap = ascending ? L::Greater(a, b) : L::Greater(b, a);
+            const typename L::Vector low = L::Blend(a, b, swap);
+            b = L::Blend(b, a, swap);
+            a = low;
+            const typename L::Vector lowItems = L::Blend(itemsA, itemsB, swap);
+            itemsB = L::Blend(itemsB, itemsA, swap);
+            itemsA = lowItems;
+        }
+        else
+        {
+            const typename L::Vector low = L::Min(a, b);
+            const typename L::Vector high = L::Max(a, b);
+            a = ascending ? low : high;
+            b = ascending ? high : low;
+        }
+    }
+
+    // lanes pairs at distance, the lanes of larger take the larger key of their pair
+    template<class L, bool Pairs>
+    __forceinline void CompareExchangeLanes(typename L::Vector& v, typename L::Vector& items, int distance, unsigned larger)
+    {
+        const typename L::Vector other = L::Swap(v, distance);
+        if (Pairs)
+        {
+            // a pair swap when its smaller lane is greater, both lanes agree on equal keys
+            const unsigned swap = (L::Greater(v, other) & ~larger) | (L::Greater(other, v) & larger);
+            v = L::Blend(v, other, swap);
+            items = L::Blend(items, L::Swap(items, distance), swap);
+        }
+        else
+        {
+            v = L::Blend(L::Min(v, other), L::Max(v, other), larger);
+        }
+    }
+
+    // bitonic sort of up to 8 vectors, padded with the largest key
+    template<class L, bool Pairs, typename T>
+    void NetworkSort(T* keys, int64_t* items, int64_t count)
+    {
+        typedef typename L::Vector Vector;
+        const int N = L::Length;
+        if (count < 2)
+            return;
+
+        int vectors = 1;
+        while (vectors * N < count)
+            vectors *= 2;
+
+        T padded[8 * N];
+        T paddedItems[Pairs ? 8 * N : 1];
+        memcpy(padded, keys, (size_t)count * sizeof(T));
+        for (int i = (int)count; i < vectors * N; ++i)
+            padded[i] = std::numeric_limits<T>::max();
+
+        Vector v[8];
+        Vector vItems[8];
+        for (int i = 0; i < vectors; ++i)
+            v[i] = L::Load(padded + i * N);
+
+        if (Pairs)
+        {
+            // the padding must sort after every key for the items to stay with theirs
+            for (int64_t i = 0; i < count; ++i)
+            {
+                if (keys[i] == std::numeric_limits<T>::max())
+                {
+                    InsertionSort<Pairs>(keys, items, count);
+                    return;
+                }
+            }
+            memcpy(paddedItems, items, (size_t)count * sizeof(T));
+            for (int i = 0; i < vectors; ++i)
+                vItems[i] = L::Load(paddedItems + i * N);
+        }
+
+        const int total = vectors * N;
+        const unsigned all = (unsigned)((1ull << N) - 1);
+        for (int k = 2; k <= total; k <<= 1)
+        {
+            for (int j = k >> 1; j > 0; j >>= 1)
+            {
+                if (j >= N)
+                {
+                    for (int i = 0; i < vectors; ++i)
+                    {
+                        const int other = i ^ (j / N);
+                        if (other > i)
+                            CompareExchange<L, Pairs, T>(v[i], v[other], vItems[i], vItems[other], ((i * N) & k) == 0);
+                    }
+                    continue;
+                }
+
+                // the upper lane of each pair take the larger key in an ascending block
+                unsigned larger = 0;
+                for (int lane = 0; lane < N; ++lane)
+                {
+                    if (((lane & j) != 0) != (k < N && (lane & k) != 0))
+                        larger |= 1u << lane;
+                }
+                for (int i = 0; i < vectors; ++i)
+                {
+                    const bool descending = k >= N && ((i * N) & k) != 0;
+                    CompareExchangeLanes<L, Pairs>(v[i], vItems[i], j, descending ? larger ^ all : larger);
+                }
+            }
+        }
+
+        for (int i = 0; i < vectors; ++i)
+            L::Store(padded + i * N, v[i]);
+        memcpy(keys, padded, (size_t)count * sizeof(T));
+        if (Pairs)
+        {
+            for (int i = 0; i < vectors; ++i)
+                L::Store(paddedItems + i * N, vItems[i]);
+            memcpy(items, paddedItems, (size_t)count * sizeof(T));
+        }
+    }
+
+    // partition and small sort of a tier
+    template<class L, bool Pairs, typename T>
+    struct Steps
+    {
+        static const int64_t SmallCount = 8 * L::Length;
+
+        static int64_t Partition(T* keys, int64_t* items, int64_t count, T pivot) { return PartitionVector<L, Pairs>(keys, items, count, pivot); }
+        static void SmallSort(T* keys, int64_t* items, int64_t count) { NetworkSort<L, Pairs>(keys, items, count); }
+    };
+
+    template<bool Pairs, typename T>
+    struct Steps<SortLanes<Scalar, T>, Pairs, T>
+    {
+        static const int64_t SmallCount = 16;
+
+        static int64_t Partition(T* keys, int64_t* items, int64_t count, T pivot) { return PartitionScalar<Pairs>(keys, items, count, pivot); }
+        static void SmallSort(T* keys, int64_t* items, int64_t count) { InsertionSort<Pairs>(keys, items, count); }
+    };
+
+    template<typename T>
+    __forceinline T Median(T a, T b, T c)
+    {
+        if (a > b)
+            std::swap(a, b);
+        if (b > c)
+            b = c;
+        return a > b ? a : b;
+    }
+
+    // [0, mid[ <= [mid, count[, 0 when all the keys are equal. when the pivot is the largest key the
+    // keys equal to it are split from the others
+    template<class L, bool Pairs, typename T>
+    int64_t Split(T* keys, int64_t* items, int64_t count)
+    {
+        typedef Steps<L, Pairs, T> S;
+        const T pivot = Median(keys[count / 4], keys[count / 2], keys[count - 1 - count / 4]);
+        const int64_t mid = S::Partition(keys, items, count, pivot);
+        if (mid < count)
+            return mid;
+        if (pivot == std::numeric_limits<T>::min())
+            return 0;
+        return S::Partition(keys, items, count, pivot - 1);
+    }
+
+    template<class L, bool Pairs, typename T>
+    void Introsort(T* keys, int64_t* items, int64_t count, int depth)
+    {
+        typedef Steps<L, Pairs, T> S;
+        while (count > S::SmallCount)
+        {
+            if (depth-- == 0)
+            {
+                HeapSort<Pairs>(keys, items, count);
+                return;
+            }
+
+            const int64_t mid = Split<L, Pairs>(keys, items, count);
+            if (mid == 0)
+                return;
+
+            // recurse in the smaller side, loop on the larger
+            if (mid < count - mid)
+            {
+                Introsort<L, Pairs>(keys, items, mid, depth);
+                keys += mid;
+                if (Pairs)
+                    items += mid;
+                count -= mid;
+            }
+            else
+            {
+                Introsort<L, Pairs>(keys + mid, Pairs ? items + mid : items, count - mid, depth);
+                count = mid;
+            }
+        }
+        S::SmallSort(keys, items, count);
+    }
+
+    int DepthLimit(int64_t count)
+    {
+        int depth = 0;
+        for (; count > 1; count >>= 1)
+            depth += 2;
+        return depth;
+    }
+
+    // below, the sampling cost more than the introsort can save
+    const int64_t PresortedCount = 4096;
+
+    // nearly sorted keys: the keys that break the ascending order are moved out with the key before
+    // them, the others stay in order at the start. the moved keys are sorted then merged back from the
+    // end. false when too many keys would move, the keys are then all back in place for the introsort
+    template<class L, bool Pairs, typename T>
+    bool SortPresorted(T* keys, int64_t* items, int64_t count)
+    {
+        // adjacent pairs sampled across the keys, about half descend on random keys
+        const int Samples = 64;
+        const int64_t stride = (count - 1) / Samples;
+        int descents = 0;
+        for (int i = 0; i < Samples; ++i)
+            descents += keys[i * stride] > keys[i * stride + 1];
+
+        if (descents == Samples)
+        {
+            for (int64_t i = 1; i < count; ++i)
+            {
+                if (keys[i - 1] < keys[i])
+                    return false;
+            }
+            std::reverse(keys, keys + count);
+            if (Pairs)
+                std::reverse(items, items + count);
+            return true;
+        }
+
+        if (descents > Samples / 8)
+            return false;
+
+        const int64_t limit = count / 16;
+        std::vector<T> moved;
+        std::vector<int64_t> movedItems;
+        moved.reserve((size_t)limit + 2);
+        if (Pairs)
+            movedItems.reserve((size_t)limit + 2);
+
+        int64_t kept = 0;
+        int64_t i = 0;
+        for (; i < count; ++i)
+        {
+            const T key = keys[i];
+            if (kept && key < keys[kept - 1])
+            {
+                if ((int64_t)moved.size() >= limit)
+                    break;
+                --kept;
+                moved.push_back(keys[kept]);
+                moved.push_back(key);
+                if (Pairs)
+                {
+                    movedItems.push_back(items[kept]);
+                    movedItems.push_back(items[i]);
+                }
+                continue;
+            }
+            keys[kept] = key;
+            if (Pairs)
+                items[kept] = items[i];
+            ++kept;
+        }
+
+        // the moved keys fill the gap they left before the keys not scanned
+        if (i < count)
+        {
+            std::copy(moved.begin(), moved.end(), keys + kept);
+            if (Pairs)
+                std::copy(movedItems.begin(), movedItems.end(), items + kept);
+            return false;
+        }
+
+        int64_t m = (int64_t)moved.size();
+        if (!m)
+            return true;
+
+        Introsort<L, Pairs>(moved.data(), Pairs ? movedItems.data() : nullptr, m, DepthLimit(m));
+        for (int64_t end = count; m;)
+        {
+            --end;
+            if (kept && keys[kept - 1] > moved[m - 1])
+            {
+                --kept;
+                keys[end] = keys[kept];
+                if (Pairs)
+                    items[end] = items[kept];
+            }
+            else
+            {
+                --m;
+                keys[end] = moved[m];
+                if (Pairs)
+                    items[end] = movedItems[m];
+            }
+        }
+        return true;
+    }
+
+    template<class L, bool Pairs, typename T>
+    void Sort(T* keys, int64_t* items, int64_t count)
+    {
+        if (count >= PresortedCount && SortPresorted<L, Pairs>(keys, items, count))
+            return;
+        Introsort<L, Pairs>(keys, items, count, DepthLimit(count));
+    }
+
+    template<typename T>
+    void SortCpp(T* keys, int64_t*, int64_t count)
+    {
+        std::sort(keys, keys + count);
+    }
+
+    template<typename T>
+    void SortPairsCpp(T* keys, int64_t* items, int64_t count)
+    {
+        Sort<SortLanes<Scalar, T>, true>(keys, items, count);
+    }
+
+    template<class L, bool Pairs, typename T>
+    int64_t Partition(T* keys, int64_t* items, int64_t count)
+    {
+        if (count < 2)
+            return 0;
+        if (count <= Steps<L, Pairs, T>::SmallCount)
+            return Split<SortLanes<Scalar, T>, Pairs>(keys, items, count);
+        return Split<L, Pairs>(keys, items, count);
+    }
+
+    template<typename T>
+    int64_t PartitionCpp(T* keys, int64_t* items, int64_t count)
+    {
+        return Partition<SortLanes<Scalar, T>, false>(keys, items, count);
+    }
+
+    template<typename T>
+    int64_t PartitionPairsCpp(T* keys, int64_t* items, int64_t count)
+    {
+        return Partition<SortLanes<Scalar, T>, true>(keys, items, count);
+    }
+
+    // the sign bit flip the other bits of negative floats, the keys then order -NaN, the numbers and
+    // +NaN. the keys are rotated by the +NaN count so they wrap to the start: every NaN sorts first and
+    // the keys convert back to the exact float bits
+    const uint32_t FloatNaNs = 0x7fffff;
+    const uint64_t DoubleNaNs = 0xfffffffffffffull;
+
+    __forceinline int32_t FloatKey(int32_t bits)
+    {
+        return (int32_t)((uint32_t)(bits ^ ((bits >> 31) & 0x7fffffff)) + FloatNaNs);
+    }
+
+    __forceinline int64_t FloatKey(int64_t bits)
+    {
+        return (int64_t)((uint64_t)(bits ^ ((bits >> 63) & 0x7fffffffffffffffll)) + DoubleNaNs);
+    }
+
+    __forceinline int32_t FloatBits(int32_t key)
+    {
+        const int32_t bits = (int32_t)((uint32_t)key - FloatNaNs);
+        return bits ^ ((bits >> 31) & 0x7fffffff);
+    }
+
+    __forceinline int64_t FloatBits(int64_t key)
+    {
+        const int64_t bits = (int64_t)((uint64_t)key - DoubleNaNs);
+        return bits ^ ((bits >> 63) & 0x7fffffffffffffffll);
+    }
+}
+
+#ifdef INTRINSICS_AVX512
+#define SORT_CASE_AVX512(T, kernel, pairs, args) case ArrayAvx512: return kernel<SortLanes<Avx512, T>, pairs> args;
+#else
+#define SORT_CASE_AVX512(T, kernel, pairs, args) case ArrayAvx512:
+#endif
+
+// kernel instantiated for the sort lanes of the tier, the scalar fallback otherwise
+#define SORT_DISPATCH(T, kernel, pairs, fallback, args) \
+    switch (tier) \
+    { \
+    SORT_CASE_AVX512(T, kernel, pairs, args) \
+    case ArrayAvx2: return kernel<SortLanes<Avx2, T>, pairs> args; \
+    default: return fallback args; \
+    }
+
+void ArraySort(ArrayTier tier, int32_t* keys, int64_t count)
+{
+    SORT_DISPATCH(int32_t, Sort, false, SortCpp, (keys, nullptr, count))
+}
+
+void ArraySort(ArrayTier tier, int64_t* keys, int64_t count)
+{
+    SORT_DISPATCH(int64_t, Sort, false, SortCpp, (keys, nullptr, count))
+}
+
+void ArraySort(ArrayTier tier, int64_t* keys, int64_t* items, int64_t count)
+{
+    SORT_DISPATCH(int64_t, Sort, true, SortPairsCpp, (keys, items, count))
+}
+
+int64_t ArraySortPartition(ArrayTier tier, int32_t* keys, int64_t count)
+{
+    SORT_DISPATCH(int32_t, Partition, false, PartitionCpp, (keys, nullptr, count))
+}
+
+int64_t ArraySortPartition(ArrayTier tier, int64_t* keys, int64_t count)
+{
+    SORT_DISPATCH(int64_t, Partition, false, PartitionCpp, (keys, nullptr, count))
+}
+
+int64_t ArraySortPartition(ArrayTier tier, int64_t* keys, int64_t* items, int64_t count)
+{
+    SORT_DISPATCH(int64_t, Partition, true, PartitionPairsCpp, (keys, items, count))
+}
+
+void ArrayFloatToKeys(float* a, int64_t count)
+{
+    int32_t* keys = (int32_t*)a;
+    for (int64_t i = 0; i < count; ++i)
+        keys[i] = FloatKey(keys[i]);
+}
+
+void ArrayFloatToKeys(double* a, int64_t count)
+{
+    int64_t* keys = (int64_t*)a;
+    for (int64_t i = 0; i < count; ++i)
+        keys[i] = FloatKey(keys[i]);
+}
+
+void ArrayKeysToFloat(int32_t* keys, int64_t count)
+{
+    for (int64_t i = 0; i < count; ++i)
+        keys[i] = FloatBits(keys[i]);
+}
+
+void ArrayKeysToFloat(int64_t* keys, int64_t count)
+{
+    for (int64_t i = 0; i < count; ++i)
+        keys[i] = FloatBits(keys[i]);
+}
+
+void ArrayPackIndex(const int32_t* keys, int64_t* packed, int64_t count)
+{
+    for (int64_t i = 0; i < count; ++i)
+        packed[i] = (int64_t)((uint64_t)(uint32_t)keys[i] << 32 | (uint32_t)i);
+}
+
+void ArrayUnpackIndex(const int64_t* packed, int32_t* keys, int32_t* indices, int64_t count)
+{
+    for (int64_t i = 0; i < count; ++i)
+    {
+        keys[i] = (int32_t)(packed[i] >> 32);
+        indices[i] = (int32_t)packed[i];
+    }
+}
@@ -0,0 +1,54 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// unmanaged in place sort of 32 and 64 bits keys, compiled without /clr like StringKernels
+//
+// an introsort: partitions around a median of 3 pivot, vector partitions move the lanes of each
+// vector below and above the pivot to both ends of the free space with a permute table (avx2) or
+// compress stores (avx-512). partitions of 8 vectors or less are sorted in registers by a bitonic
+// network. the avx2 and avx-512 tiers are vectorized, the others run the scalar introsort.
+// pairs sort 64 bits keys and move their items with them, equal keys keep no particular order.
+// floats are sorted as order preserving integer keys, ArrayFloatToKeys converts them in place.
+
+#include "ArrayKernels.h"
+
+void ArraySort(ArrayTier tier, int32_t* keys, int64_t count);
+void ArraySort(ArrayTier tier, int64_t* keys, int64_t count);
+void ArraySort(ArrayTier tier, int64_t* keys, int64_t* items, int64_t count);
+
+// one introsort step, for parallel sorts: a is split in [0, mid[ <= [mid, count[ and mid is returned,
+// or 0 when all the keys are equal
+int64_t ArraySortPartition(ArrayTier tier, int32_t* keys, int64_t count);
+int64_t ArraySortPartition(ArrayTier tier, int64_t* keys, int64_t count);
+int64_t ArraySortPartition(ArrayTier tier, int64_t* keys, int64_t* items, int64_t count);
+
+// in place, integer keys ordered like the floats with NaN first, then -0 before 0. the conversion is
+// exact, a sorted array hold the same bits
+void ArrayFloatToKeys(float* a, int64_t count);
+void ArrayFloatToKeys(double* a, int64_t count);
+void ArrayKeysToFloat(int32_t* keys, int64_t count);
+void ArrayKeysToFloat(int64_t* keys, int64_t count);
+
+// 32 bits keys and their index in 64 bits keys: sorting them is stable
+void ArrayPackIndex(const int32_t* keys, int64_t* packed, int64_t count);
+void ArrayUnpackIndex(const int64_t* packed, int32_t* keys, int32_t* indices, int64_t count);
@@ -21,101 +21,30 @@
 //  SOFTWARE.
 
 #include "String.h"
+#include "MatchBuffer.h"
 
 #include <vcclr.h>          // cli/c++ pinning
-#include <intrin.h>         // intrinsics
-#include <emmintrin.h>      // SSE2
-#include <immintrin.h>      // AVX2
-#include "InstructionSet.h" // cpu intrinsics support helper
+#include "StringKernels.h"  // unmanaged kernels
+#include "Instrumentation.h" // kernels counters
+#include "Tuning.h"         // crossover table
 
-// add the check here, calling InstructionSet::SSE2() inside managed code is very slow due to bit manipulation
-static const bool CpuSupportSse2 = InstructionSet::SSE2();
-// untested yet, should work but my I7 don't support it so I cannot valid it
-static const bool CpuSupportAvx2 = false; // InstructionSet::AVX2();
-
-#pragma unmanaged
+#pragma managed
 
-int StrIndexOfAll_SSE2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results)
+// managed loops, no managed to native transition so they win on tiny strings
+static int StrIndexOfAll_CLI(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results)
 {
     int* resultCur = results;
     const wchar_t* s = str + startIndex;
     const wchar_t* end = s + count;
 
-    __m128i zero = _mm_setzero_si128();
-    __m128i chars128[Intrinsics::SearchCharsMax];
-    __m128i charsIndex128[Intrinsics::SearchCharsMax];
-
-    for (int i = 0; i < charsLength; ++i)
-    {
-        chars128[i] = _mm_set1_epi16(chars[i]);
-        charsIndex128[i] = _mm_set1_epi16(i);
-    }
-
-    __m128i mergeCompare = zero;
-    __m128i mergeIndex = zero;
-
-    // don't use unalign load here, sse2 code here was slower then the c++ version on x64
-    for (; s < end && (size_t)s & (__alignof(__m128i) - 1); ++s)
-    {
-        for (int i = 0; i < charsLength; ++i)
-        {
-            const wchar_t c = chars[i];
-            if (*s == c)
-            {
-                int index = (int)(s - str);
-                *(resultCur++) = index;   // string index in str
-                *(resultCur++) = i;       // char index in chars
-                break;
-            }
-        }
-    }
-
-    // process aligned string part
-    __m128i store;
-    const wchar_t* alignEnd = end - 8;
-    for (; s < alignEnd; s += 8)
-    {
-        __m128i  str128 = _mm_load_si128((__m128i const *)s);
-
-        for (int i = 0; i < charsLength; ++i)
-        {
-            __m128i  cmp = _mm_cmpeq_epi16(chars128[i], str128);
-            __m128i  cmpIndex = _mm_and_si128(cmp, charsIndex128[i]);
-            mergeCompare = _mm_or_si128(mergeCompare, cmp);
-            mergeIndex = _mm_or_si128(mergeIndex, cmpIndex);
-        }
-
-        unsigned v0 = _mm_movemask_epi8(mergeCompare);
-        if (v0)
-        {
-            do
-            {
-                unsigned long traillingZero;
-                _BitScanForward(&traillingZero, v0);
-                const int offset = (traillingZero >> 1);
-                const wchar_t* c = s + offset;
-                *(resultCur++) = (int)(c - str);                // string index in str
-                _mm_store_si128((__m128i*)&store, mergeIndex);
-                *(resultCur++) = store.m128i_i16[offset];
-                v0 &= ~(0x3 << traillingZero);                  // clear result char
-            } while (v0);
-
-            mergeCompare = zero;
-            mergeIndex = zero;
-        }
-    }
-
-    // process remaining string
     for (; s < end; ++s)
     {
         for (int i = 0; i < charsLength; ++i)
         {
-            const wchar_t c = chars[i];
-            if (*s == c)
+            if (*s == chars[i])
             {
-                int index = (int)(s - str);
-                *(resultCur++) = index;   // string index in str
-                *(resultCur++) = i;       // char index in chars
+                *(resultCur++) = (int)(s - str);    // string index in str
+                *(resultCur++) = i;                 // char index in chars
                 break;
             }
         }
@@ -123,203 +52,97 @@ int StrIndexOfAll_SSE2(const wchar_t * str, const wchar_t* chars, int charsLengt
     return (int)(resultCur - results) >> 1;
 }
 
-#ifdef INTRINSICS_TEST
-int StrIndexOfAll_SSE2_V2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results)
-{
-    return StrIndexOfAll_SSE2(str, chars, charsLength, startIndex, count, results);
-}
-#endif
-
-// not tested!
-int StrIndexOfAll_AVX2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results)
+static int StrIndexOfAny_CLI(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count)
 {
-    int* resultCur = results;
     const wchar_t* s = str + startIndex;
     const wchar_t* end = s + count;
-
-    // process begin of string, unalign part
-    if ((size_t)s & (__alignof(__m256i) - 1))
-    {
-        const int unalignCount = (__alignof(__m256i) - (((uintptr_t)s) & (__alignof(__m256i) - 1))) >> 1;
-        const wchar_t* unalignEnd = s + (unalignCount < count ? unalignCount : count);
-        for (; s < unalignEnd; ++s)
-        {
-            for (int i = 0; i < charsLength; ++i)
-            {
-                if (*s == chars[i])
-                {
-                    *(resultCur++) = (int)(s - str);    // string index in str
-                    *(resultCur++) = i;                 // char index in chars
-                }
-            }
-        }
-        if (unalignEnd == end)
-            return (int)(resultCur - results) >> 1;
-    }
-
-    __m256i zero = _mm256_setzero_si256();
-    __m256i chars128[Intrinsics::SearchCharsMax];
-    __m256i charsIndex128[Intrinsics::SearchCharsMax];
-
-    for (int i = 0; i < charsLength; ++i)
-    {
-        chars128[i] = _mm256_set1_epi16(chars[i]);
-        charsIndex128[i] = _mm256_set1_epi16(i);
-    }
-
-    // sse process aligned string part
-    __m256i mergeCompare = zero;
-    __m256i mergeIndex = zero;
-
-    for (; s + 16 < end; s += 16)
-    {
-        __m256i  str128 = _mm256_loadu_si256((__m256i const *)s);
-
-        for (int i = 0; i < charsLength; ++i)
-        {
-            __m256i  cmp = _mm256_cmpeq_epi16(chars128[i], str128);
-            __m256i  cmpIndex = _mm256_and_si256(cmp, charsIndex128[i]);
-            mergeCompare = _mm256_or_si256(mergeCompare, cmp);
-            mergeIndex = _mm256_or_si256(mergeIndex, cmpIndex);
-        }
-
-        unsigned v0 = _mm256_movemask_epi8(mergeCompare);
-        if (v0)
-        {
-            do
-            {
-                unsigned long traillingZero;
-                _BitScanForward(&traillingZero, v0);
-                const int offset = (traillingZero >> 1);
-                const wchar_t* c = s + offset;
-                *(resultCur++) = (int)(c - str);                       // string index in str
-                *(resultCur++) = mergeIndex.m256i_i16[offset];  // char index in chars
-                v0 &= ~(0x3 << traillingZero);                  // clear found char
-            } while (v0);
-
-            mergeCompare = zero;
-            mergeIndex = zero;
-        }
-    }
-
-    // process remaining string
     for (; s < end; ++s)
     {
         for (int i = 0; i < charsLength; ++i)
         {
             if (*s == chars[i])
-            {
-                *(resultCur++) = (int)(s - str);    // string index in str
-                *(resultCur++) = i;                 // char index in chars
-            }
+                return (int)(s - str);
         }
     }
-    return (int)(resultCur - results) >> 1;
+    return -1;
 }
 
-int StrIndexOfAll_CPP(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results)
+int StrIndexOfAllTier(TuningTier tier, const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results)
 {
-    int* resultCur = results;
-    const wchar_t* s = str + startIndex;
-    const wchar_t* end = s + count;
-
-    for (; s < end; ++s)
+    switch (tier)
     {
-        for (int i = 0; i < charsLength; ++i)
-        {
-            const wchar_t c = chars[i];
-            if (*s == c)
-            {
-                int index = (int)(s - str);
-                *(resultCur++) = index;   // string index in str
-                *(resultCur++) = i;       // char index in chars
-                break;
-            }
-        }
+    case TuningAvx2:
+        return StrIndexOfAll_AVX2(str, chars, charsLength, startIndex, count, results);
+    case TuningSse2:
+        return StrIndexOfAll_SSE2(str, chars, charsLength, startIndex, count, results);
+    case TuningCpp:
+        return StrIndexOfAll_CPP(str, chars, charsLength, startIndex, count, results);
+    default:
+        return StrIndexOfAll_CLI(str, chars, charsLength, startIndex, count, results);
     }
-
-    return (int)(resultCur - results) >> 1;
 }
 
-int StrIndexOfAny_SSE2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count)
+int StrIndexOfAnyTier(TuningTier tier, const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count)
 {
-    __m128i zero = _mm_setzero_si128();
-    __m128i chars128[Intrinsics::SearchCharsMax];
-    __m128i mergeCompare = zero;
-    for (int i = 0; i < charsLength; ++i)
-        chars128[i] = _mm_set1_epi16(chars[i]);
-
-    const wchar_t* s = str + startIndex;
-    const wchar_t* end = s + count;
-    for (; s < end && (size_t)s & (__alignof(__m128i) - 1); ++s)
+    switch (tier)
     {
-        for (int i = 0; i < charsLength; ++i)
-        {
-            const wchar_t c = chars[i];
-            if (*s == c)
-                return (int)(s - str);
-        }
+    case TuningAvx2:
+        return StrIndexOfAny_AVX2(str, chars, charsLength, startIndex, count);
+    case TuningSse2:
+        return StrIndexOfAny_SSE2(str, chars, charsLength, startIndex, count);
+    case TuningCpp:
+        return StrIndexOfAny_CPP(str, chars, charsLength, startIndex, count);
+    default:
+        return StrIndexOfAny_CLI(str, chars, charsLength, startIndex, count);
     }
-    if (s == end)
-        return -1;
+}
 
-    // process aligned string part
-    const wchar_t* alignEnd = end - 8;
-    for (; s < alignEnd; s += 8)
-    {
-        __m128i  str128 = _mm_load_si128((__m128i const *)s);
+// tier picked from the crossover table, the table only hold tiers this cpu support
+static int StrIndexOfAll(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results)
+{
+    return StrIndexOfAllTier(TuningSelect(TuningIndexOfAll, charsLength, count), str, chars, charsLength, startIndex, count, results);
+}
 
-        for (int i = 0; i < charsLength; ++i)
-        {
-            __m128i  cmp = _mm_cmpeq_epi16(chars128[i], str128);
-            mergeCompare = _mm_or_si128(mergeCompare, cmp);
-        }
+static int StrIndexOfAny(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count)
+{
+    return StrIndexOfAnyTier(TuningSelect(TuningIndexOfAny, charsLength, count), str, chars, charsLength, startIndex, count);
+}
 
-        unsigned v0 = _mm_movemask_epi8(mergeCompare);
-        if (v0)
-        {
-            unsigned long traillingZero;
-            _BitScanForward(&traillingZero, v0);
-            const int offset = (traillingZero >> 1);
-            const wchar_t* c = s + offset;
-            return (int)(c - str);
-        }
+namespace Intrinsics
+{
+    String::String()
+    {
+        Tuning::Initialize();
     }
 
-    // process remaining string
-    for (; s < end; ++s)
+    // smallest slice searched at once when filling a MatchBuffer
+    static const int MatchBufferChunkMin = 4096;
+
+    // search the string by slices never larger than the free results space so the kernels can't
+    // overflow the buffer, grow it geometrically only when free space is smaller than a slice
+    static bool __clrcall IndexOfAllGrow(System::String ^ str, const wchar_t* chars, int charsLength, int startIndex, int count, MatchBuffer ^ results)
     {
-        for (int i = 0; i < charsLength; ++i)
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+
+        results->count_ = 0;
+        while (count)
         {
-            const wchar_t c = chars[i];
-            if (*s == c)
-                return (int)(s - str);
-        }
-    }
+            int slice = count < MatchBufferChunkMin ? count : MatchBufferChunkMin;
+            if (results->Capacity - results->count_ < slice)
+                results->Grow(results->count_ + slice);
 
-    return -1;
-}
+            int available = results->Capacity - results->count_;
+            slice = count < available ? count : available;
 
+            pin_ptr<String::MatchIndex > pinResults = &results->results_[results->count_];
+            results->count_ += StrIndexOfAll(pinStr, chars, charsLength, startIndex, slice, (int*)pinResults);
 
-int StrIndexOfAny_CPP(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count)
-{
-    const wchar_t* s = str + startIndex;
-    const wchar_t* end = s + count;
-    for (; s < end; ++s)
-    {
-        for (int i = 0; i < charsLength; ++i)
-        {
-            if (*s == chars[i])
-                return (int)(s - str);
+            startIndex += slice;
+            count -= slice;
         }
+        return results->count_ != 0;
     }
-    return -1;
-}
-
-#pragma managed
 
-namespace Intrinsics
-{
     bool __clrcall String::IndexOfAll(System::String ^ str, wchar_t c, array<MatchIndex >^% results, [Out] int% resultsCount)
     {
         if (!str->Length)
@@ -334,17 +157,15 @@ namespace Intrinsics
 
         // realloc the to maximum possible results size if needed
         if (results->Length < str->Length)
+        {
             results = gcnew array<MatchIndex >(str->Length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
 
         pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
         pin_ptr<MatchIndex > pinResults = &results[0];
 
-        if (CpuSupportAvx2)
-            resultsCount = StrIndexOfAll_AVX2(pinStr, &c, 1, startIndex, count, (int*)pinResults);
-        else if (CpuSupportSse2)
-            resultsCount = StrIndexOfAll_SSE2(pinStr, &c, 1, startIndex, count, (int*)pinResults);
-        else
-            resultsCount = StrIndexOfAll_CPP(pinStr, &c, 1, startIndex, count, (int*)pinResults);
+        resultsCount = StrIndexOfAll(pinStr, &c, 1, startIndex, count, (int*)pinResults);
         return resultsCount != 0;
     }
 
@@ -363,17 +184,15 @@ namespace Intrinsics
 
         // realloc the to maximum possible results size if needed
         if (results->Length < str->Length)
+        {
             results = gcnew array<MatchIndex >(str->Length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
 
         pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
         pin_ptr<MatchIndex > pinResults = &results[0];
 
-        if (CpuSupportAvx2)
-            resultsCount = StrIndexOfAll_AVX2(pinStr, &c, 1, startIndex, count, (int*)pinResults);
-        else if (CpuSupportSse2)
-            resultsCount = StrIndexOfAll_SSE2(pinStr, &c, 1, startIndex, count, (int*)pinResults);
-        else
-            resultsCount = StrIndexOfAll_CPP(pinStr, &c, 1, startIndex, count, (int*)pinResults);
+        resultsCount = StrIndexOfAll(pinStr, &c, 1, startIndex, count, (int*)pinResults);
         return resultsCount != 0;
     }
 
@@ -393,17 +212,15 @@ namespace Intrinsics
 
         // realloc the to maximum possible results size if needed
         if (results->Length < str->Length)
+        {
             results = gcnew array<MatchIndex >(str->Length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
 
         pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
         pin_ptr<MatchIndex > pinResults = &results[0];
 
-        if (CpuSupportAvx2)
-            resultsCount = StrIndexOfAll_AVX2(pinStr, &c, 1, startIndex, count, (int*)pinResults);
-        else if (CpuSupportSse2)
-            resultsCount = StrIndexOfAll_SSE2(pinStr, &c, 1, startIndex, count, (int*)pinResults);
-        else
-            resultsCount = StrIndexOfAll_CPP(pinStr, &c, 1, startIndex, count, (int*)pinResults);
+        resultsCount = StrIndexOfAll(pinStr, &c, 1, startIndex, count, (int*)pinResults);
         return resultsCount != 0;
     }
 
@@ -424,18 +241,16 @@ namespace Intrinsics
 
         // realloc the to maximum possible results size if needed
         if (results->Length < str->Length)
+        {
             results = gcnew array<MatchIndex >(str->Length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
 
         pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
         pin_ptr<const wchar_t> pinChars = &chars[0];
         pin_ptr<MatchIndex > pinResults = &results[0];
 
-        if (CpuSupportAvx2)
-            resultsCount = StrIndexOfAll_AVX2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        else if (CpuSupportSse2)
-            resultsCount = StrIndexOfAll_SSE2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        else
-            resultsCount = StrIndexOfAll_CPP(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
+        resultsCount = StrIndexOfAll(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
         return resultsCount != 0;
     }
 
@@ -457,18 +272,16 @@ namespace Intrinsics
 
         // realloc the to maximum possible results size if needed
         if (results->Length < str->Length)
+        {
             results = gcnew array<MatchIndex >(str->Length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
 
         pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
         pin_ptr<const wchar_t> pinChars = &chars[0];
         pin_ptr<MatchIndex > pinResults = &results[0];
 
-        if (CpuSupportAvx2)
-            resultsCount = StrIndexOfAll_AVX2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        else if (CpuSupportSse2)
-            resultsCount = StrIndexOfAll_SSE2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        else
-            resultsCount = StrIndexOfAll_CPP(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
+        resultsCount = StrIndexOfAll(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
         return resultsCount != 0;
     }
 
@@ -491,18 +304,16 @@ namespace Intrinsics
 
         // realloc the to maximum possible results size if needed
         if (results->Length < str->Length)
+        {
             results = gcnew array<MatchIndex >(str->Length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
 
         pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
         pin_ptr<const wchar_t> pinChars = &chars[0];
         pin_ptr<MatchIndex > pinResults = &results[0];
 
-        if (CpuSupportAvx2)
-            resultsCount = StrIndexOfAll_AVX2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        else if (CpuSupportSse2)
-            resultsCount = StrIndexOfAll_SSE2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        else
-            resultsCount = StrIndexOfAll_CPP(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
+        resultsCount = StrIndexOfAll(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
         return resultsCount != 0;
     }
 
@@ -523,18 +334,16 @@ namespace Intrinsics
 
         // realloc the to maximum possible results size if needed
         if (results->Length < str->Length)
+        {
             results = gcnew array<MatchIndex >(str->Length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
 
         pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
         pin_ptr<const wchar_t> pinChars = PtrToStringChars(chars);
         pin_ptr<MatchIndex > pinResults = &results[0];
 
-        if (CpuSupportAvx2)
-            resultsCount = StrIndexOfAll_AVX2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        else if (CpuSupportSse2)
-            resultsCount = StrIndexOfAll_SSE2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        else
-            resultsCount = StrIndexOfAll_CPP(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
+        resultsCount = StrIndexOfAll(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
         return resultsCount != 0;
     }
 
@@ -556,18 +365,16 @@ namespace Intrinsics
 
         // realloc the to maximum possible results size if needed
         if (results->Length < str->Length)
+        {
             results = gcnew array<MatchIndex >(str->Length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
 
         pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
         pin_ptr<const wchar_t> pinChars = PtrToStringChars(chars);
         pin_ptr<MatchIndex > pinResults = &results[0];
 
-        if (CpuSupportAvx2)
-            resultsCount = StrIndexOfAll_AVX2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        else if (CpuSupportSse2)
-            resultsCount = StrIndexOfAll_SSE2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        else
-            resultsCount = StrIndexOfAll_CPP(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
+        resultsCount = StrIndexOfAll(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
         return resultsCount != 0;
     }
 
@@ -590,68 +397,65 @@ namespace Intrinsics
 
         // realloc the to maximum possible results size if needed
         if (results->Length < str->Length)
+        {
             results = gcnew array<MatchIndex >(str->Length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
 
         pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
         pin_ptr<const wchar_t> pinChars = PtrToStringChars(chars);
         pin_ptr<MatchIndex > pinResults = &results[0];
 
-        if (CpuSupportAvx2)
-            resultsCount = StrIndexOfAll_AVX2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        else if (CpuSupportSse2)
-            resultsCount = StrIndexOfAll_SSE2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        else
-            resultsCount = StrIndexOfAll_CPP(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
+        resultsCount = StrIndexOfAll(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
         return resultsCount != 0;
     }
 
-    int __clrcall String::IndexOfAny(System::String ^ str, array<wchar_t>^ anyOf)
+    bool __clrcall String::IndexOfAll(System::String ^ str, wchar_t c, MatchBuffer ^ results)
     {
-        if (anyOf == nullptr)
-            throw gcnew ArgumentNullException("anyOf is null");
-
-        if (anyOf->Length > SearchCharsMax)
-            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+        if (results == nullptr)
+            throw gcnew ArgumentNullException("results is null");
 
         if (!str->Length)
-            return -1;
+        {
+            results->count_ = 0;
+            return false;
+        }
 
-        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
-        pin_ptr<const wchar_t> pinChars = &anyOf[0];
-        return StrIndexOfAny_SSE2(pinStr, pinChars, anyOf->Length, 0, str->Length);
+        int startIndex = 0;
+        int count = str->Length;
+
+        return IndexOfAllGrow(str, &c, 1, startIndex, count, results);
     }
 
-    int __clrcall String::IndexOfAny(System::String ^ str, array<wchar_t>^ anyOf, int startIndex)
+    bool __clrcall String::IndexOfAll(System::String ^ str, wchar_t c, MatchBuffer ^ results, int startIndex)
     {
-        if (anyOf == nullptr)
-            throw gcnew ArgumentNullException("anyOf is null");
-
-        if (anyOf->Length > SearchCharsMax)
-            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+        if (results == nullptr)
+            throw gcnew ArgumentNullException("results is null");
 
         if (!str->Length)
-            return -1;
+        {
+            results->count_ = 0;
+            return false;
+        }
 
         if (startIndex < 0 || startIndex + 1 > str->Length)
             throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length - 1");
 
-        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
-        pin_ptr<const wchar_t> pinChars = &anyOf[0];
-        return StrIndexOfAny_SSE2(pinStr, pinChars, anyOf->Length, startIndex, str->Length - startIndex);
+        int count = str->Length - startIndex;
+
+        return IndexOfAllGrow(str, &c, 1, startIndex, count, results);
     }
 
-    int __clrcall String::IndexOfAny(System::String ^ str, array<wchar_t>^ anyOf, int startIndex, int count)
+    bool __clrcall String::IndexOfAll(System::String ^ str, wchar_t c, MatchBuffer ^ results, int startIndex, int count)
     {
-        //if (str->Length < 128)
-        //    return str->IndexOfAny(anyOf, startIndex, count);
-        if (anyOf == nullptr)
-            throw gcnew ArgumentNullException("anyOf is null");
-
-        if (anyOf->Length > SearchCharsMax)
-            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+        if (results == nullptr)
+            throw gcnew ArgumentNullException("results is null");
 
         if (!str->Length)
-            return -1;
+        {
+            results->count_ = 0;
+            return false;
+        }
 
         if (startIndex < 0 || startIndex + 1 > str->Length)
             throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length - 1");
@@ -659,51 +463,64 @@ namespace Intrinsics
         if (count > str->Length - startIndex)
             throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
 
-        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
-        pin_ptr<const wchar_t> pinChars = &anyOf[0];
-        return StrIndexOfAny_SSE2(pinStr, pinChars, anyOf->Length, startIndex, count);
+        return IndexOfAllGrow(str, &c, 1, startIndex, count, results);
     }
 
-#ifdef INTRINSICS_TEST
-
-    bool __clrcall String::IndexOfAllWip(System::String ^ str, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count)
+    bool __clrcall String::IndexOfAll(System::String ^ str, array<wchar_t>^ chars, MatchBuffer ^ results)
     {
         if (chars->Length > SearchCharsMax)
             throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
 
+        if (results == nullptr)
+            throw gcnew ArgumentNullException("results is null");
+
         if (!str->Length)
         {
-            resultsCount = 0;
+            results->count_ = 0;
             return false;
         }
 
+        int startIndex = 0;
+        int count = str->Length;
 
-        if (startIndex < 0 || startIndex + 1 > str->Length)
-            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length - 1");
+        pin_ptr<const wchar_t> pinChars = &chars[0];
+        return IndexOfAllGrow(str, pinChars, chars->Length, startIndex, count, results);
+    }
 
-        if (count > str->Length - startIndex)
-            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+    bool __clrcall String::IndexOfAll(System::String ^ str, array<wchar_t>^ chars, MatchBuffer ^ results, int startIndex)
+    {
+        if (chars->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
 
-        // realloc the to maximum possible results size if needed
-        if (results->Length < str->Length)
-            results = gcnew array<MatchIndex >(str->Length);
+        if (results == nullptr)
+            throw gcnew ArgumentNullException("results is null");
 
-        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
-        pin_ptr<const wchar_t> pinChars = PtrToStringChars(chars);
-        pin_ptr<MatchIndex > pinResults = &results[0];
+        if (!str->Length)
+        {
+            results->count_ = 0;
+            return false;
+        }
 
-        resultsCount = StrIndexOfAll_SSE2_V2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
-        return resultsCount != 0;
+        if (startIndex < 0 || startIndex + 1 > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length - 1");
+
+        int count = str->Length - startIndex;
+
+        pin_ptr<const wchar_t> pinChars = &chars[0];
+        return IndexOfAllGrow(str, pinChars, chars->Length, startIndex, count, results);
     }
 
-    bool __clrcall String::IndexOfAllCli(System::String ^ str, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count)
+    bool __clrcall String::IndexOfAll(System::String ^ str, array<wchar_t>^ chars, MatchBuffer ^ results, int startIndex, int count)
     {
         if (chars->Length > SearchCharsMax)
             throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
 
+        if (results == nullptr)
+            throw gcnew ArgumentNullException("results is null");
+
         if (!str->Length)
         {
-            resultsCount = 0;
+            results->count_ = 0;
             return false;
         }
 
@@ -713,43 +530,632 @@ namespace Intrinsics
         if (count > str->Length - startIndex)
             throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
 
-        resultsCount = 0;
-        int end = startIndex + count;
-        for (int i = startIndex; i < end; ++i)
-        {
-            for (int j = 0; j < chars->Length; ++j)
-            {
-                if (str[i] == chars[j])
-                {
-                    results[resultsCount].StringIndex = i;
-                    results[resultsCount++].CharIndex = j;
-                    break;
-                }
-            }
-        }
-        return resultsCount != 0;
+        pin_ptr<const wchar_t> pinChars = &chars[0];
+        return IndexOfAllGrow(str, pinChars, chars->Length, startIndex, count, results);
     }
 
-    bool __clrcall String::IndexOfAllCpp(System::String ^ str, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count)
+    bool __clrcall String::IndexOfAll(System::String ^ str, System::String ^ chars, MatchBuffer ^ results)
     {
         if (chars->Length > SearchCharsMax)
             throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
 
+        if (results == nullptr)
+            throw gcnew ArgumentNullException("results is null");
+
         if (!str->Length)
         {
-            resultsCount = 0;
+            results->count_ = 0;
             return false;
         }
 
-        if (startIndex < 0 || startIndex + 1 > str->Length)
-            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length - 1");
+        int startIndex = 0;
+        int count = str->Length;
 
-        if (count > str->Length - startIndex)
-            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+        pin_ptr<const wchar_t> pinChars = PtrToStringChars(chars);
+        return IndexOfAllGrow(str, pinChars, chars->Length, startIndex, count, results);
+    }
 
-        // realloc the to maximum possible results size if needed
+    bool __clrcall String::IndexOfAll(System::String ^ str, System::String ^ chars, MatchBuffer ^ results, int startIndex)
+    {
+        if (chars->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (results == nullptr)
+            throw gcnew ArgumentNullException("results is null");
+
+        if (!str->Length)
+        {
+            results->count_ = 0;
+            return false;
+        }
+
+        if (startIndex < 0 || startIndex + 1 > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length - 1");
+
+        int count = str->Length - startIndex;
+
+        pin_ptr<const wchar_t> pinChars = PtrToStringChars(chars);
+        return IndexOfAllGrow(str, pinChars, chars->Length, startIndex, count, results);
+    }
+
+    bool __clrcall String::IndexOfAll(System::String ^ str, System::String ^ chars, MatchBuffer ^ results, int startIndex, int count)
+    {
+        if (chars->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (results == nullptr)
+            throw gcnew ArgumentNullException("results is null");
+
+        if (!str->Length)
+        {
+            results->count_ = 0;
+            return false;
+        }
+
+        if (startIndex < 0 || startIndex + 1 > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length - 1");
+
+        if (count > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+
+        pin_ptr<const wchar_t> pinChars = PtrToStringChars(chars);
+        return IndexOfAllGrow(str, pinChars, chars->Length, startIndex, count, results);
+    }
+
+    bool __clrcall String::IndexOfAll(array<wchar_t>^ str, wchar_t c, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (startIndex < 0 || startIndex > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length");
+
+        if (count < 0 || count > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+
+        if (!count)
+        {
+            resultsCount = 0;
+            return false;
+        }
+
+        // realloc the to maximum possible results size if needed
+        if (results->Length < count)
+        {
+            results = gcnew array<MatchIndex >(count);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
+
+        pin_ptr<const wchar_t> pinStr = &str[0];
+        pin_ptr<MatchIndex > pinResults = &results[0];
+
+        resultsCount = StrIndexOfAll(pinStr, &c, 1, startIndex, count, (int*)pinResults);
+        return resultsCount != 0;
+    }
+
+    bool __clrcall String::IndexOfAll(array<wchar_t>^ str, array<wchar_t>^ chars, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (chars->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (startIndex < 0 || startIndex > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length");
+
+        if (count < 0 || count > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+
+        if (!count)
+        {
+            resultsCount = 0;
+            return false;
+        }
+
+        // realloc the to maximum possible results size if needed
+        if (results->Length < count)
+        {
+            results = gcnew array<MatchIndex >(count);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
+
+        pin_ptr<const wchar_t> pinStr = &str[0];
+        pin_ptr<const wchar_t> pinChars = &chars[0];
+        pin_ptr<MatchIndex > pinResults = &results[0];
+
+        resultsCount = StrIndexOfAll(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
+        return resultsCount != 0;
+    }
+
+    bool __clrcall String::IndexOfAll(array<wchar_t>^ str, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (chars->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (startIndex < 0 || startIndex > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length");
+
+        if (count < 0 || count > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+
+        if (!count)
+        {
+            resultsCount = 0;
+            return false;
+        }
+
+        // realloc the to maximum possible results size if needed
+        if (results->Length < count)
+        {
+            results = gcnew array<MatchIndex >(count);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
+
+        pin_ptr<const wchar_t> pinStr = &str[0];
+        pin_ptr<const wchar_t> pinChars = PtrToStringChars(chars);
+        pin_ptr<MatchIndex > pinResults = &results[0];
+
+        resultsCount = StrIndexOfAll(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
+        return resultsCount != 0;
+    }
+
+    bool __clrcall String::IndexOfAll(const wchar_t* str, int length, wchar_t c, array<MatchIndex >^% results, [Out] int% resultsCount)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (length < 0)
+            throw gcnew ArgumentOutOfRangeException(L"length must be greater or equal to 0");
+
+        if (!length)
+        {
+            resultsCount = 0;
+            return false;
+        }
+
+        // realloc the to maximum possible results size if needed
+        if (results->Length < length)
+        {
+            results = gcnew array<MatchIndex >(length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
+
+        pin_ptr<MatchIndex > pinResults = &results[0];
+
+        resultsCount = StrIndexOfAll(str, &c, 1, 0, length, (int*)pinResults);
+        return resultsCount != 0;
+    }
+
+    bool __clrcall String::IndexOfAll(const wchar_t* str, int length, array<wchar_t>^ chars, array<MatchIndex >^% results, [Out] int% resultsCount)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (chars->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (length < 0)
+            throw gcnew ArgumentOutOfRangeException(L"length must be greater or equal to 0");
+
+        if (!length)
+        {
+            resultsCount = 0;
+            return false;
+        }
+
+        // realloc the to maximum possible results size if needed
+        if (results->Length < length)
+        {
+            results = gcnew array<MatchIndex >(length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
+
+        pin_ptr<const wchar_t> pinChars = &chars[0];
+        pin_ptr<MatchIndex > pinResults = &results[0];
+
+        resultsCount = StrIndexOfAll(str, pinChars, chars->Length, 0, length, (int*)pinResults);
+        return resultsCount != 0;
+    }
+
+    bool __clrcall String::IndexOfAll(const wchar_t* str, int length, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (chars->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (length < 0)
+            throw gcnew ArgumentOutOfRangeException(L"length must be greater or equal to 0");
+
+        if (!length)
+        {
+            resultsCount = 0;
+            return false;
+        }
+
+        // realloc the to maximum possible results size if needed
+        if (results->Length < length)
+        {
+            results = gcnew array<MatchIndex >(length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
+
+        pin_ptr<const wchar_t> pinChars = PtrToStringChars(chars);
+        pin_ptr<MatchIndex > pinResults = &results[0];
+
+        resultsCount = StrIndexOfAll(str, pinChars, chars->Length, 0, length, (int*)pinResults);
+        return resultsCount != 0;
+    }
+
+    bool __clrcall String::IndexOfAll(System::Text::StringBuilder ^ str, wchar_t c, array<MatchIndex >^% results, [Out] int% resultsCount)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        int length = str->Length;
+        if (!length)
+        {
+            resultsCount = 0;
+            return false;
+        }
+
+        // realloc the to maximum possible results size if needed
+        if (results->Length < length)
+        {
+            results = gcnew array<MatchIndex >(length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
+
+        array<wchar_t>^ window = BuilderWindow();
+        pin_ptr<const wchar_t> pinWindow = &window[0];
+        pin_ptr<MatchIndex > pinResults = &results[0];
+
+        // the only state carried from a window to the next is the window offset in the builder
+        resultsCount = 0;
+        for (int offset = 0; offset < length; offset += BuilderWindowLength)
+        {
+            int count = length - offset < BuilderWindowLength ? length - offset : BuilderWindowLength;
+            str->CopyTo(offset, window, 0, count);
+
+            int* windowResults = (int*)pinResults + (resultsCount << 1);
+            int windowResultsCount = StrIndexOfAll(pinWindow, &c, 1, 0, count, windowResults);
+            for (int i = 0; i < windowResultsCount; ++i)
+                windowResults[i << 1] += offset;    // window index to builder index
+
+            resultsCount += windowResultsCount;
+        }
+        return resultsCount != 0;
+    }
+
+    bool __clrcall String::IndexOfAll(System::Text::StringBuilder ^ str, array<wchar_t>^ chars, array<MatchIndex >^% results, [Out] int% resultsCount)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (chars->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        int length = str->Length;
+        if (!length)
+        {
+            resultsCount = 0;
+            return false;
+        }
+
+        // realloc the to maximum possible results size if needed
+        if (results->Length < length)
+        {
+            results = gcnew array<MatchIndex >(length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
+
+        array<wchar_t>^ window = BuilderWindow();
+        pin_ptr<const wchar_t> pinWindow = &window[0];
+        pin_ptr<const wchar_t> pinChars = &chars[0];
+        pin_ptr<MatchIndex > pinResults = &results[0];
+
+        // the only state carried from a window to the next is the window offset in the builder
+        resultsCount = 0;
+        for (int offset = 0; offset < length; offset += BuilderWindowLength)
+        {
+            int count = length - offset < BuilderWindowLength ? length - offset : BuilderWindowLength;
+            str->CopyTo(offset, window, 0, count);
+
+            int* windowResults = (int*)pinResults + (resultsCount << 1);
+            int windowResultsCount = StrIndexOfAll(pinWindow, pinChars, chars->Length, 0, count, windowResults);
+            for (int i = 0; i < windowResultsCount; ++i)
+                windowResults[i << 1] += offset;    // window index to builder index
+
+            resultsCount += windowResultsCount;
+        }
+        return resultsCount != 0;
+    }
+
+    bool __clrcall String::IndexOfAll(System::Text::StringBuilder ^ str, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (chars->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        int length = str->Length;
+        if (!length)
+        {
+            resultsCount = 0;
+            return false;
+        }
+
+        // realloc the to maximum possible results size if needed
+        if (results->Length < length)
+        {
+            results = gcnew array<MatchIndex >(length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
+
+        array<wchar_t>^ window = BuilderWindow();
+        pin_ptr<const wchar_t> pinWindow = &window[0];
+        pin_ptr<const wchar_t> pinChars = PtrToStringChars(chars);
+        pin_ptr<MatchIndex > pinResults = &results[0];
+
+        // the only state carried from a window to the next is the window offset in the builder
+        resultsCount = 0;
+        for (int offset = 0; offset < length; offset += BuilderWindowLength)
+        {
+            int count = length - offset < BuilderWindowLength ? length - offset : BuilderWindowLength;
+            str->CopyTo(offset, window, 0, count);
+
+            int* windowResults = (int*)pinResults + (resultsCount << 1);
+            int windowResultsCount = StrIndexOfAll(pinWindow, pinChars, chars->Length, 0, count, windowResults);
+            for (int i = 0; i < windowResultsCount; ++i)
+                windowResults[i << 1] += offset;    // window index to builder index
+
+            resultsCount += windowResultsCount;
+        }
+        return resultsCount != 0;
+    }
+
+    int __clrcall String::IndexOfAny(System::String ^ str, array<wchar_t>^ anyOf)
+    {
+        if (anyOf == nullptr)
+            throw gcnew ArgumentNullException("anyOf is null");
+
+        if (anyOf->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (!str->Length)
+            return -1;
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<const wchar_t> pinChars = &anyOf[0];
+        return StrIndexOfAny(pinStr, pinChars, anyOf->Length, 0, str->Length);
+    }
+
+    int __clrcall String::IndexOfAny(System::String ^ str, array<wchar_t>^ anyOf, int startIndex)
+    {
+        if (anyOf == nullptr)
+            throw gcnew ArgumentNullException("anyOf is null");
+
+        if (anyOf->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (!str->Length)
+            return -1;
+
+        if (startIndex < 0 || startIndex + 1 > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length - 1");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<const wchar_t> pinChars = &anyOf[0];
+        return StrIndexOfAny(pinStr, pinChars, anyOf->Length, startIndex, str->Length - startIndex);
+    }
+
+    int __clrcall String::IndexOfAny(System::String ^ str, array<wchar_t>^ anyOf, int startIndex, int count)
+    {
+        //if (str->Length < 128)
+        //    return str->IndexOfAny(anyOf, startIndex, count);
+        if (anyOf == nullptr)
+            throw gcnew ArgumentNullException("anyOf is null");
+
+        if (anyOf->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (!str->Length)
+            return -1;
+
+        if (startIndex < 0 || startIndex + 1 > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length - 1");
+
+        if (count > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<const wchar_t> pinChars = &anyOf[0];
+        return StrIndexOfAny(pinStr, pinChars, anyOf->Length, startIndex, count);
+    }
+
+    int __clrcall String::IndexOfAny(array<wchar_t>^ str, array<wchar_t>^ anyOf, int startIndex, int count)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (anyOf == nullptr)
+            throw gcnew ArgumentNullException("anyOf is null");
+
+        if (anyOf->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (startIndex < 0 || startIndex > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length");
+
+        if (count < 0 || count > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+
+        if (!count)
+            return -1;
+
+        pin_ptr<const wchar_t> pinStr = &str[0];
+        pin_ptr<const wchar_t> pinChars = &anyOf[0];
+        return StrIndexOfAny(pinStr, pinChars, anyOf->Length, startIndex, count);
+    }
+
+    int __clrcall String::IndexOfAny(const wchar_t* str, int length, array<wchar_t>^ anyOf)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (anyOf == nullptr)
+            throw gcnew ArgumentNullException("anyOf is null");
+
+        if (anyOf->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (length < 0)
+            throw gcnew ArgumentOutOfRangeException(L"length must be greater or equal to 0");
+
+        if (!length)
+            return -1;
+
+        pin_ptr<const wchar_t> pinChars = &anyOf[0];
+        return StrIndexOfAny(str, pinChars, anyOf->Length, 0, length);
+    }
+
+    int __clrcall String::IndexOfAny(System::Text::StringBuilder ^ str, array<wchar_t>^ anyOf)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (anyOf == nullptr)
+            throw gcnew ArgumentNullException("anyOf is null");
+
+        if (anyOf->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        int length = str->Length;
+        if (!length)
+            return -1;
+
+        array<wchar_t>^ window = BuilderWindow();
+        pin_ptr<const wchar_t> pinWindow = &window[0];
+        pin_ptr<const wchar_t> pinChars = &anyOf[0];
+
+        for (int offset = 0; offset < length; offset += BuilderWindowLength)
+        {
+            int count = length - offset < BuilderWindowLength ? length - offset : BuilderWindowLength;
+            str->CopyTo(offset, window, 0, count);
+
+            int index = StrIndexOfAny(pinWindow, pinChars, anyOf->Length, 0, count);
+            if (index >= 0)
+                return offset + index;
+        }
+        return -1;
+    }
+
+    array<wchar_t>^ __clrcall String::BuilderWindow()
+    {
+        array<wchar_t>^ window = builderWindow_;
+        if (window == nullptr)
+            builderWindow_ = window = gcnew array<wchar_t>(BuilderWindowLength);
+        return window;
+    }
+
+#ifdef INTRINSICS_TEST
+
+    bool __clrcall String::IndexOfAllWip(System::String ^ str, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count)
+    {
+        if (chars->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (!str->Length)
+        {
+            resultsCount = 0;
+            return false;
+        }
+
+
+        if (startIndex < 0 || startIndex + 1 > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length - 1");
+
+        if (count > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+
+        // realloc the to maximum possible results size if needed
+        if (results->Length < str->Length)
+        {
+            results = gcnew array<MatchIndex >(str->Length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<const wchar_t> pinChars = PtrToStringChars(chars);
+        pin_ptr<MatchIndex > pinResults = &results[0];
+
+        resultsCount = StrIndexOfAll_SSE2_V2(pinStr, pinChars, chars->Length, startIndex, count, (int*)pinResults);
+        return resultsCount != 0;
+    }
+
+    bool __clrcall String::IndexOfAllCli(System::String ^ str, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count)
+    {
+        if (chars->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (!str->Length)
+        {
+            resultsCount = 0;
+            return false;
+        }
+
+        if (startIndex < 0 || startIndex + 1 > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length - 1");
+
+        if (count > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+
+        resultsCount = 0;
+        int end = startIndex + count;
+        for (int i = startIndex; i < end; ++i)
+        {
+            for (int j = 0; j < chars->Length; ++j)
+            {
+                if (str[i] == chars[j])
+                {
+                    results[resultsCount].StringIndex = i;
+                    results[resultsCount++].CharIndex = j;
+                    break;
+                }
+            }
+        }
+        return resultsCount != 0;
+    }
+
+    bool __clrcall String::IndexOfAllCpp(System::String ^ str, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count)
+    {
+        if (chars->Length > SearchCharsMax)
+            throw gcnew ArgumentOutOfRangeException(System::String::Format(L"chars length must be smaller than {0}", SearchCharsMax));
+
+        if (!str->Length)
+        {
+            resultsCount = 0;
+            return false;
+        }
+
+        if (startIndex < 0 || startIndex + 1 > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length - 1");
+
+        if (count > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+
+        // realloc the to maximum possible results size if needed
         if (results->Length < str->Length)
+        {
             results = gcnew array<MatchIndex >(str->Length);
+            INTRINSICS_PROBE_REALLOCATION(IndexOfAll);
+        }
 
         pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
         pin_ptr<const wchar_t> pinChars = PtrToStringChars(chars);
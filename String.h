@@ -21,13 +21,15 @@
 //  SOFTWARE.
 #pragma once
 
+#include "StringKernels.h"
+
 using namespace System;
 using namespace System::Collections::Generic;
 using namespace System::Runtime::InteropServices;
 
 namespace Intrinsics
 {
-    static const int SearchCharsMax = 32;
+    ref class MatchBuffer;
 
     public ref class String abstract sealed
     {
@@ -46,6 +48,33 @@ namespace Intrinsics
             int CharIndex;
         };
 
+        // (start index, length) of a field, see GetFieldRanges
+        value struct FieldRange
+        {
+        public:
+            __clrcall FieldRange(int startIndex, int length)
+            {
+                StartIndex = startIndex;
+                Length = length;
+            };
+
+            int StartIndex;
+            int Length;
+        };
+
+        enum class HashAlgorithm
+        {
+            Crc32C,     // sse4.2 crc32, fastest, a seed don't prevent crafted collisions
+            Aes         // aes rounds keyed by the seed, use a secret seed for untrusted keys
+        };
+
+        value struct Hash128Value
+        {
+        public:
+            Int64 Low;
+            Int64 High;
+        };
+
         literal int SearchCharsMax = Intrinsics::SearchCharsMax;
 
         static bool __clrcall IndexOfAll(System::String ^ str, wchar_t c, array<MatchIndex >^% results, [Out] int% resultsCount);
@@ -66,12 +95,188 @@ namespace Intrinsics
 
         static bool __clrcall IndexOfAll(System::String ^ str, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count);
 
+        // MatchBuffer overloads grow the rented buffer from the matches count, see MatchBufferPool
+        static bool __clrcall IndexOfAll(System::String ^ str, wchar_t c, MatchBuffer ^ results);
+
+        static bool __clrcall IndexOfAll(System::String ^ str, wchar_t c, MatchBuffer ^ results, int startIndex);
+
+        static bool __clrcall IndexOfAll(System::String ^ str, wchar_t c, MatchBuffer ^ results, int startIndex, int count);
+
+        static bool __clrcall IndexOfAll(System::String ^ str, array<wchar_t>^ chars, MatchBuffer ^ results);
+
+        static bool __clrcall IndexOfAll(System::String ^ str, array<wchar_t>^ chars, MatchBuffer ^ results, int startIndex);
+
+        static bool __clrcall IndexOfAll(System::String ^ str, array<wchar_t>^ chars, MatchBuffer ^ results, int startIndex, int count);
+
+        static bool __clrcall IndexOfAll(System::String ^ str, System::String ^ chars, MatchBuffer ^ results);
+
+        static bool __clrcall IndexOfAll(System::String ^ str, System::String ^ chars, MatchBuffer ^ results, int startIndex);
+
+        static bool __clrcall IndexOfAll(System::String ^ str, System::String ^ chars, MatchBuffer ^ results, int startIndex, int count);
+
+        // char array slice overloads, results index are relative to the array start
+        static bool __clrcall IndexOfAll(array<wchar_t>^ str, wchar_t c, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count);
+
+        static bool __clrcall IndexOfAll(array<wchar_t>^ str, array<wchar_t>^ chars, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count);
+
+        static bool __clrcall IndexOfAll(array<wchar_t>^ str, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count);
+
+        // raw pointer overloads for unsafe callers, str must stay valid (pinned) during the call
+        [CLSCompliant(false)]
+        static bool __clrcall IndexOfAll(const wchar_t* str, int length, wchar_t c, array<MatchIndex >^% results, [Out] int% resultsCount);
+
+        [CLSCompliant(false)]
+        static bool __clrcall IndexOfAll(const wchar_t* str, int length, array<wchar_t>^ chars, array<MatchIndex >^% results, [Out] int% resultsCount);
+
+        [CLSCompliant(false)]
+        static bool __clrcall IndexOfAll(const wchar_t* str, int length, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount);
+
+        // StringBuilder overloads, search the builder content without creating a string. .net 4.5 has no
+        // StringBuilder.GetChunks, the content is copied by window with CopyTo that walks the chunks list
+        // from the last chunk: each window cost the chunks count on top of its copy. on builders of many
+        // chunks (more than a few 100k chars) ToString then the string overload is as fast, these save
+        // the string allocation only
+        static bool __clrcall IndexOfAll(System::Text::StringBuilder ^ str, wchar_t c, array<MatchIndex >^% results, [Out] int% resultsCount);
+
+        static bool __clrcall IndexOfAll(System::Text::StringBuilder ^ str, array<wchar_t>^ chars, array<MatchIndex >^% results, [Out] int% resultsCount);
+
+        static bool __clrcall IndexOfAll(System::Text::StringBuilder ^ str, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount);
+
         static int __clrcall IndexOfAny(System::String ^ str, array<wchar_t>^ anyOf);
 
         static int __clrcall IndexOfAny(System::String ^ str, array<wchar_t>^ anyOf, int startIndex);
 
         static int __clrcall IndexOfAny(System::String ^ str, array<wchar_t>^ anyOf, int startIndex, int count);
 
+        static int __clrcall IndexOfAny(array<wchar_t>^ str, array<wchar_t>^ anyOf, int startIndex, int count);
+
+        [CLSCompliant(false)]
+        static int __clrcall IndexOfAny(const wchar_t* str, int length, array<wchar_t>^ anyOf);
+
+        // copied by window like the IndexOfAll StringBuilder overloads, stops at the window of the first match
+        static int __clrcall IndexOfAny(System::Text::StringBuilder ^ str, array<wchar_t>^ anyOf);
+
+        // ordinal compares, the vector kernels find the first char that differ. IgnoreCase fold the ascii
+        // letters only, like the hashes.
+        static bool __clrcall Equals(System::String ^ a, System::String ^ b);
+
+        static bool __clrcall EqualsIgnoreCase(System::String ^ a, System::String ^ b);
+
+        // difference of the first chars that differ, or of the lengths. null is smaller than any string
+        static int __clrcall CompareOrdinal(System::String ^ a, System::String ^ b);
+
+        static int __clrcall CompareOrdinal(System::String ^ a, int indexA, System::String ^ b, int indexB, int length);
+
+        static bool __clrcall StartsWith(System::String ^ str, System::String ^ value);
+
+        static bool __clrcall EndsWith(System::String ^ str, System::String ^ value);
+
+        static int __clrcall CommonPrefixLength(System::String ^ a, System::String ^ b);
+
+        // chars before startIndex are known to be equal, the result count them
+        static int __clrcall CommonPrefixLength(System::String ^ a, System::String ^ b, int startIndex);
+
+        // hashes of the string chars, ignoreCase fold the ascii letters only. values don't depend on the
+        // cpu, a software version run when the instructions are missing. see HashComparer for dictionaries.
+        static int __clrcall Hash32(System::String ^ str);
+
+        static int __clrcall Hash32(System::String ^ str, Int64 seed, bool ignoreCase);
+
+        static Int64 __clrcall Hash64(System::String ^ str, HashAlgorithm algorithm);
+
+        static Int64 __clrcall Hash64(System::String ^ str, HashAlgorithm algorithm, Int64 seed, bool ignoreCase);
+
+        static Int64 __clrcall Hash64(array<wchar_t>^ str, int startIndex, int count, HashAlgorithm algorithm, Int64 seed, bool ignoreCase);
+
+        [CLSCompliant(false)]
+        static Int64 __clrcall Hash64(const wchar_t* str, int length, HashAlgorithm algorithm, Int64 seed, bool ignoreCase);
+
+        static Hash128Value __clrcall Hash128(System::String ^ str, Int64 seed, bool ignoreCase);
+
+        static bool __clrcall IsAscii(System::String ^ str);
+
+        static bool __clrcall IsAscii(array<unsigned char>^ bytes, int index, int count);
+
+        // false when str has an unpaired surrogate
+        static bool __clrcall IsValidUtf16(System::String ^ str);
+
+        // false on overlong, surrogate, above U+10FFFF or truncated sequences
+        static bool __clrcall IsValidUtf8(array<unsigned char>^ bytes, int index, int count);
+
+        // utf-8 transcoding, invalid input throw ArgumentException with the first invalid index instead of
+        // being replaced. the count methods are the exact length pre-pass of the caller buffers.
+        static int __clrcall GetUtf8ByteCount(System::String ^ str);
+
+        static int __clrcall ToUtf8(System::String ^ str, array<unsigned char>^ bytes, int byteIndex);
+
+        static array<unsigned char>^ __clrcall ToUtf8(System::String ^ str);
+
+        static int __clrcall GetUtf16CharCount(array<unsigned char>^ bytes, int index, int count);
+
+        static int __clrcall FromUtf8(array<unsigned char>^ bytes, int index, int count, array<wchar_t>^ chars, int charIndex);
+
+        static System::String ^ __clrcall FromUtf8(array<unsigned char>^ bytes, int index, int count);
+
+        // fields between the delimiters found by IndexOfAll, delimitersCount + 1 ranges. ranges grow when
+        // too small, returns the ranges count
+        static int __clrcall GetFieldRanges(System::String ^ str, array<MatchIndex >^ delimiters, int delimitersCount, array<FieldRange >^% ranges);
+
+        // parse count ranges of str in values, values grow when too small. plain forms ('-' then digits,
+        // with a '.' for doubles) are parsed by the vector kernels, others by Int64::Parse or Double::Parse
+        // with the invariant culture, which throw on invalid fields
+        static void __clrcall ParseInt64Batch(System::String ^ str, array<FieldRange >^ ranges, int count, array<Int64>^% values);
+
+        static void __clrcall ParseDoubleBatch(System::String ^ str, array<FieldRange >^ ranges, int count, array<double>^% values);
+
+        static double __clrcall ParseDouble(System::String ^ str);
+
+        static double __clrcall ParseDouble(System::String ^ str, int startIndex, int length);
+
+        // whitespace is the char::IsWhiteSpace set. the trims return str when there is nothing to remove
+        static System::String ^ __clrcall Trim(System::String ^ str);
+
+        static System::String ^ __clrcall TrimStart(System::String ^ str);
+
+        static System::String ^ __clrcall TrimEnd(System::String ^ str);
+
+        // part of [startIndex, startIndex + length[ without the leading and trailing whitespace
+        static FieldRange __clrcall TrimRange(System::String ^ str, int startIndex, int length);
+
+        // trim count ranges in place, see GetFieldRanges
+        static void __clrcall TrimRanges(System::String ^ str, array<FieldRange >^ ranges, int count);
+
+        static bool __clrcall IsNullOrWhiteSpace(System::String ^ str);
+
+        // each whitespace run replaced by a single space, chars must have room for str length chars.
+        // returns the chars written
+        static int __clrcall CollapseWhitespace(System::String ^ str, array<wchar_t>^ chars, int charIndex);
+
+        // occurrences of each char below 0x100 added to counts[c], the other chars to counts[256]. counts
+        // must have 257 elements, it is not cleared so a histogram can span several strings
+        static void __clrcall Histogram(System::String ^ str, array<int>^ counts);
+
+        static void __clrcall Histogram(System::String ^ str, int startIndex, int count, array<int>^ counts);
+
+        // the distinct chars of str in increasing order and their occurrences, chars and counts grow when
+        // too small. returns the distinct chars count
+        static int __clrcall HistogramSparse(System::String ^ str, array<wchar_t>^% chars, array<int>^% counts);
+
+        static int __clrcall HistogramSparse(System::String ^ str, int startIndex, int count, array<wchar_t>^% chars, array<int>^% counts);
+
+        // levenshtein distance of a and b, inserts, deletes and substitutes cost 1
+        static int __clrcall EditDistance(System::String ^ a, System::String ^ b);
+
+        // EditDistance bounded by maxDistance, returns maxDistance + 1 when the distance is larger. stops
+        // as soon as the distance can't be maxDistance or less, much faster on unrelated strings.
+        // maxDistance must be 0 or more
+        static int __clrcall EditDistance(System::String ^ a, System::String ^ b, int maxDistance);
+
+        // EditDistance of pattern to each candidate in distances, bounded like EditDistance when maxDistance
+        // >= 0 and exact when maxDistance is negative. several candidates scored at once on vector lanes,
+        // pinned and scored 16 at a time. distances grows when too small. returns the candidates within
+        // maxDistance, all of them when it is negative
+        static int __clrcall EditDistanceBatch(System::String ^ pattern, array<System::String ^>^ candidates, int maxDistance, array<int>^% distances);
+
 #ifdef INTRINSICS_TEST
         // use to make optim and compare results
         static bool __clrcall IndexOfAllWip(System::String ^ str, System::String ^ chars, array<MatchIndex >^% results, [Out] int% resultsCount, int startIndex, int count);
@@ -84,5 +289,18 @@ namespace Intrinsics
 
         static int __clrcall IndexOfAnyCpp(System::String ^ str, array<wchar_t>^ anyOf, int startIndex, int count);
 #endif
+
+    private:
+        // install the crossover table before the first search, see Tuning
+        static String();
+
+        // StringBuilder content is copied by window in this buffer, small enough to stay in L1. larger than
+        // the 8000 chars StringBuilder max chunk, there is no more CopyTo chunks walks than chunks
+        literal int BuilderWindowLength = 8192;
+
+        static array<wchar_t>^ __clrcall BuilderWindow();
+
+        [ThreadStatic]
+        static array<wchar_t>^ builderWindow_;
     };
 }
@@ -0,0 +1,196 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "String.h"
+
+#include <vcclr.h>          // cli/c++ pinning
+#include "StringKernels.h"  // unmanaged kernels
+#include "Tuning.h"         // crossover table
+
+#pragma managed
+
+static int StrCommonPrefix_CLI(const wchar_t* a, const wchar_t* b, int length, bool ignoreCase)
+{
+    for (int i = 0; i < length; ++i)
+    {
+        wchar_t ca = a[i];
+        wchar_t cb = b[i];
+        if (ca == cb)
+            continue;
+        if (!ignoreCase)
+            return i;
+        if ((unsigned)(ca - L'A') < 26u)
+            ca |= 0x20;
+        if ((unsigned)(cb - L'A') < 26u)
+            cb |= 0x20;
+        if (ca != cb)
+            return i;
+    }
+    return length;
+}
+
+int StrCommonPrefixTier(TuningTier tier, const wchar_t* a, const wchar_t* b, int length, bool ignoreCase)
+{
+    switch (tier)
+    {
+    case TuningAvx2:
+        return StrCommonPrefix_AVX2(a, b, length, ignoreCase);
+    case TuningSse2:
+        return StrCommonPrefix_SSE2(a, b, length, ignoreCase);
+    case TuningCpp:
+        return StrCommonPrefix_CPP(a, b, length, ignoreCase);
+    default:
+        return StrCommonPrefix_CLI(a, b, length, ignoreCase);
+    }
+}
+
+static int StrCommonPrefix(const wchar_t* a, const wchar_t* b, int length, bool ignoreCase)
+{
+    return StrCommonPrefixTier(TuningSelect(TuningCommonPrefix, 1, length), a, b, length, ignoreCase);
+}
+
+namespace Intrinsics
+{
+    static bool __clrcall EqualsCore(System::String ^ a, System::String ^ b, bool ignoreCase)
+    {
+        if (Object::ReferenceEquals(a, b))
+            return true;
+
+        if (a == nullptr || b == nullptr || a->Length != b->Length)
+            return false;
+
+        pin_ptr<const wchar_t> pinA = PtrToStringChars(a);
+        pin_ptr<const wchar_t> pinB = PtrToStringChars(b);
+        return StrCommonPrefix(pinA, pinB, a->Length, ignoreCase) == a->Length;
+    }
+
+    static int __clrcall CompareCore(const wchar_t* a, int lengthA, const wchar_t* b, int lengthB)
+    {
+        const int length = lengthA < lengthB ? lengthA : lengthB;
+        const int prefix = StrCommonPrefix(a, b, length, false);
+        if (prefix < length)
+            return (int)a[prefix] - (int)b[prefix];
+        return lengthA - lengthB;
+    }
+
+    bool __clrcall String::Equals(System::String ^ a, System::String ^ b)
+    {
+        return EqualsCore(a, b, false);
+    }
+
+    bool __clrcall String::EqualsIgnoreCase(System::String ^ a, System::String ^ b)
+    {
+        return EqualsCore(a, b, true);
+    }
+
+    int __clrcall String::CompareOrdinal(System::String ^ a, System::String ^ b)
+    {
+        if (Object::ReferenceEquals(a, b))
+            return 0;
+
+        if (a == nullptr)
+            return -1;
+
+        if (b == nullptr)
+            return 1;
+
+        pin_ptr<const wchar_t> pinA = PtrToStringChars(a);
+        pin_ptr<const wchar_t> pinB = PtrToStringChars(b);
+        return CompareCore(pinA, a->Length, pinB, b->Length);
+    }
+
+    int __clrcall String::CompareOrdinal(System::String ^ a, int indexA, System::String ^ b, int indexB, int length)
+    {
+        if (a == nullptr || b == nullptr)
+            return a == nullptr ? (b == nullptr ? 0 : -1) : 1;
+
+        if (length < 0)
+            throw gcnew ArgumentOutOfRangeException(L"length must be greater or equal to 0");
+
+        if (indexA < 0 || indexA > a->Length)
+            throw gcnew ArgumentOutOfRangeException(L"indexA must be greater than 0 and smaller than a length");
+
+        if (indexB < 0 || indexB > b->Length)
+            throw gcnew ArgumentOutOfRangeException(L"indexB must be greater than 0 and smaller than b length");
+
+        // like System::String::CompareOrdinal, length is clamped to each string end
+        const int lengthA = length < a->Length - indexA ? length : a->Length - indexA;
+        const int lengthB = length < b->Length - indexB ? length : b->Length - indexB;
+
+        pin_ptr<const wchar_t> pinA = PtrToStringChars(a);
+        pin_ptr<const wchar_t> pinB = PtrToStringChars(b);
+        return CompareCore((const wchar_t*)pinA + indexA, lengthA, (const wchar_t*)pinB + indexB, lengthB);
+    }
+
+    bool __clrcall String::StartsWith(System::String ^ str, System::String ^ value)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (value == nullptr)
+            throw gcnew ArgumentNullException("value is null");
+
+        if (value->Length > str->Length)
+            return false;
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<const wchar_t> pinValue = PtrToStringChars(value);
+        return StrCommonPrefix(pinStr, pinValue, value->Length, false) == value->Length;
+    }
+
+    bool __clrcall String::EndsWith(System::String ^ str, System::String ^ value)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (value == nullptr)
+            throw gcnew ArgumentNullException("value is null");
+
+        if (value->Length > str->Length)
+            return false;
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<const wchar_t> pinValue = PtrToStringChars(value);
+        return StrCommonPrefix((const wchar_t*)pinStr + (str->Length - value->Length), pinValue, value->Length, false) == value->Length;
+    }
+
+    int __clrcall String::CommonPrefixLength(System::String ^ a, System::String ^ b)
+    {
+        return CommonPrefixLength(a, b, 0);
+    }
+
+    int __clrcall String::CommonPrefixLength(System::String ^ a, System::String ^ b, int startIndex)
+    {
+        if (a == nullptr)
+            throw gcnew ArgumentNullException("a is null");
+
+        if (b == nullptr)
+            throw gcnew ArgumentNullException("b is null");
+
+        const int length = a->Length < b->Length ? a->Length : b->Length;
+        if (startIndex < 0 || startIndex > length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than the shortest string length");
+
+        pin_ptr<const wchar_t> pinA = PtrToStringChars(a);
+        pin_ptr<const wchar_t> pinB = PtrToStringChars(b);
+        return startIndex + StrCommonPrefix((const wchar_t*)pinA + startIndex, (const wchar_t*)pinB + startIndex, length - startIndex, false);
+    }
+}
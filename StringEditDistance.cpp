@@ -0,0 +1,118 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "String.h"
+
+#include <vcclr.h>                  // cli/c++ pinning
+#include "EditDistanceKernels.h"    // unmanaged kernels
+
+#pragma managed
+
+namespace Intrinsics
+{
+    // candidates scored per kernel call, a multiple of the AVX2 and SSE2 lanes. only a group is pinned at
+    // a time, the gc heap is never held by the whole batch
+    static const int EditBatchGroup = 16;
+
+    // pins the group candidate at index + lane then recurses for the next one, the kernel runs once the
+    // whole group is pinned and the pins are released on the way back
+    static int __clrcall EditDistanceGroup(const EditPattern* compiled, array<System::String ^>^ candidates, int index, int lane, int count,
+        const wchar_t** texts, int* lengths, int maxDistance, int* distances)
+    {
+        System::String ^ candidate = candidates[index + lane];
+        pin_ptr<const wchar_t> pinCandidate = PtrToStringChars(candidate);
+        texts[lane] = pinCandidate;
+        lengths[lane] = candidate->Length;
+        if (lane + 1 < count)
+            return EditDistanceGroup(compiled, candidates, index, lane + 1, count, texts, lengths, maxDistance, distances);
+        return StrEditDistanceBatch(compiled, texts, lengths, count, maxDistance, distances);
+    }
+
+    int __clrcall String::EditDistance(System::String ^ a, System::String ^ b)
+    {
+        if (a == nullptr)
+            throw gcnew ArgumentNullException("a is null");
+
+        if (b == nullptr)
+            throw gcnew ArgumentNullException("b is null");
+
+        pin_ptr<const wchar_t> pinA = PtrToStringChars(a);
+        pin_ptr<const wchar_t> pinB = PtrToStringChars(b);
+        return StrEditDistance(pinA, a->Length, pinB, b->Length, -1);
+    }
+
+    int __clrcall String::EditDistance(System::String ^ a, System::String ^ b, int maxDistance)
+    {
+        if (a == nullptr)
+            throw gcnew ArgumentNullException("a is null");
+
+        if (b == nullptr)
+            throw gcnew ArgumentNullException("b is null");
+
+        if (maxDistance < 0)
+            throw gcnew ArgumentOutOfRangeException(L"maxDistance must be greater or equal to 0");
+
+        pin_ptr<const wchar_t> pinA = PtrToStringChars(a);
+        pin_ptr<const wchar_t> pinB = PtrToStringChars(b);
+        return StrEditDistance(pinA, a->Length, pinB, b->Length, maxDistance);
+    }
+
+    int __clrcall String::EditDistanceBatch(System::String ^ pattern, array<System::String ^>^ candidates, int maxDistance, array<int>^% distances)
+    {
+        if (pattern == nullptr)
+            throw gcnew ArgumentNullException("pattern is null");
+
+        if (candidates == nullptr)
+            throw gcnew ArgumentNullException("candidates is null");
+
+        for (int i = 0; i < candidates->Length; ++i)
+        {
+            if (candidates[i] == nullptr)
+                throw gcnew ArgumentNullException("candidates element is null");
+        }
+
+        if (distances == nullptr || distances->Length < candidates->Length)
+            distances = gcnew array<int>(candidates->Length);
+
+        if (!candidates->Length)
+            return 0;
+
+        pin_ptr<const wchar_t> pinPattern = PtrToStringChars(pattern);
+        pin_ptr<int> pinDistances = &distances[0];
+        EditPattern* compiled = StrEditPatternCreate(pinPattern, pattern->Length);
+        int within = 0;
+        try
+        {
+            for (int i = 0; i < candidates->Length; i += EditBatchGroup)
+            {
+                const int count = candidates->Length - i < EditBatchGroup ? candidates->Length - i : EditBatchGroup;
+                const wchar_t* texts[EditBatchGroup];
+                int lengths[EditBatchGroup];
+                within += EditDistanceGroup(compiled, candidates, i, 0, count, texts, lengths, maxDistance, (int*)pinDistances + i);
+            }
+        }
+        finally
+        {
+            StrEditPatternFree(compiled);
+        }
+        return within;
+    }
+}
@@ -0,0 +1,160 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "StringHash.h"
+#include "Cpu.h"
+
+#include <vcclr.h>              // cli/c++ pinning
+#include "StringHashKernels.h"  // unmanaged kernels
+
+#pragma managed
+
+static int64_t StrHash64(const wchar_t* str, int length, Intrinsics::String::HashAlgorithm algorithm, int64_t seed, bool ignoreCase)
+{
+    if (algorithm == Intrinsics::String::HashAlgorithm::Crc32C)
+        return (int64_t)StrHashCrc32C(str, length, (uint64_t)seed, ignoreCase);
+
+    uint64_t hash[2];
+    StrHashAes(str, length, (uint64_t)seed, ignoreCase, hash);
+    return (int64_t)hash[0];
+}
+
+namespace Intrinsics
+{
+    int __clrcall String::Hash32(System::String ^ str)
+    {
+        return Hash32(str, 0, false);
+    }
+
+    int __clrcall String::Hash32(System::String ^ str, Int64 seed, bool ignoreCase)
+    {
+        // 64 bits crc hash folded
+        Int64 hash = Hash64(str, HashAlgorithm::Crc32C, seed, ignoreCase);
+        return (int)(hash ^ (hash >> 32));
+    }
+
+    Int64 __clrcall String::Hash64(System::String ^ str, HashAlgorithm algorithm)
+    {
+        return Hash64(str, algorithm, 0, false);
+    }
+
+    Int64 __clrcall String::Hash64(System::String ^ str, HashAlgorithm algorithm, Int64 seed, bool ignoreCase)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (algorithm != HashAlgorithm::Crc32C && algorithm != HashAlgorithm::Aes)
+            throw gcnew ArgumentOutOfRangeException(L"algorithm");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        return StrHash64(pinStr, str->Length, algorithm, seed, ignoreCase);
+    }
+
+    Int64 __clrcall String::Hash64(array<wchar_t>^ str, int startIndex, int count, HashAlgorithm algorithm, Int64 seed, bool ignoreCase)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (startIndex < 0 || startIndex > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length");
+
+        if (count < 0 || count > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+
+        if (algorithm != HashAlgorithm::Crc32C && algorithm != HashAlgorithm::Aes)
+            throw gcnew ArgumentOutOfRangeException(L"algorithm");
+
+        if (!count)
+            return StrHash64(nullptr, 0, algorithm, seed, ignoreCase);
+
+        pin_ptr<const wchar_t> pinStr = &str[startIndex];
+        return StrHash64(pinStr, count, algorithm, seed, ignoreCase);
+    }
+
+    Int64 __clrcall String::Hash64(const wchar_t* str, int length, HashAlgorithm algorithm, Int64 seed, bool ignoreCase)
+    {
+        if (str == nullptr && length)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (length < 0)
+            throw gcnew ArgumentOutOfRangeException(L"length must be greater or equal to 0");
+
+        if (algorithm != HashAlgorithm::Crc32C && algorithm != HashAlgorithm::Aes)
+            throw gcnew ArgumentOutOfRangeException(L"algorithm");
+
+        return StrHash64(str, length, algorithm, seed, ignoreCase);
+    }
+
+    String::Hash128Value __clrcall String::Hash128(System::String ^ str, Int64 seed, bool ignoreCase)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        uint64_t hash[2];
+        StrHashAes(pinStr, str->Length, (uint64_t)seed, ignoreCase, hash);
+
+        Hash128Value value;
+        value.Low = (Int64)hash[0];
+        value.High = (Int64)hash[1];
+        return value;
+    }
+
+    HashComparer::HashComparer(String::HashAlgorithm algorithm, bool ignoreCase, Int64 seed)
+        : algorithm_(algorithm), ignoreCase_(ignoreCase), seed_(seed)
+    {
+        if (algorithm != String::HashAlgorithm::Crc32C && algorithm != String::HashAlgorithm::Aes)
+            throw gcnew ArgumentOutOfRangeException(L"algorithm");
+    }
+
+    HashComparer::HashComparer()
+    {
+        // software aes is slower than the crc fallback, values only need to be stable in this process
+        String::HashAlgorithm algorithm = Cpu::Supports(CpuFeatures::Aes) ? String::HashAlgorithm::Aes : String::HashAlgorithm::Crc32C;
+        ordinal_ = gcnew HashComparer(algorithm, false, RandomSeed());
+        ordinalIgnoreCase_ = gcnew HashComparer(algorithm, true, RandomSeed());
+    }
+
+    Int64 __clrcall HashComparer::RandomSeed()
+    {
+        array<unsigned char>^ bytes = gcnew array<unsigned char>(sizeof(Int64));
+        System::Security::Cryptography::RandomNumberGenerator^ random = System::Security::Cryptography::RandomNumberGenerator::Create();
+        random->GetBytes(bytes);
+        delete random;
+        return BitConverter::ToInt64(bytes, 0);
+    }
+
+    bool __clrcall HashComparer::Equals(System::String ^ x, System::String ^ y)
+    {
+        return ignoreCase_ ? String::EqualsIgnoreCase(x, y) : String::Equals(x, y);
+    }
+
+    int __clrcall HashComparer::GetHashCode(System::String ^ str)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        int64_t hash = StrHash64(pinStr, str->Length, algorithm_, seed_, ignoreCase_);
+        return (int)(hash ^ (hash >> 32));
+    }
+}
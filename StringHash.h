@@ -0,0 +1,75 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+#include "String.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace Intrinsics
+{
+    // string keys comparer for Dictionary and HashSet, hash with String::Hash64 and compare ordinal or
+    // ascii case insensitive to match the hash.
+    public ref class HashComparer sealed : IEqualityComparer<System::String ^>
+    {
+    public:
+        HashComparer(String::HashAlgorithm algorithm, bool ignoreCase, Int64 seed);
+
+        // Aes when the cpu support it, Crc32C otherwise, with a random seed per process
+        static property HashComparer^ Ordinal
+        {
+            HashComparer^ get() { return ordinal_; }
+        }
+
+        static property HashComparer^ OrdinalIgnoreCase
+        {
+            HashComparer^ get() { return ordinalIgnoreCase_; }
+        }
+
+        property String::HashAlgorithm Algorithm
+        {
+            String::HashAlgorithm get() { return algorithm_; }
+        }
+
+        property bool IgnoreCase
+        {
+            bool get() { return ignoreCase_; }
+        }
+
+        virtual bool __clrcall Equals(System::String ^ x, System::String ^ y);
+
+        virtual int __clrcall GetHashCode(System::String ^ str);
+
+    private:
+        static HashComparer();
+
+        static Int64 __clrcall RandomSeed();
+
+        static initonly HashComparer^ ordinal_;
+        static initonly HashComparer^ ordinalIgnoreCase_;
+
+        initonly String::HashAlgorithm algorithm_;
+        initonly bool ignoreCase_;
+        initonly Int64 seed_;
+    };
+}
@@ -0,0 +1,260 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "StringHashKernels.h"
+#include "InstructionSet.h"
+
+#include <intrin.h>         // intrinsics
+#include <emmintrin.h>      // SSE2
+#include <nmmintrin.h>      // SSE4.2 crc32
+#include <wmmintrin.h>      // AES
+
+namespace
+{
+    const uint64_t HashK0 = 0x9e3779b97f4a7c15ull;
+    const uint64_t HashK1 = 0xc2b2ae3d27d4eb4full;
+
+    // 8 chars, ascii letters folded to lower case when ignoreCase
+    __forceinline __m128i Block(__m128i v, bool ignoreCase)
+    {
+        if (!ignoreCase)
+            return v;
+
+        // 'A'-'Z' moved to the bottom of the signed range so a single compare select them
+        const __m128i t = _mm_add_epi16(v, _mm_set1_epi16((short)(0x8000 - 'A')));
+        const __m128i upper = _mm_cmplt_epi16(t, _mm_set1_epi16((short)(0x8000 + 26)));
+        return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi16(0x20)));
+    }
+
+    __forceinline __m128i Block(const wchar_t* s, bool ignoreCase)
+    {
+        return Block(_mm_loadu_si128((const __m128i*)s), ignoreCase);
+    }
+
+    // remaining chars zero padded, don't read past the string end
+    __forceinline __m128i TailBlock(const wchar_t* s, int remaining, bool ignoreCase)
+    {
+        wchar_t tail[8] = {};
+        for (int i = 0; i < remaining; ++i)
+            tail[i] = s[i];
+        return Block(tail, ignoreCase);
+    }
+
+    __forceinline __m128i Set64(uint64_t high, uint64_t low)
+    {
+        return _mm_set_epi32((int)(high >> 32), (int)high, (int)(low >> 32), (int)low);
+    }
+
+    // murmur3 finalizer
+    __forceinline uint64_t Mix64(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    struct Crc32CHardware
+    {
+        static __forceinline uint32_t U64(uint32_t crc, uint64_t v)
+        {
+#ifdef _M_X64
+            return (uint32_t)_mm_crc32_u64(crc, v);
+#else
+            return _mm_crc32_u32(_mm_crc32_u32(crc, (uint32_t)v), (uint32_t)(v >> 32));
+#endif
+        }
+    };
+
+    // bitwise crc32c, only used on cpus older than sse4.2
+    struct Crc32CSoftware
+    {
+        static __forceinline uint32_t U64(uint32_t crc, uint64_t v)
+        {
+            for (int i = 0; i < 8; ++i, v >>= 8)
+            {
+                crc ^= (uint32_t)(v & 0xff);
+                for (int bit = 0; bit < 8; ++bit)
+                    crc = (crc >> 1) ^ (0x82f63b78u & (0u - (crc & 1)));
+            }
+            return crc;
+        }
+    };
+
+    template<class Crc>
+    uint64_t HashCrc32C(const wchar_t* str, int length, uint64_t seed, bool ignoreCase)
+    {
+        uint32_t crc0 = (uint32_t)seed;
+        uint32_t crc1 = (uint32_t)(seed >> 32) ^ (uint32_t)HashK0;
+        uint64_t words[2];
+
+        const wchar_t* s = str;
+        const wchar_t* end = str + length;
+        for (; end - s >= 8; s += 8)
+        {
+            _mm_storeu_si128((__m128i*)words, Block(s, ignoreCase));
+            crc0 = Crc::U64(crc0, words[0]);
+            crc1 = Crc::U64(crc1, words[1]);
+        }
+
+        if (s < end)
+        {
+            _mm_storeu_si128((__m128i*)words, TailBlock(s, (int)(end - s), ignoreCase));
+            crc0 = Crc::U64(crc0, words[0]);
+            crc1 = Crc::U64(crc1, words[1]);
+        }
+
+        const uint64_t h = ((uint64_t)crc1 << 32 | crc0) + (uint64_t)length * HashK1;
+        return Mix64(h ^ seed);
+    }
+
+    struct AesHardware
+    {
+        static __forceinline __m128i Round(__m128i state, __m128i key)
+        {
+            return _mm_aesenc_si128(state, key);
+        }
+    };
+
+    // aesenc: ShiftRows, SubBytes, MixColumns then xor the round key, only used on cpus without aes
+    struct AesSoftware
+    {
+        static const unsigned char SBox[256];
+
+        static __forceinline unsigned char Times2(unsigned char x)
+        {
+            return (unsigned char)((x << 1) ^ ((x & 0x80) ? 0x1b : 0));
+        }
+
+        static __m128i Round(__m128i state, __m128i key)
+        {
+            unsigned char in[16];
+            unsigned char out[16];
+            _mm_storeu_si128((__m128i*)in, state);
+
+            // byte r + 4 * c is row r of column c
+            unsigned char shifted[16];
+            for (int c = 0; c < 4; ++c)
+            {
+                for (int r = 0; r < 4; ++r)
+                    shifted[r + 4 * c] = SBox[in[r + 4 * ((c + r) & 3)]];
+            }
+
+            for (int c = 0; c < 4; ++c)
+            {
+                const unsigned char a0 = shifted[4 * c], a1 = shifted[4 * c + 1], a2 = shifted[4 * c + 2], a3 = shifted[4 * c + 3];
+                out[4 * c] = (unsigned char)(Times2(a0) ^ Times2(a1) ^ a1 ^ a2 ^ a3);
+                out[4 * c + 1] = (unsigned char)(a0 ^ Times2(a1) ^ Times2(a2) ^ a2 ^ a3);
+                out[4 * c + 2] = (unsigned char)(a0 ^ a1 ^ Times2(a2) ^ Times2(a3) ^ a3);
+                out[4 * c + 3] = (unsigned char)(Times2(a0) ^ a0 ^ a1 ^ a2 ^ Times2(a3));
+            }
+            return _mm_xor_si128(_mm_loadu_si128((const __m128i*)out), key);
+        }
+    };
+
+    const unsigned char AesSoftware::SBox[256] =
+    {
+        0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+        0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+        0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+        0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+        0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+        0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+        0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+        0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+        0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+        0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+        0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+        0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+        0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+        0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+        0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+        0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+    };
+
+    // 2 states per block: the block as round key of the first, xored in the second keyed by the seed,
+    // so a block difference can't be cancelled by the next block without knowing the seed
+    template<class Aes>
+    void HashAes(const wchar_t* str, int length, uint64_t seed, bool ignoreCase, uint64_t hash[2])
+    {
+        const __m128i key = Set64(seed ^ HashK1, seed ^ HashK0);
+        __m128i state0 = key;
+        __m128i state1 = Aes::Round(key, Set64(HashK0, HashK1));
+
+        const wchar_t* s = str;
+        const wchar_t* end = str + length;
+        for (; end - s >= 8; s += 8)
+        {
+            const __m128i block = Block(s, ignoreCase);
+            state0 = Aes::Round(state0, block);
+            state1 = Aes::Round(_mm_xor_si128(state1, block), key);
+        }
+
+        if (s < end)
+        {
+            const __m128i block = TailBlock(s, (int)(end - s), ignoreCase);
+            state0 = Aes::Round(state0, block);
+            state1 = Aes::Round(_mm_xor_si128(state1, block), key);
+        }
+
+        __m128i h = Aes::Round(state0, state1);
+        h = Aes::Round(h, _mm_xor_si128(key, Set64(0, (uint64_t)length)));
+        h = Aes::Round(h, key);
+        _mm_storeu_si128((__m128i*)hash, h);
+    }
+}
+
+uint64_t StrHashCrc32C(const wchar_t* str, int length, uint64_t seed, bool ignoreCase)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE42))
+        return HashCrc32C<Crc32CHardware>(str, length, seed, ignoreCase);
+    return HashCrc32C<Crc32CSoftware>(str, length, seed, ignoreCase);
+}
+
+uint64_t StrHashCrc32C_SSE42(const wchar_t* str, int length, uint64_t seed, bool ignoreCase)
+{
+    return HashCrc32C<Crc32CHardware>(str, length, seed, ignoreCase);
+}
+
+uint64_t StrHashCrc32C_CPP(const wchar_t* str, int length, uint64_t seed, bool ignoreCase)
+{
+    return HashCrc32C<Crc32CSoftware>(str, length, seed, ignoreCase);
+}
+
+void StrHashAes(const wchar_t* str, int length, uint64_t seed, bool ignoreCase, uint64_t hash[2])
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAES))
+        HashAes<AesHardware>(str, length, seed, ignoreCase, hash);
+    else
+        HashAes<AesSoftware>(str, length, seed, ignoreCase, hash);
+}
+
+void StrHashAes_AESNI(const wchar_t* str, int length, uint64_t seed, bool ignoreCase, uint64_t hash[2])
+{
+    HashAes<AesHardware>(str, length, seed, ignoreCase, hash);
+}
+
+void StrHashAes_CPP(const wchar_t* str, int length, uint64_t seed, bool ignoreCase, uint64_t hash[2])
+{
+    HashAes<AesSoftware>(str, length, seed, ignoreCase, hash);
+}
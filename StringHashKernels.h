@@ -0,0 +1,48 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// unmanaged hash kernels, compiled without /clr like StringKernels
+//
+// the length chars of str are hashed. ignoreCase fold the ascii letters A-Z to a-z before hashing,
+// other chars are hashed ordinal. chars are consumed 8 at a time, the last partial block is zero
+// padded and the length is mixed in the finalization.
+// Crc32C kernels run the crc32 instruction on 2 interleaved 8 bytes lanes and finish with a 64 bits
+// mix. crc is linear, a seed change the values but don't prevent crafted collisions.
+// Aes kernels run aes encryption rounds with the seed as key and return 128 bits, use them with a
+// secret seed for untrusted keys.
+// _CPP kernels return the same values as the instructions kernels, the dispatchers pick one from the
+// cpu features.
+
+#include <stdint.h>
+
+uint64_t StrHashCrc32C(const wchar_t* str, int length, uint64_t seed, bool ignoreCase);
+
+uint64_t StrHashCrc32C_SSE42(const wchar_t* str, int length, uint64_t seed, bool ignoreCase);
+
+uint64_t StrHashCrc32C_CPP(const wchar_t* str, int length, uint64_t seed, bool ignoreCase);
+
+void StrHashAes(const wchar_t* str, int length, uint64_t seed, bool ignoreCase, uint64_t hash[2]);
+
+void StrHashAes_AESNI(const wchar_t* str, int length, uint64_t seed, bool ignoreCase, uint64_t hash[2]);
+
+void StrHashAes_CPP(const wchar_t* str, int length, uint64_t seed, bool ignoreCase, uint64_t hash[2]);
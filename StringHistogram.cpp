@@ -0,0 +1,128 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "String.h"
+
+#include <vcclr.h>              // cli/c++ pinning
+#include "HistogramKernels.h"   // unmanaged kernels
+
+#include <algorithm>            // std::sort
+
+#pragma managed
+
+namespace Intrinsics
+{
+    void __clrcall String::Histogram(System::String ^ str, array<int>^ counts)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        Histogram(str, 0, str->Length, counts);
+    }
+
+    void __clrcall String::Histogram(System::String ^ str, int startIndex, int count, array<int>^ counts)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (counts == nullptr)
+            throw gcnew ArgumentNullException("counts is null");
+
+        if (startIndex < 0 || startIndex > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length");
+
+        if (count < 0 || count > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+
+        if (counts->Length != HistogramLength)
+            throw gcnew ArgumentException(L"counts must have 257 elements");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<int> pinCounts = &counts[0];
+        StrHistogram((const wchar_t*)pinStr + startIndex, count, (uint32_t*)(int*)pinCounts, nullptr);
+    }
+
+    int __clrcall String::HistogramSparse(System::String ^ str, array<wchar_t>^% chars, array<int>^% counts)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        return HistogramSparse(str, 0, str->Length, chars, counts);
+    }
+
+    int __clrcall String::HistogramSparse(System::String ^ str, int startIndex, int count, array<wchar_t>^% chars, array<int>^% counts)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (startIndex < 0 || startIndex > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length");
+
+        if (count < 0 || count > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than str - startIndex");
+
+        // the chars above 0xff are only gathered when there are some, sorted then counted by runs
+        uint32_t low[HistogramLength] = {};
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        const wchar_t* begin = (const wchar_t*)pinStr + startIndex;
+        const int othersCount = StrHistogram(begin, count, low, nullptr);
+
+        array<wchar_t>^ others = nullptr;
+        if (othersCount)
+        {
+            uint32_t scratch[HistogramLength] = {};
+            others = gcnew array<wchar_t>(othersCount);
+            pin_ptr<wchar_t> pinOthers = &others[0];
+            StrHistogram(begin, count, scratch, pinOthers);
+            std::sort((wchar_t*)pinOthers, (wchar_t*)pinOthers + othersCount);
+        }
+
+        int distinct = 0;
+        for (int c = 0; c < 256; ++c)
+            distinct += low[c] != 0;
+        for (int i = 0; i < othersCount; ++i)
+            distinct += !i || others[i] != others[i - 1];
+
+        if (chars == nullptr || chars->Length < distinct)
+            chars = gcnew array<wchar_t>(distinct);
+        if (counts == nullptr || counts->Length < distinct)
+            counts = gcnew array<int>(distinct);
+
+        int n = 0;
+        for (int c = 0; c < 256; ++c)
+        {
+            if (!low[c])
+                continue;
+            chars[n] = (wchar_t)c;
+            counts[n++] = (int)low[c];
+        }
+        for (int i = 0; i < othersCount; ++n)
+        {
+            int end = i + 1;
+            while (end < othersCount && others[end] == others[i])
+                ++end;
+            chars[n] = others[i];
+            counts[n] = end - i;
+            i = end;
+        }
+        return distinct;
+    }
+}
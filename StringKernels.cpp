@@ -0,0 +1,548 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "StringKernels.h"
+#include "Instrumentation.h"
+#include "InstructionSet.h"
+#include "KernelIsa.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <intrin.h>         // intrinsics
+#include <emmintrin.h>      // SSE2
+#include <immintrin.h>      // AVX2
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+// search sets up to this size get a fully unrolled kernel, larger sets use the generic loop
+static const int SearchCharsUnrolled = 8;
+
+// large input mode scans by page blocks
+static const int CacheLine = 64;
+static const int StreamBlock = 4096;
+static const int StreamBlockChars = StreamBlock / sizeof(wchar_t);
+
+// huge page size used to align StrAllocateLarge buffers when the os don't provide large pages
+static const size_t HugePage = 2 * 1024 * 1024;
+
+StrStreamSettings StrStream = { 0, 1024 };
+
+namespace
+{
+    // index of c in chars or -1, N is the chars count or 0 when only known at runtime
+    template<int N>
+    __forceinline int CharIndex(wchar_t c, const wchar_t* chars, int charsLength)
+    {
+        const int length = N ? N : charsLength;
+        for (int i = 0; i < length; ++i)
+        {
+            if (c == chars[i])
+                return i;
+        }
+        return -1;
+    }
+
+    // compare a string vector with the N first search chars, unrolled at compile time so the
+    // broadcast chars stay in registers. N == 0 loops on the runtime length.
+    template<class Isa, int N>
+    struct SearchSet
+    {
+        typedef typename Isa::Vector Vector;
+
+        static __forceinline Vector Compare(const Vector* chars128, int length, Vector str128)
+        {
+            return Isa::Or(SearchSet<Isa, N - 1>::Compare(chars128, length, str128), Isa::Equal(chars128[N - 1], str128));
+        }
+
+        static __forceinline void Merge(const Vector* chars128, const Vector* charsIndex128, int length, Vector str128, Vector& mergeCompare, Vector& mergeIndex)
+        {
+            SearchSet<Isa, N - 1>::Merge(chars128, charsIndex128, length, str128, mergeCompare, mergeIndex);
+            Vector cmp = Isa::Equal(chars128[N - 1], str128);
+            mergeCompare = Isa::Or(mergeCompare, cmp);
+            mergeIndex = Isa::Or(mergeIndex, Isa::And(cmp, charsIndex128[N - 1]));
+        }
+    };
+
+    template<class Isa>
+    struct SearchSet<Isa, 1>
+    {
+        typedef typename Isa::Vector Vector;
+
+        static __forceinline Vector Compare(const Vector* chars128, int length, Vector str128)
+        {
+            return Isa::Equal(chars128[0], str128);
+        }
+
+        // char index 0, nothing to merge
+        static __forceinline void Merge(const Vector* chars128, const Vector* charsIndex128, int length, Vector str128, Vector& mergeCompare, Vector& mergeIndex)
+        {
+            mergeCompare = Isa::Equal(chars128[0], str128);
+            mergeIndex = Isa::Zero();
+        }
+    };
+
+    template<class Isa>
+    struct SearchSet<Isa, 0>
+    {
+        typedef typename Isa::Vector Vector;
+
+        static __forceinline Vector Compare(const Vector* chars128, int length, Vector str128)
+        {
+            Vector mergeCompare = Isa::Zero();
+            for (int i = 0; i < length; ++i)
+                mergeCompare = Isa::Or(mergeCompare, Isa::Equal(chars128[i], str128));
+            return mergeCompare;
+        }
+
+        static __forceinline void Merge(const Vector* chars128, const Vector* charsIndex128, int length, Vector str128, Vector& mergeCompare, Vector& mergeIndex)
+        {
+            mergeCompare = Isa::Zero();
+            mergeIndex = Isa::Zero();
+            for (int i = 0; i < length; ++i)
+            {
+                Vector cmp = Isa::Equal(chars128[i], str128);
+                mergeCompare = Isa::Or(mergeCompare, cmp);
+                mergeIndex = Isa::Or(mergeIndex, Isa::And(cmp, charsIndex128[i]));
+            }
+        }
+    };
+
+    // string index and char index pairs of the matches in one vector, out must have room for Isa::Length pairs
+    template<class Isa, int N>
+    __forceinline int* VectorMatches(const wchar_t* s, const wchar_t* str, const typename Isa::Vector* chars128, const typename Isa::Vector* charsIndex128, int length, int* out)
+    {
+        typedef typename Isa::Vector Vector;
+
+        Vector str128 = Isa::Load(s);
+
+        if (N == 1)
+        {
+            unsigned v0 = Isa::Mask(SearchSet<Isa, 1>::Compare(chars128, length, str128));
+            while (v0)
+            {
+                unsigned long traillingZero;
+                _BitScanForward(&traillingZero, v0);
+                *(out++) = (int)(s - str) + (traillingZero >> 1);   // string index in str
+                *(out++) = 0;                                       // char index in chars
+                v0 &= ~(3u << traillingZero);                       // clear result char
+            }
+            return out;
+        }
+
+        Vector mergeCompare;
+        Vector mergeIndex;
+        SearchSet<Isa, N>::Merge(chars128, charsIndex128, length, str128, mergeCompare, mergeIndex);
+
+        unsigned v0 = Isa::Mask(mergeCompare);
+        if (v0)
+        {
+            short store[Isa::Length];
+            Isa::Store(store, mergeIndex);
+            do
+            {
+                unsigned long traillingZero;
+                _BitScanForward(&traillingZero, v0);
+                const int offset = (traillingZero >> 1);
+                *(out++) = (int)(s - str) + offset;     // string index in str
+                *(out++) = store[offset];               // char index in chars
+                v0 &= ~(3u << traillingZero);           // clear result char
+            } while (v0);
+        }
+        return out;
+    }
+
+    // read once hint for the line prefetchDistance bytes ahead, one prefetch per cache line
+    __forceinline void PrefetchAhead(const wchar_t* s, int prefetchDistance)
+    {
+        if (((size_t)s & (CacheLine - 1)) == 0)
+            _mm_prefetch((const char*)s + prefetchDistance, _MM_HINT_NTA);
+    }
+
+    // copy staged results to dst with non temporal stores, dst is only int aligned so src is read unaligned
+    __forceinline int* StreamStore(int* dst, const int* src, size_t count)
+    {
+        const int* end = src + count;
+        for (; src < end && (size_t)dst & 15; ++src, ++dst)
+            _mm_stream_si32(dst, *src);
+        for (; src + 4 <= end; src += 4, dst += 4)
+            _mm_stream_si128((__m128i*)dst, _mm_loadu_si128((const __m128i*)src));
+        for (; src < end; ++src, ++dst)
+            _mm_stream_si32(dst, *src);
+        return dst;
+    }
+
+    // N is the search set size, the compare loop is fully unrolled and the broadcast chars stay in
+    // registers. N == 0 is the generic kernel looping on charsLength, N == 1 is a single compare
+    // without char index merge.
+    // Stream is the large input mode: prefetch ahead with the non temporal hint, scan by page blocks and
+    // write each block results with streaming stores so a single pass don't evict the caller working set.
+    template<class Isa, int N, bool Stream>
+    int IndexOfAll(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results)
+    {
+        typedef typename Isa::Vector Vector;
+
+        INTRINSICS_PROBE_TIER(IndexOfAll, Isa::Tier, count);
+
+        const int length = N ? N : charsLength;
+        int* resultCur = results;
+        const wchar_t* s = str + startIndex;
+        const wchar_t* end = s + count;
+
+        // process begin of string up to vector alignment
+        for (; s < end && (size_t)s & (sizeof(Vector) - 1); ++s)
+        {
+            int i = CharIndex<N>(*s, chars, charsLength);
+            if (i >= 0)
+            {
+                *(resultCur++) = (int)(s - str);    // string index in str
+                *(resultCur++) = i;                 // char index in chars
+            }
+        }
+
+        Vector chars128[N ? N : Intrinsics::SearchCharsMax];
+        Vector charsIndex128[N ? N : Intrinsics::SearchCharsMax];
+        for (int i = 0; i < length; ++i)
+        {
+            chars128[i] = Isa::Set(chars[i]);
+            charsIndex128[i] = Isa::Set(i);
+        }
+
+        // process aligned string part
+        const wchar_t* vectorEnd = s + ((end - s) & ~(Isa::Length - 1));
+        INTRINSICS_PROBE_VECTOR(vectorEnd - s);
+        if (Stream)
+        {
+            // block results are staged in L1, at most one pair per char
+            int staging[2 * StreamBlockChars];
+            const int prefetchDistance = StrStream.prefetchDistance;
+            while (s < vectorEnd)
+            {
+                const wchar_t* blockEnd = (const wchar_t*)(((size_t)s + StreamBlock) & ~(size_t)(StreamBlock - 1));
+                if (blockEnd > vectorEnd)
+                    blockEnd = vectorEnd;
+
+                int* stagingCur = staging;
+                for (; s < blockEnd; s += Isa::Length)
+                {
+                    PrefetchAhead(s, prefetchDistance);
+                    stagingCur = VectorMatches<Isa, N>(s, str, chars128, charsIndex128, length, stagingCur);
+                }
+                resultCur = StreamStore(resultCur, staging, stagingCur - staging);
+            }
+            _mm_sfence();
+        }
+        else
+        {
+            for (; s < vectorEnd; s += Isa::Length)
+                resultCur = VectorMatches<Isa, N>(s, str, chars128, charsIndex128, length, resultCur);
+        }
+
+        // process remaining string
+        for (; s < end; ++s)
+        {
+            int i = CharIndex<N>(*s, chars, charsLength);
+            if (i >= 0)
+            {
+                *(resultCur++) = (int)(s - str);    // string index in str
+                *(resultCur++) = i;                 // char index in chars
+            }
+        }
+        return INTRINSICS_PROBE_MATCHES((int)(resultCur - results) >> 1);
+    }
+
+    // Stream only add the prefetch, there is nothing to write
+    template<class Isa, int N, bool Stream>
+    int IndexOfAny(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count)
+    {
+        typedef typename Isa::Vector Vector;
+
+        INTRINSICS_PROBE_TIER(IndexOfAny, Isa::Tier, count);
+
+        const int length = N ? N : charsLength;
+        const wchar_t* s = str + startIndex;
+        const wchar_t* end = s + count;
+
+        for (; s < end && (size_t)s & (sizeof(Vector) - 1); ++s)
+        {
+            if (CharIndex<N>(*s, chars, charsLength) >= 0)
+                return INTRINSICS_PROBE_FOUND((int)(s - str), (int)(s - str) - startIndex + 1);
+        }
+
+        Vector chars128[N ? N : Intrinsics::SearchCharsMax];
+        for (int i = 0; i < length; ++i)
+            chars128[i] = Isa::Set(chars[i]);
+
+        // process aligned string part
+        const int prefetchDistance = Stream ? StrStream.prefetchDistance : 0;
+        const wchar_t* vectorEnd = s + ((end - s) & ~(Isa::Length - 1));
+        for (; s < vectorEnd; s += Isa::Length)
+        {
+            if (Stream)
+                PrefetchAhead(s, prefetchDistance);
+
+            Vector str128 = Isa::Load(s);
+            INTRINSICS_PROBE_VECTOR(Isa::Length);
+
+            unsigned v0 = Isa::Mask(SearchSet<Isa, N>::Compare(chars128, length, str128));
+            if (v0)
+            {
+                unsigned long traillingZero;
+                _BitScanForward(&traillingZero, v0);
+                const wchar_t* c = s + (traillingZero >> 1);
+                return INTRINSICS_PROBE_FOUND((int)(c - str), (int)(c - str) - startIndex + 1);
+            }
+        }
+
+        // process remaining string
+        for (; s < end; ++s)
+        {
+            if (CharIndex<N>(*s, chars, charsLength) >= 0)
+                return INTRINSICS_PROBE_FOUND((int)(s - str), (int)(s - str) - startIndex + 1);
+        }
+        return -1;
+    }
+
+    __forceinline wchar_t FoldAscii(wchar_t c)
+    {
+        return (unsigned)(c - L'A') < 26u ? (wchar_t)(c | 0x20) : c;
+    }
+
+    // ascii letters A-Z to a-z, 'A'-'Z' are moved to the bottom of the signed range so one compare select them
+    template<class Isa>
+    __forceinline typename Isa::Vector FoldAscii(typename Isa::Vector v)
+    {
+        typedef typename Isa::Vector Vector;
+        const Vector t = Isa::Add(v, Isa::Set(0x8000 - 'A'));
+        const Vector upper = Isa::Greater(Isa::Set(0x8000 + 26), t);
+        return Isa::Or(v, Isa::And(upper, Isa::Set(0x20)));
+    }
+
+    // index of the first differing char of a and b, or length. both strings are read unaligned, the
+    // last vector overlap the previous one instead of a scalar tail
+    template<class Isa, bool IgnoreCase>
+    int CommonPrefix(const wchar_t* a, const wchar_t* b, int length)
+    {
+        typedef typename Isa::Vector Vector;
+
+        INTRINSICS_PROBE_TIER(CommonPrefix, Isa::Tier, length);
+
+        if (length < Isa::Length)
+        {
+            for (int i = 0; i < length; ++i)
+            {
+                if (IgnoreCase ? FoldAscii(a[i]) != FoldAscii(b[i]) : a[i] != b[i])
+                    return i;
+            }
+            return length;
+        }
+
+        INTRINSICS_PROBE_VECTOR(length);
+        for (int i = 0;; i += Isa::Length)
+        {
+            if (i > length - Isa::Length)
+                i = length - Isa::Length;
+
+            Vector va = Isa::LoadUnaligned(a + i);
+            Vector vb = Isa::LoadUnaligned(b + i);
+            if (IgnoreCase)
+            {
+                va = FoldAscii<Isa>(va);
+                vb = FoldAscii<Isa>(vb);
+            }
+
+            unsigned v0 = Isa::Mask(Isa::Equal(va, vb)) ^ Isa::MaskAll;
+            if (v0)
+            {
+                unsigned long traillingZero;
+                _BitScanForward(&traillingZero, v0);
+                return i + (traillingZero >> 1);
+            }
+
+            if (i == length - Isa::Length)
+                return length;
+        }
+    }
+
+    typedef int(*IndexOfAllKernel)(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results);
+    typedef int(*IndexOfAnyKernel)(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count);
+
+    // dispatch tables indexed by search set size, [0] is the generic kernel
+#define INTRINSICS_KERNELS(kernel, isa, stream) \
+    { kernel<isa, 0, stream>, kernel<isa, 1, stream>, kernel<isa, 2, stream>, kernel<isa, 3, stream>, kernel<isa, 4, stream>, \
+      kernel<isa, 5, stream>, kernel<isa, 6, stream>, kernel<isa, 7, stream>, kernel<isa, 8, stream> }
+
+    // [stream][set size]
+    const IndexOfAllKernel IndexOfAllSse2[2][SearchCharsUnrolled + 1] = { INTRINSICS_KERNELS(IndexOfAll, Sse2, false), INTRINSICS_KERNELS(IndexOfAll, Sse2, true) };
+    const IndexOfAllKernel IndexOfAllAvx2[2][SearchCharsUnrolled + 1] = { INTRINSICS_KERNELS(IndexOfAll, Avx2, false), INTRINSICS_KERNELS(IndexOfAll, Avx2, true) };
+    const IndexOfAnyKernel IndexOfAnySse2[2][SearchCharsUnrolled + 1] = { INTRINSICS_KERNELS(IndexOfAny, Sse2, false), INTRINSICS_KERNELS(IndexOfAny, Sse2, true) };
+    const IndexOfAnyKernel IndexOfAnyAvx2[2][SearchCharsUnrolled + 1] = { INTRINSICS_KERNELS(IndexOfAny, Avx2, false), INTRINSICS_KERNELS(IndexOfAny, Avx2, true) };
+
+#undef INTRINSICS_KERNELS
+
+    __forceinline int KernelSlot(int charsLength)
+    {
+        return charsLength <= SearchCharsUnrolled ? charsLength : 0;
+    }
+
+    // 1 when the scanned bytes reach the streaming threshold
+    __forceinline int StreamSlot(int count)
+    {
+        const int64_t threshold = StrStream.threshold ? StrStream.threshold : (int64_t)InstructionSet::NonTemporalThreshold();
+        return threshold > 0 && (int64_t)count * (int64_t)sizeof(wchar_t) >= threshold ? 1 : 0;
+    }
+}
+
+int StrIndexOfAll_SSE2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results)
+{
+    return IndexOfAllSse2[StreamSlot(count)][KernelSlot(charsLength)](str, chars, charsLength, startIndex, count, results);
+}
+
+#ifdef INTRINSICS_TEST
+// generic loop for every set size, to compare against the unrolled kernels
+int StrIndexOfAll_SSE2_V2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results)
+{
+    return IndexOfAll<Sse2, 0, false>(str, chars, charsLength, startIndex, count, results);
+}
+#endif
+
+int StrIndexOfAll_AVX2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results)
+{
+    return IndexOfAllAvx2[StreamSlot(count)][KernelSlot(charsLength)](str, chars, charsLength, startIndex, count, results);
+}
+int StrIndexOfAll_CPP(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results)
+{
+    INTRINSICS_PROBE(IndexOfAll, Cpp, count);
+
+    int* resultCur = results;
+    const wchar_t* s = str + startIndex;
+    const wchar_t* end = s + count;
+
+    for (; s < end; ++s)
+    {
+        for (int i = 0; i < charsLength; ++i)
+        {
+            const wchar_t c = chars[i];
+            if (*s == c)
+            {
+                int index = (int)(s - str);
+                *(resultCur++) = index;   // string index in str
+                *(resultCur++) = i;       // char index in chars
+                break;
+            }
+        }
+    }
+
+    return INTRINSICS_PROBE_MATCHES((int)(resultCur - results) >> 1);
+}
+
+int StrIndexOfAny_SSE2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count)
+{
+    return IndexOfAnySse2[StreamSlot(count)][KernelSlot(charsLength)](str, chars, charsLength, startIndex, count);
+}
+
+int StrIndexOfAny_AVX2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count)
+{
+    return IndexOfAnyAvx2[StreamSlot(count)][KernelSlot(charsLength)](str, chars, charsLength, startIndex, count);
+}
+
+int StrIndexOfAny_CPP(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count)
+{
+    INTRINSICS_PROBE(IndexOfAny, Cpp, count);
+
+    const wchar_t* s = str + startIndex;
+    const wchar_t* end = s + count;
+    for (; s < end; ++s)
+    {
+        for (int i = 0; i < charsLength; ++i)
+        {
+            if (*s == chars[i])
+                return INTRINSICS_PROBE_FOUND((int)(s - str), (int)(s - str) - startIndex + 1);
+        }
+    }
+    return -1;
+}
+
+void* StrAllocateLarge(size_t bytes, bool hugePages)
+{
+#ifdef _WIN32
+    // large pages need SeLockMemoryPrivilege, fall back to regular pages
+    if (hugePages)
+    {
+        const size_t largePage = GetLargePageMinimum();
+        if (largePage)
+        {
+            void* p = VirtualAlloc(nullptr, (bytes + largePage - 1) & ~(largePage - 1), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (p)
+                return p;
+        }
+    }
+    return VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, hugePages ? HugePage : StreamBlock, bytes))
+        return nullptr;
+#ifdef MADV_HUGEPAGE
+    // transparent huge pages, only a hint
+    if (hugePages)
+        madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    return p;
+#endif
+}
+
+void StrFreeLarge(void* p)
+{
+    if (!p)
+        return;
+#ifdef _WIN32
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    free(p);
+#endif
+}
+
+int StrCommonPrefix_SSE2(const wchar_t* a, const wchar_t* b, int length, bool ignoreCase)
+{
+    return ignoreCase ? CommonPrefix<Sse2, true>(a, b, length) : CommonPrefix<Sse2, false>(a, b, length);
+}
+
+int StrCommonPrefix_AVX2(const wchar_t* a, const wchar_t* b, int length, bool ignoreCase)
+{
+    return ignoreCase ? CommonPrefix<Avx2, true>(a, b, length) : CommonPrefix<Avx2, false>(a, b, length);
+}
+
+int StrCommonPrefix_CPP(const wchar_t* a, const wchar_t* b, int length, bool ignoreCase)
+{
+    INTRINSICS_PROBE(CommonPrefix, Cpp, length);
+
+    for (int i = 0; i < length; ++i)
+    {
+        if (ignoreCase ? FoldAscii(a[i]) != FoldAscii(b[i]) : a[i] != b[i])
+            return i;
+    }
+    return length;
+}
@@ -0,0 +1,76 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// unmanaged string kernels, compiled without /clr so they can also be linked in native tools (benchmark)
+//
+// str is the string start, the [startIndex, startIndex + count[ part is searched.
+// IndexOfAll kernels write (string index, char index) pairs in results and return the pairs count,
+// results must have room for count pairs. IndexOfAny kernels return the string index or -1.
+// vector kernels select a specialization from charsLength: unrolled for 1 to 8 chars, generic loop above.
+// CommonPrefix kernels return the index of the first char that differ in a and b or length, ignoreCase
+// fold the ascii letters only.
+// scans of at least StrStream.threshold bytes switch to the large input mode: non temporal prefetch
+// ahead of the loads, page blocks and streaming stores for the results.
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Intrinsics
+{
+    static const int SearchCharsMax = 32;
+}
+
+struct StrStreamSettings
+{
+    int64_t threshold;          // scanned bytes, 0 is InstructionSet::NonTemporalThreshold(), < 0 disable the large input mode
+    int prefetchDistance;       // bytes ahead of the current load
+};
+
+extern StrStreamSettings StrStream;
+
+// page aligned buffer for large inputs, 2MB aligned and backed by huge pages when hugePages is set and the os allows it
+void* StrAllocateLarge(size_t bytes, bool hugePages);
+
+void StrFreeLarge(void* p);
+
+int StrIndexOfAll_SSE2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results);
+
+#ifdef INTRINSICS_TEST
+int StrIndexOfAll_SSE2_V2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results);
+#endif
+
+int StrIndexOfAll_AVX2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results);
+
+int StrIndexOfAll_CPP(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results);
+
+int StrIndexOfAny_SSE2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count);
+
+int StrIndexOfAny_AVX2(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count);
+
+int StrIndexOfAny_CPP(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count);
+
+int StrCommonPrefix_SSE2(const wchar_t* a, const wchar_t* b, int length, bool ignoreCase);
+
+int StrCommonPrefix_AVX2(const wchar_t* a, const wchar_t* b, int length, bool ignoreCase);
+
+int StrCommonPrefix_CPP(const wchar_t* a, const wchar_t* b, int length, bool ignoreCase);
@@ -0,0 +1,160 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "String.h"
+
+#include <vcclr.h>          // cli/c++ pinning
+#include "ParseKernels.h"   // unmanaged kernels
+
+#pragma managed
+
+using namespace System::Globalization;
+
+namespace Intrinsics
+{
+    static void __clrcall CheckRanges(System::String ^ str, array<String::FieldRange >^ ranges, int count)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (ranges == nullptr)
+            throw gcnew ArgumentNullException("ranges is null");
+
+        if (count < 0 || count > ranges->Length)
+            throw gcnew ArgumentOutOfRangeException(L"count must be greater than 0 and smaller than ranges length");
+
+        for (int i = 0; i < count; ++i)
+        {
+            const String::FieldRange range = ranges[i];
+            if (range.StartIndex < 0 || range.Length < 0 || range.Length > str->Length - range.StartIndex)
+                throw gcnew ArgumentOutOfRangeException(System::String::Format(L"ranges[{0}] is outside str", i));
+        }
+    }
+
+    int __clrcall String::GetFieldRanges(System::String ^ str, array<MatchIndex >^ delimiters, int delimitersCount, array<FieldRange >^% ranges)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (delimiters == nullptr)
+            throw gcnew ArgumentNullException("delimiters is null");
+
+        if (delimitersCount < 0 || delimitersCount > delimiters->Length)
+            throw gcnew ArgumentOutOfRangeException(L"delimitersCount must be greater than 0 and smaller than delimiters length");
+
+        if (ranges == nullptr || ranges->Length < delimitersCount + 1)
+            ranges = gcnew array<FieldRange >(delimitersCount + 1);
+
+        int start = 0;
+        for (int i = 0; i < delimitersCount; ++i)
+        {
+            const int end = delimiters[i].StringIndex;
+            if (end < start || end >= str->Length)
+                throw gcnew ArgumentException(L"delimiters must be increasing indices of str");
+
+            ranges[i] = FieldRange(start, end - start);
+            start = end + 1;
+        }
+        ranges[delimitersCount] = FieldRange(start, str->Length - start);
+        return delimitersCount + 1;
+    }
+
+    void __clrcall String::ParseInt64Batch(System::String ^ str, array<FieldRange >^ ranges, int count, array<Int64>^% values)
+    {
+        CheckRanges(str, ranges, count);
+
+        if (values == nullptr || values->Length < count)
+            values = gcnew array<Int64>(count);
+
+        if (!count)
+            return;
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<FieldRange > pinRanges = &ranges[0];
+        pin_ptr<Int64> pinValues = &values[0];
+
+        // the kernel stop on the forms it don't take, the BCL parse them or throw
+        int parsed = 0;
+        while (parsed < count)
+        {
+            parsed += StrParseInt64(pinStr, (const int*)pinRanges + 2 * parsed, count - parsed, (int64_t*)pinValues + parsed);
+            if (parsed < count)
+            {
+                values[parsed] = Int64::Parse(str->Substring(ranges[parsed].StartIndex, ranges[parsed].Length), NumberStyles::Integer, CultureInfo::InvariantCulture);
+                ++parsed;
+            }
+        }
+    }
+
+    void __clrcall String::ParseDoubleBatch(System::String ^ str, array<FieldRange >^ ranges, int count, array<double>^% values)
+    {
+        CheckRanges(str, ranges, count);
+
+        if (values == nullptr || values->Length < count)
+            values = gcnew array<double>(count);
+
+        if (!count)
+            return;
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<FieldRange > pinRanges = &ranges[0];
+        pin_ptr<double> pinValues = &values[0];
+
+        int parsed = 0;
+        while (parsed < count)
+        {
+            parsed += StrParseDouble(pinStr, (const int*)pinRanges + 2 * parsed, count - parsed, (double*)pinValues + parsed);
+            if (parsed < count)
+            {
+                values[parsed] = Double::Parse(str->Substring(ranges[parsed].StartIndex, ranges[parsed].Length), NumberStyles::Float | NumberStyles::AllowThousands, CultureInfo::InvariantCulture);
+                ++parsed;
+            }
+        }
+    }
+
+    double __clrcall String::ParseDouble(System::String ^ str)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        return ParseDouble(str, 0, str->Length);
+    }
+
+    double __clrcall String::ParseDouble(System::String ^ str, int startIndex, int length)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (startIndex < 0 || startIndex > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length");
+
+        if (length < 0 || length > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"length must be smaller than str - startIndex");
+
+        const int range[2] = { startIndex, length };
+        double value;
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        if (StrParseDouble(pinStr, range, 1, &value))
+            return value;
+
+        return Double::Parse(str->Substring(startIndex, length), NumberStyles::Float | NumberStyles::AllowThousands, CultureInfo::InvariantCulture);
+    }
+}
@@ -0,0 +1,173 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "String.h"
+
+#include <vcclr.h>          // cli/c++ pinning
+#include "Utf8Kernels.h"    // unmanaged kernels
+
+#pragma managed
+
+namespace Intrinsics
+{
+    static void __clrcall CheckBytes(array<unsigned char>^ bytes, int index, int count)
+    {
+        if (bytes == nullptr)
+            throw gcnew ArgumentNullException("bytes is null");
+
+        if (index < 0 || index > bytes->Length)
+            throw gcnew ArgumentOutOfRangeException(L"index must be greater than 0 and smaller than bytes length");
+
+        if (count < 0 || count > bytes->Length - index)
+            throw gcnew ArgumentOutOfRangeException(L"count must be smaller than bytes - index");
+    }
+
+    bool __clrcall String::IsAscii(System::String ^ str)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        return StrIsAscii(pinStr, str->Length);
+    }
+
+    bool __clrcall String::IsAscii(array<unsigned char>^ bytes, int index, int count)
+    {
+        CheckBytes(bytes, index, count);
+        if (!count)
+            return true;
+
+        pin_ptr<unsigned char> pinBytes = &bytes[index];
+        return BytesIsAscii(pinBytes, count);
+    }
+
+    bool __clrcall String::IsValidUtf16(System::String ^ str)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        return StrUtf8Length(pinStr, str->Length) >= 0;
+    }
+
+    bool __clrcall String::IsValidUtf8(array<unsigned char>^ bytes, int index, int count)
+    {
+        CheckBytes(bytes, index, count);
+        if (!count)
+            return true;
+
+        pin_ptr<unsigned char> pinBytes = &bytes[index];
+        return StrUtf16Length(pinBytes, count) >= 0;
+    }
+
+    int __clrcall String::GetUtf8ByteCount(System::String ^ str)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        const int64_t length = StrUtf8Length(pinStr, str->Length);
+        if (length < 0)
+            throw gcnew ArgumentException(System::String::Format(L"str has an unpaired surrogate at index {0}", -1 - length));
+
+        if (length > Int32::MaxValue)
+            throw gcnew ArgumentException(L"str utf-8 bytes count is larger than Int32::MaxValue");
+
+        return (int)length;
+    }
+
+    int __clrcall String::ToUtf8(System::String ^ str, array<unsigned char>^ bytes, int byteIndex)
+    {
+        const int length = GetUtf8ByteCount(str);
+
+        if (bytes == nullptr)
+            throw gcnew ArgumentNullException("bytes is null");
+
+        if (byteIndex < 0 || byteIndex > bytes->Length)
+            throw gcnew ArgumentOutOfRangeException(L"byteIndex must be greater than 0 and smaller than bytes length");
+
+        if (length > bytes->Length - byteIndex)
+            throw gcnew ArgumentException(L"bytes is too small, see GetUtf8ByteCount");
+
+        if (!length)
+            return 0;
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<unsigned char> pinBytes = &bytes[byteIndex];
+        return (int)StrToUtf8(pinStr, str->Length, pinBytes);
+    }
+
+    array<unsigned char>^ __clrcall String::ToUtf8(System::String ^ str)
+    {
+        array<unsigned char>^ bytes = gcnew array<unsigned char>(GetUtf8ByteCount(str));
+        ToUtf8(str, bytes, 0);
+        return bytes;
+    }
+
+    int __clrcall String::GetUtf16CharCount(array<unsigned char>^ bytes, int index, int count)
+    {
+        CheckBytes(bytes, index, count);
+        if (!count)
+            return 0;
+
+        pin_ptr<unsigned char> pinBytes = &bytes[index];
+        const int length = StrUtf16Length(pinBytes, count);
+        if (length < 0)
+            throw gcnew ArgumentException(System::String::Format(L"bytes has an invalid utf-8 sequence at index {0}", index - 1 - length));
+
+        return length;
+    }
+
+    int __clrcall String::FromUtf8(array<unsigned char>^ bytes, int index, int count, array<wchar_t>^ chars, int charIndex)
+    {
+        const int length = GetUtf16CharCount(bytes, index, count);
+
+        if (chars == nullptr)
+            throw gcnew ArgumentNullException("chars is null");
+
+        if (charIndex < 0 || charIndex > chars->Length)
+            throw gcnew ArgumentOutOfRangeException(L"charIndex must be greater than 0 and smaller than chars length");
+
+        if (length > chars->Length - charIndex)
+            throw gcnew ArgumentException(L"chars is too small, see GetUtf16CharCount");
+
+        if (!length)
+            return 0;
+
+        pin_ptr<unsigned char> pinBytes = &bytes[index];
+        pin_ptr<wchar_t> pinChars = &chars[charIndex];
+        return StrFromUtf8(pinBytes, count, pinChars);
+    }
+
+    System::String ^ __clrcall String::FromUtf8(array<unsigned char>^ bytes, int index, int count)
+    {
+        const int length = GetUtf16CharCount(bytes, index, count);
+        if (!length)
+            return System::String::Empty;
+
+        // the string is decoded in place, it isn't visible to anyone else before the return
+        System::String ^ str = gcnew System::String(L'\0', length);
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<unsigned char> pinBytes = &bytes[index];
+        StrFromUtf8(pinBytes, count, const_cast<wchar_t*>((const wchar_t*)pinStr));
+        return str;
+    }
+}
@@ -0,0 +1,131 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "String.h"
+
+#include <vcclr.h>              // cli/c++ pinning
+#include "WhitespaceKernels.h"  // unmanaged kernels
+
+#pragma managed
+
+namespace Intrinsics
+{
+    System::String ^ __clrcall String::Trim(System::String ^ str)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        FieldRange range = TrimRange(str, 0, str->Length);
+        return range.Length == str->Length ? str : str->Substring(range.StartIndex, range.Length);
+    }
+
+    System::String ^ __clrcall String::TrimStart(System::String ^ str)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        const int startIndex = StrSkipWhitespace(pinStr, str->Length);
+        return startIndex ? str->Substring(startIndex) : str;
+    }
+
+    System::String ^ __clrcall String::TrimEnd(System::String ^ str)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        const int length = StrSkipWhitespaceBack(pinStr, str->Length);
+        return length == str->Length ? str : str->Substring(0, length);
+    }
+
+    String::FieldRange __clrcall String::TrimRange(System::String ^ str, int startIndex, int length)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (startIndex < 0 || startIndex > str->Length)
+            throw gcnew ArgumentOutOfRangeException(L"startIndex must be greater than 0 and smaller than str length");
+
+        if (length < 0 || length > str->Length - startIndex)
+            throw gcnew ArgumentOutOfRangeException(L"length must be smaller than str - startIndex");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        const wchar_t* s = (const wchar_t*)pinStr + startIndex;
+        const int skipped = StrSkipWhitespace(s, length);
+        return FieldRange(startIndex + skipped, StrSkipWhitespaceBack(s + skipped, length - skipped));
+    }
+
+    void __clrcall String::TrimRanges(System::String ^ str, array<FieldRange >^ ranges, int count)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (ranges == nullptr)
+            throw gcnew ArgumentNullException("ranges is null");
+
+        if (count < 0 || count > ranges->Length)
+            throw gcnew ArgumentOutOfRangeException(L"count must be greater than 0 and smaller than ranges length");
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        for (int i = 0; i < count; ++i)
+        {
+            const FieldRange range = ranges[i];
+            if (range.StartIndex < 0 || range.Length < 0 || range.Length > str->Length - range.StartIndex)
+                throw gcnew ArgumentOutOfRangeException(System::String::Format(L"ranges[{0}] is outside str", i));
+
+            const wchar_t* s = (const wchar_t*)pinStr + range.StartIndex;
+            const int skipped = StrSkipWhitespace(s, range.Length);
+            ranges[i] = FieldRange(range.StartIndex + skipped, StrSkipWhitespaceBack(s + skipped, range.Length - skipped));
+        }
+    }
+
+    bool __clrcall String::IsNullOrWhiteSpace(System::String ^ str)
+    {
+        if (str == nullptr)
+            return true;
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        return StrSkipWhitespace(pinStr, str->Length) == str->Length;
+    }
+
+    int __clrcall String::CollapseWhitespace(System::String ^ str, array<wchar_t>^ chars, int charIndex)
+    {
+        if (str == nullptr)
+            throw gcnew ArgumentNullException("str is null");
+
+        if (chars == nullptr)
+            throw gcnew ArgumentNullException("chars is null");
+
+        if (charIndex < 0 || charIndex > chars->Length)
+            throw gcnew ArgumentOutOfRangeException(L"charIndex must be greater than 0 and smaller than chars length");
+
+        if (str->Length > chars->Length - charIndex)
+            throw gcnew ArgumentException(L"chars must have room for str length chars");
+
+        if (!str->Length)
+            return 0;
+
+        pin_ptr<const wchar_t> pinStr = PtrToStringChars(str);
+        pin_ptr<wchar_t> pinChars = &chars[charIndex];
+        return StrCollapseWhitespace(pinStr, str->Length, pinChars);
+    }
+}
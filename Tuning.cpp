@@ -0,0 +1,262 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "Tuning.h"
+#include "Cpu.h"
+#include "StringKernels.h"
+#include "InstructionSet.h" // cpu intrinsics support helper
+
+#pragma managed
+
+using namespace System::Diagnostics;
+using namespace System::IO;
+using namespace System::Text;
+
+namespace Intrinsics
+{
+    // representative search set size of each TuningSetClass
+    static const int TuningSetSizes[TuningSetClasses] = { 1, 2, 4, 8, 16, 32 };
+
+    // chars scanned per measure, enough to hide the timer resolution
+    static const int TuningCharsPerMeasure = 1 << 16;
+
+    static const int TuningRounds = 3;
+
+    System::String ^ Tuning::DefaultPath::get()
+    {
+        System::String ^ folder = Environment::GetFolderPath(Environment::SpecialFolder::LocalApplicationData);
+        return Path::Combine(Path::Combine(folder, L"Intrinsics.Net"), L"tuning.txt");
+    }
+
+    Int64 Tuning::StreamThreshold::get()
+    {
+        return StrStream.threshold;
+    }
+
+    void Tuning::StreamThreshold::set(Int64 value)
+    {
+        StrStream.threshold = value;
+    }
+
+    int Tuning::PrefetchDistance::get()
+    {
+        return StrStream.prefetchDistance;
+    }
+
+    void Tuning::PrefetchDistance::set(int value)
+    {
+        if (value < 64 || value > 64 * 1024)
+            throw gcnew ArgumentOutOfRangeException(L"value must be between 64 and 65536");
+        StrStream.prefetchDistance = value;
+    }
+
+    Tuning::Tier __clrcall Tuning::Select(Operation operation, int charsLength, int length)
+    {
+        if (operation < Operation::IndexOfAll || operation > Operation::CommonPrefix)
+            throw gcnew ArgumentOutOfRangeException(L"operation");
+
+        return (Tier)TuningSelect((TuningOperation)operation, charsLength, length);
+    }
+
+    double __clrcall Tuning::Measure(TuningOperation operation, TuningTier tier, const wchar_t* text, const wchar_t* other, const wchar_t* chars, int charsLength, int length, int* results)
+    {
+        const int iterations = TuningCharsPerMeasure / (length + 16) + 1;
+
+        double best = Double::MaxValue;
+        for (int round = 0; round < TuningRounds; ++round)
+        {
+            Int64 start = Stopwatch::GetTimestamp();
+            for (int i = 0; i < iterations; ++i)
+            {
+                if (operation == TuningIndexOfAll)
+                    StrIndexOfAllTier(tier, text, chars, charsLength, 0, length, results);
+                else if (operation == TuningIndexOfAny)
+                    StrIndexOfAnyTier(tier, text, chars, charsLength, 0, length);
+                else
+                    StrCommonPrefixTier(tier, text, other, length, false);
+            }
+            double elapsed = (double)(Stopwatch::GetTimestamp() - start) / iterations;
+            if (elapsed < best)
+                best = elapsed;
+        }
+        return best;
+    }
+
+    void __clrcall Tuning::Calibrate()
+    {
+        const uint64_t features = InstructionSet::Features();
+        const TuningTier best = TuningBestTier(features);
+        const int lengthMax = 1 << (TuningLengthBuckets - 1);
+
+        // text without any match, the scan cost dominate real workloads
+        array<wchar_t>^ text = gcnew array<wchar_t>(lengthMax);
+        for (int i = 0; i < lengthMax; ++i)
+            text[i] = (wchar_t)(L'a' + (i * 7) % 26);
+
+        // equal copy, compares run to the end
+        array<wchar_t>^ other = (array<wchar_t>^)text->Clone();
+
+        array<wchar_t>^ chars = gcnew array<wchar_t>(TuningSetSizes[TuningSetClasses - 1]);
+        for (int i = 0; i < chars->Length; ++i)
+            chars[i] = (wchar_t)(0xe000 + i);
+
+        array<int>^ results = gcnew array<int>(lengthMax * 2);
+
+        pin_ptr<wchar_t> pinText = &text[0];
+        pin_ptr<wchar_t> pinOther = &other[0];
+        pin_ptr<wchar_t> pinChars = &chars[0];
+        pin_ptr<int> pinResults = &results[0];
+
+        TuningTable table;
+        TuningDefault(table);
+        for (int operation = 0; operation < TuningOperationCount; ++operation)
+        {
+            for (int setClass = 0; setClass < TuningSetClasses; ++setClass)
+            {
+                // compares don't have a search set, the first class is measured for all
+                if (operation == TuningCommonPrefix && setClass)
+                {
+                    for (int bucket = 1; bucket < TuningLengthBuckets; ++bucket)
+                        table.tiers[operation][setClass][bucket] = table.tiers[operation][0][bucket];
+                    continue;
+                }
+
+                // bucket 0 is the empty string, nothing to measure
+                for (int bucket = 1; bucket < TuningLengthBuckets; ++bucket)
+                {
+                    const int length = (3 << bucket) >> 2;
+
+                    TuningTier fastest = TuningManaged;
+                    double fastestTime = Double::MaxValue;
+                    for (int tier = TuningManaged; tier <= best; ++tier)
+                    {
+                        double time = Measure((TuningOperation)operation, (TuningTier)tier, pinText, pinOther, pinChars, TuningSetSizes[setClass], length, pinResults);
+                        if (time < fastestTime)
+                        {
+                            fastestTime = time;
+                            fastest = (TuningTier)tier;
+                        }
+                    }
+                    table.tiers[operation][setClass][bucket] = (unsigned char)fastest;
+                }
+            }
+        }
+
+        TuningInstall(table, features);
+        calibrated_ = true;
+    }
+
+    void __clrcall Tuning::Reset()
+    {
+        TuningTable table;
+        TuningDefault(table);
+        TuningInstall(table, InstructionSet::Features());
+        calibrated_ = false;
+    }
+
+    System::String ^ __clrcall Tuning::Key()
+    {
+        return System::String::Format(L"{0} 0x{1:x16}", Cpu::Brand, (UInt64)Cpu::Features);
+    }
+
+    // Intrinsics.Net tuning <version>
+    // cpu <brand> 0x<features>
+    // <operation> <set class> <tier per length bucket>
+    void __clrcall Tuning::Save(System::String ^ path)
+    {
+        if (path == nullptr)
+            throw gcnew ArgumentNullException("path is null");
+
+        StringBuilder^ builder = gcnew StringBuilder();
+        builder->AppendFormat(L"Intrinsics.Net tuning {0}\n", Version);
+        builder->AppendFormat(L"cpu {0}\n", Key());
+        for (int operation = 0; operation < TuningOperationCount; ++operation)
+        {
+            for (int setClass = 0; setClass < TuningSetClasses; ++setClass)
+            {
+                builder->AppendFormat(L"{0} {1} ", (Operation)operation, setClass);
+                for (int bucket = 0; bucket < TuningLengthBuckets; ++bucket)
+                    builder->Append((wchar_t)(L'0' + TuningCurrent.tiers[operation][setClass][bucket]));
+                builder->Append(L'\n');
+            }
+        }
+
+        System::String ^ folder = Path::GetDirectoryName(path);
+        if (!System::String::IsNullOrEmpty(folder))
+            Directory::CreateDirectory(folder);
+        File::WriteAllText(path, builder->ToString());
+    }
+
+    bool __clrcall Tuning::Load(System::String ^ path)
+    {
+        if (path == nullptr)
+            throw gcnew ArgumentNullException("path is null");
+
+        if (!File::Exists(path))
+            return false;
+
+        array<System::String ^>^ lines = File::ReadAllLines(path);
+        if (lines->Length != 2 + TuningOperationCount * TuningSetClasses)
+            return false;
+        if (lines[0] != System::String::Format(L"Intrinsics.Net tuning {0}", Version))
+            return false;
+        if (lines[1] != L"cpu " + Key())
+            return false;
+
+        TuningTable table;
+        for (int operation = 0; operation < TuningOperationCount; ++operation)
+        {
+            for (int setClass = 0; setClass < TuningSetClasses; ++setClass)
+            {
+                System::String ^ prefix = System::String::Format(L"{0} {1} ", (Operation)operation, setClass);
+                System::String ^ line = lines[2 + operation * TuningSetClasses + setClass];
+                if (!line->StartsWith(prefix, StringComparison::Ordinal) || line->Length != prefix->Length + TuningLengthBuckets)
+                    return false;
+
+                for (int bucket = 0; bucket < TuningLengthBuckets; ++bucket)
+                {
+                    int tier = line[prefix->Length + bucket] - L'0';
+                    if (tier < 0 || tier >= TuningTierCount)
+                        return false;
+                    table.tiers[operation][setClass][bucket] = (unsigned char)tier;
+                }
+            }
+        }
+
+        TuningInstall(table, InstructionSet::Features());
+        calibrated_ = true;
+        return true;
+    }
+
+    Tuning::Tuning()
+    {
+        Reset();
+        try
+        {
+            Load(DefaultPath);
+        }
+        catch (Exception^)
+        {
+            // unreadable calibration, keep the built-in table
+        }
+    }
+}
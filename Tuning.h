@@ -0,0 +1,113 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+#include "TuningTable.h"
+
+using namespace System;
+
+// String.cpp, run one tier regardless of the table
+int StrIndexOfAllTier(TuningTier tier, const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results);
+int StrIndexOfAnyTier(TuningTier tier, const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count);
+int StrCommonPrefixTier(TuningTier tier, const wchar_t* a, const wchar_t* b, int length, bool ignoreCase);
+
+namespace Intrinsics
+{
+    // crossover table choosing the implementation per operation, search set size and length.
+    // a built-in table is used until Calibrate measure this machine, Save persist the calibration and
+    // the saved table is loaded at startup from DefaultPath when it match this cpu brand and features.
+    public ref class Tuning abstract sealed
+    {
+    public:
+        enum class Operation
+        {
+            IndexOfAll = TuningIndexOfAll,
+            IndexOfAny = TuningIndexOfAny,
+            CommonPrefix = TuningCommonPrefix
+        };
+
+        enum class Tier
+        {
+            Managed = TuningManaged,
+            Cpp = TuningCpp,
+            Sse2 = TuningSse2,
+            Avx2 = TuningAvx2
+        };
+
+        // file format version, files of other versions are ignored
+        literal int Version = 2;
+
+        // %LOCALAPPDATA%\Intrinsics.Net\tuning.txt
+        static property System::String ^ DefaultPath
+        {
+            System::String ^ get();
+        }
+
+        // true when the active table was measured on this machine
+        static property bool Calibrated
+        {
+            bool get() { return calibrated_; }
+        }
+
+        // scanned bytes from which the vector searches use the large input mode: non temporal prefetch
+        // and streaming stores for the results. 0 is Cpu::NonTemporalThreshold, negative disable it
+        static property Int64 StreamThreshold
+        {
+            Int64 get();
+            void set(Int64 value);
+        }
+
+        // large input mode prefetch distance, bytes ahead of the current load
+        static property int PrefetchDistance
+        {
+            int get();
+            void set(int value);
+        }
+
+        static Tier __clrcall Select(Operation operation, int charsLength, int length);
+
+        // micro-benchmark every supported tier per set size and length bucket and install the result
+        static void __clrcall Calibrate();
+
+        // install the built-in table
+        static void __clrcall Reset();
+
+        static void __clrcall Save(System::String ^ path);
+
+        // false when the file is missing, of another version or calibrated on another cpu
+        static bool __clrcall Load(System::String ^ path);
+
+    internal:
+        // run the static constructor, called by String before its first search
+        static void __clrcall Initialize() {}
+
+    private:
+        // built-in table then DefaultPath
+        static Tuning();
+
+        static double __clrcall Measure(TuningOperation operation, TuningTier tier, const wchar_t* text, const wchar_t* other, const wchar_t* chars, int charsLength, int length, int* results);
+
+        static System::String ^ __clrcall Key();
+
+        static bool calibrated_;
+    };
+}
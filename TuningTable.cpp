@@ -0,0 +1,76 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "TuningTable.h"
+#include "InstructionSet.h"
+
+TuningTable TuningCurrent;
+
+void TuningDefault(TuningTable& table)
+{
+    for (int operation = 0; operation < TuningOperationCount; ++operation)
+    {
+        for (int setClass = 0; setClass < TuningSetClasses; ++setClass)
+        {
+            for (int bucket = 0; bucket < TuningLengthBuckets; ++bucket)
+            {
+                // under 8 chars the managed to native transition cost more than the search,
+                // AVX2 need a few full vectors to amortize its unaligned head and tail
+                TuningTier tier = bucket <= 3 ? TuningManaged : bucket <= 6 ? TuningSse2 : TuningAvx2;
+                table.tiers[operation][setClass][bucket] = (unsigned char)tier;
+            }
+        }
+    }
+}
+
+TuningTier TuningBestTier(uint64_t features)
+{
+    if (features & InstructionSet::FeatureAVX2)
+        return TuningAvx2;
+    if (features & InstructionSet::FeatureSSE2)
+        return TuningSse2;
+    return TuningCpp;
+}
+
+void TuningInstall(const TuningTable& table, uint64_t features)
+{
+    const TuningTier best = TuningBestTier(features);
+
+    TuningTable installed = table;
+    for (int operation = 0; operation < TuningOperationCount; ++operation)
+    {
+        for (int setClass = 0; setClass < TuningSetClasses; ++setClass)
+        {
+            for (int bucket = 0; bucket < TuningLengthBuckets; ++bucket)
+            {
+                unsigned char& tier = installed.tiers[operation][setClass][bucket];
+                if (tier >= TuningTierCount)
+                    tier = TuningManaged;
+                else if (tier > best)
+                    tier = (unsigned char)best;
+            }
+        }
+    }
+
+    // readers may see a mix of both tables while copying, every entry is valid in both
+    TuningCurrent = installed;
+}
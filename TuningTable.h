@@ -0,0 +1,97 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// crossover table, the implementation tier used per operation, search set size and string length.
+// filled with TuningDefault or a calibrated table (see Intrinsics::Tuning), a lookup is 3 array indexes.
+
+#include <stdint.h>
+
+enum TuningTier
+{
+    TuningManaged,      // loop compiled as managed code, no managed to native transition
+    TuningCpp,
+    TuningSse2,
+    TuningAvx2,
+    TuningTierCount
+};
+
+enum TuningOperation
+{
+    TuningIndexOfAll,
+    TuningIndexOfAny,
+    TuningCommonPrefix,     // ordinal compares, a single set class is used
+    TuningOperationCount
+};
+
+// search set size classes: 1, 2, 3-4, 5-8, 9-16, 17+
+static const int TuningSetClasses = 6;
+
+// length buckets: bucket b hold lengths in [2^(b-1), 2^b[, the last one is open ended
+static const int TuningLengthBuckets = 16;
+
+struct TuningTable
+{
+    unsigned char tiers[TuningOperationCount][TuningSetClasses][TuningLengthBuckets];
+};
+
+// active table, all TuningManaged until a table is installed
+extern TuningTable TuningCurrent;
+
+// built-in table used when the machine was never calibrated
+void TuningDefault(TuningTable& table);
+
+// install a table, tiers the cpu doesn't support fall back to the best supported one
+void TuningInstall(const TuningTable& table, uint64_t features);
+
+// fastest supported tier of a cpu features mask (InstructionSet::Features())
+TuningTier TuningBestTier(uint64_t features);
+
+inline int TuningSetClass(int charsLength)
+{
+    return charsLength <= 2 ? (charsLength < 1 ? 0 : charsLength - 1)
+        : charsLength <= 4 ? 2
+        : charsLength <= 8 ? 3
+        : charsLength <= 16 ? 4
+        : 5;
+}
+
+// bit length of count clamped to the last bucket, binary search since bit scan intrinsics aren't
+// available to the managed callers
+inline int TuningLengthBucket(int count)
+{
+    unsigned length = (unsigned)count;
+    if (length >= 1u << (TuningLengthBuckets - 2))
+        return TuningLengthBuckets - 1;
+
+    int bucket = 0;
+    if (length >= 1u << 8) { length >>= 8; bucket += 8; }
+    if (length >= 1u << 4) { length >>= 4; bucket += 4; }
+    if (length >= 1u << 2) { length >>= 2; bucket += 2; }
+    if (length >= 1u << 1) { length >>= 1; bucket += 1; }
+    return bucket + (int)length;
+}
+
+inline TuningTier TuningSelect(TuningOperation operation, int charsLength, int count)
+{
+    return (TuningTier)TuningCurrent.tiers[operation][TuningSetClass(charsLength)][TuningLengthBucket(count)];
+}
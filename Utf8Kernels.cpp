@@ -0,0 +1,764 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "Utf8Kernels.h"
+#include "InstructionSet.h"
+#include "KernelIsa.h"
+
+#include <tmmintrin.h>      // SSSE3 shuffle
+#include <nmmintrin.h>      // popcnt
+
+namespace
+{
+    // error results carry the index of the first invalid char or byte
+    __forceinline int64_t Invalid(int64_t index)
+    {
+        return -1 - index;
+    }
+
+    // utf-8 bytes of the char at s: 1 to 3, 4 for a surrogate pair and 0 for an unpaired surrogate
+    __forceinline int Utf8Bytes(const wchar_t* s, const wchar_t* end)
+    {
+        const unsigned c = s[0];
+        if (c < 0x80)
+            return 1;
+        if (c < 0x800)
+            return 2;
+        if ((c & 0xf800) != 0xd800)
+            return 3;
+        if (c < 0xdc00 && s + 1 < end && (unsigned)(s[1] - 0xdc00) < 0x400)
+            return 4;
+        return 0;
+    }
+
+    __forceinline unsigned char* Encode(const wchar_t* s, int bytes, unsigned char* dst)
+    {
+        const unsigned c = s[0];
+        switch (bytes)
+        {
+        case 1:
+            dst[0] = (unsigned char)c;
+            break;
+        case 2:
+            dst[0] = (unsigned char)(0xc0 | (c >> 6));
+            dst[1] = (unsigned char)(0x80 | (c & 0x3f));
+            break;
+        case 3:
+            dst[0] = (unsigned char)(0xe0 | (c >> 12));
+            dst[1] = (unsigned char)(0x80 | ((c >> 6) & 0x3f));
+            dst[2] = (unsigned char)(0x80 | (c & 0x3f));
+            break;
+        default:
+        {
+            const unsigned cp = 0x10000 + ((c - 0xd800) << 10) + (s[1] - 0xdc00);
+            dst[0] = (unsigned char)(0xf0 | (cp >> 18));
+            dst[1] = (unsigned char)(0x80 | ((cp >> 12) & 0x3f));
+            dst[2] = (unsigned char)(0x80 | ((cp >> 6) & 0x3f));
+            dst[3] = (unsigned char)(0x80 | (cp & 0x3f));
+            break;
+        }
+        }
+        return dst + bytes;
+    }
+
+    // sequence length at p, 0 when invalid. c receive the code point
+    __forceinline int Decode(const unsigned char* p, const unsigned char* end, unsigned& c)
+    {
+        const unsigned b0 = p[0];
+        if (b0 < 0x80)
+        {
+            c = b0;
+            return 1;
+        }
+
+        // continuation bytes and overlong 2 bytes leads
+        if (b0 < 0xc2)
+            return 0;
+
+        const ptrdiff_t available = end - p;
+        if (b0 < 0xe0)
+        {
+            if (available < 2 || (p[1] & 0xc0) != 0x80)
+                return 0;
+            c = (b0 & 0x1f) << 6 | (p[1] & 0x3f);
+            return 2;
+        }
+
+        if (b0 < 0xf0)
+        {
+            // e0 need a0+ to not be overlong, ed need 9f- to not encode a surrogate
+            const unsigned low = b0 == 0xe0 ? 0xa0 : 0x80;
+            const unsigned high = b0 == 0xed ? 0x9f : 0xbf;
+            if (available < 3 || p[1] < low || p[1] > high || (p[2] & 0xc0) != 0x80)
+                return 0;
+            c = (b0 & 0x0f) << 12 | (p[1] & 0x3f) << 6 | (p[2] & 0x3f);
+            return 3;
+        }
+
+        if (b0 < 0xf5)
+        {
+            // f0 need 90+ to not be overlong, f4 need 8f- to stay below U+110000
+            const unsigned low = b0 == 0xf0 ? 0x90 : 0x80;
+            const unsigned high = b0 == 0xf4 ? 0x8f : 0xbf;
+            if (available < 4 || p[1] < low || p[1] > high || (p[2] & 0xc0) != 0x80 || (p[3] & 0xc0) != 0x80)
+                return 0;
+            c = (b0 & 0x07) << 18 | (p[1] & 0x3f) << 12 | (p[2] & 0x3f) << 6 | (p[3] & 0x3f);
+            return 4;
+        }
+
+        return 0;
+    }
+
+    __forceinline wchar_t* Emit(unsigned c, wchar_t* dst)
+    {
+        if (c < 0x10000)
+        {
+            dst[0] = (wchar_t)c;
+            return dst + 1;
+        }
+        c -= 0x10000;
+        dst[0] = (wchar_t)(0xd800 + (c >> 10));
+        dst[1] = (wchar_t)(0xdc00 + (c & 0x3ff));
+        return dst + 2;
+    }
+
+    // pshufb controls that compress 8 chars of 1 or 2 bytes to their utf-8 bytes, indexed by the
+    // mask of the chars >= 0x80. a 1 byte char keep its low byte, a 2 bytes char keep both.
+    struct Utf8PackTable
+    {
+        unsigned char shuffle[256][16];
+        unsigned char length[256];
+
+        Utf8PackTable()
+        {
+            for (int mask = 0; mask < 256; ++mask)
+            {
+                int n = 0;
+                for (int i = 0; i < 8; ++i)
+                {
+                    shuffle[mask][n++] = (unsigned char)(2 * i);
+                    if (mask & (1 << i))
+                        shuffle[mask][n++] = (unsigned char)(2 * i + 1);
+                }
+                length[mask] = (unsigned char)n;
+                while (n < 16)
+                    shuffle[mask][n++] = 0x80;
+            }
+        }
+    };
+
+    const Utf8PackTable PackTable;
+
+    // 8 chars below 0x800 to utf-8, write 16 bytes and return the end of the used ones
+    __forceinline unsigned char* Pack2(__m128i v, unsigned char* dst)
+    {
+        const __m128i multi = _mm_cmpgt_epi16(v, _mm_set1_epi16(0x7f));
+
+        // 110xxxxx lead in the low byte, 10xxxxxx continuation in the high byte
+        const __m128i lead = _mm_or_si128(_mm_srli_epi16(v, 6), _mm_set1_epi16(0xc0));
+        const __m128i next = _mm_slli_epi16(_mm_or_si128(_mm_and_si128(v, _mm_set1_epi16(0x3f)), _mm_set1_epi16(0x80)), 8);
+        const __m128i encoded = _mm_or_si128(_mm_and_si128(multi, _mm_or_si128(lead, next)), _mm_andnot_si128(multi, v));
+
+        const int mask = _mm_movemask_epi8(_mm_packs_epi16(multi, _mm_setzero_si128()));
+        _mm_storeu_si128((__m128i*)dst, _mm_shuffle_epi8(encoded, _mm_loadu_si128((const __m128i*)PackTable.shuffle[mask])));
+        return dst + PackTable.length[mask];
+    }
+
+    template<class Isa>
+    __forceinline bool IsAsciiVector(typename Isa::Vector v, typename Isa::Vector high)
+    {
+        return Isa::Mask(Isa::Equal(Isa::And(v, high), Isa::Zero())) == Isa::MaskAll;
+    }
+
+    template<class Isa>
+    bool IsAscii(const wchar_t* str, int length)
+    {
+        const typename Isa::Vector high = Isa::Set(0xff80);
+        const wchar_t* s = str;
+        const wchar_t* end = str + length;
+        for (; end - s >= Isa::Length; s += Isa::Length)
+        {
+            if (!IsAsciiVector<Isa>(Isa::LoadUnaligned(s), high))
+                return false;
+        }
+
+        // overlapping last vector
+        if (s != end && length >= Isa::Length)
+            return IsAsciiVector<Isa>(Isa::LoadUnaligned(end - Isa::Length), high);
+
+        for (; s < end; ++s)
+        {
+            if (*s >= 0x80)
+                return false;
+        }
+        return true;
+    }
+
+    template<class Isa>
+    bool BytesAscii(const unsigned char* bytes, int length)
+    {
+        // the char vectors are loaded as bytes, the mask hold the bytes high bit
+        const int vectorBytes = 2 * Isa::Length;
+        const unsigned char* p = bytes;
+        const unsigned char* end = bytes + length;
+        for (; end - p >= vectorBytes; p += vectorBytes)
+        {
+            if (Isa::Mask(Isa::LoadUnaligned((const wchar_t*)p)))
+                return false;
+        }
+
+        if (p != end && length >= vectorBytes)
+            return !Isa::Mask(Isa::LoadUnaligned((const wchar_t*)(end - vectorBytes)));
+
+        for (; p < end; ++p)
+        {
+            if (*p >= 0x80)
+                return false;
+        }
+        return true;
+    }
+
+    // lanes sum of chars counters
+    template<class Isa>
+    __forceinline int64_t Sum(typename Isa::Vector v)
+    {
+        short lanes[Isa::Length];
+        Isa::Store(lanes, v);
+        int64_t sum = 0;
+        for (int i = 0; i < Isa::Length; ++i)
+            sum += (unsigned short)lanes[i];
+        return sum;
+    }
+
+    template<class Isa>
+    int64_t Utf8Length(const wchar_t* str, int length)
+    {
+        typedef typename Isa::Vector Vector;
+
+        // each char is 3 bytes minus one when below 0x80 and one when below 0x800, the counters are
+        // summed before the 16 bits lanes overflow
+        const int FlushBlocks = 8192;
+
+        const Vector ascii = Isa::Set(0xff80);
+        const Vector two = Isa::Set(0xf800);
+        const Vector surrogate = Isa::Set(0xd800);
+
+        const wchar_t* s = str;
+        const wchar_t* end = str + length;
+        int64_t bytes = 0;
+        while (end - s >= Isa::Length)
+        {
+            Vector below = Isa::Zero();
+            int blocks = 0;
+            for (; blocks < FlushBlocks && end - s >= Isa::Length; ++blocks)
+            {
+                const Vector v = Isa::LoadUnaligned(s);
+                const Vector top = Isa::And(v, two);
+
+                // surrogates are paired in the scalar code, the pair may cross the block end
+                if (Isa::Mask(Isa::Equal(top, surrogate)))
+                {
+                    const wchar_t* blockEnd = s + Isa::Length;
+                    while (s < blockEnd)
+                    {
+                        const int n = Utf8Bytes(s, end);
+                        if (!n)
+                            return Invalid(s - str);
+                        bytes += n;
+                        s += n == 4 ? 2 : 1;
+                    }
+                    --blocks;
+                    continue;
+                }
+
+                below = Isa::Sub(below, Isa::Equal(Isa::And(v, ascii), Isa::Zero()));
+                below = Isa::Sub(below, Isa::Equal(top, Isa::Zero()));
+                s += Isa::Length;
+            }
+            bytes += 3 * (int64_t)blocks * Isa::Length - Sum<Isa>(below);
+        }
+
+        while (s < end)
+        {
+            const int n = Utf8Bytes(s, end);
+            if (!n)
+                return Invalid(s - str);
+            bytes += n;
+            s += n == 4 ? 2 : 1;
+        }
+        return bytes;
+    }
+
+    // Shuffle pack the blocks of 1 and 2 bytes chars, it need ssse3
+    template<class Isa, bool Shuffle>
+    int64_t ToUtf8(const wchar_t* str, int length, unsigned char* bytes)
+    {
+        typedef typename Isa::Vector Vector;
+
+        const Vector ascii = Isa::Set(0xff80);
+        const Vector two = Isa::Set(0xf800);
+
+        const wchar_t* s = str;
+        const wchar_t* end = str + length;
+        unsigned char* dst = bytes;
+        while (end - s >= Isa::Length)
+        {
+            const Vector v = Isa::LoadUnaligned(s);
+            if (IsAsciiVector<Isa>(v, ascii))
+            {
+                Isa::StoreNarrow(dst, v);
+                dst += Isa::Length;
+                s += Isa::Length;
+                continue;
+            }
+
+            // the shuffle store 16 bytes, the chars left make sure they stay in the output
+            if (Shuffle && end - s >= 2 * Isa::Length && IsAsciiVector<Isa>(v, two))
+            {
+                dst = Pack2(Isa::Low128(v), dst);
+                if (Isa::Length > 8)
+                    dst = Pack2(Isa::High128(v), dst);
+                s += Isa::Length;
+                continue;
+            }
+
+            const wchar_t* blockEnd = s + Isa::Length;
+            while (s < blockEnd)
+            {
+                const int n = Utf8Bytes(s, end);
+                if (!n)
+                    return Invalid(s - str);
+                dst = Encode(s, n, dst);
+                s += n == 4 ? 2 : 1;
+            }
+        }
+
+        while (s < end)
+        {
+            const int n = Utf8Bytes(s, end);
+            if (!n)
+                return Invalid(s - str);
+            dst = Encode(s, n, dst);
+            s += n == 4 ? 2 : 1;
+        }
+        return dst - bytes;
+    }
+
+    // ascii blocks of 16 bytes are counted without decoding
+    int Utf16Length(const unsigned char* bytes, int length, bool vector)
+    {
+        const unsigned char* p = bytes;
+        const unsigned char* end = bytes + length;
+        int chars = 0;
+        while (p < end)
+        {
+            const unsigned char* blockEnd = end;
+            if (vector && end - p >= 16)
+            {
+                if (!_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)p)))
+                {
+                    chars += 16;
+                    p += 16;
+                    continue;
+                }
+                blockEnd = p + 16;
+            }
+
+            while (p < blockEnd)
+            {
+                unsigned c;
+                const int n = Decode(p, end, c);
+                if (!n)
+                    return (int)Invalid(p - bytes);
+                chars += n == 4 ? 2 : 1;
+                p += n;
+            }
+        }
+        return chars;
+    }
+
+    // utf-8 validation of 32 bytes at once by nibbles lookups (Keiser and Lemire). each lookup give the
+    // errors a pair of bytes could be from one nibble, the pair is invalid when the 3 lookups share one.
+    // the 3 and 4 bytes sequences continuations are checked from the 2 and 3 bytes before
+    enum Utf8Error
+    {
+        TooShort = 1 << 0,      // lead not followed by a continuation
+        TooLong = 1 << 1,       // continuation after an ascii byte
+        Overlong3 = 1 << 2,
+        TooLarge = 1 << 3,      // above U+10FFFF
+        Surrogate = 1 << 4,
+        Overlong2 = 1 << 5,
+        TooLarge1000 = 1 << 6,
+        Overlong4 = 1 << 6,
+        TwoConts = 1 << 7,      // continuation after a continuation, valid only in 3 and 4 bytes sequences
+        Carry = TooShort | TooLong | TwoConts
+    };
+
+    __forceinline __m256i Utf8Table(int b0, int b1, int b2, int b3, int b4, int b5, int b6, int b7, int b8, int b9, int b10, int b11, int b12, int b13, int b14, int b15)
+    {
+        const __m128i table = _mm_setr_epi8((char)b0, (char)b1, (char)b2, (char)b3, (char)b4, (char)b5, (char)b6, (char)b7, (char)b8, (char)b9, (char)b10, (char)b11, (char)b12, (char)b13, (char)b14, (char)b15);
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(table), table, 1);
+    }
+
+    struct Utf8Validator
+    {
+        __m256i byte1High;
+        __m256i byte1Low;
+        __m256i byte2High;
+
+        __forceinline Utf8Validator()
+        {
+            // first byte high nibble: ascii, continuation, 2 bytes leads c and d, 3 bytes lead, 4 bytes lead
+            byte1High = Utf8Table(TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+                TwoConts, TwoConts, TwoConts, TwoConts,
+                TooShort | Overlong2, TooShort, TooShort | Overlong3 | Surrogate, TooShort | TooLarge | TooLarge1000 | Overlong4);
+
+            // first byte low nibble: c0 c1 e0 f0 overlongs, ed surrogates, f4+ too large
+            byte1Low = Utf8Table(Carry | Overlong3 | Overlong2 | Overlong4, Carry | Overlong2, Carry, Carry,
+                Carry | TooLarge, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000 | Surrogate, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000);
+
+            // second byte high nibble: ascii, continuations 8, 9, a and b, leads
+            byte2High = Utf8Table(TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+                TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge1000 | Overlong4,
+                TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge,
+                TooLong | Overlong2 | TwoConts | Surrogate | TooLarge,
+                TooLong | Overlong2 | TwoConts | Surrogate | TooLarge,
+                TooShort, TooShort, TooShort, TooShort);
+        }
+
+        // non zero when input is invalid, previous is the 32 bytes before it
+        __forceinline __m256i Errors(__m256i input, __m256i previous) const
+        {
+            const __m256i nibble = _mm256_set1_epi8(0x0f);
+            const __m256i carried = _mm256_permute2x128_si256(previous, input, 0x21);
+            const __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+            const __m256i prev2 = _mm256_alignr_epi8(input, carried, 14);
+            const __m256i prev3 = _mm256_alignr_epi8(input, carried, 13);
+
+            const __m256i special = _mm256_and_si256(_mm256_and_si256(
+                _mm256_shuffle_epi8(byte1High, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                _mm256_shuffle_epi8(byte1Low, _mm256_and_si256(prev1, nibble))),
+                _mm256_shuffle_epi8(byte2High, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+            // high bit set 2 bytes after a e0+ lead and 3 bytes after a f0+ lead, where TwoConts is valid
+            const __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xe0 - 0x80))), _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xf0 - 0x80))));
+            return _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8((char)0x80)), special);
+        }
+    };
+
+    // Utf16Length on 32 bytes blocks: the valid blocks chars are the bytes that are not continuations
+    // plus one per 4 bytes lead. invalid blocks and the tail are left to the scalar loop
+    int Utf16LengthAvx2(const unsigned char* bytes, int length)
+    {
+        const unsigned char* p = bytes;
+        const unsigned char* end = bytes + length;
+        const __m256i notContinuation = _mm256_set1_epi8((char)0xbf);
+        const __m256i fourBytes = _mm256_set1_epi8((char)0xf0);
+
+        // non zero when the block last 3 bytes start a sequence that continue in the next block
+        const __m256i incompleteMax = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xf0 - 1), (char)(0xe0 - 1), (char)(0xc0 - 1));
+
+        // the tables are built per call, a global would run avx2 code at startup on any cpu
+        const Utf8Validator validator;
+        __m256i previous = _mm256_setzero_si256();
+        __m256i incomplete = _mm256_setzero_si256();
+        int chars = 0;
+        for (; end - p >= 32; p += 32)
+        {
+            const __m256i input = _mm256_loadu_si256((const __m256i*)p);
+            const unsigned ascii = (unsigned)_mm256_movemask_epi8(input);
+            if (!ascii && _mm256_testz_si256(incomplete, incomplete))
+            {
+                chars += 32;
+                previous = input;
+                continue;
+            }
+
+            const __m256i errors = validator.Errors(input, previous);
+            if (!_mm256_testz_si256(errors, errors))
+                break;
+
+            // signed compare: ascii and leads are above 0xbf
+            chars += _mm_popcnt_u32((unsigned)_mm256_movemask_epi8(_mm256_cmpgt_epi8(input, notContinuation)));
+            chars += _mm_popcnt_u32((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(input, fourBytes), input)));
+            previous = input;
+            incomplete = _mm256_subs_epu8(input, incompleteMax);
+        }
+
+        // a sequence started by the last counted block is decoded again with the rest
+        for (int back = 1; back <= 3 && back <= p - bytes; ++back)
+        {
+            const unsigned b = p[-back];
+            if (b < 0x80)
+                break;
+            if (b >= 0xc0)
+            {
+                if (back < (b >= 0xf0 ? 4 : b >= 0xe0 ? 3 : 2))
+                {
+                    chars -= b >= 0xf0 ? 2 : 1;
+                    p -= back;
+                }
+                break;
+            }
+        }
+
+        while (p < end)
+        {
+            unsigned c;
+            const int n = Decode(p, end, c);
+            if (!n)
+                return (int)Invalid(p - bytes);
+            chars += n == 4 ? 2 : 1;
+            p += n;
+        }
+        return chars;
+    }
+
+    // ascii blocks of a vector of bytes are widened without decoding
+    template<class Isa>
+    int FromUtf8(const unsigned char* bytes, int length, wchar_t* str)
+    {
+        const int vectorBytes = 2 * Isa::Length;
+        const unsigned char* p = bytes;
+        const unsigned char* end = bytes + length;
+        wchar_t* dst = str;
+        while (p < end)
+        {
+            const unsigned char* blockEnd = end;
+            if (end - p >= vectorBytes)
+            {
+                const typename Isa::Vector v = Isa::LoadUnaligned((const wchar_t*)p);
+                if (!Isa::Mask(v))
+                {
+                    Isa::StoreWide(dst, Isa::Low128(v));
+                    if (Isa::Length > 8)
+                        Isa::StoreWide(dst + 16, Isa::High128(v));
+                    dst += vectorBytes;
+                    p += vectorBytes;
+                    continue;
+                }
+                blockEnd = p + vectorBytes;
+            }
+
+            while (p < blockEnd)
+            {
+                unsigned c;
+                const int n = Decode(p, end, c);
+                if (!n)
+                    return (int)Invalid(p - bytes);
+                dst = Emit(c, dst);
+                p += n;
+            }
+        }
+        return (int)(dst - str);
+    }
+}
+
+bool StrIsAscii(const wchar_t* str, int length)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrIsAscii_AVX2(str, length);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return StrIsAscii_SSE2(str, length);
+    return StrIsAscii_CPP(str, length);
+}
+
+bool StrIsAscii_SSE2(const wchar_t* str, int length)
+{
+    return IsAscii<Sse2>(str, length);
+}
+
+bool StrIsAscii_AVX2(const wchar_t* str, int length)
+{
+    return IsAscii<Avx2>(str, length);
+}
+
+bool StrIsAscii_CPP(const wchar_t* str, int length)
+{
+    for (int i = 0; i < length; ++i)
+    {
+        if (str[i] >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+bool BytesIsAscii(const unsigned char* bytes, int length)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return BytesIsAscii_AVX2(bytes, length);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return BytesIsAscii_SSE2(bytes, length);
+    return BytesIsAscii_CPP(bytes, length);
+}
+
+bool BytesIsAscii_SSE2(const unsigned char* bytes, int length)
+{
+    return BytesAscii<Sse2>(bytes, length);
+}
+
+bool BytesIsAscii_AVX2(const unsigned char* bytes, int length)
+{
+    return BytesAscii<Avx2>(bytes, length);
+}
+
+bool BytesIsAscii_CPP(const unsigned char* bytes, int length)
+{
+    for (int i = 0; i < length; ++i)
+    {
+        if (bytes[i] >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+int64_t StrUtf8Length(const wchar_t* str, int length)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrUtf8Length_AVX2(str, length);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return StrUtf8Length_SSE2(str, length);
+    return StrUtf8Length_CPP(str, length);
+}
+
+int64_t StrUtf8Length_SSE2(const wchar_t* str, int length)
+{
+    return Utf8Length<Sse2>(str, length);
+}
+
+int64_t StrUtf8Length_AVX2(const wchar_t* str, int length)
+{
+    return Utf8Length<Avx2>(str, length);
+}
+
+int64_t StrUtf8Length_CPP(const wchar_t* str, int length)
+{
+    const wchar_t* s = str;
+    const wchar_t* end = str + length;
+    int64_t bytes = 0;
+    while (s < end)
+    {
+        const int n = Utf8Bytes(s, end);
+        if (!n)
+            return Invalid(s - str);
+        bytes += n;
+        s += n == 4 ? 2 : 1;
+    }
+    return bytes;
+}
+
+int64_t StrToUtf8(const wchar_t* str, int length, unsigned char* bytes)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrToUtf8_AVX2(str, length, bytes);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return StrToUtf8_SSE2(str, length, bytes);
+    return StrToUtf8_CPP(str, length, bytes);
+}
+
+int64_t StrToUtf8_SSE2(const wchar_t* str, int length, unsigned char* bytes)
+{
+    return ToUtf8<Sse2, false>(str, length, bytes);
+}
+
+int64_t StrToUtf8_AVX2(const wchar_t* str, int length, unsigned char* bytes)
+{
+    return ToUtf8<Avx2, true>(str, length, bytes);
+}
+
+int64_t StrToUtf8_CPP(const wchar_t* str, int length, unsigned char* bytes)
+{
+    const wchar_t* s = str;
+    const wchar_t* end = str + length;
+    unsigned char* dst = bytes;
+    while (s < end)
+    {
+        const int n = Utf8Bytes(s, end);
+        if (!n)
+            return Invalid(s - str);
+        dst = Encode(s, n, dst);
+        s += n == 4 ? 2 : 1;
+    }
+    return dst - bytes;
+}
+
+int StrUtf16Length(const unsigned char* bytes, int length)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrUtf16Length_AVX2(bytes, length);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return StrUtf16Length_SSE2(bytes, length);
+    return StrUtf16Length_CPP(bytes, length);
+}
+
+int StrUtf16Length_SSE2(const unsigned char* bytes, int length)
+{
+    return Utf16Length(bytes, length, true);
+}
+
+int StrUtf16Length_AVX2(const unsigned char* bytes, int length)
+{
+    return Utf16LengthAvx2(bytes, length);
+}
+
+int StrUtf16Length_CPP(const unsigned char* bytes, int length)
+{
+    return Utf16Length(bytes, length, false);
+}
+
+int StrFromUtf8(const unsigned char* bytes, int length, wchar_t* str)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrFromUtf8_AVX2(bytes, length, str);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return StrFromUtf8_SSE2(bytes, length, str);
+    return StrFromUtf8_CPP(bytes, length, str);
+}
+
+int StrFromUtf8_SSE2(const unsigned char* bytes, int length, wchar_t* str)
+{
+    return FromUtf8<Sse2>(bytes, length, str);
+}
+
+int StrFromUtf8_AVX2(const unsigned char* bytes, int length, wchar_t* str)
+{
+    return FromUtf8<Avx2>(bytes, length, str);
+}
+
+int StrFromUtf8_CPP(const unsigned char* bytes, int length, wchar_t* str)
+{
+    const unsigned char* p = bytes;
+    const unsigned char* end = bytes + length;
+    wchar_t* dst = str;
+    while (p < end)
+    {
+        unsigned c;
+        const int n = Decode(p, end, c);
+        if (!n)
+            return (int)Invalid(p - bytes);
+        dst = Emit(c, dst);
+        p += n;
+    }
+    return (int)(dst - str);
+}
@@ -0,0 +1,87 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// unmanaged utf-8 kernels, compiled without /clr like StringKernels
+//
+// utf-16 input is strict: an unpaired surrogate is invalid. utf-8 input is strict too: overlong
+// sequences, encoded surrogates, code points above U+10FFFF and truncated sequences are invalid.
+// length and transcode kernels return -1 - index of the first invalid char or byte when the input
+// is invalid, the destination content is then undefined.
+// vector kernels take ascii blocks a vector at a time and fall back to the scalar code for blocks
+// with other chars. StrToUtf8_AVX2 also pack the blocks of 1 and 2 bytes chars with a shuffle,
+// StrUtf16Length_AVX2 validate and count every 32 bytes block with nibbles lookups.
+// the kernels without suffix pick one from the cpu features.
+
+#include <stdint.h>
+
+bool StrIsAscii(const wchar_t* str, int length);
+
+bool StrIsAscii_SSE2(const wchar_t* str, int length);
+
+bool StrIsAscii_AVX2(const wchar_t* str, int length);
+
+bool StrIsAscii_CPP(const wchar_t* str, int length);
+
+bool BytesIsAscii(const unsigned char* bytes, int length);
+
+bool BytesIsAscii_SSE2(const unsigned char* bytes, int length);
+
+bool BytesIsAscii_AVX2(const unsigned char* bytes, int length);
+
+bool BytesIsAscii_CPP(const unsigned char* bytes, int length);
+
+// utf-8 bytes of str
+int64_t StrUtf8Length(const wchar_t* str, int length);
+
+int64_t StrUtf8Length_SSE2(const wchar_t* str, int length);
+
+int64_t StrUtf8Length_AVX2(const wchar_t* str, int length);
+
+int64_t StrUtf8Length_CPP(const wchar_t* str, int length);
+
+// bytes written, bytes must have room for StrUtf8Length(str, length) bytes
+int64_t StrToUtf8(const wchar_t* str, int length, unsigned char* bytes);
+
+int64_t StrToUtf8_SSE2(const wchar_t* str, int length, unsigned char* bytes);
+
+int64_t StrToUtf8_AVX2(const wchar_t* str, int length, unsigned char* bytes);
+
+int64_t StrToUtf8_CPP(const wchar_t* str, int length, unsigned char* bytes);
+
+// utf-16 chars of bytes
+int StrUtf16Length(const unsigned char* bytes, int length);
+
+int StrUtf16Length_SSE2(const unsigned char* bytes, int length);
+
+int StrUtf16Length_AVX2(const unsigned char* bytes, int length);
+
+int StrUtf16Length_CPP(const unsigned char* bytes, int length);
+
+// chars written, str must have room for StrUtf16Length(bytes, length) chars
+int StrFromUtf8(const unsigned char* bytes, int length, wchar_t* str);
+
+int StrFromUtf8_SSE2(const unsigned char* bytes, int length, wchar_t* str);
+
+int StrFromUtf8_AVX2(const unsigned char* bytes, int length, wchar_t* str);
+
+int StrFromUtf8_CPP(const unsigned char* bytes, int length, wchar_t* str);
@@ -0,0 +1,237 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#include "WhitespaceKernels.h"
+#include "InstructionSet.h"
+#include "KernelIsa.h"
+
+namespace
+{
+    // U+2000-U+207F bits: U+2000-U+200A, U+2028, U+2029, U+202F and U+205F
+    const uint32_t WhitespaceBits2000[4] = { 0x000007ff, 0x00008300, 0x80000000, 0x00000000 };
+
+    __forceinline bool IsWhitespace(unsigned c)
+    {
+        if (c < 0x80)
+            return c == L' ' || c - 9 < 5;
+        if (c < 0x100)
+            return c == 0x85 || c == 0xa0;
+        if ((c & 0xff80) == 0x2000)
+            return (WhitespaceBits2000[(c >> 5) & 3] >> (c & 31)) & 1;
+        return c == 0x1680 || c == 0x3000;
+    }
+
+    // lanes of the ascii whitespace: ' ' and '\t' to '\r'
+    template<class Isa>
+    __forceinline unsigned AsciiWhitespace(typename Isa::Vector v)
+    {
+        const typename Isa::Vector control = Isa::Sub(v, Isa::Set(9));
+        const typename Isa::Vector range = Isa::And(Isa::Greater(control, Isa::Set(-1)), Isa::Greater(Isa::Set(5), control));
+        return Isa::Mask(Isa::Or(range, Isa::Equal(v, Isa::Set(L' '))));
+    }
+
+    // lanes of the chars above 0x7f
+    template<class Isa>
+    __forceinline unsigned NonAscii(typename Isa::Vector v)
+    {
+        return Isa::Mask(Isa::Equal(Isa::And(v, Isa::Set(0xff80)), Isa::Zero())) ^ Isa::MaskAll;
+    }
+
+    template<class Isa>
+    int SkipWhitespace(const wchar_t* str, int length)
+    {
+        const wchar_t* s = str;
+        const wchar_t* end = str + length;
+        for (; end - s >= Isa::Length; s += Isa::Length)
+        {
+            const unsigned other = AsciiWhitespace<Isa>(Isa::LoadUnaligned(s)) ^ Isa::MaskAll;
+            if (other)
+            {
+                // 2 mask bits per char, the scalar loop decide for the non ascii chars
+                unsigned long first;
+                _BitScanForward(&first, other);
+                s += first >> 1;
+                break;
+            }
+        }
+
+        while (s < end && IsWhitespace(*s))
+            ++s;
+        return (int)(s - str);
+    }
+
+    template<class Isa>
+    int SkipWhitespaceBack(const wchar_t* str, int length)
+    {
+        const wchar_t* end = str + length;
+        for (; end - str >= Isa::Length; end -= Isa::Length)
+        {
+            const unsigned other = AsciiWhitespace<Isa>(Isa::LoadUnaligned(end - Isa::Length)) ^ Isa::MaskAll;
+            if (other)
+            {
+                unsigned long last;
+                _BitScanReverse(&last, other);
+                end -= Isa::Length - 1 - (last >> 1);
+                break;
+            }
+        }
+
+        while (end > str && IsWhitespace(end[-1]))
+            --end;
+        return (int)(end - str);
+    }
+
+    template<class Isa>
+    int CollapseWhitespace(const wchar_t* str, int length, wchar_t* dst)
+    {
+        const wchar_t* s = str;
+        const wchar_t* end = str + length;
+        wchar_t* d = dst;
+        bool space = false;
+        while (s < end)
+        {
+            const wchar_t* blockEnd = end;
+            if (end - s >= Isa::Length)
+            {
+                // ascii blocks without whitespace are copied as is, dst never get ahead of s
+                const typename Isa::Vector v = Isa::LoadUnaligned(s);
+                if (!AsciiWhitespace<Isa>(v) && !NonAscii<Isa>(v))
+                {
+                    Isa::Store((short*)d, v);
+                    d += Isa::Length;
+                    s += Isa::Length;
+                    space = false;
+                    continue;
+                }
+                blockEnd = s + Isa::Length;
+            }
+
+            for (; s < blockEnd; ++s)
+            {
+                const wchar_t c = *s;
+                if (!IsWhitespace(c))
+                {
+                    *d++ = c;
+                    space = false;
+                }
+                else if (!space)
+                {
+                    *d++ = L' ';
+                    space = true;
+                }
+            }
+        }
+        return (int)(d - dst);
+    }
+}
+
+int StrSkipWhitespace(const wchar_t* str, int length)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrSkipWhitespace_AVX2(str, length);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return StrSkipWhitespace_SSE2(str, length);
+    return StrSkipWhitespace_CPP(str, length);
+}
+
+int StrSkipWhitespace_SSE2(const wchar_t* str, int length)
+{
+    return SkipWhitespace<Sse2>(str, length);
+}
+
+int StrSkipWhitespace_AVX2(const wchar_t* str, int length)
+{
+    return SkipWhitespace<Avx2>(str, length);
+}
+
+int StrSkipWhitespace_CPP(const wchar_t* str, int length)
+{
+    int i = 0;
+    while (i < length && IsWhitespace(str[i]))
+        ++i;
+    return i;
+}
+
+int StrSkipWhitespaceBack(const wchar_t* str, int length)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrSkipWhitespaceBack_AVX2(str, length);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return StrSkipWhitespaceBack_SSE2(str, length);
+    return StrSkipWhitespaceBack_CPP(str, length);
+}
+
+int StrSkipWhitespaceBack_SSE2(const wchar_t* str, int length)
+{
+    return SkipWhitespaceBack<Sse2>(str, length);
+}
+
+int StrSkipWhitespaceBack_AVX2(const wchar_t* str, int length)
+{
+    return SkipWhitespaceBack<Avx2>(str, length);
+}
+
+int StrSkipWhitespaceBack_CPP(const wchar_t* str, int length)
+{
+    while (length > 0 && IsWhitespace(str[length - 1]))
+        --length;
+    return length;
+}
+
+int StrCollapseWhitespace(const wchar_t* str, int length, wchar_t* dst)
+{
+    if (InstructionSet::Supports(InstructionSet::FeatureAVX2))
+        return StrCollapseWhitespace_AVX2(str, length, dst);
+    if (InstructionSet::Supports(InstructionSet::FeatureSSE2))
+        return StrCollapseWhitespace_SSE2(str, length, dst);
+    return StrCollapseWhitespace_CPP(str, length, dst);
+}
+
+int StrCollapseWhitespace_SSE2(const wchar_t* str, int length, wchar_t* dst)
+{
+    return CollapseWhitespace<Sse2>(str, length, dst);
+}
+
+int StrCollapseWhitespace_AVX2(const wchar_t* str, int length, wchar_t* dst)
+{
+    return CollapseWhitespace<Avx2>(str, length, dst);
+}
+
+int StrCollapseWhitespace_CPP(const wchar_t* str, int length, wchar_t* dst)
+{
+    wchar_t* d = dst;
+    bool space = false;
+    for (int i = 0; i < length; ++i)
+    {
+        const wchar_t c = str[i];
+        if (!IsWhitespace(c))
+        {
+            *d++ = c;
+            space = false;
+        }
+        else if (!space)
+        {
+            *d++ = L' ';
+            space = true;
+        }
+    }
+    return (int)(d - dst);
+}
@@ -0,0 +1,57 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+// unmanaged whitespace kernels, compiled without /clr like StringKernels
+//
+// whitespace is the char::IsWhiteSpace set: U+0009-U+000D, U+0020, U+0085, U+00A0 and the unicode
+// Zs, Zl and Zp chars. vector kernels compare the ascii whitespace a vector at a time and check the
+// other chars with a table from the first lane that isn't ascii whitespace.
+// the kernels without suffix pick one from the cpu features.
+
+// index of the first char that isn't whitespace, length when all are
+int StrSkipWhitespace(const wchar_t* str, int length);
+
+int StrSkipWhitespace_SSE2(const wchar_t* str, int length);
+
+int StrSkipWhitespace_AVX2(const wchar_t* str, int length);
+
+int StrSkipWhitespace_CPP(const wchar_t* str, int length);
+
+// length without the trailing whitespace
+int StrSkipWhitespaceBack(const wchar_t* str, int length);
+
+int StrSkipWhitespaceBack_SSE2(const wchar_t* str, int length);
+
+int StrSkipWhitespaceBack_AVX2(const wchar_t* str, int length);
+
+int StrSkipWhitespaceBack_CPP(const wchar_t* str, int length);
+
+// each whitespace run replaced by a single space, returns the chars written. dst must have room for
+// length chars, it can be str.
+int StrCollapseWhitespace(const wchar_t* str, int length, wchar_t* dst);
+
+int StrCollapseWhitespace_SSE2(const wchar_t* str, int length, wchar_t* dst);
+
+int StrCollapseWhitespace_AVX2(const wchar_t* str, int length, wchar_t* dst);
+
+int StrCollapseWhitespace_CPP(const wchar_t* str, int length, wchar_t* dst);
@@ -0,0 +1,622 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+// native kernels benchmark, google benchmark like command line and json output
+//
+//  --benchmark_filter=<regex>          run benchmarks with a matching name only
+//  --benchmark_min_time=<seconds>      minimum measure time per benchmark, default 0.01
+//  --benchmark_format=<console|json>   stdout format, default json
+//  --benchmark_out=<file>              also write the json results to file
+//  --benchmark_corpus=<name>=<path>    add an utf-8 file corpus
+//  --benchmark_large=<MB>              also scan corpora tiled in a buffer of this size, temporal and stream modes
+//  --benchmark_prefetch_distance=<n>   large input mode prefetch distance in bytes, default StrStream.prefetchDistance
+//  --benchmark_huge_pages              back the large buffers with huge pages when the os allows it
+//
+// benchmark names are operation/tier/corpus/len:<length>/set:<search chars count>
+// large benchmarks are operation/tier/large_<corpus>/len:<length>/set:<search chars count>/<temporal|stream>
+// sort benchmarks are Sort/tier/<random|nearly_sorted|sorted|reversed>/len:<int keys count>, each call copy
+// the unsorted keys before sorting them
+
+#include <intrin.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <regex>
+#include <thread>
+
+#include "../StringKernels.h"
+#include "../SortKernels.h"
+#include "../InstructionSet.h"
+#include "Corpus.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+namespace
+{
+    typedef int(*IndexOfAllFunction)(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count, int* results);
+    typedef int(*IndexOfAnyFunction)(const wchar_t * str, const wchar_t* chars, int charsLength, int startIndex, int count);
+    typedef void(*SortFunction)(int32_t* keys, int64_t count);
+
+    bool SupportAlways() { return true; }
+    bool SupportSse2() { return InstructionSet::Supports(InstructionSet::FeatureSSE2); }
+    bool SupportAvx2() { return InstructionSet::Supports(InstructionSet::FeatureAVX2); }
+    bool SupportAvx512() { return InstructionSet::Supports(InstructionSet::FeatureAVX512F); }
+
+    void SortCpp(int32_t* keys, int64_t count) { ArraySort(ArrayCpp, keys, count); }
+    void SortAvx2(int32_t* keys, int64_t count) { ArraySort(ArrayAvx2, keys, count); }
+    void SortAvx512(int32_t* keys, int64_t count) { ArraySort(ArrayAvx512, keys, count); }
+
+    struct Kernel
+    {
+        const char* operation;
+        const char* tier;
+        bool(*supported)();
+        IndexOfAllFunction indexOfAll;
+        IndexOfAnyFunction indexOfAny;
+        bool stream;        // has the large input mode
+        SortFunction sort;
+    };
+
+    const Kernel Kernels[] =
+    {
+        { "IndexOfAll", "CPP", SupportAlways, StrIndexOfAll_CPP, nullptr, false, nullptr },
+        { "IndexOfAll", "SSE2", SupportSse2, StrIndexOfAll_SSE2, nullptr, true, nullptr },
+        { "IndexOfAll", "AVX2", SupportAvx2, StrIndexOfAll_AVX2, nullptr, true, nullptr },
+        { "IndexOfAny", "CPP", SupportAlways, nullptr, StrIndexOfAny_CPP, false, nullptr },
+        { "IndexOfAny", "SSE2", SupportSse2, nullptr, StrIndexOfAny_SSE2, true, nullptr },
+        { "IndexOfAny", "AVX2", SupportAvx2, nullptr, StrIndexOfAny_AVX2, true, nullptr },
+    };
+
+    const Kernel SortKernels[] =
+    {
+        { "Sort", "CPP", SupportAlways, nullptr, nullptr, false, SortCpp },
+        { "Sort", "AVX2", SupportAvx2, nullptr, nullptr, false, SortAvx2 },
+        { "Sort", "AVX512", SupportAvx512, nullptr, nullptr, false, SortAvx512 },
+    };
+
+    // presorted inputs are where the introsort alone lose to std::sort
+    const char* const SortOrders[] = { "random", "nearly_sorted", "sorted", "reversed" };
+    const int SortLengths[] = { 1 << 10, 1 << 16, 1 << 20, 10000000 };
+
+    // same length buckets as StringTest.RunProfile
+    const int Lengths[] = { 4, 8, 16, 32, 64, 92, 128, 256, 512, 768, 1024, 2048, 4096, 8192 };
+    const int SetSizes[] = { 1, 2, 4, 8, 16, 32 };
+    const size_t CorpusLength = 1024 * 1024;
+
+    // strings of a bucket are cycled, power of 2
+    const int WindowsCount = 64;
+
+    // large scans, search set sizes and StrStream.threshold per mode
+    const int LargeSetSizes[] = { 1, 8 };
+    const char* const LargeModes[] = { "temporal", "stream" };
+    const int64_t LargeThresholds[] = { -1, 1 };
+
+    struct Options
+    {
+        Options() : minTime(0.01), json(true), largeMB(0), prefetchDistance(0), hugePages(false) {}
+
+        std::string filter;
+        double minTime;
+        bool json;
+        std::string out;
+        std::vector<std::pair<std::string, std::string> > corpusFiles;
+        int largeMB;
+        int prefetchDistance;
+        bool hugePages;
+    };
+
+    struct Result
+    {
+        std::string name;
+        const Kernel* kernel;
+        std::string corpus;
+        int length;
+        int elementSize;        // bytes per char or key
+        int setSize;
+        double density;
+        uint64_t iterations;
+        double realTime;        // ns per call
+        double cpuTime;         // ns per call
+        double cyclesPerChar;   // time stamp counter cycles
+    };
+
+    double Now()
+    {
+#ifdef _WIN32
+        static LARGE_INTEGER frequency = {};
+        if (!frequency.QuadPart)
+            QueryPerformanceFrequency(&frequency);
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    double CpuNow()
+    {
+        return (double)clock() / (double)CLOCKS_PER_SEC;
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            std::string::size_type equal = arg.find('=');
+            std::string key = arg.substr(0, equal);
+            std::string value = equal == std::string::npos ? std::string() : arg.substr(equal + 1);
+
+            if (key == "--benchmark_filter")
+                options.filter = value;
+            else if (key == "--benchmark_min_time")
+                options.minTime = atof(value.c_str());
+            else if (key == "--benchmark_format" && (value == "json" || value == "console"))
+                options.json = value == "json";
+            else if (key == "--benchmark_out")
+                options.out = value;
+            else if (key == "--benchmark_corpus" && value.find('=') != std::string::npos)
+                options.corpusFiles.push_back(std::make_pair(value.substr(0, value.find('=')), value.substr(value.find('=') + 1)));
+            else if (key == "--benchmark_large" && atoi(value.c_str()) > 0 && atoi(value.c_str()) < 1024)
+                options.largeMB = atoi(value.c_str());
+            else if (key == "--benchmark_prefetch_distance" && atoi(value.c_str()) > 0)
+                options.prefetchDistance = atoi(value.c_str());
+            else if (key == "--benchmark_huge_pages" && value.empty())
+                options.hugePages = true;
+            else
+            {
+                fprintf(stderr, "unknown argument: %s\n", argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string JsonEscape(const std::string& s)
+    {
+        std::string escaped;
+        for (size_t i = 0; i < s.size(); ++i)
+        {
+            char c = s[i];
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if ((unsigned char)c < 0x20)
+            {
+                char buffer[8];
+                sprintf(buffer, "\\u%04x", (unsigned char)c);
+                escaped += buffer;
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    void WriteJson(FILE* file, const char* executable, const std::vector<Result>& results)
+    {
+        char date[64];
+        time_t now = time(nullptr);
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+        fprintf(file, "{\n");
+        fprintf(file, "  \"context\": {\n");
+        fprintf(file, "    \"date\": \"%s\",\n", date);
+        fprintf(file, "    \"executable\": \"%s\",\n", JsonEscape(executable).c_str());
+        fprintf(file, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+        fprintf(file, "    \"cpu_vendor\": \"%s\",\n", JsonEscape(InstructionSet::Vendor()).c_str());
+        fprintf(file, "    \"cpu_brand\": \"%s\",\n", JsonEscape(InstructionSet::Brand()).c_str());
+        fprintf(file, "    \"cpu_sse2\": %s,\n", InstructionSet::SSE2() ? "true" : "false");
+        fprintf(file, "    \"cpu_avx2\": %s,\n", InstructionSet::AVX2() ? "true" : "false");
+        fprintf(file, "    \"cpu_features\": \"0x%016llx\",\n", (unsigned long long)InstructionSet::Features());
+#ifdef NDEBUG
+        fprintf(file, "    \"library_build_type\": \"release\"\n");
+#else
+        fprintf(file, "    \"library_build_type\": \"debug\"\n");
+#endif
+        fprintf(file, "  },\n");
+        fprintf(file, "  \"benchmarks\": [\n");
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            double bytesPerSecond = r.realTime > 0.0 ? (double)r.length * r.elementSize * 1e9 / r.realTime : 0.0;
+            fprintf(file, "    {\n");
+            fprintf(file, "      \"name\": \"%s\",\n", JsonEscape(r.name).c_str());
+            fprintf(file, "      \"run_name\": \"%s\",\n", JsonEscape(r.name).c_str());
+            fprintf(file, "      \"run_type\": \"iteration\",\n");
+            fprintf(file, "      \"iterations\": %llu,\n", (unsigned long long)r.iterations);
+            fprintf(file, "      \"real_time\": %.4f,\n", r.realTime);
+            fprintf(file, "      \"cpu_time\": %.4f,\n", r.cpuTime);
+            fprintf(file, "      \"time_unit\": \"ns\",\n");
+            fprintf(file, "      \"bytes_per_second\": %.1f,\n", bytesPerSecond);
+            fprintf(file, "      \"operation\": \"%s\",\n", r.kernel->operation);
+            fprintf(file, "      \"tier\": \"%s\",\n", r.kernel->tier);
+            fprintf(file, "      \"corpus\": \"%s\",\n", JsonEscape(r.corpus).c_str());
+            fprintf(file, "      \"length\": %d,\n", r.length);
+            fprintf(file, "      \"set_size\": %d,\n", r.setSize);
+            fprintf(file, "      \"match_density\": %.6f,\n", r.density);
+            fprintf(file, "      \"gb_per_second\": %.4f,\n", bytesPerSecond / 1e9);
+            fprintf(file, "      \"cycles_per_char\": %.4f\n", r.cyclesPerChar);
+            fprintf(file, "    }%s\n", i + 1 < results.size() ? "," : "");
+        }
+        fprintf(file, "  ]\n");
+        fprintf(file, "}\n");
+    }
+
+    volatile int sink;
+
+    // google benchmark like, grow the iterations count until the measure last at least minTime
+    void Measure(const Kernel& kernel, const std::vector<const wchar_t*>& windows, int length, const std::vector<wchar_t>& chars, int* results, double minTime, Result& result)
+    {
+        const int charsLength = (int)chars.size();
+        uint64_t iterations = 1;
+        for (;;)
+        {
+            int accumulate = 0;
+            double start = Now();
+            double cpuStart = CpuNow();
+            uint64_t tscStart = __rdtsc();
+
+            if (kernel.indexOfAll)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                    accumulate += kernel.indexOfAll(windows[i & (WindowsCount - 1)], &chars[0], charsLength, 0, length, results);
+            }
+            else
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                    accumulate += kernel.indexOfAny(windows[i & (WindowsCount - 1)], &chars[0], charsLength, 0, length);
+            }
+
+            uint64_t tsc = __rdtsc() - tscStart;
+            double cpuElapsed = CpuNow() - cpuStart;
+            double elapsed = Now() - start;
+            sink = accumulate;
+
+            if (elapsed >= minTime || iterations >= 1000000000ull)
+            {
+                result.iterations = iterations;
+                result.realTime = elapsed * 1e9 / (double)iterations;
+                result.cpuTime = cpuElapsed * 1e9 / (double)iterations;
+                result.cyclesPerChar = (double)tsc / ((double)iterations * length);
+                return;
+            }
+
+            double multiplier = elapsed > 0.0 ? minTime * 1.4 / elapsed : 10.0;
+            multiplier = multiplier < 2.0 ? 2.0 : (multiplier > 10.0 ? 10.0 : multiplier);
+            iterations = (uint64_t)((double)iterations * multiplier);
+        }
+    }
+
+    double MatchDensity(const std::vector<const wchar_t*>& windows, int length, const std::vector<wchar_t>& chars, int* results)
+    {
+        double matches = 0.0;
+        for (size_t i = 0; i < windows.size(); ++i)
+            matches += StrIndexOfAll_CPP(windows[i], &chars[0], (int)chars.size(), 0, length, results);
+        return matches / ((double)windows.size() * length);
+    }
+
+    void Print(const Result& result)
+    {
+        printf("%-52s %12llu %12.2f %10.3f %12.3f %10.4f\n", result.name.c_str(), (unsigned long long)result.iterations, result.realTime,
+            (double)result.length * result.elementSize / result.realTime, result.cyclesPerChar, result.density);
+        fflush(stdout);
+    }
+
+    // keys of an order: random, sorted with 1% of the keys swapped at random, sorted and reversed
+    std::vector<int32_t> SortInput(const char* order, int length)
+    {
+        std::vector<int32_t> keys(length);
+        uint32_t seed = 0x9e3779b9u;
+        for (int i = 0; i < length; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            keys[i] = strcmp(order, "random") ? i : (int32_t)seed;
+        }
+
+        if (!strcmp(order, "nearly_sorted"))
+        {
+            for (int i = 0; i < length / 100; ++i)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                const int a = (int)(seed % (uint32_t)length);
+                seed = seed * 1664525u + 1013904223u;
+                std::swap(keys[a], keys[seed % (uint32_t)length]);
+            }
+        }
+        else if (!strcmp(order, "reversed"))
+        {
+            std::reverse(keys.begin(), keys.end());
+        }
+        return keys;
+    }
+
+    // like Measure, the unsorted keys are copied in work before each sort
+    void MeasureSort(const Kernel& kernel, const std::vector<int32_t>& keys, std::vector<int32_t>& work, double minTime, Result& result)
+    {
+        const int length = (int)keys.size();
+        uint64_t iterations = 1;
+        for (;;)
+        {
+            double start = Now();
+            double cpuStart = CpuNow();
+            uint64_t tscStart = __rdtsc();
+
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                memcpy(&work[0], &keys[0], (size_t)length * sizeof(int32_t));
+                kernel.sort(&work[0], length);
+            }
+
+            uint64_t tsc = __rdtsc() - tscStart;
+            double cpuElapsed = CpuNow() - cpuStart;
+            double elapsed = Now() - start;
+            sink = work[length / 2];
+
+            if (elapsed >= minTime || iterations >= 1000000000ull)
+            {
+                result.iterations = iterations;
+                result.realTime = elapsed * 1e9 / (double)iterations;
+                result.cpuTime = cpuElapsed * 1e9 / (double)iterations;
+                result.cyclesPerChar = (double)tsc / ((double)iterations * length);
+                return;
+            }
+
+            double multiplier = elapsed > 0.0 ? minTime * 1.4 / elapsed : 10.0;
+            multiplier = multiplier < 2.0 ? 2.0 : (multiplier > 10.0 ? 10.0 : multiplier);
+            iterations = (uint64_t)((double)iterations * multiplier);
+        }
+    }
+
+    void MeasureSorts(const Options& options, const std::regex& filter, std::vector<Result>& benchmarks)
+    {
+        for (size_t o = 0; o < sizeof(SortOrders) / sizeof(SortOrders[0]); ++o)
+        {
+            for (size_t l = 0; l < sizeof(SortLengths) / sizeof(SortLengths[0]); ++l)
+            {
+                std::vector<int32_t> keys;
+                std::vector<int32_t> work;
+                for (size_t k = 0; k < sizeof(SortKernels) / sizeof(SortKernels[0]); ++k)
+                {
+                    const Kernel& kernel = SortKernels[k];
+                    char name[256];
+                    sprintf(name, "%s/%s/%s/len:%d", kernel.operation, kernel.tier, SortOrders[o], SortLengths[l]);
+                    if (!kernel.supported() || !std::regex_search(std::string(name), filter))
+                        continue;
+
+                    if (keys.empty())
+                    {
+                        keys = SortInput(SortOrders[o], SortLengths[l]);
+                        work.resize(keys.size());
+                    }
+
+                    Result result;
+                    result.name = name;
+                    result.kernel = &kernel;
+                    result.corpus = SortOrders[o];
+                    result.length = SortLengths[l];
+                    result.elementSize = sizeof(int32_t);
+                    result.setSize = 0;
+                    result.density = 0.0;
+                    MeasureSort(kernel, keys, work, options.minTime, result);
+                    benchmarks.push_back(result);
+
+                    if (!options.json)
+                        Print(result);
+                }
+            }
+        }
+    }
+
+    // one scan of the corpus tiled in a buffer larger than the last level cache, every window is the buffer
+    // so each call stream from memory, the temporal and stream modes are forced with StrStream.threshold
+    bool MeasureLarge(const Options& options, const std::vector<Corpus>& corpora, const std::regex& filter, std::vector<Result>& benchmarks)
+    {
+        const size_t bytes = (size_t)options.largeMB * 1024 * 1024;
+        const int length = (int)(bytes / sizeof(wchar_t));
+        wchar_t* text = (wchar_t*)StrAllocateLarge(bytes, options.hugePages);
+        int* results = (int*)StrAllocateLarge((size_t)length * 2 * sizeof(int), options.hugePages);
+        if (!text || !results)
+        {
+            fprintf(stderr, "cannot allocate %d MB\n", options.largeMB);
+            StrFreeLarge(text);
+            StrFreeLarge(results);
+            return false;
+        }
+
+        const StrStreamSettings settings = StrStream;
+        if (options.prefetchDistance)
+            StrStream.prefetchDistance = options.prefetchDistance;
+
+        for (size_t c = 0; c < corpora.size(); ++c)
+        {
+            const Corpus& corpus = corpora[c];
+            for (size_t i = 0; i < (size_t)length; i += corpus.text.size())
+                memcpy(text + i, &corpus.text[0], ((size_t)length - i < corpus.text.size() ? (size_t)length - i : corpus.text.size()) * sizeof(wchar_t));
+
+            std::vector<const wchar_t*> windows(WindowsCount, text);
+            for (size_t s = 0; s < sizeof(LargeSetSizes) / sizeof(LargeSetSizes[0]); ++s)
+            {
+                std::vector<wchar_t> chars = CorpusSearchSet(corpus, LargeSetSizes[s]);
+                double density = -1.0;
+
+                // IndexOfAny search private use chars so the whole buffer is scanned
+                std::vector<wchar_t> absent;
+                for (int i = 0; i < LargeSetSizes[s]; ++i)
+                    absent.push_back((wchar_t)(0xE000 + i));
+
+                for (size_t k = 0; k < sizeof(Kernels) / sizeof(Kernels[0]); ++k)
+                {
+                    const Kernel& kernel = Kernels[k];
+                    for (size_t m = 0; m < sizeof(LargeModes) / sizeof(LargeModes[0]); ++m)
+                    {
+                        char name[256];
+                        sprintf(name, "%s/%s/large_%s/len:%d/set:%d/%s", kernel.operation, kernel.tier, corpus.name.c_str(), length, LargeSetSizes[s], LargeModes[m]);
+                        if (!kernel.stream || !kernel.supported() || !std::regex_search(std::string(name), filter))
+                            continue;
+
+                        if (density < 0.0 && kernel.indexOfAll)
+                            density = MatchDensity(std::vector<const wchar_t*>(1, text), length, chars, results);
+
+                        Result result;
+                        result.name = name;
+                        result.kernel = &kernel;
+                        result.corpus = "large_" + corpus.name;
+                        result.length = length;
+                        result.elementSize = sizeof(wchar_t);
+                        result.setSize = LargeSetSizes[s];
+                        result.density = kernel.indexOfAll ? density : 0.0;
+                        StrStream.threshold = LargeThresholds[m];
+                        Measure(kernel, windows, length, kernel.indexOfAll ? chars : absent, results, options.minTime, result);
+                        StrStream.threshold = settings.threshold;
+                        benchmarks.push_back(result);
+
+                        if (!options.json)
+                            Print(result);
+                    }
+                }
+            }
+        }
+
+        StrStream = settings;
+        StrFreeLarge(text);
+        StrFreeLarge(results);
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+        return 1;
+
+    std::vector<Corpus> corpora;
+    corpora.push_back(CorpusRandom(CorpusLength, 0.0));
+    corpora.push_back(CorpusRandom(CorpusLength, 0.01));
+    corpora.push_back(CorpusRandom(CorpusLength, 0.1));
+    corpora.push_back(CorpusLogs(CorpusLength));
+    corpora.push_back(CorpusJson(CorpusLength));
+    corpora.push_back(CorpusCsv(CorpusLength));
+    corpora.push_back(CorpusMixedScript(CorpusLength));
+    for (size_t i = 0; i < options.corpusFiles.size(); ++i)
+    {
+        Corpus corpus;
+        if (!CorpusFile(options.corpusFiles[i].first, options.corpusFiles[i].second, corpus))
+        {
+            fprintf(stderr, "cannot read corpus %s\n", options.corpusFiles[i].second.c_str());
+            return 1;
+        }
+        corpora.push_back(corpus);
+    }
+
+    std::regex filter(options.filter.empty() ? std::string(".*") : options.filter);
+    std::vector<int> results(2 * Lengths[sizeof(Lengths) / sizeof(Lengths[0]) - 1]);
+    std::vector<Result> benchmarks;
+
+    if (!options.json)
+        printf("%-52s %12s %12s %10s %12s %10s\n", "benchmark", "iterations", "ns/call", "GB/s", "cycles/char", "density");
+
+    for (size_t c = 0; c < corpora.size(); ++c)
+    {
+        const Corpus& corpus = corpora[c];
+        for (size_t l = 0; l < sizeof(Lengths) / sizeof(Lengths[0]); ++l)
+        {
+            const int length = Lengths[l];
+            if ((size_t)length > corpus.text.size())
+                continue;
+
+            // deterministic offsets, so every alignment is measured
+            std::vector<const wchar_t*> windows;
+            const size_t range = corpus.text.size() - length + 1;
+            for (int w = 0; w < WindowsCount; ++w)
+                windows.push_back(&corpus.text[((size_t)w * 2654435761u) % range]);
+
+            for (size_t s = 0; s < sizeof(SetSizes) / sizeof(SetSizes[0]); ++s)
+            {
+                std::vector<wchar_t> chars = CorpusSearchSet(corpus, SetSizes[s]);
+                double density = -1.0;
+
+                for (size_t k = 0; k < sizeof(Kernels) / sizeof(Kernels[0]); ++k)
+                {
+                    const Kernel& kernel = Kernels[k];
+                    char name[256];
+                    sprintf(name, "%s/%s/%s/len:%d/set:%d", kernel.operation, kernel.tier, corpus.name.c_str(), length, SetSizes[s]);
+                    if (!kernel.supported() || !std::regex_search(std::string(name), filter))
+                        continue;
+
+                    if (density < 0.0)
+                        density = MatchDensity(windows, length, chars, &results[0]);
+
+                    Result result;
+                    result.name = name;
+                    result.kernel = &kernel;
+                    result.corpus = corpus.name;
+                    result.length = length;
+                    result.elementSize = sizeof(wchar_t);
+                    result.setSize = SetSizes[s];
+                    result.density = density;
+                    Measure(kernel, windows, length, chars, &results[0], options.minTime, result);
+                    benchmarks.push_back(result);
+
+                    if (!options.json)
+                        Print(result);
+                }
+            }
+        }
+    }
+
+    MeasureSorts(options, filter, benchmarks);
+
+    if (options.largeMB && !MeasureLarge(options, corpora, filter, benchmarks))
+        return 1;
+
+    if (options.json)
+        WriteJson(stdout, argv[0], benchmarks);
+
+    if (!options.out.empty())
+    {
+        FILE* file = fopen(options.out.c_str(), "w");
+        if (!file)
+        {
+            fprintf(stderr, "cannot write %s\n", options.out.c_str());
+            return 1;
+        }
+        WriteJson(file, argv[0], benchmarks);
+        fclose(file);
+    }
+    return 0;
+}
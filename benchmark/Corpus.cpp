@@ -0,0 +1,373 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "Corpus.h"
+
+#include <stdio.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <algorithm>
+
+namespace
+{
+    // xorshift, deterministic across compilers unlike std distributions
+    class Random
+    {
+    public:
+        Random(uint32_t seed) : state_(seed ? seed : 0x9E3779B9u) {}
+
+        uint32_t Next()
+        {
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 17;
+            state_ ^= state_ << 5;
+            return state_;
+        }
+
+        int Next(int max) { return (int)(Next() % (uint32_t)max); }
+
+        double NextDouble() { return (double)Next() / 4294967296.0; }
+
+    private:
+        uint32_t state_;
+    };
+
+    void Append(std::vector<wchar_t>& text, const char* s)
+    {
+        for (; *s; ++s)
+            text.push_back((wchar_t)(unsigned char)*s);
+    }
+
+    void Append(std::vector<wchar_t>& text, const wchar_t* s)
+    {
+        for (; *s; ++s)
+            text.push_back(*s);
+    }
+
+    void AppendNumber(std::vector<wchar_t>& text, unsigned value, int digits)
+    {
+        char buffer[16];
+        sprintf(buffer, "%0*u", digits, value);
+        Append(text, buffer);
+    }
+
+    void AppendWord(std::vector<wchar_t>& text, Random& random, int minLength, int maxLength)
+    {
+        static const char letters[] = "abcdefghijklmnopqrstuvwxyz";
+        int length = minLength + random.Next(maxLength - minLength + 1);
+        for (int i = 0; i < length; ++i)
+            text.push_back((wchar_t)letters[random.Next(sizeof(letters) - 1)]);
+    }
+
+    void SetSearchChars(Corpus& corpus, const char* chars)
+    {
+        for (; *chars; ++chars)
+            corpus.searchChars.push_back((wchar_t)(unsigned char)*chars);
+    }
+
+    void Truncate(Corpus& corpus, size_t length)
+    {
+        if (corpus.text.size() > length)
+            corpus.text.resize(length);
+    }
+}
+
+Corpus CorpusRandom(size_t length, double density)
+{
+    static const char possibleChars[] = "012345679abcdefgzhjklmnopqrstuvwxyz";
+
+    Corpus corpus;
+    char name[64];
+    sprintf(name, "random_%g", density * 100.0);
+    corpus.name = name;
+    SetSearchChars(corpus, "[](){}!@#$%^&*<>?;:~|/=+-_,.'\"\\`");
+
+    Random random(1);
+    corpus.text.reserve(length);
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (density > 0.0 && random.NextDouble() < density)
+            corpus.text.push_back(corpus.searchChars[random.Next((int)corpus.searchChars.size())]);
+        else
+            corpus.text.push_back((wchar_t)possibleChars[random.Next(sizeof(possibleChars) - 1)]);
+    }
+    return corpus;
+}
+
+Corpus CorpusLogs(size_t length)
+{
+    static const char* levels[] = { "INFO ", "INFO ", "INFO ", "DEBUG", "WARN ", "ERROR" };
+    static const char* methods[] = { "GET", "GET", "GET", "POST", "PUT", "DELETE" };
+    static const char* resources[] = { "users", "orders", "products", "sessions", "search", "health" };
+    static const unsigned statuses[] = { 200, 200, 200, 200, 201, 204, 304, 400, 404, 500 };
+
+    Corpus corpus;
+    corpus.name = "logs";
+    SetSearchChars(corpus, " =/:.[]-?\n&,");
+
+    Random random(2);
+    unsigned seconds = 0;
+    while (corpus.text.size() < length)
+    {
+        seconds += random.Next(3);
+        Append(corpus.text, "2017-06-01 ");
+        AppendNumber(corpus.text, (seconds / 3600) % 24, 2);
+        corpus.text.push_back(L':');
+        AppendNumber(corpus.text, (seconds / 60) % 60, 2);
+        corpus.text.push_back(L':');
+        AppendNumber(corpus.text, seconds % 60, 2);
+        corpus.text.push_back(L'.');
+        AppendNumber(corpus.text, random.Next(1000), 3);
+        corpus.text.push_back(L' ');
+        Append(corpus.text, levels[random.Next(6)]);
+        Append(corpus.text, " [worker-");
+        AppendNumber(corpus.text, random.Next(16), 2);
+        Append(corpus.text, "] ");
+        Append(corpus.text, methods[random.Next(6)]);
+        Append(corpus.text, " /api/v1/");
+        Append(corpus.text, resources[random.Next(6)]);
+        corpus.text.push_back(L'/');
+        AppendNumber(corpus.text, random.Next(100000), 1);
+        if (random.Next(3) == 0)
+        {
+            Append(corpus.text, "?expand=");
+            AppendWord(corpus.text, random, 3, 8);
+            Append(corpus.text, "&page=");
+            AppendNumber(corpus.text, random.Next(50), 1);
+        }
+        Append(corpus.text, " status=");
+        AppendNumber(corpus.text, statuses[random.Next(10)], 3);
+        Append(corpus.text, " bytes=");
+        AppendNumber(corpus.text, random.Next(65536), 1);
+        Append(corpus.text, " ms=");
+        AppendNumber(corpus.text, random.Next(500), 1);
+        corpus.text.push_back(L'.');
+        AppendNumber(corpus.text, random.Next(10), 1);
+        Append(corpus.text, " trace=");
+        AppendNumber(corpus.text, random.Next(), 10);
+        corpus.text.push_back(L'\n');
+    }
+    Truncate(corpus, length);
+    return corpus;
+}
+
+Corpus CorpusJson(size_t length)
+{
+    Corpus corpus;
+    corpus.name = "json";
+    SetSearchChars(corpus, "\",:{}[]\\.\n -");
+
+    Random random(3);
+    unsigned id = 0;
+    while (corpus.text.size() < length)
+    {
+        Append(corpus.text, "{\"id\":");
+        AppendNumber(corpus.text, ++id, 1);
+        Append(corpus.text, ",\"name\":\"");
+        AppendWord(corpus.text, random, 3, 10);
+        corpus.text.push_back(L' ');
+        AppendWord(corpus.text, random, 4, 12);
+        Append(corpus.text, "\",\"email\":\"");
+        AppendWord(corpus.text, random, 3, 10);
+        Append(corpus.text, "@example.com\",\"tags\":[");
+        int tags = random.Next(4);
+        for (int i = 0; i < tags; ++i)
+        {
+            if (i)
+                corpus.text.push_back(L',');
+            corpus.text.push_back(L'"');
+            AppendWord(corpus.text, random, 2, 6);
+            corpus.text.push_back(L'"');
+        }
+        Append(corpus.text, "],\"active\":");
+        Append(corpus.text, random.Next(2) ? "true" : "false");
+        Append(corpus.text, ",\"score\":");
+        AppendNumber(corpus.text, random.Next(1000), 1);
+        corpus.text.push_back(L'.');
+        AppendNumber(corpus.text, random.Next(100), 2);
+        if (random.Next(4) == 0)
+        {
+            Append(corpus.text, ",\"address\":{\"street\":\"");
+            AppendNumber(corpus.text, random.Next(9999), 1);
+            corpus.text.push_back(L' ');
+            AppendWord(corpus.text, random, 4, 10);
+            Append(corpus.text, " st\",\"note\":\"line\\nbreak \\\"quoted\\\"\"}");
+        }
+        Append(corpus.text, "}\n");
+    }
+    Truncate(corpus, length);
+    return corpus;
+}
+
+Corpus CorpusCsv(size_t length)
+{
+    Corpus corpus;
+    corpus.name = "csv";
+    SetSearchChars(corpus, ",\n\"-. ");
+
+    Random random(4);
+    unsigned id = 0;
+    while (corpus.text.size() < length)
+    {
+        AppendNumber(corpus.text, ++id, 1);
+        Append(corpus.text, ",\"");
+        AppendWord(corpus.text, random, 3, 10);
+        Append(corpus.text, ", ");
+        AppendWord(corpus.text, random, 3, 10);
+        Append(corpus.text, "\",2017-");
+        AppendNumber(corpus.text, 1 + random.Next(12), 2);
+        corpus.text.push_back(L'-');
+        AppendNumber(corpus.text, 1 + random.Next(28), 2);
+        corpus.text.push_back(L',');
+        AppendNumber(corpus.text, random.Next(100000), 1);
+        corpus.text.push_back(L'.');
+        AppendNumber(corpus.text, random.Next(100), 2);
+        corpus.text.push_back(L',');
+        Append(corpus.text, random.Next(2) ? "true" : "false");
+        corpus.text.push_back(L',');
+        AppendWord(corpus.text, random, 2, 3);
+        corpus.text.push_back(L'\n');
+    }
+    Truncate(corpus, length);
+    return corpus;
+}
+
+Corpus CorpusMixedScript(size_t length)
+{
+    // escaped, source files are not utf-8 for every compiler
+    static const wchar_t* words[] =
+    {
+        L"hello", L"world", L"caf\u00e9", L"na\u00efve", L"stra\u00dfe", L"\u00e9t\u00e9",
+        L"\u03b1\u03bb\u03c6\u03b1", L"\u03ba\u03cc\u03c3\u03bc\u03bf\u03c2",
+        L"\u043f\u0440\u0438\u0432\u0435\u0442", L"\u043c\u0438\u0440",
+        L"\u0645\u0631\u062d\u0628\u0627", L"\u0633\u0644\u0627\u0645",
+        L"\u4f60\u597d", L"\u4e16\u754c", L"\u3053\u3093\u306b\u3061\u306f", L"\ud55c\uad6d\uc5b4",
+        L"\xD83D\xDE00", L"\xD83D\xDC4D\xD83C\xDFFD",
+    };
+    static const int wordsCount = sizeof(words) / sizeof(words[0]);
+
+    Corpus corpus;
+    corpus.name = "mixed_script";
+    SetSearchChars(corpus, " .,!?\n");
+
+    Random random(5);
+    while (corpus.text.size() < length)
+    {
+        Append(corpus.text, words[random.Next(wordsCount)]);
+        switch (random.Next(16))
+        {
+        case 0: Append(corpus.text, ". "); break;
+        case 1: Append(corpus.text, ", "); break;
+        case 2: Append(corpus.text, "!\n"); break;
+        case 3: Append(corpus.text, "? "); break;
+        default: corpus.text.push_back(L' '); break;
+        }
+    }
+    Truncate(corpus, length);
+    return corpus;
+}
+
+bool CorpusFile(const std::string& name, const std::string& path, Corpus& corpus)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    std::vector<unsigned char> bytes;
+    unsigned char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) != 0)
+        bytes.insert(bytes.end(), buffer, buffer + read);
+    fclose(file);
+
+    corpus.name = name;
+    corpus.text.clear();
+    corpus.searchChars.clear();
+
+    // minimal utf-8 decoder, invalid bytes are kept as latin-1
+    for (size_t i = 0; i < bytes.size();)
+    {
+        unsigned c = bytes[i];
+        unsigned cp = c;
+        size_t n = 1;
+        if (c >= 0xF0 && i + 3 < bytes.size())
+        {
+            cp = ((c & 0x07) << 18) | ((bytes[i + 1] & 0x3F) << 12) | ((bytes[i + 2] & 0x3F) << 6) | (bytes[i + 3] & 0x3F);
+            n = 4;
+        }
+        else if (c >= 0xE0 && i + 2 < bytes.size())
+        {
+            cp = ((c & 0x0F) << 12) | ((bytes[i + 1] & 0x3F) << 6) | (bytes[i + 2] & 0x3F);
+            n = 3;
+        }
+        else if (c >= 0xC0 && i + 1 < bytes.size())
+        {
+            cp = ((c & 0x1F) << 6) | (bytes[i + 1] & 0x3F);
+            n = 2;
+        }
+        i += n;
+
+        if (cp >= 0x10000)
+        {
+            cp -= 0x10000;
+            corpus.text.push_back((wchar_t)(0xD800 + (cp >> 10)));
+            corpus.text.push_back((wchar_t)(0xDC00 + (cp & 0x3FF)));
+        }
+        else
+        {
+            corpus.text.push_back((wchar_t)cp);
+        }
+    }
+
+    // most frequent ascii punctuations first
+    size_t counts[128] = {};
+    for (size_t i = 0; i < corpus.text.size(); ++i)
+    {
+        wchar_t c = corpus.text[i];
+        if (c < 128 && (ispunct(c) || c == L' ' || c == L'\t' || c == L'\n'))
+            ++counts[c];
+    }
+    for (;;)
+    {
+        size_t best = 0;
+        for (size_t c = 1; c < 128; ++c)
+        {
+            if (counts[c] > counts[best])
+                best = c;
+        }
+        if (!counts[best])
+            break;
+        corpus.searchChars.push_back((wchar_t)best);
+        counts[best] = 0;
+    }
+    return !corpus.text.empty();
+}
+
+std::vector<wchar_t> CorpusSearchSet(const Corpus& corpus, int searchCount)
+{
+    std::vector<wchar_t> chars(corpus.searchChars.begin(), corpus.searchChars.begin() + std::min((size_t)searchCount, corpus.searchChars.size()));
+
+    // private use area chars, never generated
+    for (wchar_t c = 0xE000; (int)chars.size() < searchCount; ++c)
+        chars.push_back(c);
+    return chars;
+}
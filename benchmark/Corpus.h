@@ -0,0 +1,57 @@
+//  MIT License
+//  
+//  Copyright(c) 2017 Eric Thiffeault
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files(the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions :
+//  
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+#pragma once
+
+#include <string>
+#include <vector>
+
+// benchmark inputs, text is utf-16 like .net strings
+//
+// generated corpora are deterministic (fixed seed) so results can be compared between runs and releases.
+struct Corpus
+{
+    std::string name;
+    std::vector<wchar_t> text;
+    // search chars ordered by how much the corpus use them, a set of size n is made of the n first
+    std::vector<wchar_t> searchChars;
+};
+
+// random alphanumeric text, searchChars injected with the given density (0 to 1)
+Corpus CorpusRandom(size_t length, double density);
+
+// web server like log lines
+Corpus CorpusLogs(size_t length);
+
+// one json object per line
+Corpus CorpusJson(size_t length);
+
+// quoted csv records
+Corpus CorpusCsv(size_t length);
+
+// latin, accented latin, greek, cyrillic, arabic, cjk words and surrogate pairs emoji
+Corpus CorpusMixedScript(size_t length);
+
+// utf-8 file, searchChars are the file most frequent punctuations
+bool CorpusFile(const std::string& name, const std::string& path, Corpus& corpus);
+
+// set of searchCount chars, padded with chars absent of every corpus when the corpus provide less
+std::vector<wchar_t> CorpusSearchSet(const Corpus& corpus, int searchCount);
@@ -0,0 +1,219 @@
+﻿using System;
+using System.Linq;
+using Intrinsics;
+
+namespace IntrinsicsTest
+{
+    public class ArrayTest : Test
+    {
+        public ArrayTest()
+            : base("Array")
+        {
+        }
+
+        public override void RunTest()
+        {
+            Random random = new Random(41);
+            int threshold = Intrinsics.Array.ParallelThreshold;
+            foreach (int parallelThreshold in new int[] { threshold, 1000 })
+            {
+                Intrinsics.Array.ParallelThreshold = parallelThreshold;
+                foreach (int length in new int[] { 0, 1, 3, 17, 64, 255, 1000, 4099, 100003 })
+                {
+                    TestInt(random, length);
+                    TestLong(random, length);
+                    TestDouble(random, length);
+                    TestSort(random, length);
+                }
+            }
+            Intrinsics.Array.ParallelThreshold = threshold;
+
+            // int sums don't overflow, a NaN wins min and max
+            int[] large = Enumerable.Repeat(int.MaxValue, 1000).ToArray();
+            CheckTrue(Intrinsics.Array.Sum(large) == 1000L * int.MaxValue);
+            double[] nan = new double[] { 1, 2, double.NaN, -5, double.NaN, 7 };
+            CheckTrue(Intrinsics.Array.IndexOfMin(nan) == 2 && Intrinsics.Array.IndexOfMax(nan) == 2);
+            CheckTrue(Intrinsics.Array.IndexOf(nan, double.NaN) == -1);
+
+            bool thrown = false;
+            try
+            {
+                Intrinsics.Array.Min(new float[0]);
+            }
+            catch (InvalidOperationException)
+            {
+                thrown = true;
+            }
+            CheckTrue(thrown);
+
+            // NaN first, then the infinities around the numbers
+            double[] special = new double[] { 3, double.PositiveInfinity, double.NaN, -1, double.NegativeInfinity, 0 };
+            Intrinsics.Array.Sort(special);
+            CheckTrue(double.IsNaN(special[0]) && special.Skip(1).SequenceEqual(new double[] { double.NegativeInfinity, -1, 0, 3, double.PositiveInfinity }));
+
+            // NaN payloads and signs are kept, the sorted values have the same bits
+            long[] nanBits = { 0x7ff8000000000000, 0x7ff0000000000001, unchecked((long)0xfff8000000000000), unchecked((long)0xfff0000000abcdef) };
+            double[] nans = new double[] { 1, BitConverter.Int64BitsToDouble(nanBits[0]), -2, BitConverter.Int64BitsToDouble(nanBits[1]), BitConverter.Int64BitsToDouble(nanBits[2]), 0, BitConverter.Int64BitsToDouble(nanBits[3]) };
+            long[] before = nans.Select(BitConverter.DoubleToInt64Bits).OrderBy(b => b).ToArray();
+            Intrinsics.Array.Sort(nans);
+            CheckTrue(nans.Take(4).All(double.IsNaN) && nans.Skip(4).SequenceEqual(new double[] { -2, 0, 1 }));
+            CheckTrue(nans.Select(BitConverter.DoubleToInt64Bits).OrderBy(b => b).SequenceEqual(before));
+        }
+
+        private void TestInt(Random random, int length)
+        {
+            int[] values = new int[length];
+            int[] other = new int[length];
+            for (int i = 0; i < length; ++i)
+            {
+                values[i] = random.Next(-1000, 1000);
+                other[i] = random.Next();
+            }
+
+            CheckTrue(Intrinsics.Array.Sum(values) == values.Sum(v => (long)v));
+            CheckTrue(Intrinsics.Array.Dot(values, other) == values.Select((v, i) => (long)v * other[i]).Sum());
+            int start = length / 3;
+            int count = length / 2;
+            CheckTrue(Intrinsics.Array.Sum(values, start, count) == values.Skip(start).Take(count).Sum(v => (long)v));
+
+            if (length > 0)
+            {
+                int min = values.Min();
+                int max = values.Max();
+                CheckTrue(Intrinsics.Array.Min(values) == min && Intrinsics.Array.Max(values) == max);
+                CheckTrue(Intrinsics.Array.IndexOfMin(values) == System.Array.IndexOf(values, min));
+                CheckTrue(Intrinsics.Array.IndexOfMax(values) == System.Array.IndexOf(values, max));
+                Intrinsics.Array.MinMaxValue<int> minMax = Intrinsics.Array.MinMax(values);
+                CheckTrue(minMax.Min == min && minMax.MinIndex == System.Array.IndexOf(values, min));
+                CheckTrue(minMax.Max == max && minMax.MaxIndex == System.Array.IndexOf(values, max));
+            }
+
+            for (int k = 0; k < 4; ++k)
+            {
+                int value = k == 0 && length > 0 ? values[length - 1] : random.Next(-1100, 1100);
+                CheckTrue(Intrinsics.Array.IndexOf(values, value) == System.Array.IndexOf(values, value));
+                CheckTrue(Intrinsics.Array.LastIndexOf(values, value) == System.Array.LastIndexOf(values, value));
+                CheckTrue(Intrinsics.Array.Contains(values, value) == values.Contains(value));
+                CheckTrue(Intrinsics.Array.CountEqual(values, value) == values.Count(v => v == value));
+                CheckTrue(Intrinsics.Array.IndexOf(values, value, start, count) == System.Array.IndexOf(values, value, start, count));
+                CheckTrue(Intrinsics.Array.CountEqual(values, value, start, count) == values.Skip(start).Take(count).Count(v => v == value));
+            }
+        }
+
+        private void TestLong(Random random, int length)
+        {
+            long[] values = new long[length];
+            long[] other = new long[length];
+            for (int i = 0; i < length; ++i)
+            {
+                values[i] = ((long)random.Next() << 32) - random.Next();
+                other[i] = random.Next(-100, 100);
+            }
+
+            long sum = 0;
+            long dot = 0;
+            for (int i = 0; i < length; ++i)
+            {
+                sum = unchecked(sum + values[i]);
+                dot = unchecked(dot + values[i] * other[i]);
+            }
+            CheckTrue(Intrinsics.Array.Sum(values) == sum);
+            CheckTrue(Intrinsics.Array.Dot(values, other) == dot);
+
+            if (length > 0)
+            {
+                CheckTrue(Intrinsics.Array.IndexOfMin(values) == System.Array.IndexOf(values, values.Min()));
+                CheckTrue(Intrinsics.Array.IndexOfMax(values) == System.Array.IndexOf(values, values.Max()));
+                int start = length / 4;
+                CheckTrue(Intrinsics.Array.IndexOfMin(values, start, length - start) == System.Array.IndexOf(values, values.Skip(start).Min(), start));
+
+                long value = values[random.Next(length)];
+                CheckTrue(Intrinsics.Array.IndexOf(values, value) == System.Array.IndexOf(values, value));
+                CheckTrue(Intrinsics.Array.LastIndexOf(values, value, 0, length / 2) == System.Array.LastIndexOf(values, value, length / 2 - 1 < 0 ? 0 : length / 2 - 1, length / 2));
+            }
+        }
+
+        private void TestDouble(Random random, int length)
+        {
+            float[] floats = new float[length];
+            double[] values = new double[length];
+            for (int i = 0; i < length; ++i)
+            {
+                floats[i] = random.Next(-64, 64) * 0.25f;
+                values[i] = floats[i];
+            }
+
+            // quarters sum exactly in any order
+            CheckTrue(Intrinsics.Array.Sum(floats) == values.Sum());
+            CheckTrue(Intrinsics.Array.Sum(values) == values.Sum());
+            CheckTrue(Intrinsics.Array.Dot(floats, floats) == values.Sum(v => v * v));
+
+            if (length > 0)
+            {
+                Intrinsics.Array.MinMaxValue<float> minMax = Intrinsics.Array.MinMax(floats);
+                CheckTrue(minMax.Min == floats.Min() && minMax.MinIndex == System.Array.IndexOf(floats, floats.Min()));
+                CheckTrue(minMax.Max == floats.Max() && minMax.MaxIndex == System.Array.IndexOf(floats, floats.Max()));
+                CheckTrue(Intrinsics.Array.Min(values) == values.Min() && Intrinsics.Array.Max(values) == values.Max());
+
+                double value = values[random.Next(length)];
+                CheckTrue(Intrinsics.Array.IndexOf(values, value) == System.Array.IndexOf(values, value));
+                CheckTrue(Intrinsics.Array.LastIndexOf(floats, (float)value) == System.Array.LastIndexOf(floats, (float)value));
+                CheckTrue(Intrinsics.Array.CountEqual(floats, (float)value) == floats.Count(v => v == value));
+            }
+        }
+
+        private void TestSort(Random random, int length)
+        {
+            // random, nearly sorted and few distinct values
+            for (int kind = 0; kind < 3; ++kind)
+            {
+                int[] values = new int[length];
+                for (int i = 0; i < length; ++i)
+                    values[i] = kind == 0 ? random.Next(int.MinValue, int.MaxValue) : kind == 1 ? (random.Next(100) == 0 ? random.Next() : i) : random.Next(4);
+                long[] longs = values.Select(v => (long)v * 3 << 20).ToArray();
+                float[] floats = values.Select(v => v * 0.5f).ToArray();
+                double[] doubles = values.Select(v => v * -0.25).ToArray();
+
+                int[] sorted = (int[])values.Clone();
+                Intrinsics.Array.Sort(sorted);
+                CheckTrue(sorted.SequenceEqual(values.OrderBy(v => v)));
+                long[] sortedLongs = (long[])longs.Clone();
+                Intrinsics.Array.Sort(sortedLongs);
+                CheckTrue(sortedLongs.SequenceEqual(longs.OrderBy(v => v)));
+                float[] sortedFloats = (float[])floats.Clone();
+                Intrinsics.Array.Sort(sortedFloats);
+                CheckTrue(sortedFloats.SequenceEqual(floats.OrderBy(v => v)));
+
+                int start = length / 3;
+                int count = length / 2;
+                double[] sortedDoubles = (double[])doubles.Clone();
+                Intrinsics.Array.Sort(sortedDoubles, start, count);
+                CheckTrue(sortedDoubles.SequenceEqual(doubles.Take(start).Concat(doubles.Skip(start).Take(count).OrderBy(v => v)).Concat(doubles.Skip(start + count))));
+
+                // OrderBy is stable like the indices
+                int[] expected = Enumerable.Range(0, length).OrderBy(i => values[i]).ToArray();
+                int[] indices = new int[length];
+                sorted = (int[])values.Clone();
+                Intrinsics.Array.Sort(sorted, indices);
+                CheckTrue(indices.SequenceEqual(expected) && sorted.SequenceEqual(values.OrderBy(v => v)));
+                sortedLongs = (long[])longs.Clone();
+                Intrinsics.Array.Sort(sortedLongs, indices);
+                CheckTrue(indices.SequenceEqual(expected));
+                sortedFloats = (float[])floats.Clone();
+                Intrinsics.Array.Sort(sortedFloats, indices);
+                CheckTrue(indices.SequenceEqual(Enumerable.Range(0, length).OrderBy(i => floats[i])));
+                sortedDoubles = (double[])doubles.Clone();
+                Intrinsics.Array.Sort(sortedDoubles, indices);
+                CheckTrue(indices.SequenceEqual(Enumerable.Range(0, length).OrderBy(i => doubles[i])));
+            }
+        }
+
+        public override void RunProfile()
+        {
+        }
+
+        public override void OutputProfile(SpreadsheetWriter writer)
+        {
+        }
+    }
+}
@@ -0,0 +1,137 @@
+﻿using System;
+using Intrinsics;
+
+namespace IntrinsicsTest
+{
+    public class CodecTest : Test
+    {
+        public CodecTest()
+            : base("Codec")
+        {
+        }
+
+        public override void RunTest()
+        {
+            Random random = new Random(40);
+            for (int length = 0; length < 200; ++length)
+            {
+                byte[] bytes = new byte[length];
+                random.NextBytes(bytes);
+                TestBase64(bytes);
+                TestHex(bytes);
+            }
+
+            // invalid chars in the vector blocks and in the tail, invalid padding
+            string valid = Base64.Encode(new byte[60], Base64.Variant.Standard);
+            TestInvalid(valid.Substring(0, 30) + "*" + valid.Substring(31), Base64.Variant.Standard);
+            TestInvalid(valid.Substring(0, 77) + "Ł" + valid.Substring(78), Base64.Variant.Standard);
+            TestInvalid(valid.Replace('A', '-'), Base64.Variant.Standard);
+            TestInvalid("QQ=", Base64.Variant.Standard);
+            TestInvalid("Q===", Base64.Variant.Standard);
+            TestInvalid("QQ==", Base64.Variant.StandardNoPadding);
+            TestInvalid("QUJDR", Base64.Variant.StandardNoPadding);
+            TestInvalid("+/", Base64.Variant.UrlSafeNoPadding);
+            CheckTrue(Base64.Decode("-_8", Base64.Variant.UrlSafeNoPadding).Length == 2);
+
+            bool thrown = false;
+            try
+            {
+                Hex.Decode(new string('0', 40) + "0g");
+            }
+            catch (FormatException)
+            {
+                thrown = true;
+            }
+            CheckTrue(thrown);
+
+            // an empty input still checks the output, like Hex.Decode
+            thrown = false;
+            try
+            {
+                Base64.Decode(new char[0], 0, 0, null, 0, Base64.Variant.Standard);
+            }
+            catch (ArgumentNullException)
+            {
+                thrown = true;
+            }
+            CheckTrue(thrown);
+        }
+
+        private void TestBase64(byte[] bytes)
+        {
+            string standard = Convert.ToBase64String(bytes);
+            string urlSafe = standard.Replace('+', '-').Replace('/', '_');
+            CheckTrue(Base64.Encode(bytes, Base64.Variant.Standard) == standard);
+            CheckTrue(Base64.Encode(bytes, Base64.Variant.StandardNoPadding) == standard.TrimEnd('='));
+            CheckTrue(Base64.Encode(bytes, Base64.Variant.UrlSafe) == urlSafe);
+            CheckTrue(Base64.Encode(bytes, Base64.Variant.UrlSafeNoPadding) == urlSafe.TrimEnd('='));
+            CheckTrue(Base64.GetEncodedLength(bytes.Length, Base64.Variant.Standard) == standard.Length);
+
+            foreach (Base64.Variant variant in Enum.GetValues(typeof(Base64.Variant)))
+            {
+                string encoded = Base64.Encode(bytes, variant);
+                CheckTrue(Base64.GetDecodedLength(encoded, variant) == bytes.Length);
+                CheckTrue(Equal(Base64.Decode(encoded, variant), bytes));
+
+                // caller buffers with offsets
+                char[] chars = new char[encoded.Length + 2];
+                CheckTrue(Base64.Encode(bytes, 0, bytes.Length, chars, 1, variant) == encoded.Length);
+                CheckTrue(new string(chars, 1, encoded.Length) == encoded);
+
+                byte[] decoded = new byte[bytes.Length + 2];
+                CheckTrue(Base64.Decode(chars, 1, encoded.Length, decoded, 2, variant) == bytes.Length);
+                for (int i = 0; i < bytes.Length; ++i)
+                    CheckTrue(decoded[2 + i] == bytes[i]);
+            }
+        }
+
+        private void TestHex(byte[] bytes)
+        {
+            string expected = BitConverter.ToString(bytes).Replace("-", "");
+            CheckTrue(Hex.Encode(bytes, true) == expected);
+            CheckTrue(Hex.Encode(bytes, false) == expected.ToLowerInvariant());
+            CheckTrue(Equal(Hex.Decode(expected), bytes));
+            CheckTrue(Equal(Hex.Decode(expected.ToLowerInvariant()), bytes));
+
+            char[] chars = new char[2 * bytes.Length + 1];
+            CheckTrue(Hex.Encode(bytes, 0, bytes.Length, chars, 1, false) == 2 * bytes.Length);
+            byte[] decoded = new byte[bytes.Length];
+            CheckTrue(Hex.Decode(chars, 1, 2 * bytes.Length, decoded, 0) == bytes.Length);
+            CheckTrue(Equal(decoded, bytes));
+        }
+
+        private void TestInvalid(string str, Base64.Variant variant)
+        {
+            bool thrown = false;
+            try
+            {
+                Base64.Decode(str, variant);
+            }
+            catch (FormatException)
+            {
+                thrown = true;
+            }
+            CheckTrue(thrown);
+        }
+
+        private static bool Equal(byte[] a, byte[] b)
+        {
+            if (a.Length != b.Length)
+                return false;
+            for (int i = 0; i < a.Length; ++i)
+            {
+                if (a[i] != b[i])
+                    return false;
+            }
+            return true;
+        }
+
+        public override void RunProfile()
+        {
+        }
+
+        public override void OutputProfile(SpreadsheetWriter writer)
+        {
+        }
+    }
+}
@@ -0,0 +1,69 @@
+﻿using System;
+using Intrinsics;
+
+namespace IntrinsicsTest
+{
+    public class CpuTest : Test
+    {
+        public CpuTest()
+            : base("Cpu")
+        {
+        }
+
+        public override void RunTest()
+        {
+            CpuFeatures features = Cpu.Features;
+
+            CheckTrue(Cpu.Supports(CpuFeatures.None));
+            CheckTrue(Cpu.Vendor != null);
+            CheckTrue(Cpu.Brand != null);
+
+            // every x64 cpu has SSE2
+            if (Environment.Is64BitProcess)
+                CheckTrue(Cpu.Supports(CpuFeatures.Sse2));
+
+            // OS state checked once for the whole AVX family
+            if (Cpu.Supports(CpuFeatures.Avx2))
+                CheckTrue(Cpu.Supports(CpuFeatures.Avx));
+
+            CpuFeatures avx512 = CpuFeatures.Avx512Dq | CpuFeatures.Avx512Cd | CpuFeatures.Avx512Bw | CpuFeatures.Avx512Vl
+                | CpuFeatures.Avx512Vbmi | CpuFeatures.Avx512Vbmi2 | CpuFeatures.Avx512Vnni | CpuFeatures.Avx512Bitalg | CpuFeatures.Avx512Vpopcntdq;
+            if ((features & avx512) != 0)
+                CheckTrue(Cpu.Supports(CpuFeatures.Avx512F));
+            if (Cpu.Supports(CpuFeatures.Avx512F))
+                CheckTrue(Cpu.Supports(CpuFeatures.Avx2));
+
+            CheckTrue(Cpu.Supports(features));
+            CheckTrue(!Cpu.Supports(features | (CpuFeatures)(1ul << 63)));
+
+            TestTopology();
+        }
+
+        private void TestTopology()
+        {
+            CheckTrue(Cpu.LogicalProcessors == Environment.ProcessorCount);
+            CheckTrue(Cpu.PhysicalCores >= 1 && Cpu.PhysicalCores <= Cpu.LogicalProcessors);
+            CheckTrue(Cpu.WorkerCount == Cpu.PhysicalCores);
+
+            CheckTrue(Cpu.CacheLineSize > 0 && (Cpu.CacheLineSize & (Cpu.CacheLineSize - 1)) == 0);
+            CheckTrue(Cpu.ChunkSize > 0 && Cpu.ChunkSize % 4096 == 0);
+            CheckTrue(Cpu.NonTemporalThreshold > 0);
+
+            foreach (CpuCache cache in Cpu.GetCaches())
+            {
+                CheckTrue(cache.Level >= 1 && cache.Size > 0 && cache.LineSize > 0);
+                if (cache.Type != CpuCacheType.Instruction)
+                    CheckTrue(Cpu.CacheSize(cache.Level) == cache.Size);
+            }
+            CheckTrue(Cpu.CacheSize(0) == 0);
+        }
+
+        public override void RunProfile()
+        {
+        }
+
+        public override void OutputProfile(SpreadsheetWriter writer)
+        {
+        }
+    }
+}
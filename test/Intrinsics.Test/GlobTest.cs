@@ -0,0 +1,117 @@
+﻿using System;
+using Intrinsics;
+
+namespace IntrinsicsTest
+{
+    public class GlobTest : Test
+    {
+        public GlobTest()
+            : base("Glob")
+        {
+        }
+
+        public override void RunTest()
+        {
+            CheckTrue(new GlobPattern("/api/*/users/?id").IsMatch("/api/v2/users/7id"));
+            CheckTrue(!new GlobPattern("/api/*/users/?id").IsMatch("/api/v2/users/id"));
+            CheckTrue(new GlobPattern("*.log").IsMatch(".log") && !new GlobPattern("*.log").IsMatch("a.log.gz"));
+            CheckTrue(new GlobPattern("*.LOG", true).IsMatch("server.log") && !new GlobPattern("*.LOG").IsMatch("server.log"));
+            CheckTrue(new GlobPattern("[!0-9]*[]x]").IsMatch("a12]") && !new GlobPattern("[!0-9]*").IsMatch("1a"));
+            CheckTrue(new GlobPattern("").IsMatch("") && new GlobPattern("**").IsMatch(""));
+
+            // random patterns of the atoms against random strings, compared with a backtracking match
+            string[] atoms = { "a", "b", "A", "/", ".", "*", "?", "[ab]", "[!a]", "[a-b]", "[]a]", "ab", "\u00e9" };
+            string chars = "abAB/.x\u00e9";
+            Random random = new Random(44);
+            for (int i = 0; i < 20000; ++i)
+            {
+                string pattern = "";
+                for (int n = random.Next(7); n > 0; --n)
+                    pattern += atoms[random.Next(atoms.Length)];
+                char[] str = new char[random.Next(40)];
+                for (int j = 0; j < str.Length; ++j)
+                    str[j] = chars[random.Next(chars.Length)];
+                bool ignoreCase = random.Next(2) == 0;
+                string s = new string(str);
+                CheckTrue(new GlobPattern(pattern, ignoreCase).IsMatch(s) == Match(pattern, 0, s, 0, ignoreCase));
+            }
+
+            GlobPatternSet set = new GlobPatternSet(new string[] { "*.log", "/api/*/users/?id", "*", "/API/*", "/static/[a-z]*.css" }, true);
+            int[] matches = null;
+            int count = set.Match("/api/v1/users/7id", ref matches);
+            CheckTrue(count == 3 && matches[0] == 1 && matches[1] == 2 && matches[2] == 3);
+            CheckTrue(set.IndexOfMatch("x.log") == 0 && set.IndexOfMatch("/static/site.css") == 2);
+
+            bool thrown = false;
+            try
+            {
+                new GlobPattern("a[bc");
+            }
+            catch (ArgumentException)
+            {
+                thrown = true;
+            }
+            CheckTrue(thrown);
+        }
+
+        private static char Fold(char c, bool ignoreCase)
+        {
+            return ignoreCase && c >= 'A' && c <= 'Z' ? (char)(c | 0x20) : c;
+        }
+
+        private static bool Match(string pattern, int p, string s, int i, bool ignoreCase)
+        {
+            if (p == pattern.Length)
+                return i == s.Length;
+
+            if (pattern[p] == '*')
+            {
+                for (int j = i; j <= s.Length; ++j)
+                {
+                    if (Match(pattern, p + 1, s, j, ignoreCase))
+                        return true;
+                }
+                return false;
+            }
+
+            if (i == s.Length)
+                return false;
+
+            if (pattern[p] == '[')
+            {
+                int q = p + 1;
+                bool negated = pattern[q] == '!' || pattern[q] == '^';
+                if (negated)
+                    ++q;
+                bool found = false;
+                for (bool first = true; pattern[q] != ']' || first; first = false)
+                {
+                    char low = pattern[q];
+                    char high = low;
+                    if (q + 2 < pattern.Length && pattern[q + 1] == '-' && pattern[q + 2] != ']')
+                    {
+                        high = pattern[q + 2];
+                        q += 2;
+                    }
+                    ++q;
+                    char c = s[i];
+                    char other = c < 0x80 && char.IsLetter(c) ? (char)(c ^ 0x20) : c;
+                    found |= (c >= low && c <= high) || (ignoreCase && other >= low && other <= high);
+                }
+                return found != negated && Match(pattern, q + 1, s, i + 1, ignoreCase);
+            }
+
+            if (pattern[p] != '?' && Fold(pattern[p], ignoreCase) != Fold(s[i], ignoreCase))
+                return false;
+            return Match(pattern, p + 1, s, i + 1, ignoreCase);
+        }
+
+        public override void RunProfile()
+        {
+        }
+
+        public override void OutputProfile(SpreadsheetWriter writer)
+        {
+        }
+    }
+}
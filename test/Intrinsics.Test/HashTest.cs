@@ -0,0 +1,83 @@
+﻿using System;
+using System.Collections.Generic;
+using Intrinsics;
+
+namespace IntrinsicsTest
+{
+    public class HashTest : Test
+    {
+        public HashTest()
+            : base("Hash")
+        {
+        }
+
+        public override void RunTest()
+        {
+            Random random = new Random(35);
+            char[] chars = new char[100];
+            for (int i = 0; i < chars.Length; ++i)
+                chars[i] = (char)random.Next(0x20, 0x250);
+            string s = new string(chars);
+
+            foreach (Intrinsics.String.HashAlgorithm algorithm in new Intrinsics.String.HashAlgorithm[] { Intrinsics.String.HashAlgorithm.Crc32C, Intrinsics.String.HashAlgorithm.Aes })
+            {
+                // every tail length has its own value
+                HashSet<long> values = new HashSet<long>();
+                for (int length = 0; length <= s.Length; ++length)
+                {
+                    string prefix = s.Substring(0, length);
+                    long hash = Intrinsics.String.Hash64(prefix, algorithm, 7, false);
+                    CheckTrue(values.Add(hash));
+                    CheckTrue(hash == Intrinsics.String.Hash64(new string(chars, 0, length), algorithm, 7, false));
+                    CheckTrue(hash == Intrinsics.String.Hash64(chars, 0, length, algorithm, 7, false));
+                    CheckTrue(hash != Intrinsics.String.Hash64(prefix, algorithm, 8, false));
+                }
+
+                // slices
+                for (int startIndex = 0; startIndex < 20; ++startIndex)
+                    CheckTrue(Intrinsics.String.Hash64(chars, startIndex, 30, algorithm, 0, false) == Intrinsics.String.Hash64(s.Substring(startIndex, 30), algorithm));
+
+                // ascii letters only are folded
+                CheckTrue(Intrinsics.String.Hash64("Hello World 42", algorithm, 1, true) == Intrinsics.String.Hash64("hELLO wORLD 42", algorithm, 1, true));
+                CheckTrue(Intrinsics.String.Hash64("Hello World 42", algorithm, 1, false) != Intrinsics.String.Hash64("hELLO wORLD 42", algorithm, 1, false));
+                CheckTrue(Intrinsics.String.Hash64("Été", algorithm, 1, true) != Intrinsics.String.Hash64("été", algorithm, 1, true));
+                CheckTrue(Intrinsics.String.Hash64("[@", algorithm, 1, true) != Intrinsics.String.Hash64("{`", algorithm, 1, true));
+            }
+
+            CheckTrue(Intrinsics.String.Hash32(s) == Intrinsics.String.Hash32(s, 0, false));
+            CheckTrue(Intrinsics.String.Hash128("KEY", 3, true).Low == Intrinsics.String.Hash64("key", Intrinsics.String.HashAlgorithm.Aes, 3, false));
+            CheckTrue(!Intrinsics.String.Hash128("key", 3, false).Equals(Intrinsics.String.Hash128("key", 4, false)));
+
+            TestComparer(HashComparer.Ordinal);
+            TestComparer(HashComparer.OrdinalIgnoreCase);
+            TestComparer(new HashComparer(Intrinsics.String.HashAlgorithm.Crc32C, true, 12));
+        }
+
+        private void TestComparer(HashComparer comparer)
+        {
+            Dictionary<string, int> dictionary = new Dictionary<string, int>(comparer);
+            for (int i = 0; i < 1000; ++i)
+                dictionary.Add("Key" + i, i);
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                int value;
+                CheckTrue(dictionary.TryGetValue("Key" + i, out value) && value == i);
+                CheckTrue(dictionary.ContainsKey("KEY" + i) == comparer.IgnoreCase);
+            }
+
+            CheckTrue(comparer.Equals(null, null));
+            CheckTrue(!comparer.Equals("a", null));
+            CheckTrue(comparer.Equals("abc", "ABC") == comparer.IgnoreCase);
+            CheckTrue(!comparer.Equals("abc", "abd"));
+        }
+
+        public override void RunProfile()
+        {
+        }
+
+        public override void OutputProfile(SpreadsheetWriter writer)
+        {
+        }
+    }
+}
@@ -0,0 +1,132 @@
+﻿using System;
+using System.Globalization;
+using System.Text;
+using Intrinsics;
+
+namespace IntrinsicsTest
+{
+    public class ParseTest : Test
+    {
+        public ParseTest()
+            : base("Parse")
+        {
+        }
+
+        public override void RunTest()
+        {
+            // metrics line split on the delimiters found by IndexOfAll
+            Random random = new Random(38);
+            long[] expected = new long[500];
+            StringBuilder builder = new StringBuilder();
+            for (int i = 0; i < expected.Length; ++i)
+            {
+                expected[i] = ((long)random.Next() << 32 | (uint)random.Next()) >> random.Next(64);
+                if (random.Next(2) == 0)
+                    expected[i] = -expected[i];
+                if (i > 0)
+                    builder.Append(',');
+                builder.Append(expected[i].ToString(CultureInfo.InvariantCulture));
+            }
+            string line = builder.ToString();
+
+            Intrinsics.String.MatchIndex[] delimiters = new Intrinsics.String.MatchIndex[0];
+            int delimitersCount;
+            Intrinsics.String.IndexOfAll(line, ',', ref delimiters, out delimitersCount);
+
+            Intrinsics.String.FieldRange[] ranges = null;
+            int count = Intrinsics.String.GetFieldRanges(line, delimiters, delimitersCount, ref ranges);
+            CheckTrue(count == expected.Length);
+
+            long[] values = null;
+            Intrinsics.String.ParseInt64Batch(line, ranges, count, ref values);
+            for (int i = 0; i < count; ++i)
+                CheckTrue(values[i] == expected[i]);
+
+            // limits, and forms left to Int64.Parse
+            TestInt64("0");
+            TestInt64("-0");
+            TestInt64("9223372036854775807");
+            TestInt64("-9223372036854775808");
+            TestInt64("0000000000000000000000012");
+            TestInt64("+42");
+            TestInt64(" 42 ");
+            TestInt64Invalid("9223372036854775808");
+            TestInt64Invalid("12a4");
+            TestInt64Invalid("");
+            TestInt64Invalid("-");
+
+            TestDouble("0");
+            TestDouble("1.5");
+            TestDouble("-123.456");
+            TestDouble(".5");
+            TestDouble("5.");
+            TestDouble("9007199254740993");
+            TestDouble("0.1234567890123456789");
+            TestDouble("1e10");
+            TestDouble("-0");
+            TestDouble("1,234.5");
+            for (int i = 0; i < 1000; ++i)
+            {
+                double value = Math.Round((random.NextDouble() - 0.5) * Math.Pow(10, random.Next(12)), random.Next(8));
+                TestDouble(value.ToString("R", CultureInfo.InvariantCulture));
+            }
+
+            CheckTrue(Intrinsics.String.ParseDouble("x1.25x", 1, 4) == 1.25);
+
+            bool thrown = false;
+            try
+            {
+                Intrinsics.String.ParseDouble("1.2.3");
+            }
+            catch (FormatException)
+            {
+                thrown = true;
+            }
+            CheckTrue(thrown);
+        }
+
+        private void TestInt64(string s)
+        {
+            long[] values = null;
+            Intrinsics.String.ParseInt64Batch(s, new Intrinsics.String.FieldRange[] { new Intrinsics.String.FieldRange(0, s.Length) }, 1, ref values);
+            CheckTrue(values[0] == long.Parse(s, NumberStyles.Integer, CultureInfo.InvariantCulture));
+        }
+
+        private void TestInt64Invalid(string s)
+        {
+            bool thrown = false;
+            try
+            {
+                long[] values = null;
+                Intrinsics.String.ParseInt64Batch(s, new Intrinsics.String.FieldRange[] { new Intrinsics.String.FieldRange(0, s.Length) }, 1, ref values);
+            }
+            catch (FormatException)
+            {
+                thrown = true;
+            }
+            catch (OverflowException)
+            {
+                thrown = true;
+            }
+            CheckTrue(thrown);
+        }
+
+        private void TestDouble(string s)
+        {
+            double expected = double.Parse(s, NumberStyles.Float | NumberStyles.AllowThousands, CultureInfo.InvariantCulture);
+            CheckTrue(Intrinsics.String.ParseDouble(s).Equals(expected));
+
+            double[] values = null;
+            Intrinsics.String.ParseDoubleBatch(s, new Intrinsics.String.FieldRange[] { new Intrinsics.String.FieldRange(0, s.Length) }, 1, ref values);
+            CheckTrue(values[0].Equals(expected));
+        }
+
+        public override void RunProfile()
+        {
+        }
+
+        public override void OutputProfile(SpreadsheetWriter writer)
+        {
+        }
+    }
+}
@@ -5,6 +5,30 @@ namespace IntrinsicsTest
     {
         static void Main(string[] args)
         {
+            CpuTest cpuTest = new CpuTest();
+            cpuTest.RunTest();
+
+            TuningTest tuningTest = new TuningTest();
+            tuningTest.RunTest();
+
+            HashTest hashTest = new HashTest();
+            hashTest.RunTest();
+
+            Utf8Test utf8Test = new Utf8Test();
+            utf8Test.RunTest();
+
+            ParseTest parseTest = new ParseTest();
+            parseTest.RunTest();
+
+            CodecTest codecTest = new CodecTest();
+            codecTest.RunTest();
+
+            ArrayTest arrayTest = new ArrayTest();
+            arrayTest.RunTest();
+
+            GlobTest globTest = new GlobTest();
+            globTest.RunTest();
+
             StringTest test = new StringTest();
             test.RunTest();
             test.RunProfile();
@@ -1,4 +1,5 @@
 ﻿using System;
+using System.Linq;
 using System.Text;
 using System.Diagnostics;
 
@@ -11,6 +12,7 @@ namespace IntrinsicsTest
         private int[] buckets = { 4, 8, 16, 32, 64, 92, 128, 256, 512, 768, 1024, 2048, 4096, stringSizeMax };
         private const string possiblesChar = "012345679abcdefgzhjklmnopqrstuvwxyz";
         private const string searchChars = "[](){}!@#$%^&*";
+        private const string matchingChars = "aeiou05";
         private const int stringsPerBucket = 1024 * 1;
         private string[] strings;
         private Intrinsics.String.MatchIndex[] results = new Intrinsics.String.MatchIndex[stringSizeMax];
@@ -72,13 +74,28 @@ namespace IntrinsicsTest
 
         public override void RunTest()
         {
+            TestDiagnostics();
+            TestStream();
+            TestWhitespace();
+            TestHistogram();
+            TestEditDistance();
+
             for (int i = 0; i < strings.Length; ++i)
             {
                 string s = strings[i];
                 TestIndexOfAll(s, searchChars, 0, s.Length);
+                TestIndexOfAllPooled(s, matchingChars, 0, s.Length);
+                TestIndexOfAllBuilder(s, matchingChars);
+                TestCompare(s, strings[(i * 7) % strings.Length]);
 
                 if (i == (strings.Length / 2))
                 {
+                    // every unrolled search set size, and the first generic one
+                    for (int setSize = 1; setSize <= 9; ++setSize)
+                        TestIndexOfAll(s, possiblesChar.Substring(0, setSize), 0, s.Length);
+
+                    TestComparePositions(s);
+
                     for (int startIndex = 0; startIndex < s.Length - 1; ++startIndex)
                     {
                         int count = s.Length - startIndex;
@@ -88,6 +105,9 @@ namespace IntrinsicsTest
                         TestIndexOfAny(s, searchChars, startIndex, count);
                         TestIndexOfAny(s, searchChars, 0, startIndex + 1);
 
+                        TestIndexOfAllCharArray(s, matchingChars, startIndex, count);
+                        TestIndexOfAllCharArray(s, matchingChars, 0, startIndex + 1);
+
                     }
                 }
             }
@@ -276,6 +296,399 @@ namespace IntrinsicsTest
             }
         }
 
+        private void TestIndexOfAllPooled(string s, string chars, int startIndex, int count)
+        {
+            if (s.Length == 0)
+                return;
+
+            Intrinsics.String.MatchIndex[] csResult = new Intrinsics.String.MatchIndex[s.Length];
+            int csResultCount;
+            StringCs.IndexOfAll(s, chars, ref csResult, out csResultCount, startIndex, count);
+
+            // start small to force the buffer to grow
+            using (Intrinsics.MatchBuffer pooled = Intrinsics.MatchBufferPool.Rent(1))
+            {
+                Intrinsics.String.IndexOfAll(s, chars, pooled, startIndex, count);
+
+                CheckTrue(pooled.Count == csResultCount);
+                for (int j = 0; j < pooled.Count; ++j)
+                {
+                    CheckTrue(pooled.Results[j].StringIndex == csResult[j].StringIndex);
+                    CheckTrue(chars[pooled.Results[j].CharIndex] == chars[csResult[j].CharIndex]);
+                }
+            }
+        }
+
+        private void TestIndexOfAllCharArray(string s, string chars, int startIndex, int count)
+        {
+            Intrinsics.String.MatchIndex[] csResult = new Intrinsics.String.MatchIndex[s.Length];
+            int csResultCount;
+            StringCs.IndexOfAll(s, chars, ref csResult, out csResultCount, startIndex, count);
+
+            // embed the string in a larger buffer so the slice don't start at index 0
+            const int padding = 3;
+            char[] buffer = new char[s.Length + padding * 2];
+            s.CopyTo(0, buffer, padding, s.Length);
+
+            Intrinsics.String.MatchIndex[] arrayResult = new Intrinsics.String.MatchIndex[0];
+            int arrayResultCount;
+            Intrinsics.String.IndexOfAll(buffer, chars, ref arrayResult, out arrayResultCount, padding + startIndex, count);
+
+            CheckTrue(arrayResultCount == csResultCount);
+            for (int j = 0; j < arrayResultCount; ++j)
+            {
+                CheckTrue(arrayResult[j].StringIndex - padding == csResult[j].StringIndex);
+                CheckTrue(chars[arrayResult[j].CharIndex] == chars[csResult[j].CharIndex]);
+            }
+
+            int csIndex = s.IndexOfAny(chars.ToCharArray(), startIndex, count);
+            int arrayIndex = Intrinsics.String.IndexOfAny(buffer, chars.ToCharArray(), padding + startIndex, count);
+            CheckTrue(csIndex == (arrayIndex < 0 ? arrayIndex : arrayIndex - padding));
+        }
+
+        private void TestIndexOfAllBuilder(string s, string chars)
+        {
+            // builder made of many chunks, larger than the search window
+            StringBuilder builder = new StringBuilder(16);
+            for (int i = 0; i < 4; ++i)
+                builder.Append(s);
+            string str = builder.ToString();
+            if (str.Length == 0)
+                return;
+
+            Intrinsics.String.MatchIndex[] csResult = new Intrinsics.String.MatchIndex[str.Length];
+            int csResultCount;
+            StringCs.IndexOfAll(str, chars, ref csResult, out csResultCount, 0, str.Length);
+
+            Intrinsics.String.MatchIndex[] builderResult = new Intrinsics.String.MatchIndex[0];
+            int builderResultCount;
+            Intrinsics.String.IndexOfAll(builder, chars, ref builderResult, out builderResultCount);
+
+            CheckTrue(builderResultCount == csResultCount);
+            for (int j = 0; j < builderResultCount; ++j)
+            {
+                CheckTrue(builderResult[j].StringIndex == csResult[j].StringIndex);
+                CheckTrue(chars[builderResult[j].CharIndex] == chars[csResult[j].CharIndex]);
+            }
+
+            CheckTrue(str.IndexOfAny(chars.ToCharArray()) == Intrinsics.String.IndexOfAny(builder, chars.ToCharArray()));
+        }
+
+        private void TestCompare(string s, string other)
+        {
+            CheckTrue(Intrinsics.String.Equals(s, new string(s.ToCharArray())));
+            CheckTrue(Intrinsics.String.Equals(s, other) == string.Equals(s, other));
+            CheckTrue(Math.Sign(Intrinsics.String.CompareOrdinal(s, other)) == Math.Sign(string.CompareOrdinal(s, other)));
+            CheckTrue(Intrinsics.String.StartsWith(s, other) == s.StartsWith(other, StringComparison.Ordinal));
+            CheckTrue(Intrinsics.String.EndsWith(s, other) == s.EndsWith(other, StringComparison.Ordinal));
+
+            // ascii letters only are folded
+            char[] upper = s.ToCharArray();
+            for (int i = 0; i < upper.Length; ++i)
+            {
+                if (upper[i] >= 'a' && upper[i] <= 'z')
+                    upper[i] = (char)(upper[i] - 'a' + 'A');
+            }
+            CheckTrue(Intrinsics.String.EqualsIgnoreCase(s, new string(upper)));
+            CheckTrue(Intrinsics.String.EqualsIgnoreCase("\u00e9t\u00e9", "\u00c9T\u00c9") == false);
+
+            CheckTrue(Intrinsics.String.CommonPrefixLength(s, s + "x") == s.Length);
+            CheckTrue(Intrinsics.String.CompareOrdinal(s, s + "x") < 0);
+            CheckTrue(Intrinsics.String.CompareOrdinal(null, s) < 0);
+            CheckTrue(!Intrinsics.String.Equals(null, s));
+        }
+
+        private void TestComparePositions(string s)
+        {
+            // differ at every position
+            for (int i = 0; i < s.Length; ++i)
+            {
+                char[] chars = s.ToCharArray();
+                chars[i] = (char)(chars[i] + 1);
+                string changed = new string(chars);
+
+                CheckTrue(!Intrinsics.String.Equals(s, changed));
+                CheckTrue(Intrinsics.String.CompareOrdinal(s, changed) < 0);
+                CheckTrue(Intrinsics.String.CompareOrdinal(changed, s) > 0);
+                CheckTrue(Intrinsics.String.CommonPrefixLength(s, changed) == i);
+                CheckTrue(Intrinsics.String.CommonPrefixLength(s, changed, i) == i);
+                CheckTrue(Intrinsics.String.StartsWith(s, s.Substring(0, i)));
+                CheckTrue(Intrinsics.String.EndsWith(s, s.Substring(i)));
+                CheckTrue(Intrinsics.String.StartsWith(changed, s.Substring(0, i + 1)) == false);
+                CheckTrue(Math.Sign(Intrinsics.String.CompareOrdinal(s, i, changed, i, s.Length)) == -1);
+                CheckTrue(Intrinsics.String.CompareOrdinal(s, 0, changed, 0, i) == 0);
+            }
+        }
+
+        private void TestWhitespace()
+        {
+            // U+180E was Zs before unicode 6.3, it depend on the runtime version
+            for (int c = 0; c <= 0xffff; ++c)
+            {
+                if (c != 0x180e)
+                    CheckTrue(Intrinsics.String.IsNullOrWhiteSpace(new string((char)c, 1)) == char.IsWhiteSpace((char)c));
+            }
+
+            string[] whitespaces = { " ", "\t", "\r\n", "\u00a0", "\u3000", "\u2000\u2029" };
+            Random random = new Random(39);
+            for (int i = 0; i < 500; ++i)
+            {
+                StringBuilder builder = new StringBuilder();
+                int length = random.Next(80);
+                for (int j = 0; j < length; ++j)
+                {
+                    if (random.Next(3) == 0)
+                        builder.Append(whitespaces[random.Next(whitespaces.Length)]);
+                    else
+                        builder.Append((char)random.Next('a', 'z' + 1));
+                }
+                string s = builder.ToString();
+
+                CheckTrue(Intrinsics.String.Trim(s) == s.Trim());
+                CheckTrue(Intrinsics.String.TrimStart(s) == s.TrimStart());
+                CheckTrue(Intrinsics.String.TrimEnd(s) == s.TrimEnd());
+                CheckTrue(Intrinsics.String.IsNullOrWhiteSpace(s) == string.IsNullOrWhiteSpace(s));
+
+                Intrinsics.String.FieldRange range = Intrinsics.String.TrimRange(s, 0, s.Length);
+                CheckTrue(s.Substring(range.StartIndex, range.Length) == s.Trim());
+
+                char[] chars = new char[s.Length + 1];
+                int collapsed = Intrinsics.String.CollapseWhitespace(s, chars, 1);
+                string expected = System.Text.RegularExpressions.Regex.Replace(s, "\\s+", " ");
+                CheckTrue(new string(chars, 1, collapsed) == expected);
+            }
+
+            string trimmed = "no whitespace";
+            CheckTrue(object.ReferenceEquals(Intrinsics.String.Trim(trimmed), trimmed));
+            CheckTrue(Intrinsics.String.IsNullOrWhiteSpace(null));
+            CheckTrue(Intrinsics.String.IsNullOrWhiteSpace(new string(' ', 100)));
+            CheckTrue(!Intrinsics.String.IsNullOrWhiteSpace(new string(' ', 100) + "\u200b"));
+
+            Intrinsics.String.FieldRange[] ranges = { new Intrinsics.String.FieldRange(0, 4), new Intrinsics.String.FieldRange(4, 5) };
+            Intrinsics.String.TrimRanges(" ab  cd  ", ranges, 2);
+            CheckTrue(ranges[0].StartIndex == 1 && ranges[0].Length == 2 && ranges[1].StartIndex == 5 && ranges[1].Length == 2);
+        }
+
+        private void TestHistogram()
+        {
+            Random random = new Random(43);
+            foreach (int length in new int[] { 0, 1, 15, 255, 256, 1000, 4099 })
+            {
+                // latin-1 with a few other chars
+                char[] chars = new char[length];
+                for (int i = 0; i < length; ++i)
+                    chars[i] = random.Next(50) == 0 ? (char)random.Next(0x100, 0x10000) : (char)random.Next(0x100);
+                string s = new string(chars);
+
+                int[] counts = new int[257];
+                counts[65] = 1;
+                Intrinsics.String.Histogram(s, counts);
+                int[] expected = new int[257];
+                expected[65] = 1;
+                foreach (char c in s)
+                    ++expected[c < 0x100 ? c : 256];
+                CheckTrue(counts.SequenceEqual(expected));
+
+                char[] distinct = null;
+                int[] distinctCounts = null;
+                int distinctCount = Intrinsics.String.HistogramSparse(s, ref distinct, ref distinctCounts);
+                var groups = s.GroupBy(c => c).OrderBy(g => g.Key).ToArray();
+                CheckTrue(distinctCount == groups.Length);
+                for (int i = 0; i < groups.Length; ++i)
+                    CheckTrue(distinct[i] == groups[i].Key && distinctCounts[i] == groups[i].Count());
+            }
+
+            int[] range = new int[257];
+            Intrinsics.String.Histogram("aab\u4e2dc", 1, 3, range);
+            CheckTrue(range['a'] == 1 && range['b'] == 1 && range[256] == 1 && range.Sum() == 3);
+
+            char[] rangeChars = null;
+            int[] rangeCounts = null;
+            CheckTrue(Intrinsics.String.HistogramSparse("aab\u4e2d\u4e2dc", 1, 4, ref rangeChars, ref rangeCounts) == 3);
+            CheckTrue(rangeChars[0] == 'a' && rangeChars[1] == 'b' && rangeChars[2] == '\u4e2d');
+            CheckTrue(rangeCounts[0] == 1 && rangeCounts[1] == 1 && rangeCounts[2] == 2);
+            CheckTrue(Intrinsics.String.HistogramSparse("abc", 3, 0, ref rangeChars, ref rangeCounts) == 0);
+        }
+
+        private static int EditDistanceReference(string a, string b)
+        {
+            int[] row = new int[b.Length + 1];
+            for (int j = 0; j <= b.Length; ++j)
+                row[j] = j;
+            for (int i = 1; i <= a.Length; ++i)
+            {
+                int diagonal = row[0];
+                row[0] = i;
+                for (int j = 1; j <= b.Length; ++j)
+                {
+                    int above = row[j];
+                    row[j] = Math.Min(Math.Min(row[j] + 1, row[j - 1] + 1), diagonal + (a[i - 1] == b[j - 1] ? 0 : 1));
+                    diagonal = above;
+                }
+            }
+            return row[b.Length];
+        }
+
+        private void TestEditDistance()
+        {
+            CheckTrue(Intrinsics.String.EditDistance("kitten", "sitting") == 3);
+            CheckTrue(Intrinsics.String.EditDistance("", "abc") == 3);
+            CheckTrue(Intrinsics.String.EditDistance("kitten", "sitting", 2) == 3);
+
+            bool thrown = false;
+            try
+            {
+                Intrinsics.String.EditDistance("kitten", "sitting", -1);
+            }
+            catch (ArgumentOutOfRangeException)
+            {
+                thrown = true;
+            }
+            CheckTrue(thrown);
+
+            // small alphabets with a few chars above 0xff, lengths across the 64 chars words
+            Random random = new Random(45);
+            Func<int, string> randomString = length =>
+            {
+                char[] chars = new char[length];
+                for (int i = 0; i < length; ++i)
+                    chars[i] = random.Next(8) == 0 ? (char)(0x4e00 + random.Next(3)) : (char)('a' + random.Next(4));
+                return new string(chars);
+            };
+
+            for (int test = 0; test < 200; ++test)
+            {
+                string a = randomString(random.Next(test % 4 == 0 ? 200 : 70));
+                string b = randomString(random.Next(70));
+                int expected = EditDistanceReference(a, b);
+                int maxDistance = random.Next(10);
+                int bounded = expected > maxDistance ? maxDistance + 1 : expected;
+                CheckTrue(Intrinsics.String.EditDistance(a, b) == expected);
+                CheckTrue(Intrinsics.String.EditDistance(a, b, maxDistance) == bounded);
+            }
+
+            foreach (int patternLength in new int[] { 0, 5, 20, 64, 65, 130 })
+            {
+                string pattern = randomString(patternLength);
+                string[] candidates = new string[1 + random.Next(40)];
+                for (int i = 0; i < candidates.Length; ++i)
+                    candidates[i] = randomString(Math.Max(0, patternLength + random.Next(-3, 4)));
+
+                foreach (int maxDistance in new int[] { -1, 0, 4, 20 })
+                {
+                    int[] distances = null;
+                    int within = Intrinsics.String.EditDistanceBatch(pattern, candidates, maxDistance, ref distances);
+                    int expectedWithin = 0;
+                    for (int i = 0; i < candidates.Length; ++i)
+                    {
+                        int expected = EditDistanceReference(pattern, candidates[i]);
+                        bool isWithin = maxDistance < 0 || expected <= maxDistance;
+                        expectedWithin += isWithin ? 1 : 0;
+                        CheckTrue(distances[i] == (isWithin ? expected : maxDistance + 1));
+                    }
+                    CheckTrue(within == expectedWithin);
+                }
+            }
+
+            // several pinned groups of candidates, against the scalar EditDistance
+            string word = randomString(12);
+            string[] words = new string[53];
+            for (int i = 0; i < words.Length; ++i)
+                words[i] = randomString(random.Next(8, 17));
+            foreach (int maxDistance in new int[] { -1, 3 })
+            {
+                int[] distances = null;
+                int within = Intrinsics.String.EditDistanceBatch(word, words, maxDistance, ref distances);
+                int expectedWithin = 0;
+                for (int i = 0; i < words.Length; ++i)
+                {
+                    int expected = maxDistance < 0 ? Intrinsics.String.EditDistance(word, words[i]) : Intrinsics.String.EditDistance(word, words[i], maxDistance);
+                    expectedWithin += maxDistance < 0 || expected <= maxDistance ? 1 : 0;
+                    CheckTrue(distances[i] == expected);
+                }
+                CheckTrue(within == expectedWithin);
+            }
+        }
+
+        private void TestStream()
+        {
+            // every vector search in the large input mode
+            long threshold = Intrinsics.Tuning.StreamThreshold;
+            Intrinsics.Tuning.StreamThreshold = 1;
+            try
+            {
+                string s = strings[strings.Length - 1];
+                for (int setSize = 1; setSize <= 9; ++setSize)
+                    TestIndexOfAll(s, possiblesChar.Substring(0, setSize), 0, s.Length);
+
+                TestIndexOfAll(s, searchChars, 1, s.Length - 1);
+                TestIndexOfAny(s, searchChars, 0, s.Length);
+                TestIndexOfAny(s, searchChars, 1, s.Length - 1);
+            }
+            finally
+            {
+                Intrinsics.Tuning.StreamThreshold = threshold;
+            }
+        }
+
+        private void TestDiagnostics()
+        {
+            Intrinsics.Diagnostics.Reset();
+
+            string s = strings[strings.Length - 1];
+            int resultsCount;
+            Intrinsics.String.IndexOfAll(s, matchingChars, ref results, out resultsCount);
+
+            long calls = 0;
+            long chars = 0;
+            long matches = 0;
+            Intrinsics.Diagnostics.Snapshot snapshot = Intrinsics.Diagnostics.TakeSnapshot();
+            foreach (Intrinsics.Diagnostics.Tier tier in Enum.GetValues(typeof(Intrinsics.Diagnostics.Tier)))
+            {
+                Intrinsics.Diagnostics.KernelCounters counters = snapshot.Kernel(Intrinsics.Diagnostics.Operation.IndexOfAll, tier);
+                calls += counters.Calls;
+                chars += counters.Chars;
+                matches += counters.Matches;
+                CheckTrue(counters.ScalarChars + counters.VectorChars == counters.Chars);
+                CheckTrue(counters.LengthHistogram.Length == Intrinsics.Diagnostics.HistogramBuckets);
+            }
+
+            if (Intrinsics.Diagnostics.Enabled)
+            {
+                CheckTrue(calls == 1);
+                CheckTrue(chars == s.Length);
+                CheckTrue(matches == resultsCount);
+            }
+            else
+            {
+                CheckTrue(calls == 0);
+            }
+
+            // IndexOfAny stop in the middle of a vector, the match vector chars after the match are not scanned
+            Intrinsics.Diagnostics.Reset();
+            char[] text = new string('a', 4096).ToCharArray();
+            text[2053] = 'z';
+            int index = Intrinsics.String.IndexOfAny(new string(text), new char[] { 'y', 'z' });
+            CheckTrue(index == 2053);
+
+            long anyCalls = 0;
+            long anyChars = 0;
+            snapshot = Intrinsics.Diagnostics.TakeSnapshot();
+            foreach (Intrinsics.Diagnostics.Tier tier in Enum.GetValues(typeof(Intrinsics.Diagnostics.Tier)))
+            {
+                Intrinsics.Diagnostics.KernelCounters counters = snapshot.Kernel(Intrinsics.Diagnostics.Operation.IndexOfAny, tier);
+                anyCalls += counters.Calls;
+                anyChars += counters.Chars;
+                CheckTrue(counters.ScalarChars + counters.VectorChars == counters.Chars);
+                CheckTrue(counters.ScalarChars >= 0 && counters.VectorChars >= 0);
+            }
+
+            if (Intrinsics.Diagnostics.Enabled && Intrinsics.Tuning.Select(Intrinsics.Tuning.Operation.IndexOfAny, 2, text.Length) != Intrinsics.Tuning.Tier.Managed)
+                CheckTrue(anyCalls == 1 && anyChars == index + 1);
+
+            CheckTrue(Intrinsics.Diagnostics.Events != null);
+        }
+
         private void TestIndexOfAny(string s, string charsString, int startIndex, int count)
         {
             char[] chars = charsString.ToCharArray();
@@ -0,0 +1,120 @@
+﻿using System;
+using System.IO;
+using Intrinsics;
+
+namespace IntrinsicsTest
+{
+    public class TuningTest : Test
+    {
+        private static readonly int[] setSizes = { 1, 2, 3, 4, 8, 9, 16, 32 };
+        private static readonly int[] lengths = { 0, 1, 7, 8, 63, 64, 1000, 100000 };
+
+        public TuningTest()
+            : base("Tuning")
+        {
+        }
+
+        public override void RunTest()
+        {
+            Tuning.Reset();
+            CheckTrue(!Tuning.Calibrated);
+            CheckSupported();
+            CheckDispatch();
+
+            Tuning.Calibrate();
+            CheckTrue(Tuning.Calibrated);
+            CheckSupported();
+
+            CheckDispatch();
+
+            Tuning.Tier[] calibrated = Snapshot();
+
+            string path = Path.Combine(Path.GetTempPath(), Path.GetRandomFileName());
+            try
+            {
+                Tuning.Save(path);
+                Tuning.Reset();
+                CheckTrue(Tuning.Load(path));
+                CheckTrue(Tuning.Calibrated);
+
+                Tuning.Tier[] loaded = Snapshot();
+                for (int i = 0; i < calibrated.Length; ++i)
+                    CheckTrue(calibrated[i] == loaded[i]);
+
+                // other version or other cpu are ignored
+                string[] lines = File.ReadAllLines(path);
+                lines[1] = "cpu other 0x0";
+                File.WriteAllLines(path, lines);
+                Tuning.Reset();
+                CheckTrue(!Tuning.Load(path));
+                CheckTrue(!Tuning.Calibrated);
+            }
+            finally
+            {
+                File.Delete(path);
+            }
+
+            CheckTrue(!Tuning.Load(path));
+            Tuning.Reset();
+        }
+
+        private void CheckSupported()
+        {
+            foreach (Tuning.Tier tier in Snapshot())
+            {
+                if (tier == Tuning.Tier.Sse2)
+                    CheckTrue(Cpu.Supports(CpuFeatures.Sse2));
+                else if (tier == Tuning.Tier.Avx2)
+                    CheckTrue(Cpu.Supports(CpuFeatures.Avx2));
+            }
+        }
+
+        // the String.IndexOfAny kernel counters are those of the tier the table select
+        private void CheckDispatch()
+        {
+            if (!Diagnostics.Enabled)
+                return;
+
+            foreach (int setSize in new int[] { 1, 3, 9 })
+            {
+                foreach (int length in new int[] { 7, 64, 1000, 100000 })
+                {
+                    char[] chars = "0123456789".Substring(0, setSize).ToCharArray();
+                    Diagnostics.Reset();
+                    Intrinsics.String.IndexOfAny(new string('a', length), chars);
+                    Diagnostics.Snapshot snapshot = Diagnostics.TakeSnapshot();
+
+                    Tuning.Tier selected = Tuning.Select(Tuning.Operation.IndexOfAny, setSize, length);
+                    foreach (Diagnostics.Tier tier in Enum.GetValues(typeof(Diagnostics.Tier)))
+                    {
+                        long calls = snapshot.Kernel(Diagnostics.Operation.IndexOfAny, tier).Calls;
+                        CheckTrue(calls == (tier.ToString() == selected.ToString() ? 1 : 0));
+                    }
+                }
+            }
+        }
+
+        private Tuning.Tier[] Snapshot()
+        {
+            Tuning.Tier[] tiers = new Tuning.Tier[3 * setSizes.Length * lengths.Length];
+            int index = 0;
+            foreach (Tuning.Operation operation in new Tuning.Operation[] { Tuning.Operation.IndexOfAll, Tuning.Operation.IndexOfAny, Tuning.Operation.CommonPrefix })
+            {
+                foreach (int setSize in setSizes)
+                {
+                    foreach (int length in lengths)
+                        tiers[index++] = Tuning.Select(operation, setSize, length);
+                }
+            }
+            return tiers;
+        }
+
+        public override void RunProfile()
+        {
+        }
+
+        public override void OutputProfile(SpreadsheetWriter writer)
+        {
+        }
+    }
+}
@@ -0,0 +1,147 @@
+﻿using System;
+using System.Text;
+using Intrinsics;
+
+namespace IntrinsicsTest
+{
+    public class Utf8Test : Test
+    {
+        public Utf8Test()
+            : base("Utf8")
+        {
+        }
+
+        public override void RunTest()
+        {
+            // ascii, 2 bytes, 3 bytes and surrogate pairs mixed so the vector blocks hit every path
+            Random random = new Random(37);
+            StringBuilder builder = new StringBuilder();
+            for (int i = 0; i < 2000; ++i)
+            {
+                int kind = random.Next(10);
+                if (kind < 6)
+                    builder.Append((char)random.Next(0x20, 0x7f));
+                else if (kind < 8)
+                    builder.Append((char)random.Next(0x80, 0x800));
+                else if (kind < 9)
+                    builder.Append((char)random.Next(0x800, 0xd800));
+                else
+                    builder.Append(char.ConvertFromUtf32(random.Next(0x10000, 0x110000)));
+            }
+            string s = builder.ToString();
+
+            // lengths and start offsets that don't split a surrogate pair
+            for (int length = 0; length < 300; ++length)
+            {
+                int startIndex = length % 17;
+                if (char.IsLowSurrogate(s[startIndex]) || char.IsLowSurrogate(s[startIndex + length]))
+                    continue;
+                TestString(s.Substring(startIndex, length));
+            }
+            TestString(s);
+            TestString(new string('a', 1000));
+            TestString(new string('é', 1000));
+
+            // unpaired surrogates
+            CheckTrue(!Intrinsics.String.IsValidUtf16("abc\ud800"));
+            CheckTrue(!Intrinsics.String.IsValidUtf16("abc\udc00def"));
+            CheckTrue(!Intrinsics.String.IsValidUtf16(new string('a', 100) + "\ud800a" + new string('a', 100)));
+            CheckTrue(!Intrinsics.String.IsValidUtf16("\udc00\ud800"));
+            CheckTrue(Intrinsics.String.IsValidUtf16("𐀀"));
+
+            // overlong, surrogate, too large and truncated sequences
+            TestInvalid(new byte[] { 0xc0, 0x80 });
+            TestInvalid(new byte[] { 0xe0, 0x80, 0x80 });
+            TestInvalid(new byte[] { 0xed, 0xa0, 0x80 });
+            TestInvalid(new byte[] { 0xf4, 0x90, 0x80, 0x80 });
+            TestInvalid(new byte[] { 0xf5, 0x80, 0x80, 0x80 });
+            TestInvalid(new byte[] { 0x80 });
+            TestInvalid(new byte[] { 0xe2, 0x82 });
+
+            // invalid sequences inserted in multibyte text around the 32 bytes blocks of the vector validation
+            byte[] valid = Encoding.UTF8.GetBytes(s);
+            byte[][] sequences = { new byte[] { 0xed, 0xa0, 0x80 }, new byte[] { 0xe2, 0x82 }, new byte[] { 0x80 }, new byte[] { 0xf4, 0x90, 0x80, 0x80 } };
+            foreach (byte[] sequence in sequences)
+            {
+                for (int offset = 26; offset < 100; offset += 3)
+                {
+                    int at = offset;
+                    while ((valid[at] & 0xc0) == 0x80)
+                        ++at;
+                    byte[] corrupted = new byte[valid.Length + sequence.Length];
+                    System.Array.Copy(valid, corrupted, at);
+                    System.Array.Copy(sequence, 0, corrupted, at, sequence.Length);
+                    System.Array.Copy(valid, at, corrupted, at + sequence.Length, valid.Length - at);
+                    CheckTrue(!Intrinsics.String.IsValidUtf8(corrupted, 0, corrupted.Length));
+                    CheckTrue(Intrinsics.String.IsValidUtf8(corrupted, 0, at));
+                }
+            }
+
+            byte[] bytes = Encoding.ASCII.GetBytes(new string('a', 40));
+            bytes[33] = 0xff;
+            TestInvalid(bytes);
+            CheckTrue(Intrinsics.String.IsValidUtf8(bytes, 0, 33));
+            CheckTrue(!Intrinsics.String.IsAscii(bytes, 0, bytes.Length));
+            CheckTrue(Intrinsics.String.IsAscii(bytes, 0, 33));
+
+            bool thrown = false;
+            try
+            {
+                Intrinsics.String.ToUtf8("abc", new byte[2], 0);
+            }
+            catch (ArgumentException)
+            {
+                thrown = true;
+            }
+            CheckTrue(thrown);
+        }
+
+        private void TestString(string s)
+        {
+            byte[] expected = Encoding.UTF8.GetBytes(s);
+            CheckTrue(Intrinsics.String.IsValidUtf16(s));
+            CheckTrue(Intrinsics.String.IsAscii(s) == (expected.Length == s.Length));
+            CheckTrue(Intrinsics.String.GetUtf8ByteCount(s) == expected.Length);
+
+            // caller buffer with an offset, the bytes around stay untouched
+            byte[] bytes = new byte[expected.Length + 8];
+            CheckTrue(Intrinsics.String.ToUtf8(s, bytes, 4) == expected.Length);
+            CheckTrue(bytes[3] == 0 && bytes[bytes.Length - 4] == 0);
+            for (int i = 0; i < expected.Length; ++i)
+                CheckTrue(bytes[4 + i] == expected[i]);
+
+            CheckTrue(Intrinsics.String.IsValidUtf8(bytes, 4, expected.Length));
+            CheckTrue(Intrinsics.String.IsAscii(bytes, 4, expected.Length) == (expected.Length == s.Length));
+            CheckTrue(Intrinsics.String.GetUtf16CharCount(bytes, 4, expected.Length) == s.Length);
+            CheckTrue(Intrinsics.String.FromUtf8(bytes, 4, expected.Length) == s);
+
+            char[] chars = new char[s.Length + 2];
+            CheckTrue(Intrinsics.String.FromUtf8(bytes, 4, expected.Length, chars, 1) == s.Length);
+            CheckTrue(new string(chars, 1, s.Length) == s);
+        }
+
+        private void TestInvalid(byte[] bytes)
+        {
+            CheckTrue(!Intrinsics.String.IsValidUtf8(bytes, 0, bytes.Length));
+
+            bool thrown = false;
+            try
+            {
+                Intrinsics.String.FromUtf8(bytes, 0, bytes.Length);
+            }
+            catch (ArgumentException)
+            {
+                thrown = true;
+            }
+            CheckTrue(thrown);
+        }
+
+        public override void RunProfile()
+        {
+        }
+
+        public override void OutputProfile(SpreadsheetWriter writer)
+        {
+        }
+    }
+}